@@ -0,0 +1,209 @@
+#include "arena/arena-allocator.hpp"
+#include "arena/arena.hpp"
+#include "arena/pool.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <vector>
+
+#include "../bench-utilities.hpp"
+
+// NOTE: allocate `count` small objects then free all of them, the pattern of a per-frame scratch allocator
+
+namespace {
+
+using mia::bench::report;
+
+struct particle {
+    float position[3];
+    float velocity[3];
+    float age;
+    uint32_t id;
+};
+
+// :: General purpose allocators
+
+void bm_malloc(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    std::vector<void *> pointers(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            pointers[i] = std::malloc(sizeof(particle));
+        }
+        benchmark::DoNotOptimize(pointers.data());
+        for (size_t i = 0; i < count; ++i) {
+            std::free(pointers[i]);
+        }
+    }
+    report(state, count, sizeof(particle));
+}
+
+void bm_new(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    std::vector<particle *> pointers(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            pointers[i] = new particle{};
+        }
+        benchmark::DoNotOptimize(pointers.data());
+        for (size_t i = 0; i < count; ++i) {
+            delete pointers[i];
+        }
+    }
+    report(state, count, sizeof(particle));
+}
+
+// :: std::pmr
+
+void bm_pmr_monotonic(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    std::vector<void *> pointers(count);
+    std::pmr::monotonic_buffer_resource resource;
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            pointers[i] = resource.allocate(sizeof(particle), alignof(particle));
+        }
+        benchmark::DoNotOptimize(pointers.data());
+        resource.release();
+    }
+    report(state, count, sizeof(particle));
+}
+
+void bm_pmr_pool(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    std::vector<void *> pointers(count);
+    std::pmr::unsynchronized_pool_resource resource;
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            pointers[i] = resource.allocate(sizeof(particle), alignof(particle));
+        }
+        benchmark::DoNotOptimize(pointers.data());
+        for (size_t i = 0; i < count; ++i) {
+            resource.deallocate(pointers[i], sizeof(particle), alignof(particle));
+        }
+    }
+    report(state, count, sizeof(particle));
+}
+
+// :: mia
+
+void bm_arena(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    std::vector<particle *> pointers(count);
+    mia::arena a;
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            pointers[i] = a.alloc<particle>();
+        }
+        benchmark::DoNotOptimize(pointers.data());
+        a.reset();
+    }
+    report(state, count, sizeof(particle));
+}
+
+void bm_arena_array(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    mia::arena a;
+    for (auto _ : state) {
+        particle *particles = a.alloc_array<particle>(count);
+        benchmark::DoNotOptimize(particles);
+        a.reset();
+    }
+    report(state, count, sizeof(particle));
+}
+
+void bm_arena_scope(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    std::vector<particle *> pointers(count);
+    mia::arena a;
+    for (auto _ : state) {
+        mia::arena_scope scope(a);
+        for (size_t i = 0; i < count; ++i) {
+            pointers[i] = a.alloc<particle>();
+        }
+        benchmark::DoNotOptimize(pointers.data());
+    }
+    report(state, count, sizeof(particle));
+}
+
+void bm_arena_resource(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    std::vector<void *> pointers(count);
+    mia::arena a;
+    mia::arena_resource resource(a);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            pointers[i] = resource.allocate(sizeof(particle), alignof(particle));
+        }
+        benchmark::DoNotOptimize(pointers.data());
+        a.reset();
+    }
+    report(state, count, sizeof(particle));
+}
+
+void bm_pool(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    std::vector<particle *> pointers(count);
+    mia::pool<particle> p;
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            pointers[i] = p.create();
+        }
+        benchmark::DoNotOptimize(pointers.data());
+        for (size_t i = 0; i < count; ++i) {
+            p.destroy(pointers[i]);
+        }
+    }
+    report(state, count, sizeof(particle));
+}
+
+// :: Containers, std::vector<int> grown by push_back
+
+void bm_vector_std(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        std::vector<int> v;
+        for (size_t i = 0; i < count; ++i) {
+            v.push_back(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(v.data());
+    }
+    report(state, count, sizeof(int));
+}
+
+void bm_vector_arena(benchmark::State &state) {
+    mia::arena a;
+    mia::arena_allocator<int> allocator(a);
+    const auto count = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        {
+            std::vector<int, mia::arena_allocator<int>> v(allocator);
+            for (size_t i = 0; i < count; ++i) {
+                v.push_back(static_cast<int>(i));
+            }
+            benchmark::DoNotOptimize(v.data());
+        }
+        a.reset();
+    }
+    report(state, count, sizeof(int));
+}
+
+} // namespace
+
+#define MIA_ARENA_BENCH(fn) BENCHMARK(fn)->Arg(1 << 10)->Arg(1 << 16)
+
+MIA_ARENA_BENCH(bm_malloc);
+MIA_ARENA_BENCH(bm_new);
+MIA_ARENA_BENCH(bm_pmr_monotonic);
+MIA_ARENA_BENCH(bm_pmr_pool);
+MIA_ARENA_BENCH(bm_arena);
+MIA_ARENA_BENCH(bm_arena_array);
+MIA_ARENA_BENCH(bm_arena_scope);
+MIA_ARENA_BENCH(bm_arena_resource);
+MIA_ARENA_BENCH(bm_pool);
+MIA_ARENA_BENCH(bm_vector_std);
+MIA_ARENA_BENCH(bm_vector_arena);
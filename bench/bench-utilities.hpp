@@ -0,0 +1,43 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "math/vector.hpp"
+
+// Largest problem size of the throughput benchmarks, lower it on small machines
+#ifndef MIA_BENCH_MAX_ELEMENTS
+#define MIA_BENCH_MAX_ELEMENTS 100'000'000
+#endif  // !MIA_BENCH_MAX_ELEMENTS
+
+namespace mia::bench {
+
+// Deterministic inputs in [-8, 8) (LCG), never all zero
+template <typename T, size_t Dims>
+auto make_inputs(const size_t count, const uint32_t seed) -> std::vector<mia::vector<T, Dims>> {
+    std::vector<mia::vector<T, Dims>> result(count);
+    uint32_t state = seed;
+    for (auto &v : result) {
+        for (auto &x : v) {
+            state = state * 1664525u + 1013904223u;
+            x = static_cast<T>(static_cast<double>(state >> 8) / static_cast<double>(1u << 24) * 16.0 - 8.0);
+        }
+        if (v == mia::vector<T, Dims>{}) {
+            v[0] = static_cast<T>(1);
+        }
+    }
+    return result;
+}
+
+// elements/s, GB/s (`bytes_per_element` read + written) and time per element ("ns/op", printed with an SI prefix)
+inline void report(benchmark::State &state, const size_t elements, const size_t bytes_per_element) {
+    const auto items = static_cast<int64_t>(elements);
+    state.SetItemsProcessed(state.iterations() * items);
+    state.SetBytesProcessed(state.iterations() * items * static_cast<int64_t>(bytes_per_element));
+    state.counters["ns/op"] = benchmark::Counter(static_cast<double>(elements), benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+}  // namespace mia::bench
@@ -0,0 +1,87 @@
+#include "math/aabb.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../bench-utilities.hpp"
+
+// NOTE: one ray against many boxes, scalar slab tests against 4 and 8 wide packets
+
+namespace {
+
+using mia::bench::make_inputs;
+using mia::bench::report;
+
+using box = mia::aabb3<float>;
+using ray = mia::ray<float, 3>;
+
+auto make_boxes(const size_t count) -> std::vector<box> {
+    const auto corners = make_inputs<float, 3>(count, 1);
+    const auto sizes = make_inputs<float, 3>(count, 2);
+    std::vector<box> boxes(count);
+    for (size_t i = 0; i < count; ++i) {
+        boxes[i].expand(corners[i]).expand(corners[i] + sizes[i] * 0.1f);
+    }
+    return boxes;
+}
+
+auto make_rays(const size_t count) -> std::vector<ray> {
+    const auto origins = make_inputs<float, 3>(count, 3);
+    const auto directions = make_inputs<float, 3>(count, 4);
+    std::vector<ray> rays;
+    for (size_t i = 0; i < count; ++i) {
+        rays.emplace_back(origins[i], directions[i]);
+    }
+    return rays;
+}
+
+constexpr size_t ray_count = 64;
+
+void bm_scalar_slab(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto boxes = make_boxes(count);
+    const auto rays = make_rays(ray_count);
+    for (auto _ : state) {
+        uint32_t hits = 0;
+        for (const ray &r : rays) {
+            for (const box &b : boxes) {
+                hits += b.intersect(r).has_value() ? 1u : 0u;
+            }
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    report(state, count * ray_count, sizeof(box));
+}
+
+template <size_t Width>
+void bm_packet_slab(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto boxes = make_boxes(count);
+    const auto rays = make_rays(ray_count);
+    std::vector<mia::aabb_packet<float, 3, Width>> packets((count + Width - 1) / Width);
+    for (size_t i = 0; i < count; ++i) {
+        packets[i / Width].set(i % Width, boxes[i]);
+    }
+    for (auto _ : state) {
+        uint32_t hits = 0;
+        for (const ray &r : rays) {
+            for (const auto &packet : packets) {
+                hits += static_cast<uint32_t>(std::popcount(packet.intersect(r)));
+            }
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    report(state, count * ray_count, sizeof(box));
+}
+
+constexpr int64_t box_count = 1024;
+
+} // namespace
+
+BENCHMARK(bm_scalar_slab)->Arg(box_count);
+BENCHMARK(bm_packet_slab<4>)->Name("bm_packet_slab<4>")->Arg(box_count);
+BENCHMARK(bm_packet_slab<8>)->Name("bm_packet_slab<8>")->Arg(box_count);
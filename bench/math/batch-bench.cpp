@@ -0,0 +1,357 @@
+#include "math/batch-parallel.hpp"
+#include "math/batch-reduce.hpp"
+#include "math/batch.hpp"
+#include "math/matrix.hpp"
+#include "math/vector-soa.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../bench-utilities.hpp"
+
+// NOTE: throughput from cache resident (1K) to memory bound (100M) sizes
+// Each span kernel is paired with the per-object loop it replaces
+// The dispatched level is printed in the context header as mia_isa, MIA_ISA=scalar|sse4.1|avx2|avx512 forces one
+
+namespace {
+
+using mia::bench::make_inputs;
+using mia::bench::report;
+
+const bool isa_context = [] {
+    benchmark::AddCustomContext("mia_isa", std::string(mia::batch::isa_name(mia::batch::active_isa())));
+    return true;
+}();
+
+template <typename T, size_t Dims>
+struct inputs {
+    using vector_type = mia::vector<T, Dims>;
+    using compute_type = typename vector_type::compute_type;
+
+    explicit inputs(const benchmark::State &state)
+        : count(static_cast<size_t>(state.range(0))),
+          lhs(make_inputs<T, Dims>(count, 1)),
+          rhs(make_inputs<T, Dims>(count, 2)) {
+    }
+
+    size_t count;
+    std::vector<vector_type> lhs;
+    std::vector<vector_type> rhs;
+};
+
+// NOTE: DOT PRODUCT
+
+template <typename T, size_t Dims>
+void bm_batch_dot(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    std::vector<typename inputs<T, Dims>::compute_type> out(in.count);
+    for (auto _ : state) {
+        mia::batch::dot<T, Dims>(in.lhs, in.rhs, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, in.count, 2 * sizeof(mia::vector<T, Dims>) + sizeof(out[0]));
+}
+
+template <typename T, size_t Dims>
+void bm_loop_dot(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    inputs<T, Dims> in(state);
+    std::vector<typename V::compute_type> out(in.count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < in.count; ++i) {
+            out[i] = V::dot_product(in.lhs[i], in.rhs[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, in.count, 2 * sizeof(V) + sizeof(out[0]));
+}
+
+template <typename T, size_t Dims>
+void bm_soa_dot(benchmark::State &state) {
+    using SoA = mia::vector_soa<T, Dims>;
+    inputs<T, Dims> in(state);
+    const SoA lhs(std::span<const mia::vector<T, Dims>>(in.lhs));
+    const SoA rhs(std::span<const mia::vector<T, Dims>>(in.rhs));
+    in.lhs = {};
+    in.rhs = {};
+    std::vector<typename SoA::compute_type> out(in.count);
+    for (auto _ : state) {
+        SoA::dot_product(lhs, rhs, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, in.count, 2 * Dims * sizeof(T) + sizeof(out[0]));
+}
+
+// NOTE: DISTANCE
+
+template <typename T, size_t Dims>
+void bm_batch_distance_squared(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    std::vector<typename inputs<T, Dims>::compute_type> out(in.count);
+    for (auto _ : state) {
+        mia::batch::distance_squared<T, Dims>(in.lhs, in.rhs, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, in.count, 2 * sizeof(mia::vector<T, Dims>) + sizeof(out[0]));
+}
+
+// NOTE: NORMALIZE
+
+template <typename T, size_t Dims>
+void bm_batch_normalize(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    std::vector<mia::vector<T, Dims>> out(in.count);
+    for (auto _ : state) {
+        mia::batch::normalize<T, Dims>(in.lhs, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, in.count, 2 * sizeof(mia::vector<T, Dims>));
+}
+
+template <typename T, size_t Dims>
+void bm_loop_normalize(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    std::vector<mia::vector<T, Dims>> out(in.count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < in.count; ++i) {
+            out[i] = in.lhs[i].normalized();
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, in.count, 2 * sizeof(mia::vector<T, Dims>));
+}
+
+// NOTE: LERP
+
+template <typename T, size_t Dims>
+void bm_batch_lerp(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    std::vector<mia::vector<T, Dims>> out(in.count);
+    for (auto _ : state) {
+        mia::batch::lerp<T, Dims>(in.lhs, in.rhs, static_cast<typename inputs<T, Dims>::compute_type>(0.3), out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, in.count, 3 * sizeof(mia::vector<T, Dims>));
+}
+
+template <typename T, size_t Dims>
+void bm_soa_add(benchmark::State &state) {
+    using SoA = mia::vector_soa<T, Dims>;
+    inputs<T, Dims> in(state);
+    const SoA lhs(std::span<const mia::vector<T, Dims>>(in.lhs));
+    const SoA rhs(std::span<const mia::vector<T, Dims>>(in.rhs));
+    in.lhs = {};
+    in.rhs = {};
+    SoA out(in.count);
+    for (auto _ : state) {
+        SoA::add(lhs, rhs, out);
+        benchmark::DoNotOptimize(out.lane(0).data());
+        benchmark::ClobberMemory();
+    }
+    report(state, in.count, 3 * Dims * sizeof(T));
+}
+
+// NOTE: MATRIX TRANSFORM
+
+template <typename T, size_t Dims>
+auto bench_matrix() -> mia::matrix4<T> {
+    using M = mia::matrix4<T>;
+    return M::translation(mia::vector<T, 3>{1, 2, 3}) * M::rotation(mia::vector<T, 3>{0, 1, 1}, static_cast<T>(0.5));
+}
+
+template <typename T, size_t Dims>
+void bm_batch_transform(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    const auto m = bench_matrix<T, Dims>();
+    std::vector<mia::vector<T, Dims>> out(in.count);
+    for (auto _ : state) {
+        if constexpr (Dims == 3) {
+            mia::batch::transform_points<T>(m, in.lhs, out);
+        } else {
+            mia::batch::transform<T>(m, in.lhs, out);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, in.count, 2 * sizeof(mia::vector<T, Dims>));
+}
+
+template <typename T, size_t Dims>
+void bm_loop_transform(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    const auto m = bench_matrix<T, Dims>();
+    std::vector<mia::vector<T, Dims>> out(in.count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < in.count; ++i) {
+            if constexpr (Dims == 3) {
+                out[i] = m.transform_point(in.lhs[i]);
+            } else {
+                out[i] = m * in.lhs[i];
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, in.count, 2 * sizeof(mia::vector<T, Dims>));
+}
+
+// NOTE: REDUCTIONS & PARALLEL
+// On mia::default_thread_pool(), every hardware thread
+
+template <typename T, size_t Dims>
+void bm_batch_sum(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(mia::batch::sum<T, Dims>(in.lhs));
+    }
+    report(state, in.count, sizeof(mia::vector<T, Dims>));
+}
+
+// The centroid & bounding box loops the reductions replace
+template <typename T, size_t Dims>
+void bm_loop_sum(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    for (auto _ : state) {
+        mia::vector<T, Dims> sum{};
+        for (const auto &v : in.lhs) {
+            sum += v;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state, in.count, sizeof(mia::vector<T, Dims>));
+}
+
+template <typename T, size_t Dims>
+void bm_batch_pairwise_sum(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(mia::batch::pairwise_sum<T, Dims>(in.lhs));
+    }
+    report(state, in.count, sizeof(mia::vector<T, Dims>));
+}
+
+template <typename T, size_t Dims>
+void bm_batch_kahan_sum(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(mia::batch::kahan_sum<T, Dims>(in.lhs));
+    }
+    report(state, in.count, sizeof(mia::vector<T, Dims>));
+}
+
+template <typename T, size_t Dims>
+void bm_batch_bounds(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(mia::batch::bounds<T, Dims>(in.lhs));
+    }
+    report(state, in.count, sizeof(mia::vector<T, Dims>));
+}
+
+template <typename T, size_t Dims>
+void bm_loop_bounds(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(mia::aabb<T, Dims>::from_points(in.lhs));
+    }
+    report(state, in.count, sizeof(mia::vector<T, Dims>));
+}
+
+template <typename T, size_t Dims>
+void bm_batch_covariance(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(mia::batch::covariance<T, Dims>(in.lhs));
+    }
+    report(state, in.count, 2 * sizeof(mia::vector<T, Dims>));
+}
+
+template <typename T, size_t Dims>
+void bm_parallel_sum(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    auto &pool = mia::default_thread_pool();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(mia::batch::sum<T, Dims>(pool, in.lhs));
+    }
+    report(state, in.count, sizeof(mia::vector<T, Dims>));
+}
+
+template <typename T, size_t Dims>
+void bm_parallel_dot(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    std::vector<typename inputs<T, Dims>::compute_type> out(in.count);
+    auto &pool = mia::default_thread_pool();
+    for (auto _ : state) {
+        mia::batch::dot<T, Dims>(pool, in.lhs, in.rhs, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, in.count, 2 * sizeof(mia::vector<T, Dims>) + sizeof(out[0]));
+}
+
+template <typename T, size_t Dims>
+void bm_parallel_normalize(benchmark::State &state) {
+    inputs<T, Dims> in(state);
+    std::vector<mia::vector<T, Dims>> out(in.count);
+    auto &pool = mia::default_thread_pool();
+    for (auto _ : state) {
+        mia::batch::normalize<T, Dims>(pool, in.lhs, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, in.count, 2 * sizeof(mia::vector<T, Dims>));
+}
+
+} // namespace
+
+#define MIA_BATCH_BENCH(fn, T, Ds)                     \
+    BENCHMARK(fn<T, Ds>)                               \
+        ->Name(#fn "<" #T ", " #Ds ">")                \
+        ->RangeMultiplier(10)                          \
+        ->Range(1'000, MIA_BENCH_MAX_ELEMENTS)         \
+        ->Unit(benchmark::kMicrosecond)
+
+MIA_BATCH_BENCH(bm_batch_dot, float, 3);
+MIA_BATCH_BENCH(bm_batch_dot, float, 4);
+MIA_BATCH_BENCH(bm_loop_dot, float, 3);
+MIA_BATCH_BENCH(bm_soa_dot, float, 3);
+MIA_BATCH_BENCH(bm_batch_dot, double, 4);
+
+MIA_BATCH_BENCH(bm_batch_distance_squared, float, 3);
+MIA_BATCH_BENCH(bm_batch_distance_squared, int, 3);
+
+MIA_BATCH_BENCH(bm_batch_normalize, float, 3);
+MIA_BATCH_BENCH(bm_batch_normalize, float, 4);
+MIA_BATCH_BENCH(bm_loop_normalize, float, 3);
+
+MIA_BATCH_BENCH(bm_batch_lerp, float, 3);
+MIA_BATCH_BENCH(bm_soa_add, float, 3);
+
+MIA_BATCH_BENCH(bm_batch_transform, float, 3);
+MIA_BATCH_BENCH(bm_batch_transform, float, 4);
+MIA_BATCH_BENCH(bm_loop_transform, float, 3);
+MIA_BATCH_BENCH(bm_loop_transform, float, 4);
+
+MIA_BATCH_BENCH(bm_batch_sum, float, 3);
+MIA_BATCH_BENCH(bm_loop_sum, float, 3);
+MIA_BATCH_BENCH(bm_batch_pairwise_sum, float, 3);
+MIA_BATCH_BENCH(bm_batch_kahan_sum, float, 3);
+MIA_BATCH_BENCH(bm_batch_bounds, float, 3);
+MIA_BATCH_BENCH(bm_loop_bounds, float, 3);
+MIA_BATCH_BENCH(bm_batch_covariance, float, 3);
+MIA_BATCH_BENCH(bm_batch_covariance, float, 4);
+MIA_BATCH_BENCH(bm_parallel_sum, float, 3)->UseRealTime();
+MIA_BATCH_BENCH(bm_parallel_dot, float, 3)->UseRealTime();
+MIA_BATCH_BENCH(bm_parallel_normalize, float, 3)->UseRealTime();
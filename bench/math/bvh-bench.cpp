@@ -0,0 +1,127 @@
+#include "math/bvh.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../bench-utilities.hpp"
+
+// NOTE: bvh build (serial, parallel) and queries against the brute force loops they replace
+
+namespace {
+
+using mia::bench::make_inputs;
+using mia::bench::report;
+
+using box = mia::aabb3<float>;
+using ray = mia::ray<float, 3>;
+using tree = mia::bvh<float, 3>;
+
+auto make_boxes(const size_t count) -> std::vector<box> {
+    const auto corners = make_inputs<float, 3>(count, 1);
+    const auto sizes = make_inputs<float, 3>(count, 2);
+    std::vector<box> boxes(count);
+    for (size_t i = 0; i < count; ++i) {
+        boxes[i].expand(corners[i]).expand(corners[i] + sizes[i] * 0.02f);
+    }
+    return boxes;
+}
+
+auto make_rays(const size_t count) -> std::vector<ray> {
+    const auto origins = make_inputs<float, 3>(count, 3);
+    const auto directions = make_inputs<float, 3>(count, 4);
+    std::vector<ray> rays;
+    for (size_t i = 0; i < count; ++i) {
+        rays.emplace_back(origins[i], directions[i]);
+    }
+    return rays;
+}
+
+constexpr size_t query_count = 256;
+
+// :: Build
+void bm_bvh_build(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto boxes = make_boxes(count);
+    const mia::bvh_options options{.threads = static_cast<size_t>(state.range(1))};
+    tree t;
+    for (auto _ : state) {
+        t.build(boxes, options);
+        benchmark::DoNotOptimize(t.nodes().data());
+    }
+    report(state, count, sizeof(box));
+}
+
+// :: Ray cast
+void bm_brute_force_raycast(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto boxes = make_boxes(count);
+    const auto rays = make_rays(query_count);
+    for (auto _ : state) {
+        for (const ray &r : rays) {
+            float closest = std::numeric_limits<float>::infinity();
+            for (const box &b : boxes) {
+                closest = std::min(closest, b.intersect(r).value_or(closest));
+            }
+            benchmark::DoNotOptimize(closest);
+        }
+    }
+    report(state, query_count, sizeof(ray));
+}
+
+void bm_bvh_raycast(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto boxes = make_boxes(count);
+    const auto rays = make_rays(query_count);
+    const tree t{boxes, {.wide = state.range(1) != 0}};
+    for (auto _ : state) {
+        for (const ray &r : rays) {
+            benchmark::DoNotOptimize(t.raycast(r));
+        }
+    }
+    report(state, query_count, sizeof(ray));
+}
+
+// :: Nearest neighbour
+void bm_brute_force_nearest(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto points = make_inputs<float, 3>(count, 5);
+    const auto queries = make_inputs<float, 3>(query_count, 6);
+    for (auto _ : state) {
+        for (const auto &q : queries) {
+            float closest = std::numeric_limits<float>::infinity();
+            for (const auto &p : points) {
+                closest = std::min(closest, mia::vector<float, 3>::distance_squared(p, q));
+            }
+            benchmark::DoNotOptimize(closest);
+        }
+    }
+    report(state, query_count, sizeof(float) * 3);
+}
+
+void bm_bvh_nearest(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto points = make_inputs<float, 3>(count, 5);
+    const auto queries = make_inputs<float, 3>(query_count, 6);
+    const tree t = tree::from_points(points);
+    for (auto _ : state) {
+        for (const auto &q : queries) {
+            benchmark::DoNotOptimize(t.nearest(q));
+        }
+    }
+    report(state, query_count, sizeof(float) * 3);
+}
+
+constexpr int64_t primitive_count = 100'000;
+
+} // namespace
+
+BENCHMARK(bm_bvh_build)->ArgNames({"n", "threads"})->Args({primitive_count, 1})->Args({primitive_count, 0})->UseRealTime();
+BENCHMARK(bm_brute_force_raycast)->Arg(primitive_count);
+BENCHMARK(bm_bvh_raycast)->ArgNames({"n", "wide"})->Args({primitive_count, 0})->Args({primitive_count, 1});
+BENCHMARK(bm_brute_force_nearest)->Arg(primitive_count);
+BENCHMARK(bm_bvh_nearest)->Arg(primitive_count);
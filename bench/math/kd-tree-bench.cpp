@@ -0,0 +1,95 @@
+#include "math/kd-tree.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../bench-utilities.hpp"
+
+// NOTE: kd_tree build & kNN against the brute force distance_squared loop, single queries & parallel batches
+
+namespace {
+
+using mia::bench::make_inputs;
+using mia::bench::report;
+
+using point = mia::vector<float, 3>;
+using tree = mia::kd_tree<float, 3>;
+
+constexpr size_t query_count = 1024;
+constexpr size_t k = 8;
+
+void bm_kd_tree_build(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto points = make_inputs<float, 3>(count, 1);
+    const mia::kd_tree_options options{.threads = static_cast<size_t>(state.range(1))};
+    for (auto _ : state) {
+        const tree t{points, options};
+        benchmark::DoNotOptimize(t.points().data());
+    }
+    report(state, count, sizeof(point));
+}
+
+// k smallest distances kept in a sorted array, the loop the tree replaces
+void bm_brute_force_knn(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto points = make_inputs<float, 3>(count, 1);
+    const auto queries = make_inputs<float, 3>(query_count / 16, 2);
+    for (auto _ : state) {
+        for (const point &q : queries) {
+            std::array<float, k> best;
+            best.fill(std::numeric_limits<float>::infinity());
+            for (const point &p : points) {
+                const float d = point::distance_squared(q, p);
+                if (d < best.back()) {
+                    best.back() = d;
+                    std::sort(best.begin(), best.end());
+                }
+            }
+            benchmark::DoNotOptimize(best);
+        }
+    }
+    report(state, queries.size(), sizeof(point));
+}
+
+void bm_kd_tree_knn(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto points = make_inputs<float, 3>(count, 1);
+    const auto queries = make_inputs<float, 3>(query_count, 2);
+    const tree t{points};
+    std::array<tree::neighbour, k> out;
+    for (auto _ : state) {
+        for (const point &q : queries) {
+            benchmark::DoNotOptimize(t.k_nearest(q, out));
+        }
+    }
+    report(state, query_count, sizeof(point));
+}
+
+// Whole batch per iteration, on every core (threads = 0) or one
+void bm_kd_tree_knn_batch(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto points = make_inputs<float, 3>(count, 1);
+    const auto queries = make_inputs<float, 3>(query_count * 16, 2);
+    const tree t{points, {.threads = static_cast<size_t>(state.range(1))}};
+    std::vector<tree::neighbour> out(queries.size() * k);
+    for (auto _ : state) {
+        t.k_nearest(queries, k, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    report(state, queries.size(), sizeof(point));
+}
+
+constexpr int64_t point_count = std::min<int64_t>(1'000'000, MIA_BENCH_MAX_ELEMENTS);
+
+} // namespace
+
+BENCHMARK(bm_kd_tree_build)->ArgNames({"n", "threads"})->Args({point_count, 1})->Args({point_count, 0})->UseRealTime();
+BENCHMARK(bm_brute_force_knn)->Arg(point_count);
+BENCHMARK(bm_kd_tree_knn)->Arg(point_count);
+BENCHMARK(bm_kd_tree_knn_batch)->ArgNames({"n", "threads"})->Args({point_count, 1})->Args({point_count, 0})->UseRealTime();
@@ -0,0 +1,102 @@
+#include "math/packed.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../bench-utilities.hpp"
+
+// NOTE: batch encode / decode of vector<float, 3> to half, snorm16 & octahedral normals, per element loops as baseline
+// Bytes are those of the packed side, the figure a cache or a payload sees
+
+namespace {
+
+using mia::bench::make_inputs;
+using mia::bench::report;
+
+using point = mia::vector<float, 3>;
+
+auto make_normals(const size_t count) -> std::vector<point> {
+    auto normals = make_inputs<float, 3>(count, 1);
+    for (point &n : normals) {
+        n = n.normalized();
+    }
+    return normals;
+}
+
+template <typename Packed>
+void bm_encode_loop(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto normals = make_normals(count);
+    std::vector<Packed> packed(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            packed[i] = Packed::encode(normals[i]);
+        }
+        benchmark::DoNotOptimize(packed.data());
+    }
+    report(state, count, sizeof(Packed));
+}
+
+template <typename Packed, typename Arg>
+void bm_encode_batch(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto normals = make_normals(count);
+    std::vector<Packed> packed(count);
+    for (auto _ : state) {
+        mia::batch::encode<Arg>(std::span<const point>{normals}, std::span<Packed>{packed});
+        benchmark::DoNotOptimize(packed.data());
+    }
+    report(state, count, sizeof(Packed));
+}
+
+template <typename Packed>
+void bm_decode_loop(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto normals = make_normals(count);
+    std::vector<Packed> packed(count);
+    std::transform(normals.begin(), normals.end(), packed.begin(), [](const point &n) { return Packed::encode(n); });
+    std::vector<point> out(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = packed[i].decode();
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    report(state, count, sizeof(Packed));
+}
+
+template <typename Packed, typename Arg>
+void bm_decode_batch(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto normals = make_normals(count);
+    std::vector<Packed> packed(count);
+    std::transform(normals.begin(), normals.end(), packed.begin(), [](const point &n) { return Packed::encode(n); });
+    std::vector<point> out(count);
+    for (auto _ : state) {
+        mia::batch::decode<Arg>(std::span<const Packed>{packed}, std::span<point>{out});
+        benchmark::DoNotOptimize(out.data());
+    }
+    report(state, count, sizeof(Packed));
+}
+
+constexpr int64_t element_count = std::min<int64_t>(1 << 20, MIA_BENCH_MAX_ELEMENTS);
+
+} // namespace
+
+BENCHMARK(bm_encode_loop<mia::half3>)->Arg(element_count);
+BENCHMARK(bm_encode_batch<mia::half3, mia::half_format>)->Arg(element_count);
+BENCHMARK(bm_decode_loop<mia::half3>)->Arg(element_count);
+BENCHMARK(bm_decode_batch<mia::half3, mia::half_format>)->Arg(element_count);
+BENCHMARK(bm_encode_loop<mia::snorm16x3>)->Arg(element_count);
+BENCHMARK(bm_encode_batch<mia::snorm16x3, mia::snorm_format<int16_t>>)->Arg(element_count);
+BENCHMARK(bm_decode_loop<mia::snorm16x3>)->Arg(element_count);
+BENCHMARK(bm_decode_batch<mia::snorm16x3, mia::snorm_format<int16_t>>)->Arg(element_count);
+BENCHMARK(bm_encode_loop<mia::oct16>)->Arg(element_count);
+BENCHMARK(bm_encode_batch<mia::oct16, int16_t>)->Arg(element_count);
+BENCHMARK(bm_decode_loop<mia::oct16>)->Arg(element_count);
+BENCHMARK(bm_decode_batch<mia::oct16, int16_t>)->Arg(element_count);
@@ -0,0 +1,111 @@
+#include "math/simd.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../bench-utilities.hpp"
+
+// NOTE: dot product & saxpy over float arrays, one scalar loop against simd<float, 4> and native_simd<float>
+// Cache resident sizes, so the figures are those of the arithmetic rather than of memory
+
+namespace {
+
+using mia::bench::report;
+
+auto make_floats(const size_t count, const uint32_t seed) -> std::vector<float> {
+    std::vector<float> result(count);
+    uint32_t state = seed;
+    for (float &x : result) {
+        state = state * 1664525u + 1013904223u;
+        x = static_cast<float>(state >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+    }
+    return result;
+}
+
+void bm_dot_loop(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto lhs = make_floats(count, 1);
+    const auto rhs = make_floats(count, 2);
+    for (auto _ : state) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            sum += lhs[i] * rhs[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state, count, 2 * sizeof(float));
+}
+
+// Four accumulators hide the latency of the adds
+template <size_t Width>
+void bm_dot_simd(benchmark::State &state) {
+    using pack = mia::simd<float, Width>;
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto lhs = make_floats(count, 1);
+    const auto rhs = make_floats(count, 2);
+    for (auto _ : state) {
+        pack acc[4];
+        size_t i = 0;
+        for (; i + 4 * Width <= count; i += 4 * Width) {
+            for (size_t k = 0; k < 4; ++k) {
+                acc[k] = fma(pack::loadu(lhs.data() + i + k * Width), pack::loadu(rhs.data() + i + k * Width), acc[k]);
+            }
+        }
+        float sum = reduce_add((acc[0] + acc[1]) + (acc[2] + acc[3]));
+        for (; i < count; ++i) {
+            sum += lhs[i] * rhs[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state, count, 2 * sizeof(float));
+}
+
+void bm_saxpy_loop(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto x = make_floats(count, 1);
+    auto y = make_floats(count, 2);
+    const float a = 0.5f;
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            y[i] = a * x[i] + y[i];
+        }
+        benchmark::DoNotOptimize(y.data());
+    }
+    report(state, count, 3 * sizeof(float));
+}
+
+template <size_t Width>
+void bm_saxpy_simd(benchmark::State &state) {
+    using pack = mia::simd<float, Width>;
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto x = make_floats(count, 1);
+    auto y = make_floats(count, 2);
+    const pack a{0.5f};
+    for (auto _ : state) {
+        size_t i = 0;
+        for (; i + Width <= count; i += Width) {
+            fma(a, pack::loadu(x.data() + i), pack::loadu(y.data() + i)).storeu(y.data() + i);
+        }
+        for (; i < count; ++i) {
+            y[i] = 0.5f * x[i] + y[i];
+        }
+        benchmark::DoNotOptimize(y.data());
+    }
+    report(state, count, 3 * sizeof(float));
+}
+
+constexpr int64_t element_count = std::min<int64_t>(1 << 14, MIA_BENCH_MAX_ELEMENTS);
+constexpr size_t native_width = mia::native_simd<float>::width;
+
+} // namespace
+
+BENCHMARK(bm_dot_loop)->Arg(element_count);
+BENCHMARK(bm_dot_simd<4>)->Arg(element_count);
+BENCHMARK(bm_dot_simd<native_width>)->Arg(element_count);
+BENCHMARK(bm_saxpy_loop)->Arg(element_count);
+BENCHMARK(bm_saxpy_simd<4>)->Arg(element_count);
+BENCHMARK(bm_saxpy_simd<native_width>)->Arg(element_count);
@@ -0,0 +1,71 @@
+#include "math/spatial-hash.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../bench-utilities.hpp"
+
+// NOTE: spatial_hash rebuild (serial, parallel) and the pair broad phase against the O(n^2) pair loop
+
+namespace {
+
+using mia::bench::make_inputs;
+using mia::bench::report;
+
+using point = mia::vector<float, 2>;
+using grid = mia::spatial_hash<float, 2>;
+
+// make_inputs spans [-8, 8), about 10 neighbours per particle within this radius
+constexpr float radius = 0.1f;
+
+void bm_brute_force_pairs(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto points = make_inputs<float, 2>(count, 1);
+    for (auto _ : state) {
+        size_t pairs = 0;
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = i + 1; j < count; ++j) {
+                pairs += point::distance_squared(points[i], points[j]) <= radius * radius ? size_t{1} : size_t{0};
+            }
+        }
+        benchmark::DoNotOptimize(pairs);
+    }
+    report(state, count, sizeof(point));
+}
+
+void bm_spatial_hash_pairs(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto points = make_inputs<float, 2>(count, 1);
+    grid g{radius};
+    for (auto _ : state) {
+        g.rebuild(points);
+        size_t pairs = 0;
+        g.for_each_pair(radius, [&](uint32_t, uint32_t, float) { ++pairs; });
+        benchmark::DoNotOptimize(pairs);
+    }
+    report(state, count, sizeof(point));
+}
+
+void bm_spatial_hash_rebuild(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto points = make_inputs<float, 2>(count, 1);
+    grid g{radius, {.threads = static_cast<size_t>(state.range(1))}};
+    for (auto _ : state) {
+        g.rebuild(points);
+        benchmark::DoNotOptimize(g.indices().data());
+    }
+    report(state, count, sizeof(point));
+}
+
+constexpr int64_t particle_count = 20'000;
+constexpr int64_t large_count = std::min<int64_t>(4'000'000, MIA_BENCH_MAX_ELEMENTS);
+
+} // namespace
+
+BENCHMARK(bm_brute_force_pairs)->Arg(particle_count);
+BENCHMARK(bm_spatial_hash_pairs)->Arg(particle_count);
+BENCHMARK(bm_spatial_hash_rebuild)->ArgNames({"n", "threads"})->Args({large_count, 1})->Args({large_count, 0})->UseRealTime();
@@ -0,0 +1,259 @@
+#include "math/matrix.hpp"
+#include "math/vector.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../bench-utilities.hpp"
+
+// NOTE: a per-frame pass over `count` vectors, run once with mia-lib_bench and once with mia-lib_bench_simd
+
+namespace {
+
+using mia::bench::make_inputs;
+using mia::bench::report;
+
+// out[i] = op(lhs[i], rhs[i])
+template <typename T, size_t Dims, typename Op>
+void run_binary(benchmark::State &state, Op op) {
+    using V = mia::vector<T, Dims>;
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto lhs = make_inputs<T, Dims>(count, 1);
+    const auto rhs = make_inputs<T, Dims>(count, 2);
+    std::vector<V> out(count);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = op(lhs[i], rhs[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, count, 3 * sizeof(V));
+}
+
+// acc += op(lhs[i], rhs[i]) for operations returning a scalar
+template <typename T, size_t Dims, typename Op>
+void run_reduce(benchmark::State &state, Op op) {
+    using V = mia::vector<T, Dims>;
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto lhs = make_inputs<T, Dims>(count, 1);
+    const auto rhs = make_inputs<T, Dims>(count, 2);
+
+    for (auto _ : state) {
+        decltype(op(lhs[0], rhs[0])) acc{};
+        for (size_t i = 0; i < count; ++i) {
+            acc += op(lhs[i], rhs[i]);
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    report(state, count, 2 * sizeof(V));
+}
+
+// NOTE: ARITHMETIC
+
+template <typename T, size_t Dims>
+void bm_add(benchmark::State &state) {
+    run_binary<T, Dims>(state, [](const auto &a, const auto &b) { return a + b; });
+}
+
+template <typename T, size_t Dims>
+void bm_sub(benchmark::State &state) {
+    run_binary<T, Dims>(state, [](const auto &a, const auto &b) { return a - b; });
+}
+
+template <typename T, size_t Dims>
+void bm_scale(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    run_binary<T, Dims>(state, [](const auto &a, const auto &) { return a * static_cast<typename V::compute_type>(3); });
+}
+
+template <typename T, size_t Dims>
+void bm_divide(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    run_binary<T, Dims>(state, [](const auto &a, const auto &) { return a / static_cast<typename V::compute_type>(3); });
+}
+
+// a + b * k - a / k, evaluated in one pass on assignment
+template <typename T, size_t Dims>
+void bm_fused_expression(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    using K = typename V::compute_type;
+    run_binary<T, Dims>(state, [](const auto &a, const auto &b) { return V(a + b * K(3) - a / K(2)); });
+}
+
+template <typename T, size_t Dims>
+void bm_hadamard_product(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    run_binary<T, Dims>(state, [](const auto &a, const auto &b) { return V::hadamard_product(a, b); });
+}
+
+template <typename T, size_t Dims>
+void bm_cross_product(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    run_binary<T, Dims>(state, [](const auto &a, const auto &b) { return V::cross_product(a, b); });
+}
+
+template <typename T, size_t Dims>
+void bm_min(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    run_binary<T, Dims>(state, [](const auto &a, const auto &b) { return V::min(a, b); });
+}
+
+template <typename T, size_t Dims>
+void bm_max(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    run_binary<T, Dims>(state, [](const auto &a, const auto &b) { return V::max(a, b); });
+}
+
+template <typename T, size_t Dims>
+void bm_lerp(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    run_binary<T, Dims>(state, [](const auto &a, const auto &b) { return V::lerp(a, b, static_cast<typename V::compute_type>(0.3)); });
+}
+
+// NOTE: SCALAR RESULTS
+
+template <typename T, size_t Dims>
+void bm_dot_product(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    run_reduce<T, Dims>(state, [](const auto &a, const auto &b) { return V::dot_product(a, b); });
+}
+
+template <typename T, size_t Dims>
+void bm_equal(benchmark::State &state) {
+    run_reduce<T, Dims>(state, [](const auto &a, const auto &b) { return static_cast<int>(a == b); });
+}
+
+template <typename T, size_t Dims>
+void bm_magnitude_squared(benchmark::State &state) {
+    run_reduce<T, Dims>(state, [](const auto &a, const auto &) { return a.magnitude_squared(); });
+}
+
+template <typename T, size_t Dims>
+void bm_distance_squared(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    run_reduce<T, Dims>(state, [](const auto &a, const auto &b) { return V::distance_squared(a, b); });
+}
+
+// NOTE: FLOATING POINT ONLY
+
+template <typename T, size_t Dims>
+void bm_magnitude(benchmark::State &state) {
+    run_reduce<T, Dims>(state, [](const auto &a, const auto &) { return a.magnitude(); });
+}
+
+template <typename T, size_t Dims>
+void bm_distance(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    run_reduce<T, Dims>(state, [](const auto &a, const auto &b) { return V::distance(a, b); });
+}
+
+template <typename T, size_t Dims>
+void bm_angle(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    run_reduce<T, Dims>(state, [](const auto &a, const auto &b) { return V::angle(a, b); });
+}
+
+template <typename T, size_t Dims>
+void bm_normalized(benchmark::State &state) {
+    run_binary<T, Dims>(state, [](const auto &a, const auto &) { return a.normalized(); });
+}
+
+// :: precision::fast counterparts
+template <typename T, size_t Dims>
+void bm_fast_magnitude(benchmark::State &state) {
+    run_reduce<T, Dims>(state, [](const auto &a, const auto &) { return a.template magnitude<mia::precision::fast>(); });
+}
+
+template <typename T, size_t Dims>
+void bm_fast_angle(benchmark::State &state) {
+    using V = mia::vector<T, Dims>;
+    run_reduce<T, Dims>(state, [](const auto &a, const auto &b) { return V::template angle<mia::precision::fast>(a, b); });
+}
+
+template <typename T, size_t Dims>
+void bm_fast_normalized(benchmark::State &state) {
+    run_binary<T, Dims>(state, [](const auto &a, const auto &) { return a.template normalized<mia::precision::fast>(); });
+}
+
+// NOTE: MATRIX
+
+template <typename T>
+void bm_matrix_multiply(benchmark::State &state) {
+    using M = mia::matrix4<T>;
+    const auto count = static_cast<size_t>(state.range(0));
+    std::vector<M> lhs(count, M::rotation(mia::vector<T, 3>{1, 2, 3}, static_cast<T>(0.4)));
+    std::vector<M> rhs(count, M::translation(mia::vector<T, 3>{1, 2, 3}));
+    std::vector<M> out(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = lhs[i] * rhs[i];
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, count, 3 * sizeof(M));
+}
+
+template <typename T>
+void bm_matrix_inverse(benchmark::State &state) {
+    using M = mia::matrix4<T>;
+    const auto count = static_cast<size_t>(state.range(0));
+    std::vector<M> in(count, M::rotation(mia::vector<T, 3>{1, 2, 3}, static_cast<T>(0.4)) * M::translation(mia::vector<T, 3>{1, 2, 3}));
+    std::vector<M> out(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = in[i].inverse().value_or(M{});
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, count, 2 * sizeof(M));
+}
+
+constexpr int64_t frame_size = 4096;
+
+} // namespace
+
+// Same type set as test/math/vector-test.cpp, plus float4 for the SIMD layout
+#define MIA_VECTOR_BENCH_FLOATING(fn)                                 \
+    BENCHMARK(fn<float, 2>)->Name(#fn "<float, 2>")->Arg(frame_size); \
+    BENCHMARK(fn<float, 3>)->Name(#fn "<float, 3>")->Arg(frame_size); \
+    BENCHMARK(fn<float, 4>)->Name(#fn "<float, 4>")->Arg(frame_size); \
+    BENCHMARK(fn<double, 4>)->Name(#fn "<double, 4>")->Arg(frame_size)
+#define MIA_VECTOR_BENCH(fn)         \
+    MIA_VECTOR_BENCH_FLOATING(fn);   \
+    BENCHMARK(fn<int, 3>)->Name(#fn "<int, 3>")->Arg(frame_size)
+
+MIA_VECTOR_BENCH(bm_add);
+MIA_VECTOR_BENCH(bm_sub);
+MIA_VECTOR_BENCH(bm_scale);
+MIA_VECTOR_BENCH(bm_divide);
+MIA_VECTOR_BENCH(bm_fused_expression);
+MIA_VECTOR_BENCH(bm_hadamard_product);
+MIA_VECTOR_BENCH(bm_min);
+MIA_VECTOR_BENCH(bm_max);
+MIA_VECTOR_BENCH(bm_lerp);
+MIA_VECTOR_BENCH(bm_dot_product);
+MIA_VECTOR_BENCH(bm_equal);
+MIA_VECTOR_BENCH(bm_magnitude_squared);
+MIA_VECTOR_BENCH(bm_distance_squared);
+
+BENCHMARK(bm_cross_product<float, 3>)->Name("bm_cross_product<float, 3>")->Arg(frame_size);
+BENCHMARK(bm_cross_product<int, 3>)->Name("bm_cross_product<int, 3>")->Arg(frame_size);
+
+MIA_VECTOR_BENCH_FLOATING(bm_magnitude);
+MIA_VECTOR_BENCH_FLOATING(bm_distance);
+MIA_VECTOR_BENCH_FLOATING(bm_angle);
+MIA_VECTOR_BENCH_FLOATING(bm_normalized);
+MIA_VECTOR_BENCH_FLOATING(bm_fast_magnitude);
+MIA_VECTOR_BENCH_FLOATING(bm_fast_angle);
+MIA_VECTOR_BENCH_FLOATING(bm_fast_normalized);
+
+BENCHMARK(bm_matrix_multiply<float>)->Name("bm_matrix_multiply<float, 4, 4>")->Arg(frame_size);
+BENCHMARK(bm_matrix_multiply<double>)->Name("bm_matrix_multiply<double, 4, 4>")->Arg(frame_size);
+BENCHMARK(bm_matrix_inverse<float>)->Name("bm_matrix_inverse<float, 4, 4>")->Arg(frame_size);
@@ -0,0 +1,73 @@
+#include "math/vector-io.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include "../bench-utilities.hpp"
+
+// NOTE: reloading a saved vector file: copying load() against mapped_array, opening only or reading every vector
+// The file stays in the page cache between iterations, so the mapped figures are the cost of the page faults
+
+namespace {
+
+using mia::bench::make_inputs;
+using mia::bench::report;
+
+using point = mia::vector<float, 3>;
+
+auto bench_file(const size_t count) -> std::filesystem::path {
+    auto path = std::filesystem::temp_directory_path() / ("mia-vector-io-bench-" + std::to_string(count) + ".vec");
+    if (!std::filesystem::exists(path)) {
+        const auto points = make_inputs<float, 3>(count, 1);
+        mia::save<float, 3>(path, points);
+    }
+    return path;
+}
+
+void bm_load(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto path = bench_file(count);
+    for (auto _ : state) {
+        const auto points = mia::load<float, 3>(path);
+        benchmark::DoNotOptimize(points.data());
+    }
+    report(state, count, sizeof(point));
+}
+
+void bm_map_open(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto path = bench_file(count);
+    for (auto _ : state) {
+        const mia::mapped_array<point> points{path};
+        benchmark::DoNotOptimize(points.data());
+    }
+    report(state, count, sizeof(point));
+}
+
+void bm_map_and_read(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto path = bench_file(count);
+    for (auto _ : state) {
+        const mia::mapped_array<point> points{path};
+        points.advise(mia::access_pattern::sequential);
+        point sum{};
+        for (const point &p : points) {
+            sum += p;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    report(state, count, sizeof(point));
+}
+
+constexpr int64_t point_count = std::min<int64_t>(4'000'000, MIA_BENCH_MAX_ELEMENTS);
+
+} // namespace
+
+BENCHMARK(bm_load)->Arg(point_count);
+BENCHMARK(bm_map_open)->Arg(point_count);
+BENCHMARK(bm_map_and_read)->Arg(point_count);
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+
+#include "arena.hpp"
+
+namespace mia {
+
+// std::pmr adapter, deallocation is a no-op: memory comes back on arena::reset() or destruction
+class arena_resource : public std::pmr::memory_resource {
+  public:
+    explicit arena_resource(arena& a) noexcept
+        : arena_(&a) {
+    }
+
+    [[nodiscard]] inline auto get_arena() const noexcept -> arena& {
+        return *arena_;
+    }
+
+  protected:
+    auto do_allocate(size_t bytes, size_t alignment) -> void* override {
+        return arena_->alloc_bytes(bytes, alignment);
+    }
+
+    void do_deallocate([[maybe_unused]] void* p, [[maybe_unused]] size_t bytes, [[maybe_unused]] size_t alignment) override {
+    }
+
+    [[nodiscard]] auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override {
+        const auto* other_resource = dynamic_cast<const arena_resource*>(&other);
+        return other_resource != nullptr && other_resource->arena_ == arena_;
+    }
+
+  private:
+    arena* arena_;
+};
+
+// Allocator for standard containers without the pmr virtual call
+template <typename T>
+class arena_allocator {
+  public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+
+    explicit arena_allocator(arena& a) noexcept
+        : arena_(&a) {
+    }
+    template <typename U>
+    arena_allocator(const arena_allocator<U>& other) noexcept
+        : arena_(&other.get_arena()) {
+    }
+
+    [[nodiscard]] inline auto allocate(size_type n) -> T* {
+        return arena_->alloc_array_uninitialized<T>(n);
+    }
+    inline void deallocate([[maybe_unused]] T* p, [[maybe_unused]] size_type n) noexcept {
+    }
+
+    [[nodiscard]] inline auto get_arena() const noexcept -> arena& {
+        return *arena_;
+    }
+
+    template <typename U>
+    auto operator==(const arena_allocator<U>& other) const noexcept -> bool {
+        return arena_ == &other.get_arena();
+    }
+
+  private:
+    arena* arena_;
+};
+
+}  // namespace mia
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "arena.hpp"
+
+#ifndef ARENA_CACHE_LINE
+#define ARENA_CACHE_LINE 64
+#endif  // !ARENA_CACHE_LINE
+
+namespace mia {
+
+// NOTE: THREAD-LOCAL ARENA
+
+// One arena per thread, created on first use and freed when the thread exits
+// Nothing is ever shared, so no locking. Pair with arena_scope for per-task scratch memory
+inline auto thread_arena() -> arena& {
+    thread_local arena local;
+    return local;
+}
+
+// NOTE: PER-CORE POOL
+
+class arena_pool;
+
+// Arena borrowed from an arena_pool, reset and handed back on destruction
+class arena_lease {
+  public:
+    arena_lease() noexcept = default;
+    ~arena_lease() { release(); }
+
+    arena_lease(const arena_lease& other) = delete;
+    auto operator=(const arena_lease& other) -> arena_lease& = delete;
+
+    arena_lease(arena_lease&& other) noexcept
+        : pool_(std::exchange(other.pool_, nullptr)), arena_(std::exchange(other.arena_, nullptr)), shard_(other.shard_) {
+    }
+    auto operator=(arena_lease&& other) noexcept -> arena_lease& {
+        if (this != &other) {
+            release();
+            pool_ = std::exchange(other.pool_, nullptr);
+            arena_ = std::exchange(other.arena_, nullptr);
+            shard_ = other.shard_;
+        }
+        return *this;
+    }
+
+    [[nodiscard]] inline auto get_arena() const noexcept -> arena& { return *arena_; }
+    inline auto operator*() const noexcept -> arena& { return *arena_; }
+    inline auto operator->() const noexcept -> arena* { return arena_; }
+    explicit operator bool() const noexcept { return arena_ != nullptr; }
+
+    // Shard the arena belongs to, it always goes back there
+    [[nodiscard]] inline auto shard() const noexcept -> size_t { return shard_; }
+
+    // Give the arena back early
+    inline void release() noexcept;
+
+  private:
+    friend class arena_pool;
+
+    arena_lease(arena_pool* pool, arena* a, size_t shard) noexcept
+        : pool_(pool), arena_(a), shard_(shard) {
+    }
+
+    arena_pool* pool_ = nullptr;
+    arena* arena_ = nullptr;
+    size_t shard_ = 0;
+};
+
+// Arenas grouped by core: a lease takes from the caller's shard first, so on a steady workload
+// every lease/return is one uncontended lock and no malloc
+class arena_pool {
+  public:
+    struct shard_stats {
+        size_t leases;      // lease() calls made from this shard's core
+        size_t created;     // Arenas created because the shard was empty
+        size_t stolen;      // Arenas taken from this shard by another core
+        size_t arenas;      // Arenas owned
+        size_t high_water;  // Largest arena::high_water() seen on return
+        size_t capacity;    // Payload bytes held by idle arenas
+    };
+
+    // `shard_count` 0 means one per hardware thread, `arena_capacity` 0 means ARENA_DEFAULT_CAPACITY
+    explicit arena_pool(size_t shard_count = 0, size_t arena_capacity = 0)
+        : shards_(shard_count != 0 ? shard_count : std::max(1u, std::thread::hardware_concurrency())),
+          arena_capacity_(arena_capacity) {
+    }
+
+    arena_pool(const arena_pool& other) = delete;
+    auto operator=(const arena_pool& other) -> arena_pool& = delete;
+
+    // Every lease must be returned before the pool is destroyed
+    ~arena_pool() = default;
+
+    // NOTE: LEASING
+
+    [[nodiscard]] auto lease() -> arena_lease {
+        const size_t home = current_shard();
+
+        // :: Own shard
+        {
+            shard& s = shards_[home];
+            std::lock_guard lock(s.mutex);
+            ++s.leases;
+            if (!s.idle.empty()) {
+                arena* a = s.idle.back();
+                s.idle.pop_back();
+                return {this, a, home};
+            }
+        }
+
+        // :: Steal from a neighbour without waiting on it
+        for (size_t i = 1; i < shards_.size(); ++i) {
+            const size_t victim = (home + i) % shards_.size();
+            shard& s = shards_[victim];
+            std::unique_lock lock(s.mutex, std::try_to_lock);
+            if (lock.owns_lock() && !s.idle.empty()) {
+                arena* a = s.idle.back();
+                s.idle.pop_back();
+                ++s.stolen;
+                return {this, a, victim};
+            }
+        }
+
+        // :: New arena, owned by the caller's shard so its blocks stay on that core's memory
+        auto fresh = std::make_unique<arena>(arena_capacity_);
+        arena* a = fresh.get();
+        shard& s = shards_[home];
+        std::lock_guard lock(s.mutex);
+        s.owned.push_back(std::move(fresh));
+        s.idle.reserve(s.owned.size());
+        ++s.created;
+        return {this, a, home};
+    }
+
+    // NOTE: STATISTICS
+
+    [[nodiscard]] inline auto shard_count() const noexcept -> size_t { return shards_.size(); }
+
+    [[nodiscard]] auto stats(size_t shard_index) const -> shard_stats {
+        const shard& s = shards_[shard_index];
+        std::lock_guard lock(s.mutex);
+        size_t capacity = 0;
+        for (const arena* a : s.idle) {
+            capacity += a->capacity();
+        }
+        return {s.leases, s.created, s.stolen, s.owned.size(), s.high_water, capacity};
+    }
+
+    // Sum over shards, high_water is the largest of any shard
+    [[nodiscard]] auto stats() const -> shard_stats {
+        shard_stats total{};
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            const shard_stats s = stats(i);
+            total.leases += s.leases;
+            total.created += s.created;
+            total.stolen += s.stolen;
+            total.arenas += s.arenas;
+            total.high_water = std::max(total.high_water, s.high_water);
+            total.capacity += s.capacity;
+        }
+        return total;
+    }
+
+    // Shard the calling thread maps to: its current CPU where the OS tells us, a hash of its id otherwise
+    [[nodiscard]] inline auto current_shard() const noexcept -> size_t {
+#if defined(__linux__)
+        const int cpu = sched_getcpu();
+        if (cpu >= 0) {
+            return static_cast<size_t>(cpu) % shards_.size();
+        }
+#endif
+        return std::hash<std::thread::id>{}(std::this_thread::get_id()) % shards_.size();
+    }
+
+  private:
+    friend class arena_lease;
+
+    struct alignas(ARENA_CACHE_LINE) shard {
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<arena>> owned;
+        std::vector<arena*> idle;
+        size_t leases = 0;
+        size_t created = 0;
+        size_t stolen = 0;
+        size_t high_water = 0;
+    };
+
+    void give_back(arena* a, size_t shard_index) noexcept {
+        const size_t high_water = a->high_water();
+        a->reset();
+
+        shard& s = shards_[shard_index];
+        std::lock_guard lock(s.mutex);
+        s.high_water = std::max(s.high_water, high_water);
+        // Capacity was reserved when the arena was created, push_back cannot throw here
+        s.idle.push_back(a);
+    }
+
+    std::vector<shard> shards_;
+    size_t arena_capacity_;
+};
+
+inline void arena_lease::release() noexcept {
+    if (arena_ != nullptr) {
+        pool_->give_back(std::exchange(arena_, nullptr), shard_);
+        pool_ = nullptr;
+    }
+}
+
+}  // namespace mia
@@ -1,92 +1,370 @@
-// TODO Implement dynamic arena
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 #ifndef ARENA_DEFAULT_CAPACITY
 #define ARENA_DEFAULT_CAPACITY (4ll * 1024)
 #endif  // !ARENA_DEFAULT_CAPACITY
 
+#ifndef ARENA_GROWTH_FACTOR
+#define ARENA_GROWTH_FACTOR 2
+#endif  // !ARENA_GROWTH_FACTOR
+
 namespace mia {
 
-struct arena {
-    char* buffer;
-    size_t curoffset;
+// One malloc'd chunk, the payload follows the header
+struct arena_block {
+    arena_block* prev;
     size_t capacity;
+    size_t offset;
+
+    inline auto data() noexcept -> char* {
+        return reinterpret_cast<char*>(this) + header_size();
+    }
+
+    static constexpr auto header_size() noexcept -> size_t {
+        return (sizeof(arena_block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    }
+};
+
+// Destructor registered by arena::alloc_tracked, lives in the arena itself
+struct arena_finalizer {
+    arena_finalizer* next;
+    void (*destroy)(void* object, size_t count) noexcept;
+    void* object;
+    size_t count;
+};
+
+// Growable bump allocator
+// Blocks are chained and grow geometrically, an allocation never moves once handed out
+struct arena {
+    arena_block* current;  // Block being bumped, older blocks hang off ->prev
+    arena_block* spare;    // Largest block dropped by rollback(), reused before calling malloc
+    arena_finalizer* finalizers;  // Newest first
+    size_t next_capacity;  // Payload size of the next block to malloc
+    size_t total_capacity;
+    size_t total_used;
+    size_t total_wasted;   // Alignment padding + tails of blocks that were full
+    size_t peak_used;      // Largest total_used seen before a rollback() or reset()
+
+    // Position to roll back to, see save() / rollback()
+    struct marker {
+        arena_block* block;
+        size_t offset;
+        size_t used;
+        size_t wasted;
+        arena_finalizer* finalizers;
+    };
 
     arena(size_t init_capacity = 0) {
-        capacity = init_capacity;
         if (init_capacity == 0) {
-            capacity = ARENA_DEFAULT_CAPACITY;
+            init_capacity = ARENA_DEFAULT_CAPACITY;
         }
 
-        buffer = (char*)malloc(capacity);
-        curoffset = 0;
+        current = nullptr;
+        spare = nullptr;
+        finalizers = nullptr;
+        next_capacity = init_capacity;
+        total_capacity = 0;
+        total_used = 0;
+        total_wasted = 0;
+        peak_used = 0;
+        push_block(init_capacity);
     }
 
-    ~arena() { free(buffer); }
+    ~arena() { release(); }
 
     arena(const arena& other) = delete;
     auto operator=(const arena& other) -> arena& = delete;
 
     arena(arena&& other) noexcept {
-        buffer = std::exchange(other.buffer, nullptr);
-        curoffset = std::exchange(other.curoffset, 0);
-        capacity = std::exchange(other.capacity, 0);
+        current = std::exchange(other.current, nullptr);
+        spare = std::exchange(other.spare, nullptr);
+        finalizers = std::exchange(other.finalizers, nullptr);
+        next_capacity = std::exchange(other.next_capacity, 0);
+        total_capacity = std::exchange(other.total_capacity, 0);
+        total_used = std::exchange(other.total_used, 0);
+        total_wasted = std::exchange(other.total_wasted, 0);
+        peak_used = std::exchange(other.peak_used, 0);
     }
     auto operator=(arena&& other) noexcept -> arena& {
         if (this != &other) {
-            delete[] buffer;
+            release();
 
-            buffer = std::exchange(other.buffer, nullptr);
-            curoffset = std::exchange(other.curoffset, 0);
-            capacity = std::exchange(other.capacity, 0);
+            current = std::exchange(other.current, nullptr);
+            spare = std::exchange(other.spare, nullptr);
+            finalizers = std::exchange(other.finalizers, nullptr);
+            next_capacity = std::exchange(other.next_capacity, 0);
+            total_capacity = std::exchange(other.total_capacity, 0);
+            total_used = std::exchange(other.total_used, 0);
+            total_wasted = std::exchange(other.total_wasted, 0);
+            peak_used = std::exchange(other.peak_used, 0);
         }
         return *this;
     }
 
-    template <typename T, class Allocator = std::allocator<T>, typename... Args>
-    inline auto alloc(Args&&... args) -> T* {
-        size_t size = sizeof(T);
-        size_t align = alignof(T);
+    // Raw bytes, `align` must be a power of two
+    inline auto alloc_bytes(size_t size, size_t align) -> void* {
+        assert(align != 0 && (align & (align - 1)) == 0);
+        if (size > SIZE_MAX - align) {
+            throw std::bad_alloc();
+        }
 
-        uintptr_t alloc_res = (uintptr_t)buffer + curoffset;
-        uintptr_t padding = (~alloc_res + 1) & (align - 1);
-        alloc_res += padding;
+        uintptr_t padding = 0;
+        if (current != nullptr) {
+            uintptr_t alloc_res = (uintptr_t)current->data() + current->offset;
+            padding = (~alloc_res + 1) & (align - 1);
+        }
+        if (current == nullptr || padding + size > current->capacity - current->offset) {
+            grow(size + align - 1);
+            uintptr_t alloc_res = (uintptr_t)current->data() + current->offset;
+            padding = (~alloc_res + 1) & (align - 1);
+        }
 
-        curoffset += size + padding;
+        char* res = current->data() + current->offset + padding;
+        current->offset += size + padding;
+        total_used += size;
+        total_wasted += padding;
+        return res;
+    }
+
+    template <typename T, class Allocator = std::allocator<T>, typename... Args>
+    inline auto alloc(Args&&... args) -> T* {
+        T* res_ptr = static_cast<T*>(alloc_bytes(sizeof(T), alignof(T)));
 
         Allocator alloc;
         using AllocTraits = std::allocator_traits<Allocator>;
-
-        T* res_ptr = reinterpret_cast<T*>(alloc_res);
         AllocTraits::construct(alloc, res_ptr, std::forward<Args>(args)...);
         return res_ptr;
     }
 
     template <typename T, class Allocator = std::allocator<T>>
-    inline auto add(T&& other) noexcept -> T* {
-        size_t size = sizeof(T);
-        size_t align = alignof(T);
-
-        uintptr_t alloc_res = (uintptr_t)buffer + curoffset;
-        uintptr_t padding = (~alloc_res + 1) & (align - 1);
-        alloc_res += padding;
-
-        curoffset += size + padding;
+    inline auto add(T&& other) -> T* {
+        T* res_ptr = static_cast<T*>(alloc_bytes(sizeof(T), alignof(T)));
 
         Allocator alloc;
         using AllocTraits = std::allocator_traits<Allocator>;
+        AllocTraits::construct(alloc, res_ptr, std::forward<T>(other));
+        return res_ptr;
+    }
 
-        T* res_ptr = reinterpret_cast<T*>(alloc_res);
-        AllocTraits::construct(alloc, res_ptr, other);
+    // :: Arrays of n objects
+    // Value-initialized (zeroed for trivial types)
+    template <typename T>
+    inline auto alloc_array(size_t n) -> T* {
+        T* res_ptr = alloc_array_uninitialized<T>(n);
+        std::uninitialized_value_construct_n(res_ptr, n);
+        return res_ptr;
+    }
+    // Copies of `value`
+    template <typename T>
+    inline auto alloc_array(size_t n, const T& value) -> T* {
+        T* res_ptr = alloc_array_uninitialized<T>(n);
+        std::uninitialized_fill_n(res_ptr, n, value);
         return res_ptr;
     }
+    // Default-initialized, trivial types are left indeterminate
+    template <typename T>
+    inline auto alloc_array_for_overwrite(size_t n) -> T* {
+        T* res_ptr = alloc_array_uninitialized<T>(n);
+        std::uninitialized_default_construct_n(res_ptr, n);
+        return res_ptr;
+    }
+    // Raw storage, no object is constructed
+    template <typename T>
+    inline auto alloc_array_uninitialized(size_t n) -> T* {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(alloc_bytes(n * sizeof(T), alignof(T)));
+    }
+
+    // :: Tracked objects
+    // The destructor runs on rollback() past this point, reset() or destruction of the arena
+    template <typename T, typename... Args>
+    inline auto alloc_tracked(Args&&... args) -> T* {
+        T* res_ptr = alloc_array_uninitialized<T>(1);
+        std::construct_at(res_ptr, std::forward<Args>(args)...);
+        track(res_ptr, 1);
+        return res_ptr;
+    }
+    template <typename T>
+    inline auto alloc_array_tracked(size_t n) -> T* {
+        T* res_ptr = alloc_array<T>(n);
+        track(res_ptr, n);
+        return res_ptr;
+    }
+
+    // NOTE: MARKERS
+
+    [[nodiscard]] inline auto save() const noexcept -> marker {
+        return {current, current == nullptr ? 0 : current->offset, total_used, total_wasted, finalizers};
+    }
+
+    // Free everything allocated after `m`, blocks pushed since then are dropped (the largest one is kept as spare)
+    void rollback(const marker& m) noexcept {
+        peak_used = high_water();
+        run_finalizers(m.finalizers);
+        while (current != m.block) {
+            assert(current != nullptr && "marker does not belong to this arena");
+            retire(std::exchange(current, current->prev));
+        }
+        if (current != nullptr) {
+            current->offset = m.offset;
+        }
+        total_used = m.used;
+        total_wasted = m.wasted;
+    }
+
+    // Drop every allocation, the largest block is kept so a steady workload stops calling malloc
+    void reset() noexcept {
+        peak_used = high_water();
+        run_finalizers(nullptr);
+        while (current != nullptr) {
+            retire(std::exchange(current, current->prev));
+        }
+
+        current = std::exchange(spare, nullptr);
+        total_used = 0;
+        total_wasted = 0;
+        if (current != nullptr) {
+            current->prev = nullptr;
+            current->offset = 0;
+            next_capacity = std::max(next_capacity, current->capacity * ARENA_GROWTH_FACTOR);
+        }
+    }
+
+    // NOTE: STATISTICS
+
+    // Bytes malloc'd for payloads, the spare block included
+    [[nodiscard]] inline auto capacity() const noexcept -> size_t { return total_capacity; }
+    // Bytes handed out
+    [[nodiscard]] inline auto used() const noexcept -> size_t { return total_used; }
+    // Most bytes ever in use at once, survives rollback() and reset()
+    [[nodiscard]] inline auto high_water() const noexcept -> size_t { return std::max(peak_used, total_used); }
+    // Bytes lost to alignment and to the unused tails of retired blocks
+    [[nodiscard]] inline auto wasted() const noexcept -> size_t { return total_wasted; }
+    // Bytes still available in the current block
+    [[nodiscard]] inline auto remaining() const noexcept -> size_t {
+        return current == nullptr ? 0 : current->capacity - current->offset;
+    }
+    [[nodiscard]] inline auto block_count() const noexcept -> size_t {
+        size_t count = 0;
+        for (const arena_block* b = current; b != nullptr; b = b->prev) {
+            ++count;
+        }
+        return count;
+    }
+
+  private:
+    void push_block(size_t capacity) {
+        if (capacity > SIZE_MAX - arena_block::header_size()) {
+            throw std::bad_alloc();
+        }
+        auto* block = static_cast<arena_block*>(malloc(arena_block::header_size() + capacity));
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        block->prev = current;
+        block->capacity = capacity;
+        block->offset = 0;
+
+        current = block;
+        total_capacity += capacity;
+    }
+
+    void grow(size_t min_capacity) {
+        if (current != nullptr) {
+            total_wasted += current->capacity - current->offset;
+        }
+
+        if (spare != nullptr && spare->capacity >= min_capacity) {
+            spare->prev = current;
+            spare->offset = 0;
+            current = std::exchange(spare, nullptr);
+            return;
+        }
+
+        size_t capacity = next_capacity != 0 ? next_capacity : ARENA_DEFAULT_CAPACITY;
+        // Growth stops short of wrapping around, past that the block is just big enough
+        while (capacity < min_capacity) {
+            capacity = capacity > SIZE_MAX / ARENA_GROWTH_FACTOR ? min_capacity : capacity * ARENA_GROWTH_FACTOR;
+        }
+        push_block(capacity);
+        next_capacity = capacity > SIZE_MAX / ARENA_GROWTH_FACTOR ? capacity : capacity * ARENA_GROWTH_FACTOR;
+    }
+
+    // Keep the larger of `block` and the spare, free the other
+    void retire(arena_block* block) noexcept {
+        if (spare != nullptr && spare->capacity < block->capacity) {
+            std::swap(block, spare);
+        }
+        if (spare == nullptr) {
+            spare = block;
+            return;
+        }
+        total_capacity -= block->capacity;
+        free(block);
+    }
+
+    template <typename T>
+    void track(T* objects, size_t count) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            auto* f = alloc_array_uninitialized<arena_finalizer>(1);
+            f->next = finalizers;
+            f->destroy = [](void* object, size_t n) noexcept {
+                std::destroy_n(static_cast<T*>(object), n);
+            };
+            f->object = objects;
+            f->count = count;
+            finalizers = f;
+        }
+    }
+
+    void run_finalizers(arena_finalizer* until) noexcept {
+        while (finalizers != until) {
+            assert(finalizers != nullptr && "marker does not belong to this arena");
+            arena_finalizer* f = std::exchange(finalizers, finalizers->next);
+            f->destroy(f->object, f->count);
+        }
+    }
+
+    void release() noexcept {
+        run_finalizers(nullptr);
+        while (current != nullptr) {
+            free(std::exchange(current, current->prev));
+        }
+        free(std::exchange(spare, nullptr));
+    }
+};
+
+// Rolls the arena back to where it was on construction, for scratch memory with a lexical lifetime
+class arena_scope {
+  public:
+    explicit arena_scope(arena& a) noexcept
+        : arena_(&a), marker_(a.save()) {
+    }
+    ~arena_scope() { arena_->rollback(marker_); }
+
+    arena_scope(const arena_scope& other) = delete;
+    auto operator=(const arena_scope& other) -> arena_scope& = delete;
+
+    [[nodiscard]] inline auto get_arena() const noexcept -> arena& {
+        return *arena_;
+    }
+
+  private:
+    arena* arena_;
+    arena::marker marker_;
 };
 
 }  // namespace mia
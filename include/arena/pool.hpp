@@ -0,0 +1,403 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef POOL_DEFAULT_SLAB_SLOTS
+#define POOL_DEFAULT_SLAB_SLOTS 1024
+#endif  // !POOL_DEFAULT_SLAB_SLOTS
+
+// Slots moved between a thread cache and the shared free list at once
+#ifndef POOL_CACHE_BATCH
+#define POOL_CACHE_BATCH 32
+#endif  // !POOL_CACHE_BATCH
+
+// Initial size of a thread's cache table (a power of two), it grows with the pools the thread uses
+#ifndef POOL_THREAD_CACHES
+#define POOL_THREAD_CACHES 8
+#endif  // !POOL_THREAD_CACHES
+
+namespace mia {
+
+namespace detail {
+
+// Free slot, the links overlay the object storage (so a slot is at least 16 bytes)
+struct pool_node {
+    pool_node* next;                     // Next slot in the same cache or batch
+    std::atomic<pool_node*> next_batch;  // Next batch on the shared stack, only set on a batch's first slot
+};
+
+// Treiber stack of batches, the head carries a 16 bit tag bumped on every update so a pop racing
+// with pop+push of the same node (ABA) fails its CAS. Pointers fit in the low 48 bits on x86-64 and AArch64
+class tagged_stack {
+  public:
+    static_assert(sizeof(void*) == 8, "tagged_stack packs a 48 bit pointer and a 16 bit tag");
+
+    // Push a whole batch, linked through ->next
+    inline void push(pool_node* batch) noexcept {
+        uint64_t old_head = head_.load(std::memory_order_relaxed);
+        uint64_t new_head;
+        do {
+            batch->next_batch.store(pointer(old_head), std::memory_order_relaxed);
+            new_head = pack(batch, tag(old_head) + 1);
+        } while (!head_.compare_exchange_weak(old_head, new_head, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    inline auto pop() noexcept -> pool_node* {
+        uint64_t old_head = head_.load(std::memory_order_acquire);
+        while (pointer(old_head) != nullptr) {
+            pool_node* next = speculative_next(pointer(old_head));
+            // acq_rel keeps the release sequence of earlier pushes intact for the next popper
+            if (head_.compare_exchange_weak(old_head, pack(next, tag(old_head) + 1), std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return pointer(old_head);
+            }
+        }
+        return nullptr;
+    }
+
+  private:
+    // Another thread may already have popped `node` and be writing an object over it, the value read is
+    // then garbage but the CAS that follows fails. Slabs outlive the stack so the read itself is safe
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((no_sanitize("thread"))) static inline auto speculative_next(pool_node* node) noexcept -> pool_node* {
+        static_assert(sizeof(std::atomic<pool_node*>) == sizeof(pool_node*));
+        return __atomic_load_n(reinterpret_cast<pool_node* const*>(&node->next_batch), __ATOMIC_RELAXED);
+    }
+#else
+    static inline auto speculative_next(pool_node* node) noexcept -> pool_node* {
+        return node->next_batch.load(std::memory_order_relaxed);
+    }
+#endif
+
+    static constexpr uint64_t pointer_mask = (uint64_t{1} << 48) - 1;
+
+    static inline auto pack(pool_node* p, uint64_t t) noexcept -> uint64_t {
+        assert((reinterpret_cast<uintptr_t>(p) & ~pointer_mask) == 0);
+        return (t << 48) | reinterpret_cast<uintptr_t>(p);
+    }
+    static inline auto pointer(uint64_t head) noexcept -> pool_node* {
+        return reinterpret_cast<pool_node*>(head & pointer_mask);
+    }
+    static inline auto tag(uint64_t head) noexcept -> uint64_t {
+        return head >> 48;
+    }
+
+    std::atomic<uint64_t> head_{0};
+};
+
+// One thread's private free list for one pool
+struct pool_cache {
+    pool_node* head = nullptr;
+    size_t count = 0;     // Upper bound, a refilled batch may be short
+    bool owned = false;  // Guarded by the pool's mutex
+};
+
+class pool_base;
+
+// Live pools by id, so a thread exiting after its pool died does not touch freed memory
+struct pool_registry {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, pool_base*> live;
+    uint64_t next_id = 1;
+
+    static auto instance() -> pool_registry& {
+        static pool_registry registry;
+        return registry;
+    }
+};
+
+// Untyped pool, everything but construction only depends on the slot size
+class pool_base {
+  public:
+    pool_base(size_t slot_size, size_t slot_align, size_t slab_slots)
+        : slot_align_(std::max(slot_align, alignof(pool_node))),
+          slot_size_((std::max(slot_size, sizeof(pool_node)) + slot_align_ - 1) & ~(slot_align_ - 1)),
+          slab_slots_(slab_slots != 0 ? slab_slots : POOL_DEFAULT_SLAB_SLOTS) {
+        pool_registry& registry = pool_registry::instance();
+        std::lock_guard lock(registry.mutex);
+        id_ = registry.next_id++;
+        registry.live.emplace(id_, this);
+    }
+
+    // Objects still allocated are not destroyed, their memory goes away with the slabs
+    ~pool_base() {
+        {
+            pool_registry& registry = pool_registry::instance();
+            std::lock_guard lock(registry.mutex);
+            registry.live.erase(id_);
+        }
+        for (pool_cache* cache : caches_) {
+            delete cache;
+        }
+        for (void* slab : slabs_) {
+            ::operator delete(slab, std::align_val_t{slot_align_});
+        }
+    }
+
+    pool_base(const pool_base& other) = delete;
+    auto operator=(const pool_base& other) -> pool_base& = delete;
+
+    // NOTE: ALLOCATION
+
+    // Storage for one slot, O(1) and lock-free unless a new slab is needed
+    [[nodiscard]] inline auto allocate_slot() -> void* {
+        pool_cache& cache = local_cache();
+        if (cache.head == nullptr) {
+            refill(cache);
+        }
+        pool_node* node = cache.head;
+        cache.head = node->next;
+        cache.count -= cache.count != 0;
+        return node;
+    }
+
+    // Any thread may free a slot, it lands in that thread's cache
+    inline void deallocate_slot(void* p) noexcept {
+        assert(p != nullptr);
+        pool_cache& cache = local_cache();
+        auto* node = ::new (p) pool_node{cache.head, {}};
+        cache.head = node;
+        if (++cache.count >= 2 * POOL_CACHE_BATCH) {
+            flush(cache, POOL_CACHE_BATCH);
+        }
+    }
+
+    // NOTE: STATISTICS
+
+    [[nodiscard]] inline auto slot_size() const noexcept -> size_t { return slot_size_; }
+    // Slots carved out of slabs so far, live or free
+    [[nodiscard]] auto capacity() const -> size_t {
+        std::lock_guard lock(mutex_);
+        return slabs_.size() * slab_slots_ - static_cast<size_t>(slab_end_ - slab_cursor_) / slot_size_;
+    }
+    [[nodiscard]] auto slab_count() const -> size_t {
+        std::lock_guard lock(mutex_);
+        return slabs_.size();
+    }
+
+  private:
+    // :: Thread caches
+    // Open addressed by pool id (ids are sequential, so the low bits spread them) and grown with the number of pools
+    // the thread uses: a cache stays with the thread until it exits or its pool is destroyed
+    struct cache_table {
+        struct entry {
+            uint64_t id = 0;  // 0 marks an empty slot
+            pool_cache* cache = nullptr;
+        };
+        std::vector<entry> entries;
+        size_t used = 0;
+
+        ~cache_table() {
+            pool_registry& registry = pool_registry::instance();
+            std::lock_guard lock(registry.mutex);
+            for (entry& e : entries) {
+                auto it = e.id != 0 ? registry.live.find(e.id) : registry.live.end();
+                if (it != registry.live.end()) {
+                    it->second->release_cache(*e.cache);
+                }
+            }
+        }
+
+        inline auto find(uint64_t id) const noexcept -> pool_cache* {
+            if (entries.empty()) {
+                return nullptr;
+            }
+            const size_t mask = entries.size() - 1;
+            for (size_t i = id & mask;; i = (i + 1) & mask) {
+                if (entries[i].id == id) {
+                    return entries[i].cache;
+                }
+                if (entries[i].id == 0) {
+                    return nullptr;
+                }
+            }
+        }
+
+        void insert(uint64_t id, pool_cache* cache) {
+            if (2 * (used + 1) > entries.size()) {
+                rehash();
+            }
+            place(id, cache);
+        }
+
+      private:
+        void place(uint64_t id, pool_cache* cache) noexcept {
+            const size_t mask = entries.size() - 1;
+            size_t i = id & mask;
+            while (entries[i].id != 0) {
+                i = (i + 1) & mask;
+            }
+            entries[i] = {id, cache};
+            ++used;
+        }
+
+        // Drops the entries of destroyed pools (their caches went with them), then sizes the table for one more
+        void rehash() {
+            std::vector<entry> old = std::move(entries);
+            size_t live = 0;
+            {
+                pool_registry& registry = pool_registry::instance();
+                std::lock_guard lock(registry.mutex);
+                for (entry& e : old) {
+                    if (e.id != 0 && !registry.live.contains(e.id)) {
+                        e = {};
+                    }
+                    live += e.id != 0;
+                }
+            }
+            size_t capacity = POOL_THREAD_CACHES;
+            while (2 * (live + 1) > capacity) {
+                capacity *= 2;
+            }
+            entries.assign(capacity, entry{});
+            used = 0;
+            for (const entry& e : old) {
+                if (e.id != 0) {
+                    place(e.id, e.cache);
+                }
+            }
+        }
+    };
+
+    inline auto local_cache() -> pool_cache& {
+        thread_local cache_table table;
+        pool_cache* cache = table.find(id_);
+        if (cache == nullptr) [[unlikely]] {
+            cache = &acquire_cache();
+            table.insert(id_, cache);
+        }
+        return *cache;
+    }
+
+    // A cache left behind by an exited thread keeps its slots, reuse it before making a new one
+    auto acquire_cache() -> pool_cache& {
+        std::lock_guard lock(mutex_);
+        for (pool_cache* cache : caches_) {
+            if (!cache->owned) {
+                cache->owned = true;
+                return *cache;
+            }
+        }
+        caches_.reserve(caches_.size() + 1);
+        auto* cache = new pool_cache;
+        cache->owned = true;
+        caches_.push_back(cache);
+        return *cache;
+    }
+
+    void release_cache(pool_cache& cache) noexcept {
+        while (cache.head != nullptr) {
+            flush(cache, POOL_CACHE_BATCH);
+        }
+        std::lock_guard lock(mutex_);
+        cache.owned = false;
+    }
+
+    // :: Shared free list and slabs
+    // One CAS moves a whole batch either way
+    void refill(pool_cache& cache) {
+        pool_node* batch = free_.pop();
+        if (batch != nullptr) {
+            cache.head = batch;
+            cache.count = POOL_CACHE_BATCH;
+            return;
+        }
+        carve(cache);
+    }
+
+    // Move up to `n` slots from the top of the cache to the shared stack as one batch
+    void flush(pool_cache& cache, size_t n) noexcept {
+        if (cache.head == nullptr) {
+            return;
+        }
+        pool_node* first = cache.head;
+        pool_node* last = first;
+        size_t moved = 1;
+        for (; moved < n && last->next != nullptr; ++moved) {
+            last = last->next;
+        }
+        cache.head = std::exchange(last->next, nullptr);
+        cache.count -= std::min(cache.count, moved);
+        free_.push(first);
+    }
+
+    void carve(pool_cache& cache) {
+        std::lock_guard lock(mutex_);
+        if (slab_cursor_ == slab_end_) {
+            slabs_.reserve(slabs_.size() + 1);
+            auto* slab = static_cast<char*>(::operator new(slab_slots_ * slot_size_, std::align_val_t{slot_align_}));
+            slabs_.push_back(slab);
+            slab_cursor_ = slab;
+            slab_end_ = slab + slab_slots_ * slot_size_;
+        }
+        for (size_t i = 0; i < POOL_CACHE_BATCH && slab_cursor_ != slab_end_; ++i) {
+            cache.head = ::new (slab_cursor_) pool_node{cache.head, {}};
+            ++cache.count;
+            slab_cursor_ += slot_size_;
+        }
+    }
+
+    size_t slot_align_;
+    size_t slot_size_;
+    size_t slab_slots_;
+    uint64_t id_;
+    tagged_stack free_;
+
+    mutable std::mutex mutex_;  // Slabs and cache records, never taken on the fast path
+    std::vector<void*> slabs_;
+    char* slab_cursor_ = nullptr;
+    char* slab_end_ = nullptr;
+    std::vector<pool_cache*> caches_;
+};
+
+}  // namespace detail
+
+// Fixed-size object pool
+// Each thread allocates from and frees to its own cache, batches move through a lock-free shared list
+template <typename T>
+class pool : private detail::pool_base {
+  public:
+    using value_type = T;
+
+    explicit pool(size_t slab_slots = POOL_DEFAULT_SLAB_SLOTS)
+        : detail::pool_base(sizeof(T), alignof(T), slab_slots) {
+    }
+
+    template <typename... Args>
+    [[nodiscard]] inline auto create(Args&&... args) -> T* {
+        T* res_ptr = allocate();
+        try {
+            return std::construct_at(res_ptr, std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(res_ptr);
+            throw;
+        }
+    }
+    inline void destroy(T* p) noexcept {
+        std::destroy_at(p);
+        deallocate(p);
+    }
+
+    // Raw storage for one T
+    [[nodiscard]] inline auto allocate() -> T* {
+        return static_cast<T*>(allocate_slot());
+    }
+    inline void deallocate(T* p) noexcept {
+        deallocate_slot(p);
+    }
+
+    using detail::pool_base::capacity;
+    using detail::pool_base::slab_count;
+    using detail::pool_base::slot_size;
+};
+
+}  // namespace mia
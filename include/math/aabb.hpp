@@ -0,0 +1,372 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "simd.hpp"
+#include "vector.hpp"
+
+namespace mia {
+
+// Half-line origin + t direction, t >= 0
+// The inverse direction is kept for slab tests: a 0 component gives an infinite slope, never a division at test time
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+struct ray {
+    using value_type = T;
+    using vector_type = vector<T, Dims>;
+
+    vector_type origin;
+    vector_type direction;
+    vector_type inverse_direction;
+
+    constexpr ray() = default;
+    constexpr ray(const vector_type &origin_, const vector_type &direction_)
+        : origin(origin_), direction(direction_) {
+        for (size_t d = 0; d < Dims; ++d) {
+            // Spelled out for 0, dividing by it is not a constant expression
+            if (direction[d] == 0) {
+                inverse_direction[d] = std::signbit(direction[d]) ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+            } else {
+                inverse_direction[d] = T{1} / direction[d];
+            }
+        }
+    }
+
+    constexpr auto at(const T t) const -> vector_type {
+        vector_type point;
+        for (size_t d = 0; d < Dims; ++d) {
+            point[d] = origin[d] + t * direction[d];
+        }
+        return point;
+    }
+    // Slab tests enter through the upper plane of an axis the ray goes down
+    constexpr auto negative(const size_t d) const -> bool {
+        return inverse_direction[d] < 0;
+    }
+};
+
+// Axis-aligned box [min, max], closed on both sides
+// Default constructed boxes are empty (min > max): merging or expanding them gives the other operand
+template <typename T, size_t Dims>
+    requires std::is_arithmetic_v<T>
+class aabb {
+  public:
+    // NOTE: MEMBER TYPES
+
+    using value_type = T;
+    using vector_type = vector<T, Dims>;
+
+    vector_type min = splat(std::numeric_limits<T>::max());
+    vector_type max = splat(std::numeric_limits<T>::lowest());
+
+    // NOTE: CONSTRUCTOR
+
+    constexpr aabb() = default;
+    constexpr aabb(const vector_type &min_, const vector_type &max_)
+        : min(min_), max(max_) {
+    }
+
+    // Smallest box holding every point, empty for no points
+    static constexpr auto from_points(std::span<const vector_type> points) -> aabb {
+        aabb box;
+        for (const vector_type &p : points) {
+            box.expand(p);
+        }
+        return box;
+    }
+
+    // NOTE: CONST FUNCTIONS
+
+    [[nodiscard]] constexpr auto is_empty() const -> bool {
+        for (size_t d = 0; d < Dims; ++d) {
+            if (min[d] > max[d]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] constexpr auto center() const -> vector_type {
+        vector_type c;
+        for (size_t d = 0; d < Dims; ++d) {
+            c[d] = static_cast<T>((min[d] + max[d]) / 2);
+        }
+        return c;
+    }
+    // max - min, meaningless for empty boxes
+    [[nodiscard]] constexpr auto extent() const -> vector_type {
+        return max - min;
+    }
+    // Perimeter in 2D, the cost measure of SAH builders, 0 for empty boxes
+    [[nodiscard]] constexpr auto surface_area() const -> T
+        requires(Dims == 2 || Dims == 3)
+    {
+        if (is_empty()) {
+            return T{0};
+        }
+        const vector_type e = extent();
+        if constexpr (Dims == 2) {
+            return static_cast<T>(2 * (e[0] + e[1]));
+        } else {
+            return static_cast<T>(2 * (e[0] * e[1] + e[1] * e[2] + e[2] * e[0]));
+        }
+    }
+    [[nodiscard]] constexpr auto volume() const -> T {
+        if (is_empty()) {
+            return T{0};
+        }
+        T v{1};
+        for (size_t d = 0; d < Dims; ++d) {
+            v *= max[d] - min[d];
+        }
+        return v;
+    }
+    // Index of the longest axis
+    [[nodiscard]] constexpr auto major_axis() const -> size_t {
+        const vector_type e = extent();
+        size_t axis = 0;
+        for (size_t d = 1; d < Dims; ++d) {
+            if (e[d] > e[axis]) {
+                axis = d;
+            }
+        }
+        return axis;
+    }
+
+    [[nodiscard]] constexpr auto contains(const vector_type &point) const -> bool {
+        for (size_t d = 0; d < Dims; ++d) {
+            if (point[d] < min[d] || point[d] > max[d]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    [[nodiscard]] constexpr auto contains(const aabb &other) const -> bool {
+        return other.is_empty() || (contains(other.min) && contains(other.max));
+    }
+    // Touching boxes overlap
+    [[nodiscard]] constexpr auto overlaps(const aabb &other) const -> bool {
+        for (size_t d = 0; d < Dims; ++d) {
+            if (other.max[d] < min[d] || other.min[d] > max[d]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Squared distance from `point` to the box, 0 inside
+    [[nodiscard]] constexpr auto distance_squared(const vector_type &point) const -> typename vector_type::compute_type {
+        return vector_type::distance_squared(point, vector_type::min(vector_type::max(point, min), max));
+    }
+
+    // Slab test: entry distance of the ray in [t_min, t_max], nullopt on a miss
+    // A ray lying in a slab plane (0 * infinity) is treated as inside that slab, as aabb_packet does
+    template <typename U = T>
+        requires std::is_floating_point_v<U>
+    [[nodiscard]] constexpr auto intersect(const ray<U, Dims> &r, const U t_min = U{0},
+                                           const U t_max = std::numeric_limits<U>::infinity()) const -> std::optional<U> {
+        T enter = t_min;
+        T exit = t_max;
+        for (size_t d = 0; d < Dims; ++d) {
+            const bool negative = r.negative(d);
+            const T t_near = ((negative ? max[d] : min[d]) - r.origin[d]) * r.inverse_direction[d];
+            const T t_far = ((negative ? min[d] : max[d]) - r.origin[d]) * r.inverse_direction[d];
+            enter = t_near > enter ? t_near : enter;
+            exit = t_far < exit ? t_far : exit;
+        }
+        if (enter <= exit) {
+            return enter;
+        }
+        return std::nullopt;
+    }
+
+    // NOTE: STATIC FUNCTIONS
+
+    static constexpr auto merge(const aabb &lhs, const aabb &rhs) -> aabb {
+        return aabb{vector_type::min(lhs.min, rhs.min), vector_type::max(lhs.max, rhs.max)};
+    }
+    // Overlap of both, empty when they are disjoint
+    static constexpr auto intersection(const aabb &lhs, const aabb &rhs) -> aabb {
+        return aabb{vector_type::max(lhs.min, rhs.min), vector_type::min(lhs.max, rhs.max)};
+    }
+
+    // NOTE: MODIFIERS
+
+    constexpr auto expand(const vector_type &point) -> aabb & {
+        min = vector_type::min(min, point);
+        max = vector_type::max(max, point);
+        return *this;
+    }
+    constexpr auto expand(const aabb &other) -> aabb & {
+        return *this = merge(*this, other);
+    }
+    // Grow by `margin` on every side
+    constexpr auto inflate(const T margin) -> aabb & {
+        for (size_t d = 0; d < Dims; ++d) {
+            min[d] = static_cast<T>(min[d] - margin);
+            max[d] = static_cast<T>(max[d] + margin);
+        }
+        return *this;
+    }
+
+    // NOTE: OPERATORS
+
+    constexpr auto operator==(const aabb &other) const -> bool {
+        return min == other.min && max == other.max;
+    }
+    constexpr auto operator!=(const aabb &other) const -> bool {
+        return !(operator==(other));
+    }
+
+  private:
+    static constexpr auto splat(const T v) -> vector_type {
+        vector_type result;
+        for (size_t d = 0; d < Dims; ++d) {
+            result[d] = v;
+        }
+        return result;
+    }
+};
+
+namespace detail {
+
+// Slab test of one ray against the Width boxes of an aabb_packet, bit i of the result is box i
+// Every variant ignores NaN slab distances the same way: max(enter, near) & min(exit, far) keep the running
+// value, as std::max / std::min do
+template <typename T, size_t Dims, size_t Width>
+constexpr auto slab_test(const std::array<std::array<T, Width>, Dims> &lower, const std::array<std::array<T, Width>, Dims> &upper,
+                         const ray<T, Dims> &r, const T t_min, const T t_max, T *t_enter) noexcept -> uint32_t {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < Width; ++i) {
+        T enter = t_min;
+        T exit = t_max;
+        for (size_t d = 0; d < Dims; ++d) {
+            const bool negative = r.negative(d);
+            const T t_near = ((negative ? upper[d][i] : lower[d][i]) - r.origin[d]) * r.inverse_direction[d];
+            const T t_far = ((negative ? lower[d][i] : upper[d][i]) - r.origin[d]) * r.inverse_direction[d];
+            enter = t_near > enter ? t_near : enter;
+            exit = t_far < exit ? t_far : exit;
+        }
+        mask |= static_cast<uint32_t>(enter <= exit) << i;
+        if (t_enter != nullptr) {
+            t_enter[i] = enter;
+        }
+    }
+    return mask;
+}
+
+// The primary template is the scalar fallback
+template <typename T, size_t Dims, size_t Width>
+struct slab_simd {
+    static constexpr bool enabled = false;
+
+    static constexpr auto test(const std::array<std::array<T, Width>, Dims> &lower, const std::array<std::array<T, Width>, Dims> &upper,
+                               const ray<T, Dims> &r, const T t_min, const T t_max, T *t_enter) noexcept -> uint32_t {
+        return slab_test<T, Dims, Width>(lower, upper, r, t_min, t_max, t_enter);
+    }
+};
+
+// :: One native register per slab: float x 4 with SSE2, x 8 with AVX, x 16 with AVX-512 (double x 2 / 4 / 8)
+template <typename T, size_t Dims, size_t Width>
+    requires(simd<T, Width>::ops::native && simd<T, Width>::accelerated)
+struct slab_simd<T, Dims, Width> {
+    static constexpr bool enabled = true;
+
+    using pack = simd<T, Width>;
+
+    static inline auto test(const std::array<std::array<T, Width>, Dims> &lower, const std::array<std::array<T, Width>, Dims> &upper,
+                            const ray<T, Dims> &r, const T t_min, const T t_max, T *t_enter) noexcept -> uint32_t {
+        pack enter{t_min};
+        pack exit{t_max};
+        for (size_t d = 0; d < Dims; ++d) {
+            const bool negative = r.negative(d);
+            const pack origin{r.origin[d]};
+            const pack inverse{r.inverse_direction[d]};
+            const pack t_near = (pack::load((negative ? upper : lower)[d].data()) - origin) * inverse;
+            const pack t_far = (pack::load((negative ? lower : upper)[d].data()) - origin) * inverse;
+            enter = max(enter, t_near);
+            exit = min(exit, t_far);
+        }
+        if (t_enter != nullptr) {
+            enter.storeu(t_enter);
+        }
+        return static_cast<uint32_t>((enter <= exit).bits());
+    }
+};
+
+} // namespace detail
+
+// Width boxes stored by axis (structure of arrays), tested against one ray at once
+// Widths of a native register (see simd.hpp) test one register per slab, other combinations run the scalar loop
+// Unused lanes hold empty boxes and never hit
+template <typename T, size_t Dims, size_t Width>
+    requires std::is_floating_point_v<T> && (Width > 0) && (Width <= 32)
+class aabb_packet {
+  public:
+    using value_type = T;
+    using box_type = aabb<T, Dims>;
+    using ray_type = ray<T, Dims>;
+    using simd_traits = detail::slab_simd<T, Dims, Width>;
+
+    static constexpr size_t width = Width;
+    static constexpr size_t alignment = (Width & (Width - 1)) == 0 ? Width * sizeof(T) : alignof(T);
+
+    alignas(alignment) std::array<std::array<T, Width>, Dims> lower;
+    alignas(alignment) std::array<std::array<T, Width>, Dims> upper;
+
+    constexpr aabb_packet() {
+        for (size_t d = 0; d < Dims; ++d) {
+            lower[d].fill(std::numeric_limits<T>::infinity());
+            upper[d].fill(-std::numeric_limits<T>::infinity());
+        }
+    }
+
+    constexpr void set(const size_t lane, const box_type &box) {
+        assert(lane < Width);
+        for (size_t d = 0; d < Dims; ++d) {
+            lower[d][lane] = box.min[d];
+            upper[d][lane] = box.max[d];
+        }
+    }
+    constexpr auto get(const size_t lane) const -> box_type {
+        assert(lane < Width);
+        box_type box;
+        for (size_t d = 0; d < Dims; ++d) {
+            box.min[d] = lower[d][lane];
+            box.max[d] = upper[d][lane];
+        }
+        return box;
+    }
+
+    // Bit i set when the ray hits box i within [t_min, t_max], `t_enter` (optional) receives the entry distances
+    // of every lane, meaningful for the hits only
+    constexpr auto intersect(const ray_type &r, const T t_min = T{0}, const T t_max = std::numeric_limits<T>::infinity(),
+                             T *t_enter = nullptr) const -> uint32_t {
+        if constexpr (simd_traits::enabled) {
+            if !consteval {
+                return simd_traits::test(lower, upper, r, t_min, t_max, t_enter);
+            }
+        }
+        return detail::slab_test<T, Dims, Width>(lower, upper, r, t_min, t_max, t_enter);
+    }
+};
+
+// :: Common instantiations
+template <typename T>
+using aabb2 = aabb<T, 2>;
+template <typename T>
+using aabb3 = aabb<T, 3>;
+template <typename T, size_t Dims = 3>
+using aabb4x = aabb_packet<T, Dims, 4>;
+template <typename T, size_t Dims = 3>
+using aabb8x = aabb_packet<T, Dims, 8>;
+
+} // namespace mia
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <span>
+
+#include "aabb.hpp"
+#include "batch-reduce.hpp"
+#include "batch.hpp"
+#include "matrix.hpp"
+#include "thread-pool.hpp"
+#include "vector.hpp"
+
+namespace mia::batch {
+
+// NOTE: PARALLEL BATCH OPERATIONS
+// Same contracts as the serial operations, the span cut into chunks spread over a thread_pool; each chunk
+// runs the serial (dispatched SIMD) kernel. Spans under `parallel_grain` vectors stay on the calling thread
+
+constexpr size_t parallel_grain = 4096;
+
+// Element-wise transform
+template <typename T, size_t Dims, typename Op>
+inline void transform(thread_pool &pool, std::span<const vector<T, Dims>> in, std::span<vector<T, Dims>> out, Op op) {
+    assert(out.size() >= in.size());
+    pool.parallel_for(0, in.size(), [&](const size_t begin, const size_t end) {
+        transform(in.subspan(begin, end - begin), out.subspan(begin, end - begin), op);
+    }, parallel_grain);
+}
+
+// Dot product
+template <typename T, size_t Dims>
+inline void dot(thread_pool &pool,
+                std::span<const vector<T, Dims>> lhs,
+                std::span<const vector<T, Dims>> rhs,
+                std::span<typename vector<T, Dims>::compute_type> out) {
+    assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+    pool.parallel_for(0, lhs.size(), [&](const size_t begin, const size_t end) {
+        dot(lhs.subspan(begin, end - begin), rhs.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    }, parallel_grain);
+}
+
+// Normalize
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline void normalize(thread_pool &pool, std::span<const vector<T, Dims>> in, std::span<vector<T, Dims>> out) {
+    assert(out.size() >= in.size());
+    pool.parallel_for(0, in.size(), [&](const size_t begin, const size_t end) {
+        normalize(in.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    }, parallel_grain);
+}
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline void normalize(thread_pool &pool, std::span<vector<T, Dims>> in_out) {
+    normalize(pool, std::span<const vector<T, Dims>>(in_out), in_out);
+}
+
+// :: Reductions, chunked by thread_pool::parallel_reduce: for a given span the result does not depend
+// on the pool, but a floating-point sum may differ from the serial one in the last bits
+// `in` must not be empty for min, max, mean & covariance, as for the serial ones
+template <typename T, size_t Dims>
+inline auto sum(thread_pool &pool, std::span<const vector<T, Dims>> in) -> vector<T, Dims> {
+    return pool.parallel_reduce(
+        0, in.size(), vector<T, Dims>{},
+        [&](const size_t begin, const size_t end) { return sum(in.subspan(begin, end - begin)); },
+        [](const vector<T, Dims> &lhs, const vector<T, Dims> &rhs) { return vector<T, Dims>(lhs + rhs); });
+}
+
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline auto pairwise_sum(thread_pool &pool, std::span<const vector<T, Dims>> in) -> vector<T, Dims> {
+    return pool.parallel_reduce(
+        0, in.size(), vector<T, Dims>{},
+        [&](const size_t begin, const size_t end) { return pairwise_sum(in.subspan(begin, end - begin)); },
+        [](const vector<T, Dims> &lhs, const vector<T, Dims> &rhs) { return vector<T, Dims>(lhs + rhs); });
+}
+
+// Partial sums are merged with their errors, as accurate as the serial one
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline auto kahan_sum(thread_pool &pool, std::span<const vector<T, Dims>> in) -> vector<T, Dims> {
+    using partial = detail::compensated<T, Dims>;
+    return pool.parallel_reduce(
+                   0, in.size(), partial{},
+                   [&](const size_t begin, const size_t end) { return detail::compensated_sum(in.subspan(begin, end - begin)); },
+                   partial::merge)
+        .value();
+}
+
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline auto mean(thread_pool &pool, std::span<const vector<T, Dims>> in) -> vector<T, Dims> {
+    assert(!in.empty());
+    return detail::divide(pairwise_sum(pool, in), in.size());
+}
+
+template <typename T, size_t Dims>
+inline auto min(thread_pool &pool, std::span<const vector<T, Dims>> in) -> vector<T, Dims> {
+    assert(!in.empty());
+    return pool.parallel_reduce(
+        0, in.size(), in.front(),
+        [&](const size_t begin, const size_t end) { return min(in.subspan(begin, end - begin)); },
+        [](const vector<T, Dims> &lhs, const vector<T, Dims> &rhs) { return vector<T, Dims>::min(lhs, rhs); });
+}
+template <typename T, size_t Dims>
+inline auto max(thread_pool &pool, std::span<const vector<T, Dims>> in) -> vector<T, Dims> {
+    assert(!in.empty());
+    return pool.parallel_reduce(
+        0, in.size(), in.front(),
+        [&](const size_t begin, const size_t end) { return max(in.subspan(begin, end - begin)); },
+        [](const vector<T, Dims> &lhs, const vector<T, Dims> &rhs) { return vector<T, Dims>::max(lhs, rhs); });
+}
+
+template <typename T, size_t Dims>
+inline auto bounds(thread_pool &pool, std::span<const vector<T, Dims>> in) -> aabb<T, Dims> {
+    return pool.parallel_reduce(
+        0, in.size(), aabb<T, Dims>{},
+        [&](const size_t begin, const size_t end) { return bounds(in.subspan(begin, end - begin)); },
+        aabb<T, Dims>::merge);
+}
+
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline auto covariance(thread_pool &pool, std::span<const vector<T, Dims>> in) -> matrix<T, Dims, Dims> {
+    const vector<T, Dims> centroid = mean(pool, in);
+    const auto scatter = pool.parallel_reduce(
+        0, in.size(), matrix<T, Dims, Dims>{},
+        [&](const size_t begin, const size_t end) {
+            return detail::pairwise<matrix<T, Dims, Dims>>(begin, end, [&](const size_t b, const size_t e) {
+                return detail::scatter(in.subspan(b, e - b), centroid);
+            });
+        },
+        [](const matrix<T, Dims, Dims> &lhs, const matrix<T, Dims, Dims> &rhs) { return lhs + rhs; });
+    return scatter * (T{1} / static_cast<T>(in.size()));
+}
+
+} // namespace mia::batch
@@ -0,0 +1,803 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+#include "aabb.hpp"
+#include "batch.hpp"
+#include "matrix.hpp"
+#include "vector.hpp"
+
+namespace mia::batch {
+
+namespace detail {
+
+// NOTE: REDUCTION KERNELS
+// Floats are the raw components of an array of mia::vector<float, Dims> (`stride` as for the float kernels)
+// Sums & bounds run over the flat array: six registers of lanes, lane j of a block holding component
+// j % stride (a block is a whole number of vectors for strides 2, 3 & 4), folded per component at the end
+
+constexpr size_t reduce_registers = 6;
+
+// Neumaier's variant of Kahan summation: also exact when `x` outweighs the running sum
+template <typename T>
+inline void neumaier_add(T &sum, T &error, const T x) {
+    const T t = sum + x;
+    error += std::abs(sum) >= std::abs(x) ? (sum - t) + x : (x - t) + sum;
+    sum = t;
+}
+
+// `lanes` is a block of register lanes, `tail` the floats after the last whole block
+// Components are counted rather than taken modulo the stride: a division per lane costs more than the fold
+inline void fold_sum(const float *lanes, const size_t lane_count, const float *tail, const size_t tail_count,
+                     const size_t stride, const size_t dims, float *sum) {
+    for (size_t c = 0; c < dims; ++c) {
+        sum[c] = 0;
+    }
+    for (size_t j = 0, c = 0; j < lane_count; ++j, c = c + 1 == stride ? 0 : c + 1) {
+        if (c < dims) {
+            sum[c] += lanes[j];
+        }
+    }
+    for (size_t j = 0, c = 0; j < tail_count; ++j, c = c + 1 == stride ? 0 : c + 1) {
+        if (c < dims) {
+            sum[c] += tail[j];
+        }
+    }
+}
+
+// Float compensation over at most this many blocks, then the lanes move to double totals: the float error term is a
+// plain sum of its own and drifts over millions of residuals of one sign (a constant added to a large sum)
+constexpr size_t compensated_flush = 256;
+
+inline void flush_compensated(const float *lane_sums, const float *lane_errors, const size_t lane_count, double *totals) {
+    for (size_t j = 0; j < lane_count; ++j) {
+        totals[j] += static_cast<double>(lane_sums[j]) + static_cast<double>(lane_errors[j]);
+    }
+}
+
+// Per component `total` as a float pair: `sum` the rounded total, `error` what the rounding lost
+inline void split_compensated(const double *total, const size_t dims, float *sum, float *error) {
+    for (size_t c = 0; c < dims; ++c) {
+        sum[c] = static_cast<float>(total[c]);
+        error[c] = static_cast<float>(total[c] - static_cast<double>(sum[c]));
+    }
+}
+
+inline void fold_compensated(const double *totals, const size_t lane_count, const float *tail, const size_t tail_count,
+                             const size_t stride, const size_t dims, float *sum, float *error) {
+    double total[4] = {};
+    for (size_t j = 0, c = 0; j < lane_count; ++j, c = c + 1 == stride ? 0 : c + 1) {
+        if (c < dims) {
+            total[c] += totals[j];
+        }
+    }
+    for (size_t j = 0, c = 0; j < tail_count; ++j, c = c + 1 == stride ? 0 : c + 1) {
+        if (c < dims) {
+            total[c] += static_cast<double>(tail[j]);
+        }
+    }
+    split_compensated(total, dims, sum, error);
+}
+
+inline void fold_bounds(const float *lane_low, const float *lane_high, const size_t lane_count,
+                        const float *tail, const size_t tail_count,
+                        const size_t stride, const size_t dims, float *low, float *high) {
+    for (size_t c = 0; c < dims; ++c) {
+        low[c] = std::numeric_limits<float>::infinity();
+        high[c] = -std::numeric_limits<float>::infinity();
+    }
+    for (size_t j = 0, c = 0; j < lane_count; ++j, c = c + 1 == stride ? 0 : c + 1) {
+        if (c < dims) {
+            low[c] = std::min(low[c], lane_low[j]);
+            high[c] = std::max(high[c], lane_high[j]);
+        }
+    }
+    for (size_t j = 0, c = 0; j < tail_count; ++j, c = c + 1 == stride ? 0 : c + 1) {
+        if (c < dims) {
+            low[c] = std::min(low[c], tail[j]);
+            high[c] = std::max(high[c], tail[j]);
+        }
+    }
+}
+
+// :: Scalar, four vectors in flight
+inline void sum_scalar(const float *in, const size_t count, const size_t stride, const size_t dims, float *sum) {
+    float acc[4][4] = {};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        for (size_t c = 0; c < dims; ++c) {
+            acc[0][c] += in[(i + 0) * stride + c];
+            acc[1][c] += in[(i + 1) * stride + c];
+            acc[2][c] += in[(i + 2) * stride + c];
+            acc[3][c] += in[(i + 3) * stride + c];
+        }
+    }
+    for (; i < count; ++i) {
+        for (size_t c = 0; c < dims; ++c) {
+            acc[0][c] += in[i * stride + c];
+        }
+    }
+    for (size_t c = 0; c < dims; ++c) {
+        sum[c] = (acc[0][c] + acc[1][c]) + (acc[2][c] + acc[3][c]);
+    }
+}
+
+// One double per component is already exact enough, no compensation needed
+inline void compensated_sum_scalar(const float *in, const size_t count, const size_t stride, const size_t dims,
+                                   float *sum, float *error) {
+    double total[4] = {};
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t c = 0; c < dims; ++c) {
+            total[c] += static_cast<double>(in[i * stride + c]);
+        }
+    }
+    split_compensated(total, dims, sum, error);
+}
+
+// `count` must not be 0
+inline void bounds_scalar(const float *in, const size_t count, const size_t stride, const size_t dims,
+                          float *low, float *high) {
+    for (size_t c = 0; c < dims; ++c) {
+        low[c] = in[c];
+        high[c] = in[c];
+    }
+    for (size_t i = 1; i < count; ++i) {
+        for (size_t c = 0; c < dims; ++c) {
+            low[c] = std::min(low[c], in[i * stride + c]);
+            high[c] = std::max(high[c], in[i * stride + c]);
+        }
+    }
+}
+
+// Sum of the outer products (v - mean)(v - mean)^T, row-major dims x dims
+inline void scatter_scalar(const float *in, const size_t count, const size_t stride, const size_t dims,
+                           const float *mean, float *out) {
+    float acc[4][4] = {};
+    for (size_t i = 0; i < count; ++i) {
+        float d[4];
+        for (size_t c = 0; c < dims; ++c) {
+            d[c] = in[i * stride + c] - mean[c];
+        }
+        for (size_t r = 0; r < dims; ++r) {
+            for (size_t c = r; c < dims; ++c) {
+                acc[r][c] += d[r] * d[c];
+            }
+        }
+    }
+    for (size_t r = 0; r < dims; ++r) {
+        for (size_t c = r; c < dims; ++c) {
+            out[r * dims + c] = acc[r][c];
+            out[c * dims + r] = acc[r][c];
+        }
+    }
+}
+
+#if defined(MIA_BATCH_DISPATCH)
+
+// :: SSE4.1, 24 floats per iteration
+MIA_TARGET("sse4.1")
+inline void sum_sse4_1(const float *in, const size_t count, const size_t stride, const size_t dims, float *sum) {
+    constexpr size_t block = reduce_registers * 4;
+    const size_t n = count * stride;
+    __m128 acc[reduce_registers];
+    for (__m128 &a : acc) {
+        a = _mm_setzero_ps();
+    }
+    size_t i = 0;
+    for (; i + block <= n; i += block) {
+        acc[0] = _mm_add_ps(acc[0], _mm_loadu_ps(in + i + 0));
+        acc[1] = _mm_add_ps(acc[1], _mm_loadu_ps(in + i + 4));
+        acc[2] = _mm_add_ps(acc[2], _mm_loadu_ps(in + i + 8));
+        acc[3] = _mm_add_ps(acc[3], _mm_loadu_ps(in + i + 12));
+        acc[4] = _mm_add_ps(acc[4], _mm_loadu_ps(in + i + 16));
+        acc[5] = _mm_add_ps(acc[5], _mm_loadu_ps(in + i + 20));
+    }
+    alignas(16) float lanes[block];
+    for (size_t k = 0; k < reduce_registers; ++k) {
+        _mm_store_ps(lanes + 4 * k, acc[k]);
+    }
+    fold_sum(lanes, block, in + i, n - i, stride, dims, sum);
+}
+
+MIA_TARGET("sse4.1")
+inline void neumaier_add_sse4_1(__m128 &sum, __m128 &error, const __m128 x) {
+    const __m128 magnitude = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 t = _mm_add_ps(sum, x);
+    const __m128 sum_larger = _mm_cmpge_ps(_mm_and_ps(sum, magnitude), _mm_and_ps(x, magnitude));
+    const __m128 larger = _mm_blendv_ps(x, sum, sum_larger);
+    const __m128 smaller = _mm_blendv_ps(sum, x, sum_larger);
+    error = _mm_add_ps(error, _mm_add_ps(_mm_sub_ps(larger, t), smaller));
+    sum = t;
+}
+
+MIA_TARGET("sse4.1")
+inline void compensated_sum_sse4_1(const float *in, const size_t count, const size_t stride, const size_t dims,
+                                   float *sum, float *error) {
+    constexpr size_t block = reduce_registers * 4;
+    const size_t n = count * stride;
+    double totals[block] = {};
+    alignas(16) float lane_sums[block];
+    alignas(16) float lane_errors[block];
+    size_t i = 0;
+    while (i + block <= n) {
+        __m128 sums[reduce_registers];
+        __m128 errors[reduce_registers];
+        for (size_t k = 0; k < reduce_registers; ++k) {
+            sums[k] = _mm_setzero_ps();
+            errors[k] = _mm_setzero_ps();
+        }
+        for (size_t b = 0; b < compensated_flush && i + block <= n; ++b, i += block) {
+            for (size_t k = 0; k < reduce_registers; ++k) {
+                neumaier_add_sse4_1(sums[k], errors[k], _mm_loadu_ps(in + i + 4 * k));
+            }
+        }
+        for (size_t k = 0; k < reduce_registers; ++k) {
+            _mm_store_ps(lane_sums + 4 * k, sums[k]);
+            _mm_store_ps(lane_errors + 4 * k, errors[k]);
+        }
+        flush_compensated(lane_sums, lane_errors, block, totals);
+    }
+    fold_compensated(totals, block, in + i, n - i, stride, dims, sum, error);
+}
+
+MIA_TARGET("sse4.1")
+inline void bounds_sse4_1(const float *in, const size_t count, const size_t stride, const size_t dims,
+                          float *low, float *high) {
+    constexpr size_t block = reduce_registers * 4;
+    const size_t n = count * stride;
+    __m128 lows[reduce_registers];
+    __m128 highs[reduce_registers];
+    for (size_t k = 0; k < reduce_registers; ++k) {
+        lows[k] = _mm_set1_ps(std::numeric_limits<float>::infinity());
+        highs[k] = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+    }
+    size_t i = 0;
+    for (; i + block <= n; i += block) {
+        for (size_t k = 0; k < reduce_registers; ++k) {
+            const __m128 v = _mm_loadu_ps(in + i + 4 * k);
+            lows[k] = _mm_min_ps(lows[k], v);
+            highs[k] = _mm_max_ps(highs[k], v);
+        }
+    }
+    alignas(16) float lane_low[block];
+    alignas(16) float lane_high[block];
+    for (size_t k = 0; k < reduce_registers; ++k) {
+        _mm_store_ps(lane_low + 4 * k, lows[k]);
+        _mm_store_ps(lane_high + 4 * k, highs[k]);
+    }
+    fold_bounds(lane_low, lane_high, block, in + i, n - i, stride, dims, low, high);
+}
+
+// One vector per iteration, row r of the outer product in rows[r]; lanes past `dims` are ignored
+// Loading 4 floats from an unpadded vector reads into the next one, so the last vector goes scalar
+MIA_TARGET("sse4.1")
+inline void scatter_sse4_1(const float *in, const size_t count, const size_t stride, const size_t dims,
+                           const float *mean, float *out) {
+    const size_t vector_count = (stride == 4) ? count : (count > 0 ? count - 1 : 0);
+    alignas(16) float m[4] = {};
+    for (size_t c = 0; c < dims; ++c) {
+        m[c] = mean[c];
+    }
+    const __m128 mean_v = _mm_load_ps(m);
+    __m128 rows[4] = {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+    for (size_t i = 0; i < vector_count; ++i) {
+        const __m128 d = _mm_sub_ps(_mm_loadu_ps(in + i * stride), mean_v);
+        rows[0] = _mm_add_ps(rows[0], _mm_mul_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(0, 0, 0, 0))));
+        rows[1] = _mm_add_ps(rows[1], _mm_mul_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 1, 1, 1))));
+        rows[2] = _mm_add_ps(rows[2], _mm_mul_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 2, 2, 2))));
+        rows[3] = _mm_add_ps(rows[3], _mm_mul_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(3, 3, 3, 3))));
+    }
+    scatter_scalar(in + vector_count * stride, count - vector_count, stride, dims, mean, out);
+    alignas(16) float row[4];
+    for (size_t r = 0; r < dims; ++r) {
+        _mm_store_ps(row, rows[r]);
+        for (size_t c = 0; c < dims; ++c) {
+            out[r * dims + c] += row[c];
+        }
+    }
+}
+
+// :: AVX2, 48 floats per iteration; the scatter gathers 8 vectors like the dot product
+MIA_TARGET("avx2")
+inline void sum_avx2(const float *in, const size_t count, const size_t stride, const size_t dims, float *sum) {
+    constexpr size_t block = reduce_registers * 8;
+    const size_t n = count * stride;
+    __m256 acc[reduce_registers];
+    for (__m256 &a : acc) {
+        a = _mm256_setzero_ps();
+    }
+    size_t i = 0;
+    for (; i + block <= n; i += block) {
+        acc[0] = _mm256_add_ps(acc[0], _mm256_loadu_ps(in + i + 0));
+        acc[1] = _mm256_add_ps(acc[1], _mm256_loadu_ps(in + i + 8));
+        acc[2] = _mm256_add_ps(acc[2], _mm256_loadu_ps(in + i + 16));
+        acc[3] = _mm256_add_ps(acc[3], _mm256_loadu_ps(in + i + 24));
+        acc[4] = _mm256_add_ps(acc[4], _mm256_loadu_ps(in + i + 32));
+        acc[5] = _mm256_add_ps(acc[5], _mm256_loadu_ps(in + i + 40));
+    }
+    alignas(32) float lanes[block];
+    for (size_t k = 0; k < reduce_registers; ++k) {
+        _mm256_store_ps(lanes + 8 * k, acc[k]);
+    }
+    fold_sum(lanes, block, in + i, n - i, stride, dims, sum);
+}
+
+MIA_TARGET("avx2")
+inline void neumaier_add_avx2(__m256 &sum, __m256 &error, const __m256 x) {
+    const __m256 magnitude = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 t = _mm256_add_ps(sum, x);
+    const __m256 sum_larger = _mm256_cmp_ps(_mm256_and_ps(sum, magnitude), _mm256_and_ps(x, magnitude), _CMP_GE_OQ);
+    const __m256 larger = _mm256_blendv_ps(x, sum, sum_larger);
+    const __m256 smaller = _mm256_blendv_ps(sum, x, sum_larger);
+    error = _mm256_add_ps(error, _mm256_add_ps(_mm256_sub_ps(larger, t), smaller));
+    sum = t;
+}
+
+MIA_TARGET("avx2")
+inline void compensated_sum_avx2(const float *in, const size_t count, const size_t stride, const size_t dims,
+                                 float *sum, float *error) {
+    constexpr size_t block = reduce_registers * 8;
+    const size_t n = count * stride;
+    double totals[block] = {};
+    alignas(32) float lane_sums[block];
+    alignas(32) float lane_errors[block];
+    size_t i = 0;
+    while (i + block <= n) {
+        __m256 sums[reduce_registers];
+        __m256 errors[reduce_registers];
+        for (size_t k = 0; k < reduce_registers; ++k) {
+            sums[k] = _mm256_setzero_ps();
+            errors[k] = _mm256_setzero_ps();
+        }
+        for (size_t b = 0; b < compensated_flush && i + block <= n; ++b, i += block) {
+            for (size_t k = 0; k < reduce_registers; ++k) {
+                neumaier_add_avx2(sums[k], errors[k], _mm256_loadu_ps(in + i + 8 * k));
+            }
+        }
+        for (size_t k = 0; k < reduce_registers; ++k) {
+            _mm256_store_ps(lane_sums + 8 * k, sums[k]);
+            _mm256_store_ps(lane_errors + 8 * k, errors[k]);
+        }
+        flush_compensated(lane_sums, lane_errors, block, totals);
+    }
+    fold_compensated(totals, block, in + i, n - i, stride, dims, sum, error);
+}
+
+MIA_TARGET("avx2")
+inline void bounds_avx2(const float *in, const size_t count, const size_t stride, const size_t dims,
+                        float *low, float *high) {
+    constexpr size_t block = reduce_registers * 8;
+    const size_t n = count * stride;
+    __m256 lows[reduce_registers];
+    __m256 highs[reduce_registers];
+    for (size_t k = 0; k < reduce_registers; ++k) {
+        lows[k] = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+        highs[k] = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+    }
+    size_t i = 0;
+    for (; i + block <= n; i += block) {
+        for (size_t k = 0; k < reduce_registers; ++k) {
+            const __m256 v = _mm256_loadu_ps(in + i + 8 * k);
+            lows[k] = _mm256_min_ps(lows[k], v);
+            highs[k] = _mm256_max_ps(highs[k], v);
+        }
+    }
+    alignas(32) float lane_low[block];
+    alignas(32) float lane_high[block];
+    for (size_t k = 0; k < reduce_registers; ++k) {
+        _mm256_store_ps(lane_low + 8 * k, lows[k]);
+        _mm256_store_ps(lane_high + 8 * k, highs[k]);
+    }
+    fold_bounds(lane_low, lane_high, block, in + i, n - i, stride, dims, low, high);
+}
+
+// Upper triangle only, 10 accumulators at most
+MIA_TARGET("avx2,fma")
+inline void scatter_avx2(const float *in, const size_t count, const size_t stride, const size_t dims,
+                         const float *mean, float *out) {
+    const __m256i index = gather_index_avx2(stride);
+    __m256 m[4];
+    for (size_t c = 0; c < dims; ++c) {
+        m[c] = _mm256_set1_ps(mean[c]);
+    }
+    __m256 acc[10];
+    for (__m256 &a : acc) {
+        a = _mm256_setzero_ps();
+    }
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 d[4];
+        for (size_t c = 0; c < dims; ++c) {
+            d[c] = _mm256_sub_ps(_mm256_i32gather_ps(in + i * stride + c, index, 4), m[c]);
+        }
+        size_t k = 0;
+        for (size_t r = 0; r < dims; ++r) {
+            for (size_t c = r; c < dims; ++c, ++k) {
+                acc[k] = _mm256_fmadd_ps(d[r], d[c], acc[k]);
+            }
+        }
+    }
+    scatter_scalar(in + i * stride, count - i, stride, dims, mean, out);
+    alignas(32) float lanes[8];
+    size_t k = 0;
+    for (size_t r = 0; r < dims; ++r) {
+        for (size_t c = r; c < dims; ++c, ++k) {
+            _mm256_store_ps(lanes, acc[k]);
+            const float total = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+            out[r * dims + c] += total;
+            out[c * dims + r] = out[r * dims + c];
+        }
+    }
+}
+
+// :: AVX-512, 96 floats per iteration
+MIA_TARGET("avx512f")
+inline void sum_avx512(const float *in, const size_t count, const size_t stride, const size_t dims, float *sum) {
+    constexpr size_t block = reduce_registers * 16;
+    const size_t n = count * stride;
+    __m512 acc[reduce_registers];
+    for (__m512 &a : acc) {
+        a = _mm512_setzero_ps();
+    }
+    size_t i = 0;
+    for (; i + block <= n; i += block) {
+        acc[0] = _mm512_add_ps(acc[0], _mm512_loadu_ps(in + i + 0));
+        acc[1] = _mm512_add_ps(acc[1], _mm512_loadu_ps(in + i + 16));
+        acc[2] = _mm512_add_ps(acc[2], _mm512_loadu_ps(in + i + 32));
+        acc[3] = _mm512_add_ps(acc[3], _mm512_loadu_ps(in + i + 48));
+        acc[4] = _mm512_add_ps(acc[4], _mm512_loadu_ps(in + i + 64));
+        acc[5] = _mm512_add_ps(acc[5], _mm512_loadu_ps(in + i + 80));
+    }
+    alignas(64) float lanes[block];
+    for (size_t k = 0; k < reduce_registers; ++k) {
+        _mm512_store_ps(lanes + 16 * k, acc[k]);
+    }
+    fold_sum(lanes, block, in + i, n - i, stride, dims, sum);
+}
+
+MIA_TARGET("avx512f")
+inline void neumaier_add_avx512(__m512 &sum, __m512 &error, const __m512 x) {
+    const __m512 t = _mm512_add_ps(sum, x);
+    const __mmask16 sum_larger = _mm512_cmp_ps_mask(_mm512_abs_ps(sum), _mm512_abs_ps(x), _CMP_GE_OQ);
+    const __m512 larger = _mm512_mask_blend_ps(sum_larger, x, sum);
+    const __m512 smaller = _mm512_mask_blend_ps(sum_larger, sum, x);
+    error = _mm512_add_ps(error, _mm512_add_ps(_mm512_sub_ps(larger, t), smaller));
+    sum = t;
+}
+
+MIA_TARGET("avx512f")
+inline void compensated_sum_avx512(const float *in, const size_t count, const size_t stride, const size_t dims,
+                                   float *sum, float *error) {
+    constexpr size_t block = reduce_registers * 16;
+    const size_t n = count * stride;
+    double totals[block] = {};
+    alignas(64) float lane_sums[block];
+    alignas(64) float lane_errors[block];
+    size_t i = 0;
+    while (i + block <= n) {
+        __m512 sums[reduce_registers];
+        __m512 errors[reduce_registers];
+        for (size_t k = 0; k < reduce_registers; ++k) {
+            sums[k] = _mm512_setzero_ps();
+            errors[k] = _mm512_setzero_ps();
+        }
+        for (size_t b = 0; b < compensated_flush && i + block <= n; ++b, i += block) {
+            for (size_t k = 0; k < reduce_registers; ++k) {
+                neumaier_add_avx512(sums[k], errors[k], _mm512_loadu_ps(in + i + 16 * k));
+            }
+        }
+        for (size_t k = 0; k < reduce_registers; ++k) {
+            _mm512_store_ps(lane_sums + 16 * k, sums[k]);
+            _mm512_store_ps(lane_errors + 16 * k, errors[k]);
+        }
+        flush_compensated(lane_sums, lane_errors, block, totals);
+    }
+    fold_compensated(totals, block, in + i, n - i, stride, dims, sum, error);
+}
+
+MIA_TARGET("avx512f")
+inline void bounds_avx512(const float *in, const size_t count, const size_t stride, const size_t dims,
+                          float *low, float *high) {
+    constexpr size_t block = reduce_registers * 16;
+    const size_t n = count * stride;
+    __m512 lows[reduce_registers];
+    __m512 highs[reduce_registers];
+    for (size_t k = 0; k < reduce_registers; ++k) {
+        lows[k] = _mm512_set1_ps(std::numeric_limits<float>::infinity());
+        highs[k] = _mm512_set1_ps(-std::numeric_limits<float>::infinity());
+    }
+    size_t i = 0;
+    for (; i + block <= n; i += block) {
+        for (size_t k = 0; k < reduce_registers; ++k) {
+            const __m512 v = _mm512_loadu_ps(in + i + 16 * k);
+            lows[k] = _mm512_min_ps(lows[k], v);
+            highs[k] = _mm512_max_ps(highs[k], v);
+        }
+    }
+    alignas(64) float lane_low[block];
+    alignas(64) float lane_high[block];
+    for (size_t k = 0; k < reduce_registers; ++k) {
+        _mm512_store_ps(lane_low + 16 * k, lows[k]);
+        _mm512_store_ps(lane_high + 16 * k, highs[k]);
+    }
+    fold_bounds(lane_low, lane_high, block, in + i, n - i, stride, dims, low, high);
+}
+
+MIA_TARGET("avx512f")
+inline void scatter_avx512(const float *in, const size_t count, const size_t stride, const size_t dims,
+                           const float *mean, float *out) {
+    const __m512i index = gather_index_avx512(stride);
+    __m512 m[4];
+    for (size_t c = 0; c < dims; ++c) {
+        m[c] = _mm512_set1_ps(mean[c]);
+    }
+    __m512 acc[10];
+    for (__m512 &a : acc) {
+        a = _mm512_setzero_ps();
+    }
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 d[4];
+        for (size_t c = 0; c < dims; ++c) {
+            d[c] = _mm512_sub_ps(gather_ps_avx512(in + i * stride + c, index), m[c]);
+        }
+        size_t k = 0;
+        for (size_t r = 0; r < dims; ++r) {
+            for (size_t c = r; c < dims; ++c, ++k) {
+                acc[k] = _mm512_fmadd_ps(d[r], d[c], acc[k]);
+            }
+        }
+    }
+    scatter_scalar(in + i * stride, count - i, stride, dims, mean, out);
+    size_t k = 0;
+    for (size_t r = 0; r < dims; ++r) {
+        for (size_t c = r; c < dims; ++c, ++k) {
+            out[r * dims + c] += _mm512_reduce_add_ps(acc[k]);
+            out[c * dims + r] = out[r * dims + c];
+        }
+    }
+}
+
+#endif // MIA_BATCH_DISPATCH
+
+// NOTE: REDUCTION DISPATCH
+
+struct reduce_kernels {
+    isa level;
+    void (*sum)(const float *, size_t, size_t, size_t, float *);
+    void (*compensated_sum)(const float *, size_t, size_t, size_t, float *, float *);
+    void (*bounds)(const float *, size_t, size_t, size_t, float *, float *);
+    void (*scatter)(const float *, size_t, size_t, size_t, const float *, float *);
+};
+
+inline auto reduce_kernels_for(const isa level) -> reduce_kernels {
+    switch (level) {
+#if defined(MIA_BATCH_DISPATCH)
+    case isa::avx512:
+        return {isa::avx512, sum_avx512, compensated_sum_avx512, bounds_avx512, scatter_avx512};
+    case isa::avx2:
+        return {isa::avx2, sum_avx2, compensated_sum_avx2, bounds_avx2, scatter_avx2};
+    case isa::sse4_1:
+        return {isa::sse4_1, sum_sse4_1, compensated_sum_sse4_1, bounds_sse4_1, scatter_sse4_1};
+#endif
+    default:
+        return {isa::scalar, sum_scalar, compensated_sum_scalar, bounds_scalar, scatter_scalar};
+    }
+}
+
+// Same level as the float kernels
+inline auto active_reduce_kernels() -> const reduce_kernels & {
+    static const reduce_kernels kernels = reduce_kernels_for(active_level());
+    return kernels;
+}
+
+// Spans longer than this are halved, each half summed on its own, so rounding errors grow with
+// log2(count / pairwise_block) rather than with count
+constexpr size_t pairwise_block = 1024;
+
+template <typename R, typename F>
+inline auto pairwise(const size_t begin, const size_t end, const F &block) -> R {
+    if (end - begin <= pairwise_block) {
+        return block(begin, end);
+    }
+    const size_t middle = begin + (end - begin) / 2;
+    return R(pairwise<R>(begin, middle, block) + pairwise<R>(middle, end, block));
+}
+
+// A running sum & the rounding error it carries, merged without losing either
+template <typename T, size_t Dims>
+struct compensated {
+    vector<T, Dims> sum{};
+    vector<T, Dims> error{};
+
+    [[nodiscard]] auto value() const -> vector<T, Dims> {
+        return vector<T, Dims>(sum + error);
+    }
+
+    static auto merge(const compensated &lhs, const compensated &rhs) -> compensated {
+        compensated result = lhs;
+        for (size_t c = 0; c < Dims; ++c) {
+            neumaier_add(result.sum[c], result.error[c], rhs.sum[c]);
+            result.error[c] += rhs.error[c];
+        }
+        return result;
+    }
+};
+
+// In T: vector division goes through compute_type, float for every T
+template <typename T, size_t Dims>
+inline auto divide(vector<T, Dims> v, const size_t count) -> vector<T, Dims> {
+    for (size_t c = 0; c < Dims; ++c) {
+        v[c] /= static_cast<T>(count);
+    }
+    return v;
+}
+
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline auto compensated_sum(std::span<const vector<T, Dims>> in) -> compensated<T, Dims> {
+    compensated<T, Dims> result;
+    if constexpr (dispatched_v<T, Dims>) {
+        active_reduce_kernels().compensated_sum(components(in), in.size(), stride_v<T, Dims>, Dims,
+                                                result.sum.data.data(), result.error.data.data());
+    } else {
+        for (const vector<T, Dims> &v : in) {
+            for (size_t c = 0; c < Dims; ++c) {
+                neumaier_add(result.sum[c], result.error[c], v[c]);
+            }
+        }
+    }
+    return result;
+}
+
+// Sum of the outer products (v - mean)(v - mean)^T
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline auto scatter(std::span<const vector<T, Dims>> in, const vector<T, Dims> &mean) -> matrix<T, Dims, Dims> {
+    if constexpr (dispatched_v<T, Dims>) {
+        std::array<float, Dims * Dims> elements;
+        active_reduce_kernels().scatter(components(in), in.size(), stride_v<T, Dims>, Dims, mean.data.data(), elements.data());
+        return matrix<T, Dims, Dims>::from_rows(elements);
+    } else {
+        matrix<T, Dims, Dims> result;
+        for (const vector<T, Dims> &v : in) {
+            const vector<T, Dims> d = v - mean;
+            for (size_t c = 0; c < Dims; ++c) {
+                for (size_t r = 0; r < Dims; ++r) {
+                    result(r, c) += d[r] * d[c];
+                }
+            }
+        }
+        return result;
+    }
+}
+
+} // namespace detail
+
+// NOTE: REDUCTIONS
+// Float vectors with 2 to 4 components go through the dispatched kernels, any other through vector operations
+// Sums of floats are reassociated (the kernels keep many partial sums): the result may differ from a
+// sequential loop in the last bits, pairwise_sum & kahan_sum bound that error
+
+// :: Sum, in T: mind the overflow of small integer types
+template <typename T, size_t Dims>
+inline auto sum(std::span<const vector<T, Dims>> in) -> vector<T, Dims> {
+    if constexpr (detail::dispatched_v<T, Dims>) {
+        vector<T, Dims> result;
+        detail::active_reduce_kernels().sum(detail::components(in), in.size(), detail::stride_v<T, Dims>, Dims,
+                                            result.data.data());
+        return result;
+    } else {
+        vector<T, Dims> acc[4] = {};
+        size_t i = 0;
+        for (; i + 4 <= in.size(); i += 4) {
+            acc[0] += in[i + 0];
+            acc[1] += in[i + 1];
+            acc[2] += in[i + 2];
+            acc[3] += in[i + 3];
+        }
+        for (; i < in.size(); ++i) {
+            acc[0] += in[i];
+        }
+        return vector<T, Dims>(acc[0] + acc[1]) + vector<T, Dims>(acc[2] + acc[3]);
+    }
+}
+
+// Recursive halves down to detail::pairwise_block vectors, then sum: about as fast, error in O(log n)
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline auto pairwise_sum(std::span<const vector<T, Dims>> in) -> vector<T, Dims> {
+    return detail::pairwise<vector<T, Dims>>(0, in.size(), [&](const size_t begin, const size_t end) {
+        return sum(in.subspan(begin, end - begin));
+    });
+}
+
+// Compensated (Neumaier's Kahan variant), error independent of the count, about 4 times the work of sum
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline auto kahan_sum(std::span<const vector<T, Dims>> in) -> vector<T, Dims> {
+    return detail::compensated_sum(in).value();
+}
+
+// Centroid, from the pairwise sum. `in` must not be empty
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline auto mean(std::span<const vector<T, Dims>> in) -> vector<T, Dims> {
+    assert(!in.empty());
+    return detail::divide(pairwise_sum(in), in.size());
+}
+
+// :: Min & Max, `in` must not be empty
+template <typename T, size_t Dims>
+inline auto min(std::span<const vector<T, Dims>> in) -> vector<T, Dims> {
+    assert(!in.empty());
+    vector<T, Dims> acc[4] = {in[0], in[0], in[0], in[0]};
+    size_t i = 1;
+    for (; i + 4 <= in.size(); i += 4) {
+        acc[0] = vector<T, Dims>::min(acc[0], in[i + 0]);
+        acc[1] = vector<T, Dims>::min(acc[1], in[i + 1]);
+        acc[2] = vector<T, Dims>::min(acc[2], in[i + 2]);
+        acc[3] = vector<T, Dims>::min(acc[3], in[i + 3]);
+    }
+    for (; i < in.size(); ++i) {
+        acc[0] = vector<T, Dims>::min(acc[0], in[i]);
+    }
+    return vector<T, Dims>::min(vector<T, Dims>::min(acc[0], acc[1]), vector<T, Dims>::min(acc[2], acc[3]));
+}
+template <typename T, size_t Dims>
+inline auto max(std::span<const vector<T, Dims>> in) -> vector<T, Dims> {
+    assert(!in.empty());
+    vector<T, Dims> acc[4] = {in[0], in[0], in[0], in[0]};
+    size_t i = 1;
+    for (; i + 4 <= in.size(); i += 4) {
+        acc[0] = vector<T, Dims>::max(acc[0], in[i + 0]);
+        acc[1] = vector<T, Dims>::max(acc[1], in[i + 1]);
+        acc[2] = vector<T, Dims>::max(acc[2], in[i + 2]);
+        acc[3] = vector<T, Dims>::max(acc[3], in[i + 3]);
+    }
+    for (; i < in.size(); ++i) {
+        acc[0] = vector<T, Dims>::max(acc[0], in[i]);
+    }
+    return vector<T, Dims>::max(vector<T, Dims>::max(acc[0], acc[1]), vector<T, Dims>::max(acc[2], acc[3]));
+}
+
+// :: Bounds, min & max in one pass; an empty aabb for an empty span
+template <typename T, size_t Dims>
+inline auto bounds(std::span<const vector<T, Dims>> in) -> aabb<T, Dims> {
+    if (in.empty()) {
+        return {};
+    }
+    aabb<T, Dims> box;
+    if constexpr (detail::dispatched_v<T, Dims>) {
+        detail::active_reduce_kernels().bounds(detail::components(in), in.size(), detail::stride_v<T, Dims>, Dims,
+                                               box.min.data.data(), box.max.data.data());
+    } else {
+        box = {in[0], in[0]};
+        for (size_t i = 1; i < in.size(); ++i) {
+            box.min = vector<T, Dims>::min(box.min, in[i]);
+            box.max = vector<T, Dims>::max(box.max, in[i]);
+        }
+    }
+    return box;
+}
+
+// :: Covariance, divided by the count (the population covariance: scale by n / (n - 1) for the sample one)
+// Two passes, the mean then the centered outer products summed pairwise. `in` must not be empty
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline auto covariance(std::span<const vector<T, Dims>> in) -> matrix<T, Dims, Dims> {
+    const vector<T, Dims> centroid = mean(in);
+    const auto scatter = detail::pairwise<matrix<T, Dims, Dims>>(0, in.size(), [&](const size_t begin, const size_t end) {
+        return detail::scatter(in.subspan(begin, end - begin), centroid);
+    });
+    return scatter * (T{1} / static_cast<T>(in.size()));
+}
+
+} // namespace mia::batch
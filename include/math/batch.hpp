@@ -0,0 +1,654 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "cpu-features.hpp"
+#include "matrix.hpp"
+#include "quaternion.hpp"
+#include "vector.hpp"
+
+namespace mia::batch {
+
+namespace detail {
+
+// NOTE: KERNELS
+// Float kernels work on the raw components of an array of mia::vector<float, Dims>
+// `stride` is the distance in floats between two vectors (Dims, or 4 when the SIMD layout pads)
+
+// :: Scalar, unrolled by 4
+inline void dot_scalar(const float *lhs, const float *rhs, float *out, const size_t count, const size_t stride, const size_t dims) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float acc[4] = {};
+        for (size_t c = 0; c < dims; ++c) {
+            acc[0] += lhs[(i + 0) * stride + c] * rhs[(i + 0) * stride + c];
+            acc[1] += lhs[(i + 1) * stride + c] * rhs[(i + 1) * stride + c];
+            acc[2] += lhs[(i + 2) * stride + c] * rhs[(i + 2) * stride + c];
+            acc[3] += lhs[(i + 3) * stride + c] * rhs[(i + 3) * stride + c];
+        }
+        out[i + 0] = acc[0];
+        out[i + 1] = acc[1];
+        out[i + 2] = acc[2];
+        out[i + 3] = acc[3];
+    }
+    for (; i < count; ++i) {
+        float acc = 0;
+        for (size_t c = 0; c < dims; ++c) {
+            acc += lhs[i * stride + c] * rhs[i * stride + c];
+        }
+        out[i] = acc;
+    }
+}
+
+inline void distance_squared_scalar(const float *lhs, const float *rhs, float *out, const size_t count, const size_t stride, const size_t dims) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float acc[4] = {};
+        for (size_t c = 0; c < dims; ++c) {
+            for (size_t k = 0; k < 4; ++k) {
+                const float d = rhs[(i + k) * stride + c] - lhs[(i + k) * stride + c];
+                acc[k] += d * d;
+            }
+        }
+        for (size_t k = 0; k < 4; ++k) {
+            out[i + k] = acc[k];
+        }
+    }
+    for (; i < count; ++i) {
+        float acc = 0;
+        for (size_t c = 0; c < dims; ++c) {
+            const float d = rhs[i * stride + c] - lhs[i * stride + c];
+            acc += d * d;
+        }
+        out[i] = acc;
+    }
+}
+
+inline void normalize_scalar(const float *in, float *out, const size_t count, const size_t stride, const size_t dims) {
+    for (size_t i = 0; i < count; ++i) {
+        float magnitude_squared = 0;
+        for (size_t c = 0; c < dims; ++c) {
+            magnitude_squared += in[i * stride + c] * in[i * stride + c];
+        }
+        const float inv_magnitude = 1 / std::sqrt(magnitude_squared);
+        for (size_t c = 0; c < dims; ++c) {
+            out[i * stride + c] = in[i * stride + c] * inv_magnitude;
+        }
+    }
+}
+
+// `n` is the number of floats, lerp is purely element-wise so padding lanes ride along
+inline void lerp_scalar(const float *from, const float *to, float *out, const size_t n, const float alpha) {
+    const float one_minus_alpha = 1.0f - alpha;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        out[i + 0] = one_minus_alpha * from[i + 0] + alpha * to[i + 0];
+        out[i + 1] = one_minus_alpha * from[i + 1] + alpha * to[i + 1];
+        out[i + 2] = one_minus_alpha * from[i + 2] + alpha * to[i + 2];
+        out[i + 3] = one_minus_alpha * from[i + 3] + alpha * to[i + 3];
+    }
+    for (; i < n; ++i) {
+        out[i] = one_minus_alpha * from[i] + alpha * to[i];
+    }
+}
+
+// `m` is a column-major 4x4. dims 4 takes w from the input, dims 3 uses `w` and writes rows 0-2 only
+// (the affine part, no perspective divide). Every component is read before the first write, so in == out is safe
+inline void transform_scalar(const float *m, const float *in, float *out, const size_t count, const size_t stride, const size_t dims, const float w) {
+    for (size_t i = 0; i < count; ++i) {
+        const float *v = in + i * stride;
+        const float x = v[0];
+        const float y = v[1];
+        const float z = v[2];
+        const float vw = dims == 4 ? v[3] : w;
+        float *o = out + i * stride;
+        for (size_t r = 0; r < dims; ++r) {
+            o[r] = m[r] * x + m[4 + r] * y + m[8 + r] * z + m[12 + r] * vw;
+        }
+    }
+}
+
+#if defined(MIA_BATCH_DISPATCH)
+
+// :: SSE4.1, one vector per _mm_dp_ps
+// Loading 4 floats from an unpadded vector reads into the next one, so the last vector goes scalar
+MIA_TARGET("sse4.1")
+inline auto dp_sse4_1(const __m128 a, const __m128 b, const size_t dims) -> __m128 {
+    switch (dims) {
+    case 2:
+        return _mm_dp_ps(a, b, 0x3F);
+    case 3:
+        return _mm_dp_ps(a, b, 0x7F);
+    default:
+        return _mm_dp_ps(a, b, 0xFF);
+    }
+}
+
+MIA_TARGET("sse4.1")
+inline void dot_sse4_1(const float *lhs, const float *rhs, float *out, const size_t count, const size_t stride, const size_t dims) {
+    const size_t vector_count = (stride == 4) ? count : (count > 0 ? count - 1 : 0);
+    for (size_t i = 0; i < vector_count; ++i) {
+        out[i] = _mm_cvtss_f32(dp_sse4_1(_mm_loadu_ps(lhs + i * stride), _mm_loadu_ps(rhs + i * stride), dims));
+    }
+    dot_scalar(lhs + vector_count * stride, rhs + vector_count * stride, out + vector_count, count - vector_count, stride, dims);
+}
+
+MIA_TARGET("sse4.1")
+inline void distance_squared_sse4_1(const float *lhs, const float *rhs, float *out, const size_t count, const size_t stride, const size_t dims) {
+    const size_t vector_count = (stride == 4) ? count : (count > 0 ? count - 1 : 0);
+    for (size_t i = 0; i < vector_count; ++i) {
+        const __m128 d = _mm_sub_ps(_mm_loadu_ps(rhs + i * stride), _mm_loadu_ps(lhs + i * stride));
+        out[i] = _mm_cvtss_f32(dp_sse4_1(d, d, dims));
+    }
+    distance_squared_scalar(lhs + vector_count * stride, rhs + vector_count * stride, out + vector_count, count - vector_count, stride, dims);
+}
+
+MIA_TARGET("sse4.1")
+inline void normalize_sse4_1(const float *in, float *out, const size_t count, const size_t stride, const size_t dims) {
+    const size_t vector_count = (stride == 4) ? count : (count > 0 ? count - 1 : 0);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (size_t i = 0; i < vector_count; ++i) {
+        const __m128 v = _mm_loadu_ps(in + i * stride);
+        const __m128 inv_magnitude = _mm_div_ps(one, _mm_sqrt_ps(dp_sse4_1(v, v, dims)));
+        const __m128 res = _mm_mul_ps(v, inv_magnitude);
+        if (stride == 4) {
+            _mm_storeu_ps(out + i * stride, res);
+        } else {
+            // A full store would clobber the next (not yet read) vector
+            alignas(16) float tmp[4];
+            _mm_store_ps(tmp, res);
+            for (size_t c = 0; c < dims; ++c) {
+                out[i * stride + c] = tmp[c];
+            }
+        }
+    }
+    normalize_scalar(in + vector_count * stride, out + vector_count * stride, count - vector_count, stride, dims);
+}
+
+MIA_TARGET("sse4.1")
+inline void lerp_sse4_1(const float *from, const float *to, float *out, const size_t n, const float alpha) {
+    const __m128 alpha_v = _mm_set1_ps(alpha);
+    const __m128 one_minus_alpha = _mm_set1_ps(1.0f - alpha);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(one_minus_alpha, _mm_loadu_ps(from + i)),
+                                          _mm_mul_ps(alpha_v, _mm_loadu_ps(to + i))));
+    }
+    lerp_scalar(from + i, to + i, out + i, n - i, alpha);
+}
+
+// Matrix columns, for dims 3 row 3 is dropped (the padding lane stays 0) and `w` is folded into column 3
+MIA_TARGET("sse4.1")
+inline void transform_columns_sse4_1(const float *m, const size_t dims, const float w, __m128 columns[4]) {
+    for (size_t c = 0; c < 4; ++c) {
+        columns[c] = _mm_loadu_ps(m + 4 * c);
+    }
+    if (dims == 3) {
+        const __m128 rows_0_2 = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+        for (size_t c = 0; c < 4; ++c) {
+            columns[c] = _mm_and_ps(columns[c], rows_0_2);
+        }
+        columns[3] = _mm_mul_ps(columns[3], _mm_set1_ps(w));
+    }
+}
+
+// One vector per iteration, only for the 4-float stride (padded vector<float, 3> or vector<float, 4>)
+MIA_TARGET("sse4.1")
+inline void transform_sse4_1(const float *m, const float *in, float *out, const size_t count, const size_t stride, const size_t dims, const float w) {
+    if (stride != 4) {
+        transform_scalar(m, in, out, count, stride, dims, w);
+        return;
+    }
+    __m128 c[4];
+    transform_columns_sse4_1(m, dims, w, c);
+    for (size_t i = 0; i < count; ++i) {
+        const __m128 v = _mm_loadu_ps(in + 4 * i);
+        __m128 res = _mm_mul_ps(c[0], _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        res = _mm_add_ps(res, _mm_mul_ps(c[1], _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+        res = _mm_add_ps(res, _mm_mul_ps(c[2], _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+        res = _mm_add_ps(res, dims == 4 ? _mm_mul_ps(c[3], _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))) : c[3]);
+        _mm_storeu_ps(out + 4 * i, res);
+    }
+}
+
+// :: AVX2, 8 vectors per iteration, components are gathered out of the AoS
+MIA_TARGET("avx2")
+inline auto gather_index_avx2(const size_t stride) -> __m256i {
+    return _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride)));
+}
+
+MIA_TARGET("avx2,fma")
+inline void dot_avx2(const float *lhs, const float *rhs, float *out, const size_t count, const size_t stride, const size_t dims) {
+    const __m256i index = gather_index_avx2(stride);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const float *l = lhs + i * stride;
+        const float *r = rhs + i * stride;
+        __m256 acc = _mm256_mul_ps(_mm256_i32gather_ps(l, index, 4), _mm256_i32gather_ps(r, index, 4));
+        for (size_t c = 1; c < dims; ++c) {
+            acc = _mm256_fmadd_ps(_mm256_i32gather_ps(l + c, index, 4), _mm256_i32gather_ps(r + c, index, 4), acc);
+        }
+        _mm256_storeu_ps(out + i, acc);
+    }
+    dot_scalar(lhs + i * stride, rhs + i * stride, out + i, count - i, stride, dims);
+}
+
+MIA_TARGET("avx2,fma")
+inline void distance_squared_avx2(const float *lhs, const float *rhs, float *out, const size_t count, const size_t stride, const size_t dims) {
+    const __m256i index = gather_index_avx2(stride);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const float *l = lhs + i * stride;
+        const float *r = rhs + i * stride;
+        __m256 acc = _mm256_setzero_ps();
+        for (size_t c = 0; c < dims; ++c) {
+            const __m256 d = _mm256_sub_ps(_mm256_i32gather_ps(r + c, index, 4), _mm256_i32gather_ps(l + c, index, 4));
+            acc = _mm256_fmadd_ps(d, d, acc);
+        }
+        _mm256_storeu_ps(out + i, acc);
+    }
+    distance_squared_scalar(lhs + i * stride, rhs + i * stride, out + i, count - i, stride, dims);
+}
+
+// AVX2 has no scatter, the reciprocal magnitudes are computed 8-wide and applied per vector
+MIA_TARGET("avx2,fma")
+inline void normalize_avx2(const float *in, float *out, const size_t count, const size_t stride, const size_t dims) {
+    const __m256i index = gather_index_avx2(stride);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    alignas(32) float inv_magnitude[8];
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const float *src = in + i * stride;
+        __m256 magnitude_squared = _mm256_setzero_ps();
+        for (size_t c = 0; c < dims; ++c) {
+            const __m256 v = _mm256_i32gather_ps(src + c, index, 4);
+            magnitude_squared = _mm256_fmadd_ps(v, v, magnitude_squared);
+        }
+        _mm256_store_ps(inv_magnitude, _mm256_div_ps(one, _mm256_sqrt_ps(magnitude_squared)));
+        for (size_t k = 0; k < 8; ++k) {
+            for (size_t c = 0; c < dims; ++c) {
+                out[(i + k) * stride + c] = src[k * stride + c] * inv_magnitude[k];
+            }
+        }
+    }
+    normalize_scalar(in + i * stride, out + i * stride, count - i, stride, dims);
+}
+
+MIA_TARGET("avx2")
+inline void lerp_avx2(const float *from, const float *to, float *out, const size_t n, const float alpha) {
+    const __m256 alpha_v = _mm256_set1_ps(alpha);
+    const __m256 one_minus_alpha = _mm256_set1_ps(1.0f - alpha);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(one_minus_alpha, _mm256_loadu_ps(from + i)),
+                                                _mm256_mul_ps(alpha_v, _mm256_loadu_ps(to + i))));
+    }
+    lerp_scalar(from + i, to + i, out + i, n - i, alpha);
+}
+
+// Two vectors per __m256, the matrix columns are repeated in both halves
+MIA_TARGET("avx2")
+inline void transform_avx2(const float *m, const float *in, float *out, const size_t count, const size_t stride, const size_t dims, const float w) {
+    if (stride != 4) {
+        transform_scalar(m, in, out, count, stride, dims, w);
+        return;
+    }
+    __m128 columns[4];
+    transform_columns_sse4_1(m, dims, w, columns);
+    __m256 c[4];
+    for (size_t k = 0; k < 4; ++k) {
+        c[k] = _mm256_set_m128(columns[k], columns[k]);
+    }
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m256 v = _mm256_loadu_ps(in + 4 * i);
+        __m256 res = _mm256_mul_ps(c[0], _mm256_permute_ps(v, 0x00));
+        res = _mm256_add_ps(res, _mm256_mul_ps(c[1], _mm256_permute_ps(v, 0x55)));
+        res = _mm256_add_ps(res, _mm256_mul_ps(c[2], _mm256_permute_ps(v, 0xaa)));
+        res = _mm256_add_ps(res, dims == 4 ? _mm256_mul_ps(c[3], _mm256_permute_ps(v, 0xff)) : c[3]);
+        _mm256_storeu_ps(out + 4 * i, res);
+    }
+    transform_sse4_1(m, in + 4 * i, out + 4 * i, count - i, stride, dims, w);
+}
+
+// :: AVX-512, 16 vectors per iteration with gather & scatter
+MIA_TARGET("avx512f")
+inline auto gather_index_avx512(const size_t stride) -> __m512i {
+    return _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                              _mm512_set1_epi32(static_cast<int>(stride)));
+}
+
+// Full-width gather & scatter of 16 floats at base + index, see mia::detail::gather_avx512
+MIA_TARGET("avx512f")
+inline auto gather_ps_avx512(const float *base, const __m512i index) -> __m512 {
+    return mia::detail::gather_avx512(base, index);
+}
+
+MIA_TARGET("avx512f")
+inline void scatter_ps_avx512(float *base, const __m512i index, const __m512 v) {
+    mia::detail::scatter_avx512(base, index, v);
+}
+
+MIA_TARGET("avx512f")
+inline void dot_avx512(const float *lhs, const float *rhs, float *out, const size_t count, const size_t stride, const size_t dims) {
+    const __m512i index = gather_index_avx512(stride);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const float *l = lhs + i * stride;
+        const float *r = rhs + i * stride;
+        __m512 acc = _mm512_mul_ps(gather_ps_avx512(l, index), gather_ps_avx512(r, index));
+        for (size_t c = 1; c < dims; ++c) {
+            acc = _mm512_fmadd_ps(gather_ps_avx512(l + c, index), gather_ps_avx512(r + c, index), acc);
+        }
+        _mm512_storeu_ps(out + i, acc);
+    }
+    dot_scalar(lhs + i * stride, rhs + i * stride, out + i, count - i, stride, dims);
+}
+
+MIA_TARGET("avx512f")
+inline void distance_squared_avx512(const float *lhs, const float *rhs, float *out, const size_t count, const size_t stride, const size_t dims) {
+    const __m512i index = gather_index_avx512(stride);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const float *l = lhs + i * stride;
+        const float *r = rhs + i * stride;
+        __m512 acc = _mm512_setzero_ps();
+        for (size_t c = 0; c < dims; ++c) {
+            const __m512 d = _mm512_sub_ps(gather_ps_avx512(r + c, index), gather_ps_avx512(l + c, index));
+            acc = _mm512_fmadd_ps(d, d, acc);
+        }
+        _mm512_storeu_ps(out + i, acc);
+    }
+    distance_squared_scalar(lhs + i * stride, rhs + i * stride, out + i, count - i, stride, dims);
+}
+
+MIA_TARGET("avx512f")
+inline void normalize_avx512(const float *in, float *out, const size_t count, const size_t stride, const size_t dims) {
+    const __m512i index = gather_index_avx512(stride);
+    const __m512 one = _mm512_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        // Every component is gathered before the first scatter, so in == out is safe
+        __m512 components[4];
+        __m512 magnitude_squared = _mm512_setzero_ps();
+        for (size_t c = 0; c < dims; ++c) {
+            components[c] = gather_ps_avx512(in + i * stride + c, index);
+            magnitude_squared = _mm512_fmadd_ps(components[c], components[c], magnitude_squared);
+        }
+        const __m512 inv_magnitude = _mm512_div_ps(one, _mm512_sqrt_ps(magnitude_squared));
+        for (size_t c = 0; c < dims; ++c) {
+            scatter_ps_avx512(out + i * stride + c, index, _mm512_mul_ps(components[c], inv_magnitude));
+        }
+    }
+    normalize_scalar(in + i * stride, out + i * stride, count - i, stride, dims);
+}
+
+MIA_TARGET("avx512f")
+inline void lerp_avx512(const float *from, const float *to, float *out, const size_t n, const float alpha) {
+    const __m512 alpha_v = _mm512_set1_ps(alpha);
+    const __m512 one_minus_alpha = _mm512_set1_ps(1.0f - alpha);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(out + i, _mm512_add_ps(_mm512_mul_ps(one_minus_alpha, _mm512_loadu_ps(from + i)),
+                                                _mm512_mul_ps(alpha_v, _mm512_loadu_ps(to + i))));
+    }
+    lerp_scalar(from + i, to + i, out + i, n - i, alpha);
+}
+
+// Four vectors per __m512 for the 4-float stride, gather & scatter for the unpadded vector<float, 3>
+MIA_TARGET("avx512f")
+inline void transform_avx512(const float *m, const float *in, float *out, const size_t count, const size_t stride, const size_t dims, const float w) {
+    if (stride == 4) {
+        __m128 columns[4];
+        transform_columns_sse4_1(m, dims, w, columns);
+        __m512 c[4];
+        for (size_t k = 0; k < 4; ++k) {
+            c[k] = _mm512_broadcast_f32x4(columns[k]);
+        }
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m512 v = _mm512_loadu_ps(in + 4 * i);
+            __m512 res = _mm512_mul_ps(c[0], _mm512_permute_ps(v, 0x00));
+            res = _mm512_add_ps(res, _mm512_mul_ps(c[1], _mm512_permute_ps(v, 0x55)));
+            res = _mm512_add_ps(res, _mm512_mul_ps(c[2], _mm512_permute_ps(v, 0xaa)));
+            res = _mm512_add_ps(res, dims == 4 ? _mm512_mul_ps(c[3], _mm512_permute_ps(v, 0xff)) : c[3]);
+            _mm512_storeu_ps(out + 4 * i, res);
+        }
+        transform_sse4_1(m, in + 4 * i, out + 4 * i, count - i, stride, dims, w);
+        return;
+    }
+    const __m512i index = gather_index_avx512(stride);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const float *v = in + i * stride;
+        const __m512 x = gather_ps_avx512(v + 0, index);
+        const __m512 y = gather_ps_avx512(v + 1, index);
+        const __m512 z = gather_ps_avx512(v + 2, index);
+        const __m512 vw = dims == 4 ? gather_ps_avx512(v + 3, index) : _mm512_set1_ps(w);
+        __m512 rows[4];
+        for (size_t r = 0; r < dims; ++r) {
+            rows[r] = _mm512_mul_ps(_mm512_set1_ps(m[r]), x);
+            rows[r] = _mm512_fmadd_ps(_mm512_set1_ps(m[4 + r]), y, rows[r]);
+            rows[r] = _mm512_fmadd_ps(_mm512_set1_ps(m[8 + r]), z, rows[r]);
+            rows[r] = _mm512_fmadd_ps(_mm512_set1_ps(m[12 + r]), vw, rows[r]);
+        }
+        for (size_t r = 0; r < dims; ++r) {
+            scatter_ps_avx512(out + i * stride + r, index, rows[r]);
+        }
+    }
+    transform_scalar(m, in + i * stride, out + i * stride, count - i, stride, dims, w);
+}
+
+#endif // MIA_BATCH_DISPATCH
+
+// NOTE: DISPATCH
+
+struct float_kernels {
+    isa level;
+    void (*dot)(const float *, const float *, float *, size_t, size_t, size_t);
+    void (*distance_squared)(const float *, const float *, float *, size_t, size_t, size_t);
+    void (*normalize)(const float *, float *, size_t, size_t, size_t);
+    void (*lerp)(const float *, const float *, float *, size_t, float);
+    void (*transform)(const float *, const float *, float *, size_t, size_t, size_t, float);
+};
+
+inline auto kernels_for(const isa level) -> float_kernels {
+    switch (level) {
+#if defined(MIA_BATCH_DISPATCH)
+    case isa::avx512:
+        return {isa::avx512, dot_avx512, distance_squared_avx512, normalize_avx512, lerp_avx512, transform_avx512};
+    case isa::avx2:
+        return {isa::avx2, dot_avx2, distance_squared_avx2, normalize_avx2, lerp_avx2, transform_avx2};
+    case isa::sse4_1:
+        return {isa::sse4_1, dot_sse4_1, distance_squared_sse4_1, normalize_sse4_1, lerp_sse4_1, transform_sse4_1};
+#endif
+    default:
+        return {isa::scalar, dot_scalar, distance_squared_scalar, normalize_scalar, lerp_scalar, transform_scalar};
+    }
+}
+
+// Selected once, on first use, at active_level()
+inline auto active_kernels() -> const float_kernels & {
+    static const float_kernels kernels = kernels_for(active_level());
+    return kernels;
+}
+
+template <typename T, size_t Dims>
+constexpr size_t stride_v = sizeof(vector<T, Dims>) / sizeof(T);
+
+template <typename T, size_t Dims>
+constexpr bool dispatched_v = std::is_same_v<T, float> && Dims >= 2 && Dims <= 4;
+
+template <typename T, size_t Dims>
+inline auto components(std::span<const vector<T, Dims>> s) noexcept -> const T * {
+    return s.empty() ? nullptr : s.front().data.data();
+}
+template <typename T, size_t Dims>
+inline auto components(std::span<vector<T, Dims>> s) noexcept -> T * {
+    return s.empty() ? nullptr : s.front().data.data();
+}
+
+// Column-major floats of a 4x4, whatever the column padding
+inline auto matrix_elements(const matrix<float, 4, 4> &m) noexcept -> std::array<float, 16> {
+    std::array<float, 16> elements;
+    for (size_t c = 0; c < 4; ++c) {
+        for (size_t r = 0; r < 4; ++r) {
+            elements[c * 4 + r] = m(r, c);
+        }
+    }
+    return elements;
+}
+
+} // namespace detail
+
+// NOTE: BATCH OPERATIONS
+// Every output span must be at least as long as the inputs; `out` may alias an input of the same type
+
+// :: Element-wise transform, unrolled by 4
+template <typename T, size_t Dims, typename Op>
+inline void transform(std::span<const vector<T, Dims>> in, std::span<vector<T, Dims>> out, Op op) {
+    assert(out.size() >= in.size());
+    const size_t count = in.size();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        out[i + 0] = op(in[i + 0]);
+        out[i + 1] = op(in[i + 1]);
+        out[i + 2] = op(in[i + 2]);
+        out[i + 3] = op(in[i + 3]);
+    }
+    for (; i < count; ++i) {
+        out[i] = op(in[i]);
+    }
+}
+
+// Dot product
+template <typename T, size_t Dims>
+inline void dot(std::span<const vector<T, Dims>> lhs,
+                std::span<const vector<T, Dims>> rhs,
+                std::span<typename vector<T, Dims>::compute_type> out) {
+    assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+    if constexpr (detail::dispatched_v<T, Dims>) {
+        detail::active_kernels().dot(detail::components(lhs), detail::components(rhs), out.data(),
+                                     lhs.size(), detail::stride_v<T, Dims>, Dims);
+    } else {
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            out[i] = vector<T, Dims>::dot_product(lhs[i], rhs[i]);
+        }
+    }
+}
+
+// Distance & Distance squared
+template <typename T, size_t Dims>
+inline void distance_squared(std::span<const vector<T, Dims>> lhs,
+                             std::span<const vector<T, Dims>> rhs,
+                             std::span<typename vector<T, Dims>::compute_type> out) {
+    assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+    if constexpr (detail::dispatched_v<T, Dims>) {
+        detail::active_kernels().distance_squared(detail::components(lhs), detail::components(rhs), out.data(),
+                                                  lhs.size(), detail::stride_v<T, Dims>, Dims);
+    } else {
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            out[i] = vector<T, Dims>::distance_squared(lhs[i], rhs[i]);
+        }
+    }
+}
+template <typename T, size_t Dims>
+inline void distance(std::span<const vector<T, Dims>> lhs,
+                     std::span<const vector<T, Dims>> rhs,
+                     std::span<typename vector<T, Dims>::compute_type> out) {
+    using compute_type = typename vector<T, Dims>::compute_type;
+    distance_squared(lhs, rhs, out);
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        out[i] = static_cast<compute_type>(std::sqrt(out[i]));
+    }
+}
+
+// Normalize
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline void normalize(std::span<const vector<T, Dims>> in, std::span<vector<T, Dims>> out) {
+    assert(out.size() >= in.size());
+    if constexpr (detail::dispatched_v<T, Dims>) {
+        detail::active_kernels().normalize(detail::components(in), detail::components(out),
+                                           in.size(), detail::stride_v<T, Dims>, Dims);
+    } else {
+        transform(in, out, [](const vector<T, Dims> &v) { return v.normalized(); });
+    }
+}
+template <typename T, size_t Dims>
+    requires std::is_floating_point_v<T>
+inline void normalize(std::span<vector<T, Dims>> in_out) {
+    normalize(std::span<const vector<T, Dims>>(in_out), in_out);
+}
+
+// Lerp
+template <typename T, size_t Dims>
+inline void lerp(std::span<const vector<T, Dims>> from,
+                 std::span<const vector<T, Dims>> to,
+                 const typename vector<T, Dims>::compute_type alpha,
+                 std::span<vector<T, Dims>> out) {
+    assert(from.size() == to.size() && out.size() >= from.size());
+    if constexpr (detail::dispatched_v<T, Dims>) {
+        detail::active_kernels().lerp(detail::components(from), detail::components(to), detail::components(out),
+                                      from.size() * detail::stride_v<T, Dims>, alpha);
+    } else {
+        for (size_t i = 0; i < from.size(); ++i) {
+            out[i] = vector<T, Dims>::lerp(from[i], to[i], alpha);
+        }
+    }
+}
+
+// Matrix transform
+// vector<T, 4> through the whole 4x4
+template <typename T>
+inline void transform(const matrix<T, 4, 4> &m, std::span<const vector<T, 4>> in, std::span<vector<T, 4>> out) {
+    assert(out.size() >= in.size());
+    if constexpr (std::is_same_v<T, float>) {
+        const auto elements = detail::matrix_elements(m);
+        detail::active_kernels().transform(elements.data(), detail::components(in), detail::components(out),
+                                           in.size(), detail::stride_v<T, 4>, 4, 0.0f);
+    } else {
+        transform(in, out, [&m](const vector<T, 4> &v) { return m * v; });
+    }
+}
+// vector<T, 3> as points (w = 1) or directions (w = 0) through the affine part of a 4x4
+template <typename T>
+inline void transform_points(const matrix<T, 4, 4> &m, std::span<const vector<T, 3>> in, std::span<vector<T, 3>> out) {
+    assert(out.size() >= in.size());
+    if constexpr (std::is_same_v<T, float>) {
+        const auto elements = detail::matrix_elements(m);
+        detail::active_kernels().transform(elements.data(), detail::components(in), detail::components(out),
+                                           in.size(), detail::stride_v<T, 3>, 3, 1.0f);
+    } else {
+        transform(in, out, [&m](const vector<T, 3> &v) { return m.transform_point(v); });
+    }
+}
+template <typename T>
+inline void transform_directions(const matrix<T, 4, 4> &m, std::span<const vector<T, 3>> in, std::span<vector<T, 3>> out) {
+    assert(out.size() >= in.size());
+    if constexpr (std::is_same_v<T, float>) {
+        const auto elements = detail::matrix_elements(m);
+        detail::active_kernels().transform(elements.data(), detail::components(in), detail::components(out),
+                                           in.size(), detail::stride_v<T, 3>, 3, 0.0f);
+    } else {
+        transform(in, out, [&m](const vector<T, 3> &v) { return m.transform_direction(v); });
+    }
+}
+
+// Rotation by one quaternion, through its matrix and the transform kernels for float
+template <typename T>
+    requires std::is_floating_point_v<T>
+inline void rotate(const quaternion<T> &q, std::span<const vector<T, 3>> in, std::span<vector<T, 3>> out) {
+    if constexpr (std::is_same_v<T, float>) {
+        transform_directions<T>(q.to_matrix4(), in, out);
+    } else {
+        transform(in, out, [&q](const vector<T, 3> &v) { return q.rotate(v); });
+    }
+}
+
+} // namespace mia::batch
@@ -0,0 +1,618 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../arena/arena.hpp"
+#include "aabb.hpp"
+#include "thread-pool.hpp"
+#include "vector.hpp"
+
+namespace mia {
+
+// How a bvh is built, the defaults suit per-frame rebuilds of a few thousand to a few million primitives
+struct bvh_options {
+    uint32_t bins = 16;                // SAH candidate planes per axis are bins - 1, at most 64 bins
+    uint32_t max_leaf_size = 4;        // Leaves never hold more primitives than this
+    size_t threads = 0;                // Subtrees built at once in a parallel build, 0 for the size of its thread pool
+    size_t parallel_threshold = 4096;  // Ranges of fewer primitives are built by the task that split them
+    bool wide = false;                 // Also collapse the tree into 4-wide nodes, ray casts then run on those
+};
+
+// Bounding volume hierarchy over primitive bounds, built top-down with binned SAH
+// Primitives are known by their index in the span given to build(), the tree only stores their boxes.
+// Nodes are flattened depth-first: the left child follows its parent, so descending left never leaves the
+// cache line. Temporary build nodes come from arenas kept across rebuilds, one per concurrent subtree.
+// Parallel builds run on a thread_pool, its workers are reused by every split of every rebuild
+template <typename T = float, size_t Dims = 3>
+    requires std::is_floating_point_v<T> && (Dims == 2 || Dims == 3)
+class bvh {
+  public:
+    // NOTE: MEMBER TYPES
+
+    using value_type = T;
+    using vector_type = vector<T, Dims>;
+    using box_type = aabb<T, Dims>;
+    using ray_type = ray<T, Dims>;
+    using packet_type = aabb_packet<T, Dims, 4>;
+
+    static constexpr uint32_t invalid = std::numeric_limits<uint32_t>::max();
+
+    // Interior node: `offset` is the right child, the left one is the next node
+    // Leaf: `count` primitives from `offset` in primitive order, see indices()
+    struct node {
+        box_type bounds;
+        uint32_t offset;
+        uint16_t count;  // 0 for interior nodes
+        uint16_t axis;   // Split axis, the left child holds the lower centroids
+
+        [[nodiscard]] constexpr auto is_leaf() const -> bool { return count != 0; }
+    };
+
+    // Up to 4 children under one packet slab test, unused lanes are empty boxes with an invalid offset
+    struct wide_node {
+        packet_type bounds;
+        std::array<uint32_t, 4> offset{invalid, invalid, invalid, invalid};  // Wide node of an interior child, first primitive of a leaf
+        std::array<uint32_t, 4> count{};                                     // 0 for interior children
+    };
+
+    struct hit {
+        uint32_t index;
+        T t;
+    };
+    struct neighbour {
+        uint32_t index;
+        T distance_squared;
+    };
+
+    // NOTE: CONSTRUCTOR
+
+    bvh() = default;
+    // Copies share nothing, the scratch arenas are not copied
+    bvh(const bvh &other)
+        : nodes_(other.nodes_), wide_(other.wide_), order_(other.order_), primitives_(other.primitives_), depth_(other.depth_) {
+    }
+    auto operator=(const bvh &other) -> bvh & {
+        if (this != &other) {
+            nodes_ = other.nodes_;
+            wide_ = other.wide_;
+            order_ = other.order_;
+            primitives_ = other.primitives_;
+            depth_ = other.depth_;
+        }
+        return *this;
+    }
+    bvh(bvh &&other) noexcept = default;
+    auto operator=(bvh &&other) noexcept -> bvh & = default;
+
+    explicit bvh(std::span<const box_type> bounds, const bvh_options &options = {}) {
+        build(bounds, options);
+    }
+
+    // Points are degenerate boxes, nearest() is then an exact nearest neighbour search
+    static auto from_points(std::span<const vector_type> points, const bvh_options &options = {}) -> bvh {
+        std::vector<box_type> bounds(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            bounds[i] = box_type{points[i], points[i]};
+        }
+        return bvh{bounds, options};
+    }
+
+    // NOTE: BUILD
+
+    // Replace the tree, storage and scratch arenas are reused so a steady per-frame rebuild stops calling malloc
+    // Splits do not depend on the thread count: every build of the same bounds gives the same tree
+    // From parallel_threshold primitives on, the two halves of a split are built as tasks of `pool`
+    void build(thread_pool &pool, std::span<const box_type> bounds, const bvh_options &options = {}) {
+        build_tree(bounds, options, bounds.size() < options.parallel_threshold ? nullptr : &pool);
+    }
+    // On default_thread_pool(), only created once a build reaches parallel_threshold
+    void build(std::span<const box_type> bounds, const bvh_options &options = {}) {
+        build_tree(bounds, options, bounds.size() < options.parallel_threshold ? nullptr : &default_thread_pool());
+    }
+
+    // NOTE: CONST FUNCTIONS
+
+    [[nodiscard]] inline auto size() const -> size_t { return order_.size(); }
+    [[nodiscard]] inline auto empty() const -> bool { return order_.empty(); }
+    // Levels of the binary tree, 1 for a single leaf
+    [[nodiscard]] inline auto depth() const -> size_t { return depth_; }
+    [[nodiscard]] inline auto bounds() const -> box_type { return nodes_.empty() ? box_type{} : nodes_.front().bounds; }
+
+    [[nodiscard]] inline auto nodes() const -> std::span<const node> { return nodes_; }
+    // Empty unless built with bvh_options::wide
+    [[nodiscard]] inline auto wide_nodes() const -> std::span<const wide_node> { return wide_; }
+    // Primitive indices in leaf order
+    [[nodiscard]] inline auto indices() const -> std::span<const uint32_t> { return order_; }
+
+    // :: Ray cast
+    // Closest primitive box hit within [t_min, t_max]
+    [[nodiscard]] auto raycast(const ray_type &r, const T t_min = T{0}, const T t_max = std::numeric_limits<T>::infinity()) const
+        -> std::optional<hit> {
+        return closest_hit(
+            r, [&](const uint32_t position, const T t_limit) { return primitives_[position].intersect(r, t_min, t_limit); }, t_min,
+            t_max);
+    }
+    // Closest hit of `intersect(index, ray, t_max) -> std::optional<T>`, called on primitives whose box the ray
+    // enters before the closest hit found so far. Hits outside [t_min, t_max] are ignored
+    template <typename Intersect>
+        requires std::is_invocable_r_v<std::optional<T>, Intersect &, uint32_t, const ray_type &, T>
+    [[nodiscard]] auto raycast(const ray_type &r, Intersect &&intersect, const T t_min = T{0},
+                               const T t_max = std::numeric_limits<T>::infinity()) const -> std::optional<hit> {
+        return closest_hit(
+            r, [&](const uint32_t position, const T t_limit) { return std::optional<T>{intersect(order_[position], r, t_limit)}; },
+            t_min, t_max);
+    }
+
+    // :: Nearest neighbour
+    // Primitive whose box is closest to `point`, strictly under `max_distance_squared`
+    [[nodiscard]] auto nearest(const vector_type &point, const T max_distance_squared = std::numeric_limits<T>::infinity()) const
+        -> std::optional<neighbour> {
+        return closest_primitive(
+            point, [&](const uint32_t position) { return static_cast<T>(primitives_[position].distance_squared(point)); },
+            max_distance_squared);
+    }
+    // Same with the exact squared distance `distance_squared(index, point) -> T`, which must not be less than
+    // the distance to the primitive's box
+    template <typename Distance>
+        requires std::is_invocable_r_v<T, Distance &, uint32_t, const vector_type &>
+    [[nodiscard]] auto nearest(const vector_type &point, Distance &&distance_squared,
+                               const T max_distance_squared = std::numeric_limits<T>::infinity()) const -> std::optional<neighbour> {
+        return closest_primitive(
+            point, [&](const uint32_t position) { return static_cast<T>(distance_squared(order_[position], point)); },
+            max_distance_squared);
+    }
+
+    // :: Range queries
+    // Calls `visit(index)` for every primitive whose box overlaps `region`, returns how many
+    template <typename Visit>
+        requires std::is_invocable_v<Visit &, uint32_t>
+    auto query(const box_type &region, Visit &&visit) const -> size_t {
+        return visit_overlapping([&](const box_type &box) { return box.overlaps(region); }, visit);
+    }
+    // Calls `visit(index)` for every primitive whose box is within `radius` of `center`, returns how many
+    template <typename Visit>
+        requires std::is_invocable_v<Visit &, uint32_t>
+    auto query(const vector_type &center, const T radius, Visit &&visit) const -> size_t {
+        const T radius_squared = radius * radius;
+        return visit_overlapping([&](const box_type &box) { return static_cast<T>(box.distance_squared(center)) <= radius_squared; },
+                                 visit);
+    }
+
+  private:
+    static constexpr uint32_t max_bins = 64;
+    // Below this depth splits are SAH, deeper ones are object medians so depth stays under 32 + log2(size) + 1
+    static constexpr size_t sah_depth = 32;
+    static constexpr size_t stack_size = 3 * (sah_depth + 33) + 1;
+
+    // :: Build
+    struct build_node {
+        box_type bounds;
+        build_node *left;  // nullptr for leaves
+        build_node *right;
+        uint32_t first;
+        uint32_t count;
+        uint32_t axis;
+    };
+
+    // Bounds travel with the index through the partitions, so every pass over a range reads memory in order
+    struct build_primitive {
+        box_type bounds;
+        uint32_t index;
+
+        // Twice the box center, it is only compared and binned
+        [[nodiscard]] inline auto centroid() const -> vector_type { return bounds.min + bounds.max; }
+        [[nodiscard]] inline auto centroid(const size_t axis) const -> T { return bounds.min[axis] + bounds.max[axis]; }
+    };
+
+    // Shared by the build tasks, each one only touches its own range of `primitives` and its own arena
+    struct build_context {
+        std::span<build_primitive> primitives;
+        std::span<arena> arenas;
+        uint32_t bins;
+        uint32_t max_leaf_size;
+        size_t parallel_threshold;
+        thread_pool *pool;  // Null for a serial build
+    };
+
+    struct split {
+        T cost;
+        uint32_t axis;
+        uint32_t bin;  // Last bin on the left
+    };
+
+    static auto bin_of(const T centroid, const T lowest, const T scale, const uint32_t bins) -> uint32_t {
+        return std::min(static_cast<uint32_t>((centroid - lowest) * scale), bins - 1);
+    }
+
+    // Cheapest plane between bins, cost relative to intersecting one primitive (traversal step = 1)
+    // Every axis is binned in the same pass over the range
+    static auto find_split(const build_context &context, const uint32_t first, const uint32_t count, const uint32_t bins,
+                           const box_type &bounds, const box_type &centroid_bounds) -> split {
+        std::array<std::array<box_type, max_bins>, Dims> bin_bounds;
+        std::array<std::array<uint32_t, max_bins>, Dims> bin_counts;
+        std::array<T, Dims> scale;
+        for (size_t axis = 0; axis < Dims; ++axis) {
+            const T extent = centroid_bounds.max[axis] - centroid_bounds.min[axis];
+            scale[axis] = extent > 0 ? static_cast<T>(bins) / extent : T{0};
+            std::fill_n(bin_bounds[axis].begin(), bins, box_type{});
+            std::fill_n(bin_counts[axis].begin(), bins, 0u);
+        }
+        for (uint32_t i = first; i < first + count; ++i) {
+            const build_primitive &primitive = context.primitives[i];
+            for (size_t axis = 0; axis < Dims; ++axis) {
+                const uint32_t b = bin_of(primitive.centroid(axis), centroid_bounds.min[axis], scale[axis], bins);
+                bin_bounds[axis][b].expand(primitive.bounds);
+                ++bin_counts[axis][b];
+            }
+        }
+
+        split best{std::numeric_limits<T>::infinity(), 0, 0};
+        const T inverse_area = T{1} / bounds.surface_area();
+        std::array<T, max_bins> right_cost;
+        for (uint32_t axis = 0; axis < Dims; ++axis) {
+            if (!(scale[axis] > 0)) {
+                continue;
+            }
+            // right_cost[b]: area x count of bins [b, bins)
+            box_type right;
+            uint32_t right_count = 0;
+            for (uint32_t b = bins - 1; b > 0; --b) {
+                right.expand(bin_bounds[axis][b]);
+                right_count += bin_counts[axis][b];
+                right_cost[b] = right_count == 0 ? -T{1} : right.surface_area() * static_cast<T>(right_count);
+            }
+            box_type left;
+            uint32_t left_count = 0;
+            for (uint32_t b = 0; b + 1 < bins; ++b) {
+                left.expand(bin_bounds[axis][b]);
+                left_count += bin_counts[axis][b];
+                if (left_count == 0 || right_cost[b + 1] < 0) {
+                    continue;
+                }
+                const T cost = 1 + (left.surface_area() * static_cast<T>(left_count) + right_cost[b + 1]) * inverse_area;
+                if (cost < best.cost) {
+                    best = split{cost, axis, b};
+                }
+            }
+        }
+        return best;
+    }
+
+    // Tree over `bounds`, built on `pool` unless it is null
+    void build_tree(std::span<const box_type> bounds, const bvh_options &options, thread_pool *pool) {
+        assert(bounds.size() < invalid);
+        nodes_.clear();
+        wide_.clear();
+        order_.clear();
+        primitives_.clear();
+        depth_ = 0;
+        if (bounds.empty()) {
+            return;
+        }
+
+        const auto count = static_cast<uint32_t>(bounds.size());
+        const size_t workers = pool == nullptr ? 1 : (options.threads != 0 ? options.threads : pool->size());
+        if (scratch_.size() < workers) {
+            scratch_.resize(workers);
+        }
+
+        auto *build_primitives = scratch_[0].alloc_array_for_overwrite<build_primitive>(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            build_primitives[i] = build_primitive{bounds[i], i};
+        }
+
+        const build_context context{
+            std::span<build_primitive>{build_primitives, count},
+            std::span<arena>{scratch_.data(), workers},
+            std::clamp<uint32_t>(options.bins, 2, max_bins),
+            std::clamp<uint32_t>(options.max_leaf_size, 1, std::numeric_limits<uint16_t>::max()),
+            std::max<size_t>(options.parallel_threshold, 2),
+            pool,
+        };
+        const build_node *root = build_range(context, 0, count, 0, 0, workers);
+
+        nodes_.reserve(2 * static_cast<size_t>(count) - 1);
+        flatten(root, 1);
+        order_.resize(count);
+        primitives_.resize(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            order_[i] = build_primitives[i].index;
+            primitives_[i] = build_primitives[i].bounds;
+        }
+        if (options.wide) {
+            collapse(0);
+        }
+
+        for (arena &a : scratch_) {
+            a.reset();
+        }
+    }
+
+    static auto build_range(const build_context &context, const uint32_t first, const uint32_t count, const size_t depth,
+                            const size_t worker, const size_t workers) -> build_node * {
+        box_type bounds;
+        box_type centroid_bounds;
+        for (uint32_t i = first; i < first + count; ++i) {
+            bounds.expand(context.primitives[i].bounds);
+            centroid_bounds.expand(context.primitives[i].centroid());
+        }
+        auto *result = context.arenas[worker].template alloc<build_node>(build_node{bounds, nullptr, nullptr, first, count, 0});
+        if (count == 1) {
+            return result;
+        }
+
+        auto begin = context.primitives.begin() + first;
+        auto end = begin + count;
+        auto middle = begin + count / 2;
+        const auto axis = static_cast<uint32_t>(centroid_bounds.major_axis());
+        result->axis = axis;
+        if (!(centroid_bounds.max[axis] > centroid_bounds.min[axis])) {
+            // Coincident centroids, no plane separates them: any halves will do
+            if (count <= context.max_leaf_size) {
+                return result;
+            }
+        } else {
+            // Past sah_depth, or for flat sets where every area is 0, the object median on the longest axis
+            const bool use_sah = depth < sah_depth && bounds.surface_area() > 0;
+            // No more bins than primitives, small ranges are most of the nodes
+            const uint32_t bins = std::min(context.bins, count);
+            const split best = use_sah ? find_split(context, first, count, bins, bounds, centroid_bounds)
+                                       : split{std::numeric_limits<T>::infinity(), axis, 0};
+            if (best.cost < std::numeric_limits<T>::infinity()) {
+                if (count <= context.max_leaf_size && best.cost >= static_cast<T>(count)) {
+                    return result;
+                }
+                const T lowest = centroid_bounds.min[best.axis];
+                const T scale = static_cast<T>(bins) / (centroid_bounds.max[best.axis] - lowest);
+                middle = std::partition(begin, end, [&](const build_primitive &primitive) {
+                    return bin_of(primitive.centroid(best.axis), lowest, scale, bins) <= best.bin;
+                });
+                result->axis = best.axis;
+            } else {
+                std::nth_element(begin, middle, end, [&](const build_primitive &lhs, const build_primitive &rhs) {
+                    return lhs.centroid(axis) < rhs.centroid(axis);
+                });
+            }
+        }
+
+        const auto split_at = static_cast<uint32_t>(middle - context.primitives.begin());
+        if (workers > 1 && count >= context.parallel_threshold) {
+            // Both halves are pool tasks, the right one with the upper half of the arenas
+            const size_t half = workers / 2;
+            context.pool->parallel_for(0, 2, [&](const size_t side) {
+                if (side == 0) {
+                    result->left = build_range(context, first, split_at - first, depth + 1, worker, half);
+                } else {
+                    result->right = build_range(context, split_at, first + count - split_at, depth + 1, worker + half, workers - half);
+                }
+            });
+        } else {
+            result->left = build_range(context, first, split_at - first, depth + 1, worker, workers);
+            result->right = build_range(context, split_at, first + count - split_at, depth + 1, worker, workers);
+        }
+        return result;
+    }
+
+    void flatten(const build_node *b, const size_t depth) {
+        depth_ = std::max(depth_, depth);
+        const size_t index = nodes_.size();
+        nodes_.push_back(node{b->bounds, b->first, static_cast<uint16_t>(b->count), static_cast<uint16_t>(b->axis)});
+        if (b->left != nullptr) {
+            nodes_[index].count = 0;
+            flatten(b->left, depth + 1);
+            nodes_[index].offset = static_cast<uint32_t>(nodes_.size());
+            flatten(b->right, depth + 1);
+        }
+    }
+
+    // Wide node for the binary subtree at `index`: interior lanes with the largest area are opened until 4 lanes
+    auto collapse(const uint32_t index) -> uint32_t {
+        std::array<uint32_t, 4> lanes{index};
+        size_t used = 1;
+        while (used < lanes.size()) {
+            size_t widest = used;
+            T widest_area = -1;
+            for (size_t l = 0; l < used; ++l) {
+                const node &n = nodes_[lanes[l]];
+                if (!n.is_leaf() && n.bounds.surface_area() > widest_area) {
+                    widest = l;
+                    widest_area = n.bounds.surface_area();
+                }
+            }
+            if (widest == used) {
+                break;
+            }
+            const uint32_t opened = lanes[widest];
+            lanes[widest] = opened + 1;
+            lanes[used++] = nodes_[opened].offset;
+        }
+
+        const auto wide_index = static_cast<uint32_t>(wide_.size());
+        wide_.emplace_back();
+        for (size_t l = 0; l < used; ++l) {
+            const node &n = nodes_[lanes[l]];
+            wide_[wide_index].bounds.set(l, n.bounds);
+            wide_[wide_index].count[l] = n.count;
+            // The recursion appends to wide_, index it again afterwards
+            const uint32_t offset = n.is_leaf() ? n.offset : collapse(lanes[l]);
+            wide_[wide_index].offset[l] = offset;
+        }
+        return wide_index;
+    }
+
+    // :: Traversal
+    // `intersect(position, t_max) -> std::optional<T>` tests the primitive at `position` in leaf order
+    template <typename Intersect>
+    auto closest_hit(const ray_type &r, Intersect &&intersect, const T t_min, T t_max) const -> std::optional<hit> {
+        std::optional<hit> closest;
+        const auto test_leaf = [&](const uint32_t offset, const uint32_t count) {
+            for (uint32_t position = offset; position < offset + count; ++position) {
+                const std::optional<T> t = intersect(position, t_max);
+                if (t.has_value() && *t >= t_min && *t <= t_max) {
+                    t_max = *t;
+                    closest = hit{order_[position], *t};
+                }
+            }
+        };
+        if (nodes_.empty()) {
+            return closest;
+        }
+
+        std::array<uint32_t, stack_size> stack;
+        size_t top = 0;
+        stack[top++] = 0;
+        if (!wide_.empty()) {
+            while (top != 0) {
+                const wide_node &n = wide_[stack[--top]];
+                std::array<T, 4> t_enter;
+                uint32_t mask = n.bounds.intersect(r, t_min, t_max, t_enter.data());
+                // Leaves first, they shrink t_max for the interior lanes
+                std::array<uint32_t, 4> interior;
+                size_t interior_count = 0;
+                for (; mask != 0; mask &= mask - 1) {
+                    const auto lane = static_cast<uint32_t>(std::countr_zero(mask));
+                    if (n.count[lane] != 0) {
+                        test_leaf(n.offset[lane], n.count[lane]);
+                    } else {
+                        interior[interior_count++] = lane;
+                    }
+                }
+                // Farthest pushed first so the nearest is popped next
+                std::sort(interior.begin(), interior.begin() + interior_count,
+                          [&](const uint32_t lhs, const uint32_t rhs) { return t_enter[lhs] > t_enter[rhs]; });
+                for (size_t i = 0; i < interior_count; ++i) {
+                    if (t_enter[interior[i]] <= t_max) {
+                        assert(top < stack.size());
+                        stack[top++] = n.offset[interior[i]];
+                    }
+                }
+            }
+            return closest;
+        }
+
+        if (!nodes_.front().bounds.intersect(r, t_min, t_max).has_value()) {
+            return closest;
+        }
+        while (top != 0) {
+            const uint32_t index = stack[--top];
+            const node &n = nodes_[index];
+            if (n.is_leaf()) {
+                test_leaf(n.offset, n.count);
+                continue;
+            }
+            // Both children are tested here, against the t_max of the moment
+            const std::optional<T> left = nodes_[index + 1].bounds.intersect(r, t_min, t_max);
+            const std::optional<T> right = nodes_[n.offset].bounds.intersect(r, t_min, t_max);
+            const bool right_first = right.has_value() && (!left.has_value() || *right < *left);
+            assert(top + 2 <= stack.size());
+            if (right_first) {
+                if (left.has_value()) {
+                    stack[top++] = index + 1;
+                }
+                stack[top++] = n.offset;
+            } else {
+                if (right.has_value()) {
+                    stack[top++] = n.offset;
+                }
+                if (left.has_value()) {
+                    stack[top++] = index + 1;
+                }
+            }
+        }
+        return closest;
+    }
+
+    // `distance_squared(position)` of the primitive at `position` in leaf order
+    template <typename Distance>
+    auto closest_primitive(const vector_type &point, Distance &&distance_squared, T best) const -> std::optional<neighbour> {
+        std::optional<neighbour> closest;
+        if (nodes_.empty()) {
+            return closest;
+        }
+
+        std::array<std::pair<uint32_t, T>, stack_size> stack;
+        size_t top = 0;
+        stack[top++] = {0, static_cast<T>(nodes_.front().bounds.distance_squared(point))};
+        while (top != 0) {
+            const auto [index, bound] = stack[--top];
+            if (!(bound < best)) {
+                continue;
+            }
+            const node &n = nodes_[index];
+            if (n.is_leaf()) {
+                for (uint32_t position = n.offset; position < n.offset + n.count; ++position) {
+                    const T d = distance_squared(position);
+                    if (d < best) {
+                        best = d;
+                        closest = neighbour{order_[position], d};
+                    }
+                }
+                continue;
+            }
+            const T left = static_cast<T>(nodes_[index + 1].bounds.distance_squared(point));
+            const T right = static_cast<T>(nodes_[n.offset].bounds.distance_squared(point));
+            assert(top + 2 <= stack.size());
+            if (right < left) {
+                stack[top++] = {index + 1, left};
+                stack[top++] = {n.offset, right};
+            } else {
+                stack[top++] = {n.offset, right};
+                stack[top++] = {index + 1, left};
+            }
+        }
+        return closest;
+    }
+
+    template <typename Overlaps, typename Visit>
+    auto visit_overlapping(Overlaps &&overlaps, Visit &visit) const -> size_t {
+        size_t visited = 0;
+        if (nodes_.empty()) {
+            return visited;
+        }
+
+        std::array<uint32_t, stack_size> stack;
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top != 0) {
+            const uint32_t index = stack[--top];
+            const node &n = nodes_[index];
+            if (!overlaps(n.bounds)) {
+                continue;
+            }
+            if (n.is_leaf()) {
+                for (uint32_t position = n.offset; position < n.offset + n.count; ++position) {
+                    if (overlaps(primitives_[position])) {
+                        visit(order_[position]);
+                        ++visited;
+                    }
+                }
+                continue;
+            }
+            assert(top + 2 <= stack.size());
+            stack[top++] = n.offset;
+            stack[top++] = index + 1;
+        }
+        return visited;
+    }
+
+    std::vector<node> nodes_;
+    std::vector<wide_node> wide_;
+    std::vector<uint32_t> order_;       // Primitive index of each leaf slot
+    std::vector<box_type> primitives_;  // Primitive bounds in leaf order
+    std::vector<arena> scratch_;        // Build nodes & primitives, one arena per concurrent subtree
+    size_t depth_ = 0;
+};
+
+} // namespace mia
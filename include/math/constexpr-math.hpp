@@ -0,0 +1,166 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <type_traits>
+
+// sqrt & acos usable in constant expressions, for the exact paths of vector (magnitude, normalized, distance, angle)
+// At run time they are std::sqrt & std::acos. In constant evaluation sqrt is correctly rounded, as std::sqrt is,
+// so tables baked at compile time hold the same bits as the ones computed at run time. acos is evaluated in
+// long double and is within 1 ULP of std::acos
+namespace mia::math {
+
+namespace detail {
+
+// :: Square root
+// Exact a * a = product + error (Dekker, Veltkamp split), a normal and a * a not overflowing
+template <typename T>
+constexpr auto square_error(const T a, const T product) -> T {
+    constexpr T splitter = static_cast<T>((uint64_t{1} << ((std::numeric_limits<T>::digits + 1) / 2)) + 1);
+    const T c = splitter * a;
+    const T hi = c - (c - a);
+    const T lo = a - hi;
+    return ((hi * hi - product) + 2 * hi * lo) + lo * lo;
+}
+
+// Newton's iteration from above: y' = (y + x / y) / 2 decreases monotonically to sqrt(x) (last bits may oscillate)
+template <typename T>
+constexpr auto sqrt_newton(const T x, T y) -> T {
+    for (int i = 0; i < 256; ++i) {
+        const T next = (y + x / y) / 2;
+        if (next >= y) {
+            break;
+        }
+        y = next;
+    }
+    return y;
+}
+
+// Correctly rounded sqrt of a finite double >= 0
+constexpr auto sqrt_double(const double x) -> double {
+    if (x == 0) {
+        return x;
+    }
+    // Keep lo * lo in square_error from underflowing: sqrt(x 2^200) 2^-100 scales exactly, subnormals included
+    if (x < 0x1p-800) {
+        return sqrt_double(x * 0x1p200) * 0x1p-100;
+    }
+    // Exponent halved, always above sqrt(x) so the iteration decreases
+    const double guess = std::bit_cast<double>((std::bit_cast<uint64_t>(x) >> 1) + (uint64_t{0x3ff} << 51) + (uint64_t{1} << 51));
+    const double y = sqrt_newton(x, guess);
+    // Of y and its two neighbours, the one whose square is closest to x
+    double best = y;
+    double best_residual = std::numeric_limits<double>::infinity();
+    for (int64_t step = -1; step <= 1; ++step) {
+        const double c = std::bit_cast<double>(static_cast<uint64_t>(static_cast<int64_t>(std::bit_cast<uint64_t>(y)) + step));
+        // x - c * c: at run time the compiler may contract x - product into an fma, which the Dekker
+        // correction would then count twice, so the fma is spelled out there
+        double residual = 0;
+        if consteval {
+            const double product = c * c;
+            residual = (x - product) - square_error(c, product);
+        } else {
+            residual = std::fma(-c, c, x);
+        }
+        const double magnitude = residual < 0 ? -residual : residual;
+        if (magnitude < best_residual) {
+            best = c;
+            best_residual = magnitude;
+        }
+    }
+    return best;
+}
+
+// Correctly rounded for every finite x >= 0, NaN for x < 0
+template <typename T>
+constexpr auto sqrt_constant(const T x) -> T {
+    if (x < 0 || x != x) {
+        return std::numeric_limits<T>::quiet_NaN();
+    }
+    if (x == std::numeric_limits<T>::infinity()) {
+        return x;
+    }
+    if constexpr (std::is_same_v<T, float>) {
+        // 53 >= 2 * 24 + 2 bits: rounding the double result to float is correct
+        return static_cast<float>(sqrt_double(static_cast<double>(x)));
+    } else if constexpr (std::is_same_v<T, double>) {
+        return sqrt_double(x);
+    } else {
+        return x == 0 ? x : sqrt_newton(x, x > 1 ? x : T{1});
+    }
+}
+
+// :: Arc cosine
+// atan(t) for t >= 0: halve the angle until t <= 1/8, then the Taylor series
+constexpr auto atan_extended(long double t) -> long double {
+    if (t > 1) {
+        return std::numbers::pi_v<long double> / 2 - atan_extended(1 / t);
+    }
+    int halvings = 0;
+    while (t > 0.125L) {
+        t = t / (1 + sqrt_constant(1 + t * t));
+        ++halvings;
+    }
+    const long double t2 = t * t;
+    long double power = t;
+    long double sum = t;
+    for (int n = 1; n < 64; ++n) {
+        power *= -t2;
+        const long double term = power / (2 * n + 1);
+        sum += term;
+        if ((term < 0 ? -term : term) <= sum * std::numeric_limits<long double>::epsilon()) {
+            break;
+        }
+    }
+    return sum * static_cast<long double>(1 << halvings);
+}
+
+// acos(x) = 2 atan(sqrt((1 - x) / (1 + x))), 1 - x & 1 + x are exact where acos is ill-conditioned
+template <typename T>
+constexpr auto acos_constant(const T x) -> T {
+    if (x != x || x > 1 || x < -1) {
+        return std::numeric_limits<T>::quiet_NaN();
+    }
+    if (x == -1) {
+        return std::numbers::pi_v<T>;
+    }
+    const auto e = static_cast<long double>(x);
+    return static_cast<T>(2 * atan_extended(sqrt_constant((1 - e) / (1 + e))));
+}
+
+} // namespace detail
+
+// std::sqrt usable in constant expressions, integers are computed in double (as std::sqrt does)
+template <typename T>
+    requires std::is_arithmetic_v<T>
+constexpr auto sqrt(const T x) {
+    if constexpr (std::is_integral_v<T>) {
+        return math::sqrt(static_cast<double>(x));
+    } else {
+        if consteval {
+            return detail::sqrt_constant(x);
+        } else {
+            return std::sqrt(x);
+        }
+    }
+}
+
+// std::acos usable in constant expressions, NaN outside [-1, 1]
+template <typename T>
+    requires std::is_arithmetic_v<T>
+constexpr auto acos(const T x) {
+    if constexpr (std::is_integral_v<T>) {
+        return math::acos(static_cast<double>(x));
+    } else {
+        if consteval {
+            return detail::acos_constant(x);
+        } else {
+            return std::acos(x);
+        }
+    }
+}
+
+} // namespace mia::math
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+
+// NOTE: runtime dispatch needs per-function target attributes (GCC / Clang on x86-64)
+// Kernels for every instruction set are compiled into one binary, MIA_TARGET enables an ISA for one function
+// without -m flags, and the table matching the host is picked at run time
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define MIA_BATCH_DISPATCH 1
+#define MIA_TARGET(isa) __attribute__((target(isa)))
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace mia {
+
+// NOTE: CPU FEATURES
+// What the processor runs and the operating system allows: AVX & AVX-512 also need the OS to save the wider
+// registers on context switches (XCR0), a cpuid bit alone is not enough
+struct cpu_features {
+    bool sse2 = false;
+    bool sse4_1 = false;
+    bool avx = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool f16c = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512dq = false;
+    bool avx512vl = false;
+};
+
+namespace detail {
+
+#if defined(MIA_BATCH_DISPATCH)
+// XCR0, the register state enabled by the OS; only valid when cpuid reports OSXSAVE
+inline auto read_xcr0() noexcept -> uint64_t {
+    uint32_t low = 0;
+    uint32_t high = 0;
+    __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return (static_cast<uint64_t>(high) << 32) | low;
+}
+#endif
+
+inline auto probe_cpu_features() noexcept -> cpu_features {
+    cpu_features features;
+#if defined(MIA_BATCH_DISPATCH)
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (__get_cpuid(0, &eax, &ebx, &ecx, &edx) == 0) {
+        return features;
+    }
+    const unsigned int max_leaf = eax;
+
+    __cpuid(1, eax, ebx, ecx, edx);
+    features.sse2 = (edx & bit_SSE2) != 0;
+    features.sse4_1 = (ecx & bit_SSE4_1) != 0;
+    const uint64_t xcr0 = (ecx & bit_OSXSAVE) != 0 ? read_xcr0() : 0;
+    const bool ymm_state = (xcr0 & 0x06) == 0x06; // SSE & AVX
+    const bool zmm_state = (xcr0 & 0xE6) == 0xE6; // and opmask, ZMM0-15 upper halves, ZMM16-31
+    features.avx = ymm_state && (ecx & bit_AVX) != 0;
+    features.fma = features.avx && (ecx & bit_FMA) != 0;
+    features.f16c = features.avx && (ecx & bit_F16C) != 0;
+
+    if (max_leaf >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        features.avx2 = features.avx && (ebx & bit_AVX2) != 0;
+        features.avx512f = zmm_state && (ebx & bit_AVX512F) != 0;
+        features.avx512bw = features.avx512f && (ebx & bit_AVX512BW) != 0;
+        features.avx512dq = features.avx512f && (ebx & bit_AVX512DQ) != 0;
+        features.avx512vl = features.avx512f && (ebx & bit_AVX512VL) != 0;
+    }
+#endif
+    return features;
+}
+
+} // namespace detail
+
+// Probed once, on first use
+inline auto host_cpu_features() noexcept -> const cpu_features & {
+    static const cpu_features features = detail::probe_cpu_features();
+    return features;
+}
+
+#if defined(MIA_BATCH_DISPATCH)
+namespace detail {
+
+// NOTE: AVX-512 GATHER & SCATTER
+// Every lane of base[index], shared by the batch kernels and the simd<> AVX-512 backends. These are the masked
+// forms with a typed all-lanes mask. Unoptimized GCC builds expand them to macros whose builtins take the mask as a
+// signed integer, which trips -Wsign-conversion in every caller whatever the mask, so those move lane by lane
+#if defined(__OPTIMIZE__) || defined(__clang__)
+#define MIA_AVX512_GATHER_INSTRUCTIONS 1
+#endif
+
+MIA_TARGET("avx512f")
+inline auto gather_avx512(const float *base, const __m512i index) noexcept -> __m512 {
+#if defined(MIA_AVX512_GATHER_INSTRUCTIONS)
+    return _mm512_mask_i32gather_ps(_mm512_undefined_ps(), static_cast<__mmask16>(0xFFFF), index, base, 4);
+#else
+    alignas(64) std::array<int32_t, 16> lanes;
+    alignas(64) std::array<float, 16> values;
+    _mm512_store_si512(lanes.data(), index);
+    for (size_t l = 0; l < 16; ++l) {
+        values[l] = base[lanes[l]];
+    }
+    return _mm512_load_ps(values.data());
+#endif
+}
+
+MIA_TARGET("avx512f")
+inline auto gather_avx512(const double *base, const __m256i index) noexcept -> __m512d {
+#if defined(MIA_AVX512_GATHER_INSTRUCTIONS)
+    return _mm512_mask_i32gather_pd(_mm512_undefined_pd(), static_cast<__mmask8>(0xFF), index, base, 8);
+#else
+    alignas(32) std::array<int32_t, 8> lanes;
+    alignas(64) std::array<double, 8> values;
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes.data()), index);
+    for (size_t l = 0; l < 8; ++l) {
+        values[l] = base[lanes[l]];
+    }
+    return _mm512_load_pd(values.data());
+#endif
+}
+
+// Lanes are stored in order, the highest one wins on repeated indices
+MIA_TARGET("avx512f")
+inline void scatter_avx512(float *base, const __m512i index, const __m512 v) noexcept {
+#if defined(MIA_AVX512_GATHER_INSTRUCTIONS)
+    _mm512_mask_i32scatter_ps(base, static_cast<__mmask16>(0xFFFF), index, v, 4);
+#else
+    alignas(64) std::array<int32_t, 16> lanes;
+    alignas(64) std::array<float, 16> values;
+    _mm512_store_si512(lanes.data(), index);
+    _mm512_store_ps(values.data(), v);
+    for (size_t l = 0; l < 16; ++l) {
+        base[lanes[l]] = values[l];
+    }
+#endif
+}
+
+} // namespace detail
+#endif
+
+} // namespace mia
+
+namespace mia::batch {
+
+// NOTE: INSTRUCTION SETS
+// Levels the batch kernels are compiled for, each one implies the ones below
+
+enum class isa : uint8_t {
+    scalar,
+    sse4_1,
+    avx2,
+    avx512,
+};
+
+// Forces the dispatch level, e.g. MIA_ISA=avx2: benchmark one level, or reproduce results across hosts
+// Read once, before the first dispatched call; levels above the host's are lowered to what it runs
+constexpr const char *isa_environment_variable = "MIA_ISA";
+
+inline auto isa_name(const isa level) noexcept -> std::string_view {
+    switch (level) {
+    case isa::sse4_1:
+        return "sse4.1";
+    case isa::avx2:
+        return "avx2";
+    case isa::avx512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+// The names of isa_name, "sse4_1" is accepted too
+inline auto parse_isa(const std::string_view name) noexcept -> std::optional<isa> {
+    for (const isa level : {isa::scalar, isa::sse4_1, isa::avx2, isa::avx512}) {
+        if (name == isa_name(level)) {
+            return level;
+        }
+    }
+    if (name == "sse4_1") {
+        return isa::sse4_1;
+    }
+    return std::nullopt;
+}
+
+namespace detail {
+
+// Highest level `features` run: avx2 kernels use FMA, avx512 ones only AVX-512F
+inline auto supported_isa(const cpu_features &features) noexcept -> isa {
+    if (features.avx512f) {
+        return isa::avx512;
+    }
+    if (features.avx2 && features.fma) {
+        return isa::avx2;
+    }
+    if (features.sse4_1) {
+        return isa::sse4_1;
+    }
+    return isa::scalar;
+}
+
+// Highest level of the host
+inline auto detect_isa() noexcept -> isa {
+    return supported_isa(host_cpu_features());
+}
+
+// `requested` (the variable's value, null when unset) lowered to `supported`; unknown names are ignored
+inline auto select_isa(const char *requested, const isa supported) noexcept -> isa {
+    if (requested == nullptr) {
+        return supported;
+    }
+    const auto level = parse_isa(requested);
+    return level && *level < supported ? *level : supported;
+}
+
+// Selected once, on first use; every kernel table (float, reduction, packed) follows it
+inline auto active_level() noexcept -> isa {
+    static const isa level = select_isa(std::getenv(isa_environment_variable), detect_isa());
+    return level;
+}
+
+} // namespace detail
+
+// Instruction set picked by the dispatcher for float kernels
+inline auto active_isa() noexcept -> isa {
+    return detail::active_level();
+}
+
+} // namespace mia::batch
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <type_traits>
+
+#include "vector-simd.hpp"
+
+namespace mia {
+
+// Selects the exact (std::sqrt, std::acos...) or the math::fast path of vector::magnitude, normalized & angle
+enum class precision : uint8_t {
+    exact,
+    fast,
+};
+
+} // namespace mia
+
+// Approximations for hot loops: no libm calls, no table lookups, constexpr
+// Accuracy is single precision whatever T is, error bounds are measured over the stated domains by fast-math-test.cpp
+// Arguments outside the domains (0, negative or infinite for rsqrt, NaN for all) give unspecified results
+namespace mia::math::fast {
+
+namespace detail {
+
+// Newton-Raphson step for 1 / sqrt(x), doubles the number of correct bits
+template <typename T>
+constexpr auto rsqrt_step(const T x, const T y) -> T {
+    // y + y (1 - x y^2) / 2 rounds better than y (3 - x y^2) / 2: the correction is small
+    const T residual = T{1} - x * y * y;
+    return y + static_cast<T>(0.5) * y * residual;
+}
+
+// Bit-level first guess (~3.4% relative error)
+constexpr auto rsqrt_guess(const float x) -> float {
+    return std::bit_cast<float>(0x5f375a86u - (std::bit_cast<uint32_t>(x) >> 1));
+}
+constexpr auto rsqrt_guess(const double x) -> double {
+    return std::bit_cast<double>(0x5fe6eb50c7b537a9ull - (std::bit_cast<uint64_t>(x) >> 1));
+}
+
+// sin & cos of r in [-pi/4, pi/4] (cephes sinf / cosf minimax polynomials)
+template <typename T>
+constexpr auto sin_kernel(const T r) -> T {
+    const T z = r * r;
+    return r + r * z * (static_cast<T>(-1.6666654611e-1) + z * (static_cast<T>(8.3321608736e-3) + z * static_cast<T>(-1.9515295891e-4)));
+}
+template <typename T>
+constexpr auto cos_kernel(const T r) -> T {
+    const T z = r * r;
+    return T{1} - static_cast<T>(0.5) * z +
+           z * z * (static_cast<T>(4.166664568298827e-2) + z * (static_cast<T>(-1.388731625493765e-3) + z * static_cast<T>(2.443315711809948e-5)));
+}
+
+// x = k pi/2 + r with r in [-pi/4, pi/4], pi/2 split in three parts so k pi/2 is exact for the first two (Cody & Waite)
+template <typename T>
+constexpr auto reduce_half_pi(const T x, int64_t &k) -> T {
+    const T q = x * static_cast<T>(std::numbers::inv_pi * 2);
+    k = static_cast<int64_t>(q < 0 ? q - static_cast<T>(0.5) : q + static_cast<T>(0.5));
+    const T kt = static_cast<T>(k);
+    return ((x - kt * static_cast<T>(1.5703125)) - kt * static_cast<T>(4.837512969970703125e-4)) - kt * static_cast<T>(7.54978995489188216e-8);
+}
+
+} // namespace detail
+
+// 1 / sqrt(x) for normal x > 0, max error 3 ULP (float)
+// SSE: the rsqrtss estimate (12 bits) and one Newton step, 3 ULP. Otherwise a bit-level guess and three steps, 1 ULP.
+// double goes through the float estimate and two more steps in double (~1e-16 relative)
+template <typename T>
+    requires std::is_floating_point_v<T>
+constexpr auto rsqrt(const T x) -> T {
+    if constexpr (std::is_same_v<T, float>) {
+#if defined(MIA_SIMD_SSE2)
+        if !consteval {
+            const float estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+            return detail::rsqrt_step(x, estimate);
+        }
+#endif
+        return detail::rsqrt_step(x, detail::rsqrt_step(x, detail::rsqrt_step(x, detail::rsqrt_guess(x))));
+    } else {
+        if (x >= static_cast<T>(std::numeric_limits<float>::min()) && x <= static_cast<T>(std::numeric_limits<float>::max())) {
+            const T estimate = static_cast<T>(rsqrt(static_cast<float>(x)));
+            return detail::rsqrt_step(x, detail::rsqrt_step(x, estimate));
+        }
+        const double guess = detail::rsqrt_guess(static_cast<double>(x));
+        return static_cast<T>(detail::rsqrt_step(static_cast<double>(x), detail::rsqrt_step(static_cast<double>(x),
+                               detail::rsqrt_step(static_cast<double>(x), detail::rsqrt_step(static_cast<double>(x), guess)))));
+    }
+}
+
+// sqrt(x) = x / sqrt(x) for finite x >= 0, max error 3 ULP (float)
+// SSE: sqrtss at run time, it is exact and no slower than the estimate once the Newton step is paid for
+template <typename T>
+    requires std::is_floating_point_v<T>
+constexpr auto sqrt(const T x) -> T {
+#if defined(MIA_SIMD_SSE2)
+    if constexpr (std::is_same_v<T, float>) {
+        if !consteval {
+            return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(x)));
+        }
+    }
+#endif
+    return x > 0 ? x * rsqrt(x) : T{0};
+}
+
+// acos(x) for x in [-1, 1] (clamped), max error 5 ULP (float)
+// sqrt(1 - x) times a degree 7 polynomial on [0, 1] (Abramowitz & Stegun 4.4.46), reflected for x < 0
+template <typename T>
+    requires std::is_floating_point_v<T>
+constexpr auto acos(const T x) -> T {
+    const T a = x < 0 ? -x : x;
+    const T t = a < T{1} ? a : T{1};
+    const T p = static_cast<T>(1.5707963050) +
+                t * (static_cast<T>(-0.2145988016) +
+                     t * (static_cast<T>(0.0889789874) +
+                          t * (static_cast<T>(-0.0501743046) +
+                               t * (static_cast<T>(0.0308918810) +
+                                    t * (static_cast<T>(-0.0170881256) + t * (static_cast<T>(0.0066700901) + t * static_cast<T>(-0.0012624911)))))));
+    const T r = fast::sqrt(T{1} - t) * p;
+    return x < 0 ? std::numbers::pi_v<T> - r : r;
+}
+
+// atan(x) for any finite x, max error 2 ULP (float)
+// Odd degree 17 polynomial on [-1, 1] (Abramowitz & Stegun 4.4.49), atan(x) = pi/2 - atan(1/x) outside
+template <typename T>
+    requires std::is_floating_point_v<T>
+constexpr auto atan(const T x) -> T {
+    const T a = x < 0 ? -x : x;
+    const bool inverted = a > T{1};
+    const T t = inverted ? T{1} / a : a;
+    const T z = t * t;
+    const T p = T{1} +
+                z * (static_cast<T>(-0.3333314528) +
+                     z * (static_cast<T>(0.1999355085) +
+                          z * (static_cast<T>(-0.1420889944) +
+                               z * (static_cast<T>(0.1065626393) +
+                                    z * (static_cast<T>(-0.0752896400) +
+                                         z * (static_cast<T>(0.0429096138) + z * (static_cast<T>(-0.0161657367) + z * static_cast<T>(0.0028662257))))))));
+    const T r = inverted ? std::numbers::pi_v<T> / 2 - t * p : t * p;
+    return x < 0 ? -r : r;
+}
+
+// atan2(y, x) for finite y & x, max error 2 ULP (float), atan2(0, 0) = 0
+template <typename T>
+    requires std::is_floating_point_v<T>
+constexpr auto atan2(const T y, const T x) -> T {
+    const T ay = std::signbit(y) ? -y : y;
+    const T ax = x < 0 ? -x : x;
+    if (ay == 0 && ax == 0) {
+        return x < 0 ? (std::signbit(y) ? -std::numbers::pi_v<T> : std::numbers::pi_v<T>) : y;
+    }
+    // Same reduction as atan, without the extra division
+    const bool swapped = ay > ax;
+    const T t = swapped ? ax / ay : ay / ax;
+    T r = atan(t);
+    if (swapped) {
+        r = std::numbers::pi_v<T> / 2 - r;
+    }
+    if (x < 0) {
+        r = std::numbers::pi_v<T> - r;
+    }
+    // Sign of y, -0 included: atan2(-0, -1) = -pi like std::atan2
+    return std::signbit(y) ? -r : r;
+}
+
+// sin(x) & cos(x) for |x| <= 1e4, max error 2 ULP (float) away from the zeros, 1e-7 absolute everywhere
+template <typename T>
+    requires std::is_floating_point_v<T>
+constexpr auto sin(const T x) -> T {
+    int64_t k = 0;
+    const T r = detail::reduce_half_pi(x, k);
+    switch (k & 3) {
+    case 0:
+        return detail::sin_kernel(r);
+    case 1:
+        return detail::cos_kernel(r);
+    case 2:
+        return -detail::sin_kernel(r);
+    default:
+        return -detail::cos_kernel(r);
+    }
+}
+template <typename T>
+    requires std::is_floating_point_v<T>
+constexpr auto cos(const T x) -> T {
+    int64_t k = 0;
+    const T r = detail::reduce_half_pi(x, k);
+    switch (k & 3) {
+    case 0:
+        return detail::cos_kernel(r);
+    case 1:
+        return -detail::sin_kernel(r);
+    case 2:
+        return -detail::cos_kernel(r);
+    default:
+        return detail::sin_kernel(r);
+    }
+}
+
+} // namespace mia::math::fast
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "aabb.hpp"
+#include "thread-pool.hpp"
+#include "vector.hpp"
+
+namespace mia {
+
+// How a kd_tree is built and how batched queries are spread over a thread pool
+struct kd_tree_options {
+    uint32_t bucket_size = 8;          // Ranges of at most this many points are scanned instead of split
+    size_t threads = 0;                // Subtrees built & query chunks run at once, 0 for the size of the thread pool
+    size_t parallel_threshold = 1 << 16;  // Ranges of fewer points are built by the task that split them
+};
+
+// Static k-d tree over points, implicit in the point array
+// The root of a range [lo, hi) is its median m = lo + (hi - lo) / 2, split on the axis of largest spread:
+// [lo, m) lies below it and (m, hi) above. Nothing but the reordered points, their original indices and one
+// axis byte per point is stored, no node is ever allocated. Parallel builds and batched queries run on a
+// thread_pool, its workers are reused by every build and batch
+template <typename T = float, size_t Dims = 3>
+    requires std::is_floating_point_v<T> && (Dims > 0) && (Dims <= std::numeric_limits<uint8_t>::max())
+class kd_tree {
+  public:
+    // NOTE: MEMBER TYPES
+
+    using value_type = T;
+    using vector_type = vector<T, Dims>;
+
+    static constexpr uint32_t invalid = std::numeric_limits<uint32_t>::max();
+
+    // index: in the span given to build(), invalid for the unfilled slots of k_nearest
+    struct neighbour {
+        uint32_t index;
+        T distance_squared;
+    };
+
+    // NOTE: CONSTRUCTOR
+
+    kd_tree() = default;
+    explicit kd_tree(std::span<const vector_type> points, const kd_tree_options &options = {}) {
+        build(points, options);
+    }
+
+    // NOTE: BUILD
+
+    // Replace the tree, median splits make it balanced: depth is log2(size / bucket_size) + 1
+    // From parallel_threshold points on, the two halves of a split are built as tasks of `pool`
+    void build(thread_pool &pool, std::span<const vector_type> points, const kd_tree_options &options = {}) {
+        build_tree(points, options, &pool);
+    }
+    // On default_thread_pool(), only created once a build reaches parallel_threshold
+    void build(std::span<const vector_type> points, const kd_tree_options &options = {}) {
+        const bool parallel = options.threads != 1 && points.size() >= std::max<size_t>(options.parallel_threshold, 2);
+        build_tree(points, options, parallel ? &default_thread_pool() : nullptr);
+    }
+
+    // NOTE: CONST FUNCTIONS
+
+    [[nodiscard]] inline auto size() const -> size_t { return points_.size(); }
+    [[nodiscard]] inline auto empty() const -> bool { return points_.empty(); }
+    // Points in tree order, indices() maps them back
+    [[nodiscard]] inline auto points() const -> std::span<const vector_type> { return points_; }
+    [[nodiscard]] inline auto indices() const -> std::span<const uint32_t> { return indices_; }
+
+    // :: Nearest neighbours
+    // Closest point strictly under `max_distance_squared`
+    [[nodiscard]] auto nearest(const vector_type &point, const T max_distance_squared = std::numeric_limits<T>::infinity()) const
+        -> std::optional<neighbour> {
+        std::optional<neighbour> closest;
+        T bound = max_distance_squared;
+        search(point, bound, [&](const uint32_t position, const T d) {
+            if (d < bound) {
+                bound = d;
+                closest = neighbour{indices_[position], d};
+            }
+        });
+        return closest;
+    }
+
+    // The out.size() closest points strictly under `max_distance_squared`, nearest first, returns how many
+    // Slots past the returned count are left untouched
+    auto k_nearest(const vector_type &point, std::span<neighbour> out,
+                   const T max_distance_squared = std::numeric_limits<T>::infinity()) const -> size_t {
+        if (out.empty()) {
+            return 0;
+        }
+        // Max-heap on distance over out[0, found), its top is the bound once full
+        const auto farther = [](const neighbour &lhs, const neighbour &rhs) { return lhs.distance_squared < rhs.distance_squared; };
+        size_t found = 0;
+        T bound = max_distance_squared;
+        search(point, bound, [&](const uint32_t position, const T d) {
+            if (!(d < bound)) {
+                return;
+            }
+            if (found == out.size()) {
+                std::pop_heap(out.begin(), out.end(), farther);
+                --found;
+            }
+            out[found++] = neighbour{indices_[position], d};
+            std::push_heap(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(found), farther);
+            if (found == out.size()) {
+                bound = out.front().distance_squared;
+            }
+        });
+        std::sort_heap(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(found), farther);
+        return found;
+    }
+
+    // :: Radius search
+    // Calls `visit(index, distance_squared)` for every point within `radius` of `center` (boundary included),
+    // in no particular order, returns how many
+    template <typename Visit>
+        requires std::is_invocable_v<Visit &, uint32_t, T>
+    auto query(const vector_type &center, const T radius, Visit &&visit) const -> size_t {
+        const T radius_squared = radius * radius;
+        T bound = radius_squared;
+        size_t visited = 0;
+        search(center, bound, [&](const uint32_t position, const T d) {
+            if (d <= radius_squared) {
+                visit(indices_[position], d);
+                ++visited;
+            }
+        });
+        return visited;
+    }
+
+    // :: Batched queries
+    // Query i fills out[i], contiguous ranges of queries run as tasks of `pool`
+    void nearest(thread_pool &pool, std::span<const vector_type> queries, std::span<std::optional<neighbour>> out) const {
+        nearest_batch(&pool, queries, out);
+    }
+    // On default_thread_pool(), only created once a batch is worth splitting
+    void nearest(std::span<const vector_type> queries, std::span<std::optional<neighbour>> out) const {
+        nearest_batch(batch_pool(queries.size()), queries, out);
+    }
+    // Query i fills out[i * k, (i + 1) * k), nearest first, missing neighbours are {invalid, infinity}
+    void k_nearest(thread_pool &pool, std::span<const vector_type> queries, const size_t k, std::span<neighbour> out) const {
+        k_nearest_batch(&pool, queries, k, out);
+    }
+    void k_nearest(std::span<const vector_type> queries, const size_t k, std::span<neighbour> out) const {
+        k_nearest_batch(batch_pool(queries.size()), queries, k, out);
+    }
+
+  private:
+    // Point & index moved together by the build, split apart afterwards
+    struct entry {
+        vector_type point;
+        uint32_t index;
+    };
+
+    // Range still to visit, `bound` is the squared distance to its splitting plane
+    struct pending {
+        uint32_t lo;
+        uint32_t hi;
+        T bound;
+    };
+
+    static constexpr size_t stack_size = 64;
+    // Fewer queries than this are not worth a task
+    static constexpr size_t query_grain = 256;
+
+    auto thread_count(const thread_pool &pool) const -> size_t {
+        return options_.threads != 0 ? options_.threads : pool.size();
+    }
+
+    // Tree over `points`, built on `pool` unless it is null
+    void build_tree(std::span<const vector_type> points, const kd_tree_options &options, thread_pool *pool) {
+        assert(points.size() < invalid);
+        options_ = options;
+        options_.bucket_size = std::max(options.bucket_size, 1u);
+        options_.parallel_threshold = std::max<size_t>(options.parallel_threshold, 2);
+
+        const auto count = static_cast<uint32_t>(points.size());
+        std::vector<entry> entries(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            entries[i] = entry{points[i], i};
+        }
+        axes_.assign(count, 0);
+        const size_t workers = pool == nullptr || count < options_.parallel_threshold ? 1 : thread_count(*pool);
+        build_range(pool, entries, 0, count, workers);
+
+        points_.resize(count);
+        indices_.resize(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            points_[i] = entries[i].point;
+            indices_[i] = entries[i].index;
+        }
+    }
+
+    void build_range(thread_pool *pool, std::vector<entry> &entries, const uint32_t lo, const uint32_t hi, const size_t workers) {
+        if (hi - lo <= options_.bucket_size) {
+            return;
+        }
+        aabb<T, Dims> bounds;
+        for (uint32_t i = lo; i < hi; ++i) {
+            bounds.expand(entries[i].point);
+        }
+        const size_t axis = bounds.major_axis();
+        const uint32_t middle = lo + (hi - lo) / 2;
+        std::nth_element(entries.begin() + lo, entries.begin() + middle, entries.begin() + hi,
+                         [axis](const entry &lhs, const entry &rhs) { return lhs.point[axis] < rhs.point[axis]; });
+        axes_[middle] = static_cast<uint8_t>(axis);
+
+        if (workers > 1 && hi - lo >= options_.parallel_threshold) {
+            // Both halves are pool tasks, the upper one with the upper half of the workers
+            const size_t half = workers / 2;
+            pool->parallel_for(0, 2, [&](const size_t side) {
+                if (side == 0) {
+                    build_range(pool, entries, lo, middle, half);
+                } else {
+                    build_range(pool, entries, middle + 1, hi, workers - half);
+                }
+            });
+        } else {
+            build_range(pool, entries, lo, middle, workers);
+            build_range(pool, entries, middle + 1, hi, workers);
+        }
+    }
+
+    // Calls `visit(position, distance_squared)` on every point that may lie within `bound`, which `visit`
+    // may lower as it goes. The near side of a split is followed first, the far one is kept while its plane
+    // is within the bound
+    template <typename Visit>
+    void search(const vector_type &point, const T &bound, Visit &&visit) const {
+        if (points_.empty()) {
+            return;
+        }
+        std::array<pending, stack_size> stack;
+        size_t top = 0;
+        stack[top++] = pending{0, static_cast<uint32_t>(points_.size()), T{0}};
+        while (top != 0) {
+            auto [lo, hi, plane] = stack[--top];
+            if (plane > bound) {
+                continue;
+            }
+            while (hi - lo > options_.bucket_size) {
+                const uint32_t middle = lo + (hi - lo) / 2;
+                visit(middle, distance(point, middle));
+                const size_t axis = axes_[middle];
+                const T offset = point[axis] - points_[middle][axis];
+                const T offset_squared = offset * offset;
+                if (offset_squared <= bound) {
+                    assert(top < stack.size());
+                    stack[top++] = offset < 0 ? pending{middle + 1, hi, offset_squared} : pending{lo, middle, offset_squared};
+                }
+                if (offset < 0) {
+                    hi = middle;
+                } else {
+                    lo = middle + 1;
+                }
+            }
+            for (uint32_t position = lo; position < hi; ++position) {
+                visit(position, distance(point, position));
+            }
+        }
+    }
+
+    auto distance(const vector_type &point, const uint32_t position) const -> T {
+        return static_cast<T>(vector_type::distance_squared(point, points_[position]));
+    }
+
+    void nearest_batch(thread_pool *pool, std::span<const vector_type> queries, std::span<std::optional<neighbour>> out) const {
+        assert(out.size() >= queries.size());
+        parallel_queries(pool, queries.size(), [&](const size_t i) { out[i] = nearest(queries[i]); });
+    }
+    void k_nearest_batch(thread_pool *pool, std::span<const vector_type> queries, const size_t k, std::span<neighbour> out) const {
+        assert(out.size() >= queries.size() * k);
+        parallel_queries(pool, queries.size(), [&](const size_t i) {
+            const std::span<neighbour> row = out.subspan(i * k, k);
+            const size_t found = k_nearest(queries[i], row);
+            std::fill(row.begin() + static_cast<std::ptrdiff_t>(found), row.end(),
+                      neighbour{invalid, std::numeric_limits<T>::infinity()});
+        });
+    }
+
+    // Pool of a batch of `count` queries, null when it runs on the calling thread anyway
+    auto batch_pool(const size_t count) const -> thread_pool * {
+        return options_.threads == 1 || count <= query_grain ? nullptr : &default_thread_pool();
+    }
+
+    // `query(i)` over [0, count), in chunks of at least query_grain queries on `pool` unless it is null
+    // With options.threads set, the batch is cut in that many chunks
+    template <typename Query>
+    void parallel_queries(thread_pool *pool, const size_t count, Query &&query) const {
+        if (pool == nullptr || options_.threads == 1) {
+            for (size_t i = 0; i < count; ++i) {
+                query(i);
+            }
+            return;
+        }
+        const size_t grain = options_.threads != 0 ? (count + options_.threads - 1) / options_.threads : 0;
+        pool->parallel_for(0, count, query, std::max(grain, query_grain));
+    }
+
+    std::vector<vector_type> points_;  // Tree order
+    std::vector<uint32_t> indices_;    // Original index of each point
+    std::vector<uint8_t> axes_;        // Split axis of each median, unused inside buckets
+    kd_tree_options options_;
+};
+
+} // namespace mia
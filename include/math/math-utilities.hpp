@@ -3,55 +3,195 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 #include "../utilities.hpp"
 
 constexpr size_t MIA_DEFAULT_ALIGNMENT = 16;
+constexpr size_t MIA_CACHE_LINE_ALIGNMENT = 64;  // Also a full AVX-512 register
+constexpr size_t MIA_PAGE_ALIGNMENT = 4096;
+constexpr size_t MIA_HUGE_PAGE_SIZE = 2 * 1024 * 1024;
 
 namespace mia {
 
-// SIMD allocation
-template <typename T, uint8_t Alignment = MIA_DEFAULT_ALIGNMENT>
-class simd_allocator : public std::allocator<T> {
+// NOTE: ALIGNED MEMORY
+
+// How simd_allocator backs large buffers, flags can be combined
+enum class memory_policy : uint8_t {
+    none = 0,
+    huge_pages = 1 << 0,  // Buffers of at least MIA_HUGE_PAGE_SIZE are mmapped on 2 MiB boundaries (Linux)
+};
+constexpr auto operator|(memory_policy lhs, memory_policy rhs) noexcept -> memory_policy {
+    return static_cast<memory_policy>(static_cast<uint8_t>(lhs) | static_cast<uint8_t>(rhs));
+}
+constexpr auto has_policy(memory_policy policies, memory_policy p) noexcept -> bool {
+    return (static_cast<uint8_t>(policies) & static_cast<uint8_t>(p)) != 0;
+}
+
+namespace detail {
+
+// Huge page backed mapping of `bytes` (a multiple of MIA_HUGE_PAGE_SIZE), nullptr when unsupported
+inline auto map_huge(size_t bytes) noexcept -> void * {
+#if defined(__linux__)
+#if defined(MAP_HUGETLB)
+    // Reserved huge pages, only there if the admin set vm.nr_hugepages
+    void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+        return p;
+    }
+#endif
+    // Transparent huge pages need a 2 MiB aligned range: over-map and trim both ends
+    const size_t padded = bytes + MIA_HUGE_PAGE_SIZE;
+    auto *raw = static_cast<char *>(mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    const uintptr_t address = reinterpret_cast<uintptr_t>(raw);
+    auto *aligned = raw + ((~address + 1) & (MIA_HUGE_PAGE_SIZE - 1));
+    const size_t head = static_cast<size_t>(aligned - raw);
+    if (head != 0) {
+        munmap(raw, head);
+    }
+    if (padded - head - bytes != 0) {
+        munmap(aligned + bytes, padded - head - bytes);
+    }
+#if defined(MADV_HUGEPAGE)
+    madvise(aligned, bytes, MADV_HUGEPAGE);
+#endif
+    return aligned;
+#else
+    (void)bytes;
+    return nullptr;
+#endif
+}
+
+inline void unmap_huge(void *p, size_t bytes) noexcept {
+#if defined(__linux__)
+    munmap(p, bytes);
+#else
+    (void)p;
+    (void)bytes;
+#endif
+}
+
+constexpr auto huge_pages_available() noexcept -> bool {
+#if defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+}  // namespace detail
+
+// Aligned allocator for SIMD buffers
+// `Alignment` is any power of two >= alignof(T): 16 (SSE), 32 (AVX), 64 (AVX-512 / cache line), MIA_PAGE_ALIGNMENT...
+// allocate() never writes the storage, see first_touch() to place a large buffer's pages on NUMA nodes
+template <typename T, size_t Alignment = MIA_DEFAULT_ALIGNMENT, memory_policy Policy = memory_policy::none>
+class simd_allocator {
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must not be weaker than alignof(T)");
+
   public:
-    using size_type     = size_t;
-    using pointer       = T *;
-    using const_pointer = const T *;
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer         = T *;
+    using const_pointer   = const T *;
+    using is_always_equal = std::true_type;
     template <typename Tp1>
     struct rebind {
-        using other = simd_allocator<Tp1>;
+        using other = simd_allocator<Tp1, std::max(Alignment, alignof(Tp1)), Policy>;
     };
 
-    constexpr simd_allocator() noexcept
-        : std::allocator<T>() {
-    }
-    constexpr simd_allocator(const simd_allocator &other) noexcept
-        : std::allocator<T>(other) {
-    }
-    template <class U>
-    constexpr simd_allocator(const simd_allocator<U> &other) noexcept
-        : std::allocator<T>(other) {
-    }
+    static constexpr size_t alignment = Alignment;
+    static constexpr memory_policy policy = Policy;
 
-    virtual constexpr ~simd_allocator() = default;
+    constexpr simd_allocator() noexcept = default;
+    template <class U, size_t OtherAlignment>
+    constexpr simd_allocator([[maybe_unused]] const simd_allocator<U, OtherAlignment, Policy> &other) noexcept {
+    }
 
-    constexpr auto allocate(size_type n) -> pointer {
-        return reinterpret_cast<pointer>(std::aligned_alloc(Alignment, n * sizeof(T)));
+    [[nodiscard]] auto allocate(size_type n) -> pointer {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = storage_size(n);
+
+        void *p = nullptr;
+        if (uses_huge_pages(bytes)) {
+            p = detail::map_huge(bytes);
+        } else {
+            // NOTE: std::aligned_alloc requires the size to be a multiple of the alignment
+            p = std::aligned_alloc(Alignment, bytes);
+        }
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<pointer>(p);
     }
 
-    constexpr void deallocate(pointer p, size_type n) {
-        std::free(p, n);
+    void deallocate(pointer p, size_type n) noexcept {
+        const size_t bytes = storage_size(n);
+        if (uses_huge_pages(bytes)) {
+            detail::unmap_huge(p, bytes);
+        } else {
+            std::free(p);
+        }
     }
 
-    constexpr auto operator==([[maybe_unused]] const simd_allocator other) noexcept -> bool {
+    template <typename U, size_t OtherAlignment>
+    constexpr auto operator==([[maybe_unused]] const simd_allocator<U, OtherAlignment, Policy> &other) const noexcept -> bool {
         return true;
     }
-    constexpr auto operator!=([[maybe_unused]] const simd_allocator other) noexcept -> bool {
-        return false;
+
+  private:
+    static constexpr auto storage_size(size_type n) noexcept -> size_t {
+        const size_t bytes = std::max<size_t>(n * sizeof(T), 1);
+        const size_t granularity = uses_huge_pages(bytes) ? MIA_HUGE_PAGE_SIZE : Alignment;
+        return (bytes + granularity - 1) & ~(granularity - 1);
+    }
+    // Depends on the size only so deallocate() takes the same path as allocate()
+    static constexpr auto uses_huge_pages(size_t bytes) noexcept -> bool {
+        return has_policy(Policy, memory_policy::huge_pages) && detail::huge_pages_available() && bytes >= MIA_HUGE_PAGE_SIZE &&
+               Alignment <= MIA_HUGE_PAGE_SIZE;
     }
 };
 
+// :: Common instantiations
+template <typename T>
+using avx_allocator = simd_allocator<T, std::max<size_t>(32, alignof(T))>;
+template <typename T>
+using avx512_allocator = simd_allocator<T, std::max<size_t>(MIA_CACHE_LINE_ALIGNMENT, alignof(T))>;
+template <typename T>
+using page_allocator = simd_allocator<T, std::max<size_t>(MIA_PAGE_ALIGNMENT, alignof(T)), memory_policy::huge_pages>;
+
+// :: First touch
+// Write one byte per page of [p, p + bytes) from the threads of `executor`, before anything else writes them
+// On a NUMA machine a page lands on the node of the thread that first writes it: touched here, a buffer is spread
+// over the nodes the executor runs on instead of sitting on the allocating thread's. Run it on raw storage from
+// simd_allocator::allocate that the same executor's loops will then fill and read
+// `executor.parallel_for(begin, end, body(begin, end))` splits the pages, e.g. a mia::thread_pool (thread-pool.hpp)
+template <typename Executor>
+    requires requires(Executor &executor, void (*body)(size_t, size_t)) { executor.parallel_for(size_t{0}, size_t{1}, body); }
+inline void first_touch(void *p, const size_t bytes, Executor &executor) {
+    const size_t pages = (bytes + MIA_PAGE_ALIGNMENT - 1) / MIA_PAGE_ALIGNMENT;
+    executor.parallel_for(size_t{0}, pages, [p](const size_t begin, const size_t end) {
+        for (size_t page = begin; page < end; ++page) {
+            static_cast<volatile char *>(p)[page * MIA_PAGE_ALIGNMENT] = 0;
+        }
+    });
+}
+
 // Math
 namespace math {
 
@@ -0,0 +1,435 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "vector.hpp"
+
+namespace mia {
+
+namespace detail {
+
+// Kernels used by mia::matrix, same opt-in as vector_simd (MIA_ENABLE_SIMD)
+// The primary template is the scalar fallback
+template <typename T, size_t R, size_t C>
+struct matrix_simd {
+    static constexpr bool enabled = false;
+};
+
+#if defined(MIA_SIMD_SSE2)
+
+// :: matrix<float, 4, 4>
+// Columns are four aligned __m128, a product column is a sum of lhs columns scaled by one rhs column
+template <>
+struct matrix_simd<float, 4, 4> {
+    static constexpr bool enabled = true;
+
+    static inline auto combine(const float *m, const __m128 v) noexcept -> __m128 {
+        __m128 res = _mm_mul_ps(_mm_load_ps(m + 0), _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        res = _mm_add_ps(res, _mm_mul_ps(_mm_load_ps(m + 4), _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+        res = _mm_add_ps(res, _mm_mul_ps(_mm_load_ps(m + 8), _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+        return _mm_add_ps(res, _mm_mul_ps(_mm_load_ps(m + 12), _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+    }
+
+    // res = m * v
+    static inline void transform(float *res, const float *m, const float *v) noexcept {
+        _mm_store_ps(res, combine(m, _mm_load_ps(v)));
+    }
+
+#if defined(MIA_SIMD_AVX)
+    // res = lhs * rhs, two result columns per __m256
+    static inline void multiply(float *res, const float *lhs, const float *rhs) noexcept {
+        const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(lhs + 0));
+        const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(lhs + 4));
+        const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(lhs + 8));
+        const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(lhs + 12));
+        for (size_t j = 0; j < 16; j += 8) {
+            const __m256 b = _mm256_load_ps(rhs + j);
+            __m256 acc = _mm256_mul_ps(c0, _mm256_permute_ps(b, 0x00));
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(c1, _mm256_permute_ps(b, 0x55)));
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(c2, _mm256_permute_ps(b, 0xaa)));
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(c3, _mm256_permute_ps(b, 0xff)));
+            _mm256_store_ps(res + j, acc);
+        }
+    }
+#else
+    static inline void multiply(float *res, const float *lhs, const float *rhs) noexcept {
+        for (size_t j = 0; j < 16; j += 4) {
+            _mm_store_ps(res + j, combine(lhs, _mm_load_ps(rhs + j)));
+        }
+    }
+#endif
+};
+
+#endif // MIA_SIMD_SSE2
+
+} // namespace detail
+
+// Fixed-size R x C matrix, column-major: every column is a mia::vector<T, R>, so columns inherit
+// its padding & alignment and a matrix<float, 4, 4> is four aligned __m128 when SIMD is enabled
+// Unlike vector, products are computed in T (no compute_type narrowing)
+template <typename T, size_t R, size_t C>
+    requires std::is_arithmetic_v<T> && (R > 0) && (C > 0)
+class matrix {
+  public:
+    using column_type = vector<T, R>;
+    using row_type = vector<T, C>;
+    using simd_traits = detail::matrix_simd<T, R, C>;
+
+    static constexpr size_t alignment = std::max<size_t>(alignof(column_type), simd_traits::enabled ? 32 : 1);
+
+    alignas(alignment) std::array<column_type, C> columns{};
+
+    // NOTE: MEMBER TYPES
+
+    using value_type = T;
+    using size_type = size_t;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+
+    // NOTE: CONSTRUCTOR
+
+    // Zero matrix
+    constexpr matrix() = default;
+
+    // From columns
+    template <typename... Columns>
+        requires(sizeof...(Columns) == C) && (std::is_convertible_v<Columns, column_type> && ...)
+    constexpr explicit matrix(const Columns &...cols)
+        : columns{column_type(cols)...} {
+    }
+
+    // Elements listed row by row, so the source reads like the matrix
+    static constexpr auto from_rows(const std::array<T, R * C> &elements) -> matrix {
+        matrix result;
+        for (size_t r = 0; r < R; ++r) {
+            for (size_t c = 0; c < C; ++c) {
+                result(r, c) = elements[r * C + c];
+            }
+        }
+        return result;
+    }
+    // Elements listed column by column (storage order)
+    static constexpr auto from_columns(const std::array<T, R * C> &elements) -> matrix {
+        matrix result;
+        for (size_t c = 0; c < C; ++c) {
+            for (size_t r = 0; r < R; ++r) {
+                result(r, c) = elements[c * R + r];
+            }
+        }
+        return result;
+    }
+
+    static constexpr auto identity() -> matrix
+        requires(R == C)
+    {
+        matrix result;
+        for (size_t i = 0; i < R; ++i) {
+            result(i, i) = T{1};
+        }
+        return result;
+    }
+
+    // NOTE: ELEMENT ACCESS
+
+    constexpr auto operator()(const size_t row, const size_t col) -> reference {
+        return columns[col][row];
+    }
+    constexpr auto operator()(const size_t row, const size_t col) const -> const_reference {
+        return columns[col][row];
+    }
+    constexpr auto column(const size_t col) -> column_type & {
+        return columns[col];
+    }
+    constexpr auto column(const size_t col) const -> const column_type & {
+        return columns[col];
+    }
+    constexpr auto row(const size_t r) const -> row_type {
+        row_type result;
+        for (size_t c = 0; c < C; ++c) {
+            result[c] = columns[c][r];
+        }
+        return result;
+    }
+
+    [[nodiscard]] static constexpr auto rows() noexcept -> size_type {
+        return R;
+    }
+    [[nodiscard]] static constexpr auto cols() noexcept -> size_type {
+        return C;
+    }
+
+    // NOTE: CONST FUNCTIONS
+
+    [[nodiscard]] constexpr auto transposed() const -> matrix<T, C, R> {
+        matrix<T, C, R> result;
+        for (size_t c = 0; c < C; ++c) {
+            for (size_t r = 0; r < R; ++r) {
+                result(c, r) = columns[c][r];
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] constexpr auto determinant() const -> T
+        requires(R == C) && (R >= 2 && R <= 4)
+    {
+        const matrix &m = *this;
+        if constexpr (R == 2) {
+            return m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+        } else if constexpr (R == 3) {
+            return m(0, 0) * (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1))
+                   - m(0, 1) * (m(1, 0) * m(2, 2) - m(1, 2) * m(2, 0))
+                   + m(0, 2) * (m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0));
+        } else {
+            const auto [s, c] = minors_2x2();
+            return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+        }
+    }
+
+    // Inverse, nullopt when the matrix is singular (determinant exactly 0)
+    [[nodiscard]] constexpr auto inverse() const -> std::optional<matrix>
+        requires std::is_floating_point_v<T> && (R == C) && (R >= 2 && R <= 4)
+    {
+        const matrix &m = *this;
+        matrix result;
+        if constexpr (R == 2) {
+            const T det = determinant();
+            if (det == 0)
+                return std::nullopt;
+            result = from_rows({m(1, 1), -m(0, 1),
+                                -m(1, 0), m(0, 0)});
+            return result * (T{1} / det);
+        } else if constexpr (R == 3) {
+            // Transposed cofactors
+            result = from_rows({m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1), m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2), m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1),
+                                m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2), m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0), m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2),
+                                m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0), m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1), m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0)});
+            const T det = m(0, 0) * result(0, 0) + m(0, 1) * result(1, 0) + m(0, 2) * result(2, 0);
+            if (det == 0)
+                return std::nullopt;
+            return result * (T{1} / det);
+        } else {
+            // Laplace expansion over the 2x2 minors of the top & bottom row pairs
+            const auto [s, c] = minors_2x2();
+            const T det = s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+            if (det == 0)
+                return std::nullopt;
+            result = from_rows({m(1, 1) * c[5] - m(1, 2) * c[4] + m(1, 3) * c[3],
+                                -m(0, 1) * c[5] + m(0, 2) * c[4] - m(0, 3) * c[3],
+                                m(3, 1) * s[5] - m(3, 2) * s[4] + m(3, 3) * s[3],
+                                -m(2, 1) * s[5] + m(2, 2) * s[4] - m(2, 3) * s[3],
+
+                                -m(1, 0) * c[5] + m(1, 2) * c[2] - m(1, 3) * c[1],
+                                m(0, 0) * c[5] - m(0, 2) * c[2] + m(0, 3) * c[1],
+                                -m(3, 0) * s[5] + m(3, 2) * s[2] - m(3, 3) * s[1],
+                                m(2, 0) * s[5] - m(2, 2) * s[2] + m(2, 3) * s[1],
+
+                                m(1, 0) * c[4] - m(1, 1) * c[2] + m(1, 3) * c[0],
+                                -m(0, 0) * c[4] + m(0, 1) * c[2] - m(0, 3) * c[0],
+                                m(3, 0) * s[4] - m(3, 1) * s[2] + m(3, 3) * s[0],
+                                -m(2, 0) * s[4] + m(2, 1) * s[2] - m(2, 3) * s[0],
+
+                                -m(1, 0) * c[3] + m(1, 1) * c[1] - m(1, 2) * c[0],
+                                m(0, 0) * c[3] - m(0, 1) * c[1] + m(0, 2) * c[0],
+                                -m(3, 0) * s[3] + m(3, 1) * s[1] - m(3, 2) * s[0],
+                                m(2, 0) * s[3] - m(2, 1) * s[1] + m(2, 2) * s[0]});
+            return result * (T{1} / det);
+        }
+    }
+
+    // NOTE: AFFINE TRANSFORMS
+    // 4x4 for 3D and 3x3 for 2D, columns act on column vectors (v' = M * v), translation is the last column
+
+    static constexpr auto translation(const vector<T, R - 1> &offset) -> matrix
+        requires(R == C) && (R == 3 || R == 4)
+    {
+        matrix result = identity();
+        for (size_t i = 0; i < R - 1; ++i) {
+            result(i, R - 1) = offset[i];
+        }
+        return result;
+    }
+    static constexpr auto scaling(const vector<T, R - 1> &factors) -> matrix
+        requires(R == C) && (R == 3 || R == 4)
+    {
+        matrix result = identity();
+        for (size_t i = 0; i < R - 1; ++i) {
+            result(i, i) = factors[i];
+        }
+        return result;
+    }
+    // Counter-clockwise rotation of `radians` around `axis` (right-handed), axis need not be unit length
+    // 3x3 is the plain 3D rotation, 4x4 its homogeneous form
+    static auto rotation(const vector<T, 3> &axis, const T radians) -> matrix
+        requires std::is_floating_point_v<T> && (R == C) && (R == 3 || R == 4)
+    {
+        const T length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+        const T x = axis[0] / length;
+        const T y = axis[1] / length;
+        const T z = axis[2] / length;
+        const T cos_v = std::cos(radians);
+        const T sin_v = std::sin(radians);
+        const T t = T{1} - cos_v;
+
+        matrix result = identity();
+        result(0, 0) = t * x * x + cos_v;
+        result(0, 1) = t * x * y - sin_v * z;
+        result(0, 2) = t * x * z + sin_v * y;
+        result(1, 0) = t * x * y + sin_v * z;
+        result(1, 1) = t * y * y + cos_v;
+        result(1, 2) = t * y * z - sin_v * x;
+        result(2, 0) = t * x * z - sin_v * y;
+        result(2, 1) = t * y * z + sin_v * x;
+        result(2, 2) = t * z * z + cos_v;
+        return result;
+    }
+
+    // Point (w = 1) & direction (w = 0) through a 4x4 affine transform, the bottom row is ignored
+    [[nodiscard]] constexpr auto transform_point(const vector<T, 3> &point) const -> vector<T, 3>
+        requires(R == 4 && C == 4)
+    {
+        vector<T, 3> result;
+        for (size_t r = 0; r < 3; ++r) {
+            result[r] = columns[0][r] * point[0] + columns[1][r] * point[1] + columns[2][r] * point[2] + columns[3][r];
+        }
+        return result;
+    }
+    [[nodiscard]] constexpr auto transform_direction(const vector<T, 3> &direction) const -> vector<T, 3>
+        requires(R == 4 && C == 4)
+    {
+        vector<T, 3> result;
+        for (size_t r = 0; r < 3; ++r) {
+            result[r] = columns[0][r] * direction[0] + columns[1][r] * direction[1] + columns[2][r] * direction[2];
+        }
+        return result;
+    }
+
+    // NOTE: OPERATORS
+
+    // :: Compare operators
+    constexpr auto operator==(const matrix &other) const -> bool {
+        for (size_t c = 0; c < C; ++c) {
+            if (columns[c] != other.columns[c])
+                return false;
+        }
+        return true;
+    }
+    constexpr auto operator!=(const matrix &other) const -> bool {
+        return !(operator==(other));
+    }
+
+    // :: Operators
+    // +, - with matrix
+    constexpr auto operator+(const matrix &other) const -> matrix {
+        matrix result;
+        for (size_t c = 0; c < C; ++c) {
+            for (size_t r = 0; r < R; ++r) {
+                result.columns[c][r] = columns[c][r] + other.columns[c][r];
+            }
+        }
+        return result;
+    }
+    constexpr auto operator-(const matrix &other) const -> matrix {
+        matrix result;
+        for (size_t c = 0; c < C; ++c) {
+            for (size_t r = 0; r < R; ++r) {
+                result.columns[c][r] = columns[c][r] - other.columns[c][r];
+            }
+        }
+        return result;
+    }
+
+    // * with number
+    constexpr auto operator*(const T k) const -> matrix {
+        matrix result;
+        for (size_t c = 0; c < C; ++c) {
+            for (size_t r = 0; r < R; ++r) {
+                result.columns[c][r] = columns[c][r] * k;
+            }
+        }
+        return result;
+    }
+
+    // * with vector, a weighted sum of the columns
+    constexpr auto operator*(const row_type &v) const -> column_type {
+        column_type result;
+        if constexpr (simd_traits::enabled) {
+            if !consteval {
+                simd_traits::transform(result.data.data(), columns[0].data.data(), v.data.data());
+                return result;
+            }
+        }
+        for (size_t c = 0; c < C; ++c) {
+            for (size_t r = 0; r < R; ++r) {
+                result[r] += columns[c][r] * v[c];
+            }
+        }
+        return result;
+    }
+
+    // * with matrix
+    template <size_t N>
+    constexpr auto operator*(const matrix<T, C, N> &other) const -> matrix<T, R, N> {
+        matrix<T, R, N> result;
+        if constexpr (simd_traits::enabled && N == 4) {
+            if !consteval {
+                simd_traits::multiply(result.columns[0].data.data(), columns[0].data.data(), other.columns[0].data.data());
+                return result;
+            }
+        }
+        for (size_t j = 0; j < N; ++j) {
+            result.columns[j] = *this * other.columns[j];
+        }
+        return result;
+    }
+
+    constexpr auto operator*=(const matrix &other) -> matrix &
+        requires(R == C)
+    {
+        return *this = (*this * other);
+    }
+
+  private:
+    // 2x2 minors of rows 0-1 (s) and rows 2-3 (c) of a 4x4
+    constexpr auto minors_2x2() const -> std::pair<std::array<T, 6>, std::array<T, 6>>
+        requires(R == 4 && C == 4)
+    {
+        const matrix &m = *this;
+        std::array<T, 6> s = {m(0, 0) * m(1, 1) - m(1, 0) * m(0, 1),
+                              m(0, 0) * m(1, 2) - m(1, 0) * m(0, 2),
+                              m(0, 0) * m(1, 3) - m(1, 0) * m(0, 3),
+                              m(0, 1) * m(1, 2) - m(1, 1) * m(0, 2),
+                              m(0, 1) * m(1, 3) - m(1, 1) * m(0, 3),
+                              m(0, 2) * m(1, 3) - m(1, 2) * m(0, 3)};
+        std::array<T, 6> c = {m(2, 0) * m(3, 1) - m(3, 0) * m(2, 1),
+                              m(2, 0) * m(3, 2) - m(3, 0) * m(2, 2),
+                              m(2, 0) * m(3, 3) - m(3, 0) * m(2, 3),
+                              m(2, 1) * m(3, 2) - m(3, 1) * m(2, 2),
+                              m(2, 1) * m(3, 3) - m(3, 1) * m(2, 3),
+                              m(2, 2) * m(3, 3) - m(3, 2) * m(2, 3)};
+        return {s, c};
+    }
+};
+
+// Define the rest of operator
+template <typename T, size_t R, size_t C>
+constexpr auto operator*(const T k, const matrix<T, R, C> &m) -> matrix<T, R, C> {
+    return m * k;
+}
+
+// :: Common aliases
+template <typename T>
+using matrix2 = matrix<T, 2, 2>;
+template <typename T>
+using matrix3 = matrix<T, 3, 3>;
+template <typename T>
+using matrix4 = matrix<T, 4, 4>;
+
+} // namespace mia
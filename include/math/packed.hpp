@@ -0,0 +1,602 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+#include "batch.hpp"
+#include "vector.hpp"
+
+namespace mia {
+
+// NOTE: HALF PRECISION
+// IEEE 754 binary16, rounded to nearest even: the same bits F16C produces, NaN payloads included
+
+constexpr auto float_to_half(const float value) noexcept -> uint16_t {
+    constexpr uint32_t infinity = 0x7F80'0000u;
+    constexpr uint32_t overflow = (127u + 16) << 23;                  // 65536, rounds past the largest half
+    constexpr uint32_t normal = (127u - 14) << 23;                    // smallest normal half, 2^-14
+    constexpr float subnormal_magic = std::bit_cast<float>(126u << 23); // 0.5, aligns the ulp of 2^-24 to bit 0
+
+    uint32_t bits = std::bit_cast<uint32_t>(value);
+    const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    bits &= 0x7FFF'FFFFu;
+
+    if (bits >= overflow) {
+        return sign | static_cast<uint16_t>(bits > infinity ? 0x7E00u | ((bits >> 13) & 0x3FFu) : 0x7C00u);
+    }
+    if (bits < normal) {
+        // The float adder rounds the mantissa for us
+        const float shifted = std::bit_cast<float>(bits) + subnormal_magic;
+        return sign | static_cast<uint16_t>(std::bit_cast<uint32_t>(shifted) - std::bit_cast<uint32_t>(subnormal_magic));
+    }
+    const uint32_t odd = (bits >> 13) & 1u;
+    bits += ((15u - 127u) << 23) + 0xFFFu + odd;
+    return sign | static_cast<uint16_t>(bits >> 13);
+}
+
+constexpr auto half_to_float(const uint16_t half) noexcept -> float {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1Fu;
+    const uint32_t mantissa = half & 0x3FFu;
+
+    if (exponent == 0x1F) {
+        return std::bit_cast<float>(sign | 0x7F80'0000u | (mantissa << 13));
+    }
+    if (exponent == 0) {
+        // Zero or subnormal, exact in float
+        const float magnitude = static_cast<float>(mantissa) * 0x1p-24f;
+        return std::bit_cast<float>(sign | std::bit_cast<uint32_t>(magnitude));
+    }
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+// NOTE: FORMATS
+// A format maps one float component to its `storage` and back
+
+struct half_format {
+    using storage = uint16_t;
+
+    static constexpr auto encode(const float value) noexcept -> storage {
+        return float_to_half(value);
+    }
+    static constexpr auto decode(const storage value) noexcept -> float {
+        return half_to_float(value);
+    }
+};
+
+namespace detail {
+
+// Half away from zero, `scaled` already clamped to the storage range
+constexpr auto round_to_int(const float scaled) noexcept -> int32_t {
+    return static_cast<int32_t>(scaled + (scaled < 0.0f ? -0.5f : 0.5f));
+}
+
+} // namespace detail
+
+// :: [-1, 1] onto [-max, max], the storage minimum decodes to -1 as well
+// Clamps mirror _mm_max_ps / _mm_min_ps, NaN encodes to -1
+template <std::signed_integral S>
+    requires(sizeof(S) <= 2)
+struct snorm_format {
+    using storage = S;
+
+    static constexpr float scale = static_cast<float>(std::numeric_limits<S>::max());
+    static constexpr float inverse_scale = 1.0f / scale;
+
+    static constexpr auto encode(const float value) noexcept -> storage {
+        const float low = value > -1.0f ? value : -1.0f;
+        const float clamped = low < 1.0f ? low : 1.0f;
+        return static_cast<storage>(detail::round_to_int(clamped * scale));
+    }
+    static constexpr auto decode(const storage value) noexcept -> float {
+        const float v = static_cast<float>(value) * inverse_scale;
+        return v > -1.0f ? v : -1.0f;
+    }
+};
+
+// :: [0, 1] onto [0, max], NaN encodes to 0
+template <std::unsigned_integral S>
+    requires(sizeof(S) <= 2)
+struct unorm_format {
+    using storage = S;
+
+    static constexpr float scale = static_cast<float>(std::numeric_limits<S>::max());
+    static constexpr float inverse_scale = 1.0f / scale;
+
+    static constexpr auto encode(const float value) noexcept -> storage {
+        const float low = value > 0.0f ? value : 0.0f;
+        const float clamped = low < 1.0f ? low : 1.0f;
+        return static_cast<storage>(detail::round_to_int(clamped * scale));
+    }
+    static constexpr auto decode(const storage value) noexcept -> float {
+        return static_cast<float>(value) * inverse_scale;
+    }
+};
+
+// NOTE: PACKED VECTOR
+// Storage only, tightly packed (no SIMD padding): decode to a vector<float, Dims> to compute
+
+template <typename Format, size_t Dims>
+struct packed_vector {
+    using format = Format;
+    using storage_type = typename Format::storage;
+
+    std::array<storage_type, Dims> data{};
+
+    [[nodiscard]] static constexpr auto encode(const vector<float, Dims> &v) noexcept -> packed_vector {
+        packed_vector packed;
+        for (size_t i = 0; i < Dims; ++i) {
+            packed.data[i] = Format::encode(v[i]);
+        }
+        return packed;
+    }
+
+    [[nodiscard]] constexpr auto decode() const noexcept -> vector<float, Dims> {
+        vector<float, Dims> v;
+        for (size_t i = 0; i < Dims; ++i) {
+            v[i] = Format::decode(data[i]);
+        }
+        return v;
+    }
+
+    constexpr auto operator==(const packed_vector &) const -> bool = default;
+};
+
+// :: Aliases
+using half2 = packed_vector<half_format, 2>;
+using half3 = packed_vector<half_format, 3>;
+using half4 = packed_vector<half_format, 4>;
+using snorm8x2 = packed_vector<snorm_format<int8_t>, 2>;
+using snorm8x3 = packed_vector<snorm_format<int8_t>, 3>;
+using snorm8x4 = packed_vector<snorm_format<int8_t>, 4>;
+using snorm16x2 = packed_vector<snorm_format<int16_t>, 2>;
+using snorm16x3 = packed_vector<snorm_format<int16_t>, 3>;
+using snorm16x4 = packed_vector<snorm_format<int16_t>, 4>;
+using unorm8x2 = packed_vector<unorm_format<uint8_t>, 2>;
+using unorm8x3 = packed_vector<unorm_format<uint8_t>, 3>;
+using unorm8x4 = packed_vector<unorm_format<uint8_t>, 4>;
+using unorm16x2 = packed_vector<unorm_format<uint16_t>, 2>;
+using unorm16x3 = packed_vector<unorm_format<uint16_t>, 3>;
+using unorm16x4 = packed_vector<unorm_format<uint16_t>, 4>;
+
+// NOTE: OCTAHEDRAL NORMAL
+// A direction projected onto the octahedron |x| + |y| + |z| = 1, the lower half folded over the
+// upper one, then quantized to two snorm components: 4 (or 2) bytes instead of 12
+
+template <std::signed_integral S = int16_t>
+    requires(sizeof(S) <= 2)
+struct octahedral_normal {
+    using format = snorm_format<S>;
+    using storage_type = S;
+
+    std::array<S, 2> data{};
+
+    // `n` does not need to be unit length, zero encodes +z
+    [[nodiscard]] static constexpr auto encode(const vector<float, 3> &n) noexcept -> octahedral_normal {
+        const float l1 = (abs(n[0]) + abs(n[1])) + abs(n[2]);
+        const float inverse = l1 > 0.0f ? 1.0f / l1 : 0.0f;
+        float u = n[0] * inverse;
+        float v = n[1] * inverse;
+        if (n[2] < 0.0f) {
+            const float folded_u = (1.0f - abs(v)) * sign(u);
+            const float folded_v = (1.0f - abs(u)) * sign(v);
+            u = folded_u;
+            v = folded_v;
+        }
+        return octahedral_normal{{format::encode(u), format::encode(v)}};
+    }
+
+    // Unit length
+    [[nodiscard]] constexpr auto decode() const noexcept -> vector<float, 3> {
+        float u = format::decode(data[0]);
+        float v = format::decode(data[1]);
+        const float z = 1.0f - abs(u) - abs(v);
+        if (z < 0.0f) {
+            const float unfolded_u = (1.0f - abs(v)) * sign(u);
+            const float unfolded_v = (1.0f - abs(u)) * sign(v);
+            u = unfolded_u;
+            v = unfolded_v;
+        }
+        return vector<float, 3>{u, v, z}.normalized();
+    }
+
+    constexpr auto operator==(const octahedral_normal &) const -> bool = default;
+
+  private:
+    static constexpr auto abs(const float x) noexcept -> float {
+        return x < 0.0f ? -x : x;
+    }
+    static constexpr auto sign(const float x) noexcept -> float {
+        return x >= 0.0f ? 1.0f : -1.0f;
+    }
+};
+
+using oct16 = octahedral_normal<int16_t>;
+using oct8 = octahedral_normal<int8_t>;
+
+} // namespace mia
+
+namespace mia::batch {
+
+namespace detail {
+
+// NOTE: PACKED KERNELS
+// Floats are the raw components of an array of mia::vector<float, Dims> (`stride` as for the float kernels),
+// packed components are contiguous, `dims` per vector
+
+// :: Scalar
+template <typename Format>
+inline void encode_scalar(const float *in, typename Format::storage *out, const size_t count, const size_t stride, const size_t dims) {
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t c = 0; c < dims; ++c) {
+            out[i * dims + c] = Format::encode(in[i * stride + c]);
+        }
+    }
+}
+
+template <typename Format>
+inline void decode_scalar(const typename Format::storage *in, float *out, const size_t count, const size_t stride, const size_t dims) {
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t c = 0; c < dims; ++c) {
+            out[i * stride + c] = Format::decode(in[i * dims + c]);
+        }
+    }
+}
+
+template <typename S>
+inline void encode_octahedral_scalar(const float *in, S *out, const size_t count, const size_t stride) {
+    for (size_t i = 0; i < count; ++i) {
+        const float *n = in + i * stride;
+        const auto packed = octahedral_normal<S>::encode(vector<float, 3>{n[0], n[1], n[2]});
+        out[2 * i + 0] = packed.data[0];
+        out[2 * i + 1] = packed.data[1];
+    }
+}
+
+template <typename S>
+inline void decode_octahedral_scalar(const S *in, float *out, const size_t count, const size_t stride) {
+    for (size_t i = 0; i < count; ++i) {
+        const vector<float, 3> n = octahedral_normal<S>{{in[2 * i + 0], in[2 * i + 1]}}.decode();
+        out[i * stride + 0] = n[0];
+        out[i * stride + 1] = n[1];
+        out[i * stride + 2] = n[2];
+    }
+}
+
+#if defined(MIA_BATCH_DISPATCH)
+
+// :: AVX2 + F16C, 8 components per iteration
+// Padded vector<float, 3> (stride 4) goes 2 vectors at a time, the padding lanes squeezed out with a permute
+
+template <typename Format>
+constexpr bool avx2_format_v = false;
+template <>
+constexpr bool avx2_format_v<half_format> = true;
+template <typename S>
+constexpr bool avx2_format_v<snorm_format<S>> = true;
+template <typename S>
+constexpr bool avx2_format_v<unorm_format<S>> = true;
+
+template <typename Format>
+MIA_TARGET("avx2,f16c")
+inline auto quantize_avx2(const __m256 v) -> __m256i {
+    constexpr float low = std::is_signed_v<typename Format::storage> ? -1.0f : 0.0f;
+    const __m256 clamped = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(low)), _mm256_set1_ps(1.0f));
+    const __m256 scaled = _mm256_mul_ps(clamped, _mm256_set1_ps(Format::scale));
+    // Half away from zero, as detail::round_to_int
+    const __m256 bias = _mm256_or_ps(_mm256_set1_ps(0.5f), _mm256_and_ps(scaled, _mm256_set1_ps(-0.0f)));
+    return _mm256_cvttps_epi32(_mm256_add_ps(scaled, bias));
+}
+
+// 8 int32 lanes, in range of S, narrowed into the low bytes
+template <typename S>
+MIA_TARGET("avx2")
+inline auto narrow_avx2(const __m256i lanes) -> __m128i {
+    if constexpr (sizeof(S) == 2) {
+        const __m256i words = std::is_signed_v<S> ? _mm256_packs_epi32(lanes, lanes) : _mm256_packus_epi32(lanes, lanes);
+        return _mm256_castsi256_si128(_mm256_permute4x64_epi64(words, 0b1000));
+    } else {
+        const __m256i words = _mm256_packs_epi32(lanes, lanes);
+        const __m256i bytes = std::is_signed_v<S> ? _mm256_packs_epi16(words, words) : _mm256_packus_epi16(words, words);
+        return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0)));
+    }
+}
+
+template <typename S>
+MIA_TARGET("avx2")
+inline auto widen_avx2(const __m128i packed) -> __m256i {
+    if constexpr (sizeof(S) == 2) {
+        return std::is_signed_v<S> ? _mm256_cvtepi16_epi32(packed) : _mm256_cvtepu16_epi32(packed);
+    } else {
+        return std::is_signed_v<S> ? _mm256_cvtepi8_epi32(packed) : _mm256_cvtepu8_epi32(packed);
+    }
+}
+
+// Encodes 8 floats, stores the first `n` (8 or 6)
+template <typename Format>
+MIA_TARGET("avx2,f16c")
+inline void store8_avx2(typename Format::storage *out, const __m256 v, const size_t n) {
+    using S = typename Format::storage;
+    alignas(16) S lanes[16 / sizeof(S)];
+    if constexpr (std::is_same_v<Format, half_format>) {
+        _mm_store_si128(reinterpret_cast<__m128i *>(lanes), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+    } else {
+        _mm_store_si128(reinterpret_cast<__m128i *>(lanes), narrow_avx2<S>(quantize_avx2<Format>(v)));
+    }
+    if (n == 8) {
+        std::memcpy(out, lanes, 8 * sizeof(S));
+    } else {
+        std::memcpy(out, lanes, 6 * sizeof(S));
+    }
+}
+
+// Decodes the 8 components at `in`, all of them readable
+template <typename Format>
+MIA_TARGET("avx2,f16c")
+inline auto load8_avx2(const typename Format::storage *in) -> __m256 {
+    using S = typename Format::storage;
+    const __m128i packed = sizeof(S) == 2 ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(in))
+                                          : _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in));
+    if constexpr (std::is_same_v<Format, half_format>) {
+        return _mm256_cvtph_ps(packed);
+    } else {
+        const __m256 v = _mm256_mul_ps(_mm256_cvtepi32_ps(widen_avx2<S>(packed)), _mm256_set1_ps(Format::inverse_scale));
+        return std::is_signed_v<S> ? _mm256_max_ps(v, _mm256_set1_ps(-1.0f)) : v;
+    }
+}
+
+template <typename Format>
+MIA_TARGET("avx2,f16c")
+inline void encode_avx2(const float *in, typename Format::storage *out, const size_t count, const size_t stride, const size_t dims) {
+    size_t i = 0;
+    if (stride == dims) {
+        const size_t n = count * dims;
+        for (; i + 8 <= n; i += 8) {
+            store8_avx2<Format>(out + i, _mm256_loadu_ps(in + i), 8);
+        }
+        for (; i < n; ++i) {
+            out[i] = Format::encode(in[i]);
+        }
+        return;
+    }
+    if (stride == 4 && dims == 3) {
+        const __m256i squeeze = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+        for (; i + 2 <= count; i += 2) {
+            store8_avx2<Format>(out + i * 3, _mm256_permutevar8x32_ps(_mm256_loadu_ps(in + i * 4), squeeze), 6);
+        }
+    }
+    encode_scalar<Format>(in + i * stride, out + i * dims, count - i, stride, dims);
+}
+
+template <typename Format>
+MIA_TARGET("avx2,f16c")
+inline void decode_avx2(const typename Format::storage *in, float *out, const size_t count, const size_t stride, const size_t dims) {
+    size_t i = 0;
+    if (stride == dims) {
+        const size_t n = count * dims;
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_ps(out + i, load8_avx2<Format>(in + i));
+        }
+        for (; i < n; ++i) {
+            out[i] = Format::decode(in[i]);
+        }
+        return;
+    }
+    if (stride == 4 && dims == 3) {
+        // Lanes 6 & 7 belong to the next vector: a third one must follow, the padding is zeroed
+        const __m256i spread = _mm256_setr_epi32(0, 1, 2, 6, 3, 4, 5, 7);
+        for (; i + 3 <= count; i += 2) {
+            const __m256 v = _mm256_permutevar8x32_ps(load8_avx2<Format>(in + i * 3), spread);
+            _mm256_storeu_ps(out + i * 4, _mm256_blend_ps(v, _mm256_setzero_ps(), 0b1000'1000));
+        }
+    }
+    decode_scalar<Format>(in + i * dims, out + i * stride, count - i, stride, dims);
+}
+
+// :: AVX2 octahedral, 8 normals per iteration, components gathered out of the AoS
+MIA_TARGET("avx2")
+inline auto octahedral_sign_avx2(const __m256 x) -> __m256 {
+    return _mm256_blendv_ps(_mm256_set1_ps(-1.0f), _mm256_set1_ps(1.0f), _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GE_OQ));
+}
+
+MIA_TARGET("avx2")
+inline auto octahedral_abs_avx2(const __m256 x) -> __m256 {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x);
+}
+
+template <typename S>
+MIA_TARGET("avx2,f16c")
+inline void encode_octahedral_avx2(const float *in, S *out, const size_t count, const size_t stride) {
+    const __m256i index = gather_index_avx2(stride);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const float *base = in + i * stride;
+        const __m256 x = _mm256_i32gather_ps(base + 0, index, 4);
+        const __m256 y = _mm256_i32gather_ps(base + 1, index, 4);
+        const __m256 z = _mm256_i32gather_ps(base + 2, index, 4);
+        const __m256 l1 = _mm256_add_ps(_mm256_add_ps(octahedral_abs_avx2(x), octahedral_abs_avx2(y)), octahedral_abs_avx2(z));
+        const __m256 inverse = _mm256_and_ps(_mm256_div_ps(one, l1), _mm256_cmp_ps(l1, _mm256_setzero_ps(), _CMP_GT_OQ));
+        const __m256 u = _mm256_mul_ps(x, inverse);
+        const __m256 v = _mm256_mul_ps(y, inverse);
+        const __m256 folded_u = _mm256_mul_ps(_mm256_sub_ps(one, octahedral_abs_avx2(v)), octahedral_sign_avx2(u));
+        const __m256 folded_v = _mm256_mul_ps(_mm256_sub_ps(one, octahedral_abs_avx2(u)), octahedral_sign_avx2(v));
+        const __m256 lower = _mm256_cmp_ps(z, _mm256_setzero_ps(), _CMP_LT_OQ);
+        const __m256i qu = quantize_avx2<snorm_format<S>>(_mm256_blendv_ps(u, folded_u, lower));
+        const __m256i qv = quantize_avx2<snorm_format<S>>(_mm256_blendv_ps(v, folded_v, lower));
+
+        // Per 128-bit lane: u0 v0 u1 v1 | u2 v2 u3 v3, packing keeps that order
+        const __m256i low = _mm256_unpacklo_epi32(qu, qv);
+        const __m256i high = _mm256_unpackhi_epi32(qu, qv);
+        const __m256i words = _mm256_packs_epi32(low, high);
+        if constexpr (sizeof(S) == 2) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 2 * i), words);
+        } else {
+            const __m256i bytes = _mm256_permute4x64_epi64(_mm256_packs_epi16(words, words), 0b1000);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 2 * i), _mm256_castsi256_si128(bytes));
+        }
+    }
+    encode_octahedral_scalar(in + i * stride, out + 2 * i, count - i, stride);
+}
+
+template <typename S>
+MIA_TARGET("avx2,f16c")
+inline void decode_octahedral_avx2(const S *in, float *out, const size_t count, const size_t stride) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // u in the low, v in the high 16 bits of each 32-bit pair
+        __m256i pairs;
+        if constexpr (sizeof(S) == 2) {
+            pairs = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 2 * i));
+        } else {
+            pairs = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 2 * i)));
+        }
+        const __m256 scale = _mm256_set1_ps(snorm_format<S>::inverse_scale);
+        const __m256 minus_one = _mm256_set1_ps(-1.0f);
+        const __m256 u = _mm256_max_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(pairs, 16), 16)), scale), minus_one);
+        const __m256 v = _mm256_max_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(pairs, 16)), scale), minus_one);
+        const __m256 z = _mm256_sub_ps(_mm256_sub_ps(one, octahedral_abs_avx2(u)), octahedral_abs_avx2(v));
+        const __m256 unfolded_u = _mm256_mul_ps(_mm256_sub_ps(one, octahedral_abs_avx2(v)), octahedral_sign_avx2(u));
+        const __m256 unfolded_v = _mm256_mul_ps(_mm256_sub_ps(one, octahedral_abs_avx2(u)), octahedral_sign_avx2(v));
+        const __m256 lower = _mm256_cmp_ps(z, _mm256_setzero_ps(), _CMP_LT_OQ);
+        const __m256 x = _mm256_blendv_ps(u, unfolded_u, lower);
+        const __m256 y = _mm256_blendv_ps(v, unfolded_v, lower);
+        const __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+        const __m256 inverse = _mm256_div_ps(one, length);
+
+        alignas(32) float components[3][8];
+        _mm256_store_ps(components[0], _mm256_mul_ps(x, inverse));
+        _mm256_store_ps(components[1], _mm256_mul_ps(y, inverse));
+        _mm256_store_ps(components[2], _mm256_mul_ps(z, inverse));
+        for (size_t k = 0; k < 8; ++k) {
+            float *n = out + (i + k) * stride;
+            n[0] = components[0][k];
+            n[1] = components[1][k];
+            n[2] = components[2][k];
+        }
+    }
+    decode_octahedral_scalar(in + 2 * i, out + i * stride, count - i, stride);
+}
+
+#endif // MIA_BATCH_DISPATCH
+
+// NOTE: PACKED DISPATCH
+// F16C ships with every AVX2 core but is checked anyway; AVX-512 cores run the AVX2 kernels
+
+template <typename Format>
+struct packed_kernels {
+    using storage = typename Format::storage;
+
+    isa level;
+    void (*encode)(const float *, storage *, size_t, size_t, size_t);
+    void (*decode)(const storage *, float *, size_t, size_t, size_t);
+};
+
+template <typename S>
+struct octahedral_kernels {
+    isa level;
+    void (*encode)(const float *, S *, size_t, size_t);
+    void (*decode)(const S *, float *, size_t, size_t);
+};
+
+inline auto packed_avx2_supported(const isa level) noexcept -> bool {
+#if defined(MIA_BATCH_DISPATCH)
+    return level >= isa::avx2 && host_cpu_features().f16c;
+#else
+    (void)level;
+    return false;
+#endif
+}
+
+template <typename Format>
+inline auto packed_kernels_for(const isa level) -> packed_kernels<Format> {
+#if defined(MIA_BATCH_DISPATCH)
+    if constexpr (avx2_format_v<Format>) {
+        if (packed_avx2_supported(level)) {
+            return {isa::avx2, encode_avx2<Format>, decode_avx2<Format>};
+        }
+    }
+#endif
+    (void)level;
+    return {isa::scalar, encode_scalar<Format>, decode_scalar<Format>};
+}
+
+template <typename S>
+inline auto octahedral_kernels_for(const isa level) -> octahedral_kernels<S> {
+#if defined(MIA_BATCH_DISPATCH)
+    if (packed_avx2_supported(level)) {
+        return {isa::avx2, encode_octahedral_avx2<S>, decode_octahedral_avx2<S>};
+    }
+#endif
+    (void)level;
+    return {isa::scalar, encode_octahedral_scalar<S>, decode_octahedral_scalar<S>};
+}
+
+// Selected once per format, on first use
+template <typename Format>
+inline auto active_packed_kernels() -> const packed_kernels<Format> & {
+    static const packed_kernels<Format> kernels = packed_kernels_for<Format>(active_level());
+    return kernels;
+}
+
+template <typename S>
+inline auto active_octahedral_kernels() -> const octahedral_kernels<S> & {
+    static const octahedral_kernels<S> kernels = octahedral_kernels_for<S>(active_level());
+    return kernels;
+}
+
+} // namespace detail
+
+// NOTE: PACKED ENCODE / DECODE
+// Every output span must be at least as long as the input
+
+template <typename Format, size_t Dims>
+inline void encode(std::span<const vector<float, Dims>> in, std::span<packed_vector<Format, Dims>> out) {
+    assert(out.size() >= in.size());
+    if (in.empty()) {
+        return;
+    }
+    detail::active_packed_kernels<Format>().encode(detail::components(in), out.front().data.data(),
+                                                   in.size(), detail::stride_v<float, Dims>, Dims);
+}
+
+template <typename Format, size_t Dims>
+inline void decode(std::span<const packed_vector<Format, Dims>> in, std::span<vector<float, Dims>> out) {
+    assert(out.size() >= in.size());
+    if (in.empty()) {
+        return;
+    }
+    detail::active_packed_kernels<Format>().decode(in.front().data.data(), detail::components(out),
+                                                   in.size(), detail::stride_v<float, Dims>, Dims);
+}
+
+template <typename S>
+inline void encode(std::span<const vector<float, 3>> in, std::span<octahedral_normal<S>> out) {
+    assert(out.size() >= in.size());
+    if (in.empty()) {
+        return;
+    }
+    detail::active_octahedral_kernels<S>().encode(detail::components(in), out.front().data.data(),
+                                                  in.size(), detail::stride_v<float, 3>);
+}
+
+template <typename S>
+inline void decode(std::span<const octahedral_normal<S>> in, std::span<vector<float, 3>> out) {
+    assert(out.size() >= in.size());
+    if (in.empty()) {
+        return;
+    }
+    detail::active_octahedral_kernels<S>().decode(in.front().data.data(), detail::components(out),
+                                                  in.size(), detail::stride_v<float, 3>);
+}
+
+} // namespace mia::batch
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "constexpr-math.hpp"
+#include "matrix.hpp"
+#include "vector.hpp"
+
+namespace mia {
+
+// Rotation quaternion x i + y j + z k + w
+// Everything but from_axis_angle, slerp & slerp_fast is constexpr. Rotations assume unit length,
+// renormalize after long chains of products. Batched rotation lives in batch.hpp and vector-soa.hpp
+template <typename T>
+    requires std::is_floating_point_v<T>
+class quaternion {
+  public:
+    // NOTE: MEMBER TYPES
+
+    using value_type = T;
+    using vector_type = vector<T, 3>;
+
+    // (x, y, z, w), one aligned SIMD register for float & double with SIMD enabled
+    vector<T, 4> data{T{0}, T{0}, T{0}, T{1}};
+
+    // NOTE: CONSTRUCTOR
+
+    // Identity rotation
+    constexpr quaternion() = default;
+
+    constexpr quaternion(const T x, const T y, const T z, const T w)
+        : data{x, y, z, w} {
+    }
+
+    static constexpr auto identity() -> quaternion {
+        return {};
+    }
+
+    // Counter-clockwise rotation of `radians` around `axis`, axis need not be unit length
+    static auto from_axis_angle(const vector_type &axis, const T radians) -> quaternion {
+        const T length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+        const T k = std::sin(radians / 2) / length;
+        return {axis[0] * k, axis[1] * k, axis[2] * k, std::cos(radians / 2)};
+    }
+
+    // From a rotation matrix (orthonormal, determinant 1), Shepperd's method: the largest
+    // diagonal term picks the formula so the division never goes near 0
+    static constexpr auto from_matrix(const matrix<T, 3, 3> &m) -> quaternion {
+        const T trace = m(0, 0) + m(1, 1) + m(2, 2);
+        if (trace > 0) {
+            const T s = math::sqrt(trace + T{1}) * 2;
+            return {(m(2, 1) - m(1, 2)) / s, (m(0, 2) - m(2, 0)) / s, (m(1, 0) - m(0, 1)) / s, s / 4};
+        }
+        if (m(0, 0) > m(1, 1) && m(0, 0) > m(2, 2)) {
+            const T s = math::sqrt(T{1} + m(0, 0) - m(1, 1) - m(2, 2)) * 2;
+            return {s / 4, (m(0, 1) + m(1, 0)) / s, (m(0, 2) + m(2, 0)) / s, (m(2, 1) - m(1, 2)) / s};
+        }
+        if (m(1, 1) > m(2, 2)) {
+            const T s = math::sqrt(T{1} + m(1, 1) - m(0, 0) - m(2, 2)) * 2;
+            return {(m(0, 1) + m(1, 0)) / s, s / 4, (m(1, 2) + m(2, 1)) / s, (m(0, 2) - m(2, 0)) / s};
+        }
+        const T s = math::sqrt(T{1} + m(2, 2) - m(0, 0) - m(1, 1)) * 2;
+        return {(m(0, 2) + m(2, 0)) / s, (m(1, 2) + m(2, 1)) / s, s / 4, (m(1, 0) - m(0, 1)) / s};
+    }
+    // Upper-left 3x3 of an affine transform without scale
+    static constexpr auto from_matrix(const matrix<T, 4, 4> &m) -> quaternion {
+        matrix<T, 3, 3> rotation;
+        for (size_t c = 0; c < 3; ++c) {
+            for (size_t r = 0; r < 3; ++r) {
+                rotation(r, c) = m(r, c);
+            }
+        }
+        return from_matrix(rotation);
+    }
+
+    // NOTE: ELEMENT ACCESS
+
+    constexpr auto x() const -> T {
+        return data[0];
+    }
+    constexpr auto y() const -> T {
+        return data[1];
+    }
+    constexpr auto z() const -> T {
+        return data[2];
+    }
+    constexpr auto w() const -> T {
+        return data[3];
+    }
+    // Imaginary part
+    constexpr auto vector_part() const -> vector_type {
+        return vector_type{data[0], data[1], data[2]};
+    }
+
+    // NOTE: CONST FUNCTIONS
+
+    // Computed in T, unlike vector::dot_product (whose compute_type is float for double)
+    static constexpr auto dot(const quaternion &lhs, const quaternion &rhs) -> T {
+        return lhs.data[0] * rhs.data[0] + lhs.data[1] * rhs.data[1] + lhs.data[2] * rhs.data[2] + lhs.data[3] * rhs.data[3];
+    }
+    [[nodiscard]] constexpr auto magnitude_squared() const -> T {
+        return dot(*this, *this);
+    }
+    [[nodiscard]] constexpr auto magnitude() const -> T {
+        return math::sqrt(magnitude_squared());
+    }
+    [[nodiscard]] constexpr auto normalized() const -> quaternion {
+        const T k = T{1} / magnitude();
+        return {data[0] * k, data[1] * k, data[2] * k, data[3] * k};
+    }
+
+    [[nodiscard]] constexpr auto conjugate() const -> quaternion {
+        return {-data[0], -data[1], -data[2], data[3]};
+    }
+    // Conjugate for unit quaternions, also correct otherwise
+    [[nodiscard]] constexpr auto inverse() const -> quaternion {
+        const T k = T{1} / magnitude_squared();
+        return {-data[0] * k, -data[1] * k, -data[2] * k, data[3] * k};
+    }
+
+    // v' = q v q*, expanded to two cross products: t = 2 (u x v), v' = v + w t + u x t
+    [[nodiscard]] constexpr auto rotate(const vector_type &v) const -> vector_type {
+        const T ux = data[0];
+        const T uy = data[1];
+        const T uz = data[2];
+        const T tx = 2 * (uy * v[2] - uz * v[1]);
+        const T ty = 2 * (uz * v[0] - ux * v[2]);
+        const T tz = 2 * (ux * v[1] - uy * v[0]);
+        return vector_type{v[0] + data[3] * tx + (uy * tz - uz * ty),
+                           v[1] + data[3] * ty + (uz * tx - ux * tz),
+                           v[2] + data[3] * tz + (ux * ty - uy * tx)};
+    }
+
+    // NOTE: CONVERSION
+
+    [[nodiscard]] constexpr auto to_matrix3() const -> matrix<T, 3, 3> {
+        const T x = data[0];
+        const T y = data[1];
+        const T z = data[2];
+        const T w = data[3];
+        return matrix<T, 3, 3>::from_rows({T{1} - 2 * (y * y + z * z), 2 * (x * y - z * w), 2 * (x * z + y * w),
+                                           2 * (x * y + z * w), T{1} - 2 * (x * x + z * z), 2 * (y * z - x * w),
+                                           2 * (x * z - y * w), 2 * (y * z + x * w), T{1} - 2 * (x * x + y * y)});
+    }
+    [[nodiscard]] constexpr auto to_matrix4() const -> matrix<T, 4, 4> {
+        const matrix<T, 3, 3> rotation = to_matrix3();
+        matrix<T, 4, 4> result = matrix<T, 4, 4>::identity();
+        for (size_t c = 0; c < 3; ++c) {
+            for (size_t r = 0; r < 3; ++r) {
+                result(r, c) = rotation(r, c);
+            }
+        }
+        return result;
+    }
+
+    // NOTE: INTERPOLATION
+    // All take the shortest arc (rhs is negated when the quaternions are more than 180 degrees apart)
+
+    // Normalized lerp: constant-time, exact at 0, 1/2 & 1, angular speed varies in between
+    static constexpr auto nlerp(const quaternion &from, const quaternion &to, const T alpha) -> quaternion {
+        const T k = dot(from, to) < 0 ? -alpha : alpha;
+        return blend(from, to, T{1} - alpha, k).normalized();
+    }
+
+    // Spherical lerp: constant angular speed
+    static auto slerp(const quaternion &from, const quaternion &to, const T alpha) -> quaternion {
+        T cos_v = dot(from, to);
+        const T sign = cos_v < 0 ? T{-1} : T{1};
+        cos_v *= sign;
+        // Nearly parallel, sin(theta) ~ 0 and nlerp is within rounding of slerp
+        if (cos_v > static_cast<T>(0.9995)) {
+            return nlerp(from, to, alpha);
+        }
+        const T theta = std::acos(cos_v);
+        const T sin_theta = std::sin(theta);
+        return blend(from, to, std::sin((T{1} - alpha) * theta) / sin_theta, sign * std::sin(alpha * theta) / sin_theta);
+    }
+
+    // nlerp with alpha corrected by a cubic fitted to slerp (zeux.io, "Approximating slerp", 2015)
+    // No trigonometry, worst angular error ~7e-4 radians up to 180 degrees apart (see quaternion-test.cpp)
+    static auto slerp_fast(const quaternion &from, const quaternion &to, const T alpha) -> quaternion {
+        const T d = std::abs(dot(from, to));
+        const T a = static_cast<T>(1.0904) + d * (static_cast<T>(-3.2452) + d * (static_cast<T>(3.55645) - d * static_cast<T>(1.43519)));
+        const T b = static_cast<T>(0.848013) + d * (static_cast<T>(-1.06021) + d * static_cast<T>(0.215638));
+        const T k = a * (alpha - static_cast<T>(0.5)) * (alpha - static_cast<T>(0.5)) + b;
+        const T corrected = alpha + alpha * (alpha - static_cast<T>(0.5)) * (alpha - T{1}) * k;
+        return nlerp(from, to, corrected);
+    }
+
+    // NOTE: OPERATORS
+
+    // :: Compare operators
+    constexpr auto operator==(const quaternion &other) const -> bool {
+        return data[0] == other.data[0] && data[1] == other.data[1] && data[2] == other.data[2] && data[3] == other.data[3];
+    }
+    constexpr auto operator!=(const quaternion &other) const -> bool {
+        return !(operator==(other));
+    }
+
+    // :: Operators
+    // Hamilton product, (a * b) rotates by b then by a
+    constexpr auto operator*(const quaternion &other) const -> quaternion {
+        const T ax = data[0], ay = data[1], az = data[2], aw = data[3];
+        const T bx = other.data[0], by = other.data[1], bz = other.data[2], bw = other.data[3];
+        return {aw * bx + ax * bw + ay * bz - az * by,
+                aw * by - ax * bz + ay * bw + az * bx,
+                aw * bz + ax * by - ay * bx + az * bw,
+                aw * bw - ax * bx - ay * by - az * bz};
+    }
+    constexpr auto operator*=(const quaternion &other) -> quaternion & {
+        return *this = (*this * other);
+    }
+
+    // Same as rotate(v)
+    constexpr auto operator*(const vector_type &v) const -> vector_type {
+        return rotate(v);
+    }
+
+  private:
+    // a * from + b * to
+    static constexpr auto blend(const quaternion &from, const quaternion &to, const T a, const T b) -> quaternion {
+        return {a * from.data[0] + b * to.data[0], a * from.data[1] + b * to.data[1],
+                a * from.data[2] + b * to.data[2], a * from.data[3] + b * to.data[3]};
+    }
+};
+
+} // namespace mia
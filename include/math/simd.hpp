@@ -0,0 +1,1205 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "cpu-features.hpp"
+
+// NOTE: SIMD is opt-in, define MIA_ENABLE_SIMD (or configure with -DMIA_ENABLE_SIMD=ON)
+// SSE2 is the baseline; AVX, AVX2, FMA & AVX-512F are used when the target enables them (-mavx2 -mfma, -mavx512f)
+#if defined(MIA_ENABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#define MIA_SIMD_SSE2 1
+#include <emmintrin.h>
+#if defined(__AVX__)
+#define MIA_SIMD_AVX 1
+#include <immintrin.h>
+#endif
+#if defined(__AVX2__)
+#define MIA_SIMD_AVX2 1
+#endif
+#if defined(__FMA__)
+#define MIA_SIMD_FMA 1
+#endif
+#if defined(__AVX512F__)
+#define MIA_SIMD_AVX512 1
+#endif
+#endif
+
+namespace mia::detail {
+
+// NOTE: SIMD OPERATIONS
+// simd_ops<T, N> is the engine of mia::simd<T, N>: a register `type`, a comparison `mask_type` and static kernels
+// Native specializations exist per instruction set (float 4 / 8 / 16, double 2 / 4 / 8), any other N is
+// an array of the widest native parts dividing it, down to N = 1 (one scalar)
+// min / max follow std::min / std::max: min(a, b) = b < a ? b : a, max(a, b) = a < b ? b : a
+
+template <typename T, size_t N>
+struct simd_ops;
+
+// True for the widths with a register of their own (and N = 1, a scalar)
+template <typename T, size_t N>
+constexpr bool simd_native_v = N == 1;
+#if defined(MIA_SIMD_SSE2)
+template <>
+constexpr bool simd_native_v<float, 4> = true;
+template <>
+constexpr bool simd_native_v<double, 2> = true;
+#endif
+#if defined(MIA_SIMD_AVX)
+template <>
+constexpr bool simd_native_v<float, 8> = true;
+template <>
+constexpr bool simd_native_v<double, 4> = true;
+#endif
+#if defined(MIA_SIMD_AVX512)
+template <>
+constexpr bool simd_native_v<float, 16> = true;
+template <>
+constexpr bool simd_native_v<double, 8> = true;
+#endif
+
+// Widest native width below N dividing it, 1 when none does
+template <typename T, size_t N>
+consteval auto simd_part_width() -> size_t {
+    constexpr std::array<size_t, 4> widths = {16, 8, 4, 2};
+    constexpr std::array<bool, 4> natives = {simd_native_v<T, 16>, simd_native_v<T, 8>, simd_native_v<T, 4>, simd_native_v<T, 2>};
+    for (size_t k = 0; k < widths.size(); ++k) {
+        if (natives[k] && widths[k] < N && N % widths[k] == 0) {
+            return widths[k];
+        }
+    }
+    return 1;
+}
+
+// :: One scalar
+template <typename T, size_t N>
+    requires(N == 1)
+struct simd_ops<T, N> {
+    static constexpr bool native = simd_native_v<T, N>;
+    static constexpr bool accelerated = false;
+    static constexpr size_t width = 1;
+    using type = T;
+    using mask_type = bool;
+
+    static inline auto load(const T *p) noexcept -> type {
+        return *p;
+    }
+    static inline auto loadu(const T *p) noexcept -> type {
+        return *p;
+    }
+    static inline void store(T *p, const type v) noexcept {
+        *p = v;
+    }
+    static inline void storeu(T *p, const type v) noexcept {
+        *p = v;
+    }
+    static inline auto set1(const T v) noexcept -> type {
+        return v;
+    }
+    static inline auto gather(const T *base, const int32_t *indices) noexcept -> type {
+        return base[indices[0]];
+    }
+    static inline auto add(const type a, const type b) noexcept -> type {
+        return static_cast<T>(a + b);
+    }
+    static inline auto sub(const type a, const type b) noexcept -> type {
+        return static_cast<T>(a - b);
+    }
+    static inline auto mul(const type a, const type b) noexcept -> type {
+        return static_cast<T>(a * b);
+    }
+    static inline auto div(const type a, const type b) noexcept -> type {
+        return static_cast<T>(a / b);
+    }
+    static inline auto neg(const type a) noexcept -> type {
+        return static_cast<T>(-a);
+    }
+    static inline auto fma(const type a, const type b, const type c) noexcept -> type {
+        return static_cast<T>(a * b + c);
+    }
+    static inline auto min(const type a, const type b) noexcept -> type {
+        return std::min(a, b);
+    }
+    static inline auto max(const type a, const type b) noexcept -> type {
+        return std::max(a, b);
+    }
+    static inline auto abs(const type a) noexcept -> type {
+        return a < T{0} ? static_cast<T>(-a) : a;
+    }
+    static inline auto sqrt(const type a) noexcept -> type {
+        return static_cast<T>(std::sqrt(a));
+    }
+    // 1 / sqrt(a), float registers use the hardware estimate and one Newton step (see math::fast::rsqrt)
+    static inline auto rsqrt(const type a) noexcept -> type {
+        return static_cast<T>(static_cast<T>(1) / std::sqrt(a));
+    }
+    static inline auto eq(const type a, const type b) noexcept -> mask_type {
+        return a == b;
+    }
+    static inline auto lt(const type a, const type b) noexcept -> mask_type {
+        return a < b;
+    }
+    static inline auto le(const type a, const type b) noexcept -> mask_type {
+        return a <= b;
+    }
+    static inline auto mask_and(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return a && b;
+    }
+    static inline auto mask_or(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return a || b;
+    }
+    static inline auto mask_not(const mask_type a) noexcept -> mask_type {
+        return !a;
+    }
+    // Bit i set for lane i
+    static inline auto mask_bits(const mask_type a) noexcept -> uint64_t {
+        return a ? 1 : 0;
+    }
+    // Lanes of `a` where `m` is set, of `b` elsewhere
+    static inline auto select(const mask_type m, const type a, const type b) noexcept -> type {
+        return m ? a : b;
+    }
+    static inline auto reduce_add(const type a) noexcept -> T {
+        return a;
+    }
+    static inline auto reduce_min(const type a) noexcept -> T {
+        return a;
+    }
+    static inline auto reduce_max(const type a) noexcept -> T {
+        return a;
+    }
+};
+
+// K registers (masks) of Ops side by side, templated on Ops: __m128 & co as template arguments lose their attributes
+template <typename Ops, size_t K>
+struct simd_parts {
+    typename Ops::type part[K];
+
+    constexpr auto operator[](const size_t k) noexcept -> typename Ops::type & {
+        return part[k];
+    }
+    constexpr auto operator[](const size_t k) const noexcept -> const typename Ops::type & {
+        return part[k];
+    }
+};
+
+template <typename Ops, size_t K>
+struct simd_mask_parts {
+    typename Ops::mask_type part[K];
+
+    constexpr auto operator[](const size_t k) noexcept -> typename Ops::mask_type & {
+        return part[k];
+    }
+    constexpr auto operator[](const size_t k) const noexcept -> const typename Ops::mask_type & {
+        return part[k];
+    }
+};
+
+// :: Parts, the widest native registers dividing N (scalars at worst)
+template <typename T, size_t N>
+struct simd_ops {
+    static_assert(N > 0 && N <= 64, "mia::simd: 1 to 64 lanes");
+
+    using part = simd_ops<T, simd_part_width<T, N>()>;
+    static constexpr size_t parts = N / part::width;
+
+    static constexpr bool native = simd_native_v<T, N>;
+    static constexpr bool accelerated = part::accelerated;
+    static constexpr size_t width = N;
+    using type = simd_parts<part, parts>;
+    using mask_type = simd_mask_parts<part, parts>;
+
+    template <typename F>
+    static inline auto each(F f) noexcept -> type {
+        type result;
+        for (size_t k = 0; k < parts; ++k) {
+            result[k] = f(k);
+        }
+        return result;
+    }
+    template <typename F>
+    static inline auto each_mask(F f) noexcept -> mask_type {
+        mask_type result;
+        for (size_t k = 0; k < parts; ++k) {
+            result[k] = f(k);
+        }
+        return result;
+    }
+
+    static inline auto load(const T *p) noexcept -> type {
+        return each([p](const size_t k) { return part::load(p + k * part::width); });
+    }
+    static inline auto loadu(const T *p) noexcept -> type {
+        return each([p](const size_t k) { return part::loadu(p + k * part::width); });
+    }
+    static inline void store(T *p, const type v) noexcept {
+        for (size_t k = 0; k < parts; ++k) {
+            part::store(p + k * part::width, v[k]);
+        }
+    }
+    static inline void storeu(T *p, const type v) noexcept {
+        for (size_t k = 0; k < parts; ++k) {
+            part::storeu(p + k * part::width, v[k]);
+        }
+    }
+    static inline auto set1(const T v) noexcept -> type {
+        return each([v](size_t) { return part::set1(v); });
+    }
+    static inline auto gather(const T *base, const int32_t *indices) noexcept -> type {
+        return each([=](const size_t k) { return part::gather(base, indices + k * part::width); });
+    }
+    static inline auto add(const type &a, const type &b) noexcept -> type {
+        return each([&](const size_t k) { return part::add(a[k], b[k]); });
+    }
+    static inline auto sub(const type &a, const type &b) noexcept -> type {
+        return each([&](const size_t k) { return part::sub(a[k], b[k]); });
+    }
+    static inline auto mul(const type &a, const type &b) noexcept -> type {
+        return each([&](const size_t k) { return part::mul(a[k], b[k]); });
+    }
+    static inline auto div(const type &a, const type &b) noexcept -> type {
+        return each([&](const size_t k) { return part::div(a[k], b[k]); });
+    }
+    static inline auto neg(const type &a) noexcept -> type {
+        return each([&](const size_t k) { return part::neg(a[k]); });
+    }
+    static inline auto fma(const type &a, const type &b, const type &c) noexcept -> type {
+        return each([&](const size_t k) { return part::fma(a[k], b[k], c[k]); });
+    }
+    static inline auto min(const type &a, const type &b) noexcept -> type {
+        return each([&](const size_t k) { return part::min(a[k], b[k]); });
+    }
+    static inline auto max(const type &a, const type &b) noexcept -> type {
+        return each([&](const size_t k) { return part::max(a[k], b[k]); });
+    }
+    static inline auto abs(const type &a) noexcept -> type {
+        return each([&](const size_t k) { return part::abs(a[k]); });
+    }
+    static inline auto sqrt(const type &a) noexcept -> type {
+        return each([&](const size_t k) { return part::sqrt(a[k]); });
+    }
+    static inline auto rsqrt(const type &a) noexcept -> type {
+        return each([&](const size_t k) { return part::rsqrt(a[k]); });
+    }
+    static inline auto eq(const type &a, const type &b) noexcept -> mask_type {
+        return each_mask([&](const size_t k) { return part::eq(a[k], b[k]); });
+    }
+    static inline auto lt(const type &a, const type &b) noexcept -> mask_type {
+        return each_mask([&](const size_t k) { return part::lt(a[k], b[k]); });
+    }
+    static inline auto le(const type &a, const type &b) noexcept -> mask_type {
+        return each_mask([&](const size_t k) { return part::le(a[k], b[k]); });
+    }
+    static inline auto mask_and(const mask_type &a, const mask_type &b) noexcept -> mask_type {
+        return each_mask([&](const size_t k) { return part::mask_and(a[k], b[k]); });
+    }
+    static inline auto mask_or(const mask_type &a, const mask_type &b) noexcept -> mask_type {
+        return each_mask([&](const size_t k) { return part::mask_or(a[k], b[k]); });
+    }
+    static inline auto mask_not(const mask_type &a) noexcept -> mask_type {
+        return each_mask([&](const size_t k) { return part::mask_not(a[k]); });
+    }
+    static inline auto mask_bits(const mask_type &a) noexcept -> uint64_t {
+        uint64_t bits = 0;
+        for (size_t k = 0; k < parts; ++k) {
+            bits |= part::mask_bits(a[k]) << (k * part::width);
+        }
+        return bits;
+    }
+    static inline auto select(const mask_type &m, const type &a, const type &b) noexcept -> type {
+        return each([&](const size_t k) { return part::select(m[k], a[k], b[k]); });
+    }
+    // Parts are combined first, then one part is reduced
+    static inline auto reduce_add(const type &a) noexcept -> T {
+        typename part::type acc = a[0];
+        for (size_t k = 1; k < parts; ++k) {
+            acc = part::add(acc, a[k]);
+        }
+        return part::reduce_add(acc);
+    }
+    static inline auto reduce_min(const type &a) noexcept -> T {
+        typename part::type acc = a[0];
+        for (size_t k = 1; k < parts; ++k) {
+            acc = part::min(acc, a[k]);
+        }
+        return part::reduce_min(acc);
+    }
+    static inline auto reduce_max(const type &a) noexcept -> T {
+        typename part::type acc = a[0];
+        for (size_t k = 1; k < parts; ++k) {
+            acc = part::max(acc, a[k]);
+        }
+        return part::reduce_max(acc);
+    }
+};
+
+#if defined(MIA_SIMD_SSE2)
+
+// :: SSE2, float x 4 & double x 2
+// Operands of min / max are swapped so the result matches std::min / std::max exactly (ties & NaN)
+template <>
+struct simd_ops<float, 4> {
+    static constexpr bool native = true;
+    static constexpr bool accelerated = true;
+    static constexpr size_t width = 4;
+    using type = __m128;
+    using mask_type = __m128;
+
+    static inline auto load(const float *p) noexcept -> type {
+        return _mm_load_ps(p);
+    }
+    static inline auto loadu(const float *p) noexcept -> type {
+        return _mm_loadu_ps(p);
+    }
+    static inline void store(float *p, const type v) noexcept {
+        _mm_store_ps(p, v);
+    }
+    static inline void storeu(float *p, const type v) noexcept {
+        _mm_storeu_ps(p, v);
+    }
+    static inline auto set1(const float v) noexcept -> type {
+        return _mm_set1_ps(v);
+    }
+    static inline auto gather(const float *base, const int32_t *indices) noexcept -> type {
+        return _mm_setr_ps(base[indices[0]], base[indices[1]], base[indices[2]], base[indices[3]]);
+    }
+    static inline auto add(const type a, const type b) noexcept -> type {
+        return _mm_add_ps(a, b);
+    }
+    static inline auto sub(const type a, const type b) noexcept -> type {
+        return _mm_sub_ps(a, b);
+    }
+    static inline auto mul(const type a, const type b) noexcept -> type {
+        return _mm_mul_ps(a, b);
+    }
+    static inline auto div(const type a, const type b) noexcept -> type {
+        return _mm_div_ps(a, b);
+    }
+    static inline auto neg(const type a) noexcept -> type {
+        return _mm_xor_ps(a, _mm_set1_ps(-0.0f));
+    }
+    static inline auto fma(const type a, const type b, const type c) noexcept -> type {
+#if defined(MIA_SIMD_FMA)
+        return _mm_fmadd_ps(a, b, c);
+#else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+    }
+    static inline auto min(const type a, const type b) noexcept -> type {
+        return _mm_min_ps(b, a);
+    }
+    static inline auto max(const type a, const type b) noexcept -> type {
+        return _mm_max_ps(b, a);
+    }
+    static inline auto abs(const type a) noexcept -> type {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+    }
+    static inline auto sqrt(const type a) noexcept -> type {
+        return _mm_sqrt_ps(a);
+    }
+    static inline auto rsqrt(const type a) noexcept -> type {
+        const type y = _mm_rsqrt_ps(a);
+        const type residual = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_mul_ps(a, y), y));
+        return _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), y), residual));
+    }
+    static inline auto eq(const type a, const type b) noexcept -> mask_type {
+        return _mm_cmpeq_ps(a, b);
+    }
+    static inline auto lt(const type a, const type b) noexcept -> mask_type {
+        return _mm_cmplt_ps(a, b);
+    }
+    static inline auto le(const type a, const type b) noexcept -> mask_type {
+        return _mm_cmple_ps(a, b);
+    }
+    static inline auto mask_and(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return _mm_and_ps(a, b);
+    }
+    static inline auto mask_or(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return _mm_or_ps(a, b);
+    }
+    static inline auto mask_not(const mask_type a) noexcept -> mask_type {
+        return _mm_xor_ps(a, _mm_castsi128_ps(_mm_set1_epi32(-1)));
+    }
+    static inline auto mask_bits(const mask_type a) noexcept -> uint64_t {
+        return static_cast<uint64_t>(_mm_movemask_ps(a));
+    }
+    static inline auto select(const mask_type m, const type a, const type b) noexcept -> type {
+        return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+    }
+    static inline auto reduce_add(const type a) noexcept -> float {
+        const type pairs = _mm_add_ps(a, _mm_movehl_ps(a, a));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+    }
+    static inline auto reduce_min(const type a) noexcept -> float {
+        const type pairs = _mm_min_ps(a, _mm_movehl_ps(a, a));
+        return _mm_cvtss_f32(_mm_min_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+    }
+    static inline auto reduce_max(const type a) noexcept -> float {
+        const type pairs = _mm_max_ps(a, _mm_movehl_ps(a, a));
+        return _mm_cvtss_f32(_mm_max_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+    }
+};
+
+template <>
+struct simd_ops<double, 2> {
+    static constexpr bool native = true;
+    static constexpr bool accelerated = true;
+    static constexpr size_t width = 2;
+    using type = __m128d;
+    using mask_type = __m128d;
+
+    static inline auto load(const double *p) noexcept -> type {
+        return _mm_load_pd(p);
+    }
+    static inline auto loadu(const double *p) noexcept -> type {
+        return _mm_loadu_pd(p);
+    }
+    static inline void store(double *p, const type v) noexcept {
+        _mm_store_pd(p, v);
+    }
+    static inline void storeu(double *p, const type v) noexcept {
+        _mm_storeu_pd(p, v);
+    }
+    static inline auto set1(const double v) noexcept -> type {
+        return _mm_set1_pd(v);
+    }
+    static inline auto gather(const double *base, const int32_t *indices) noexcept -> type {
+        return _mm_setr_pd(base[indices[0]], base[indices[1]]);
+    }
+    static inline auto add(const type a, const type b) noexcept -> type {
+        return _mm_add_pd(a, b);
+    }
+    static inline auto sub(const type a, const type b) noexcept -> type {
+        return _mm_sub_pd(a, b);
+    }
+    static inline auto mul(const type a, const type b) noexcept -> type {
+        return _mm_mul_pd(a, b);
+    }
+    static inline auto div(const type a, const type b) noexcept -> type {
+        return _mm_div_pd(a, b);
+    }
+    static inline auto neg(const type a) noexcept -> type {
+        return _mm_xor_pd(a, _mm_set1_pd(-0.0));
+    }
+    static inline auto fma(const type a, const type b, const type c) noexcept -> type {
+#if defined(MIA_SIMD_FMA)
+        return _mm_fmadd_pd(a, b, c);
+#else
+        return _mm_add_pd(_mm_mul_pd(a, b), c);
+#endif
+    }
+    static inline auto min(const type a, const type b) noexcept -> type {
+        return _mm_min_pd(b, a);
+    }
+    static inline auto max(const type a, const type b) noexcept -> type {
+        return _mm_max_pd(b, a);
+    }
+    static inline auto abs(const type a) noexcept -> type {
+        return _mm_andnot_pd(_mm_set1_pd(-0.0), a);
+    }
+    static inline auto sqrt(const type a) noexcept -> type {
+        return _mm_sqrt_pd(a);
+    }
+    static inline auto rsqrt(const type a) noexcept -> type {
+        return _mm_div_pd(_mm_set1_pd(1.0), _mm_sqrt_pd(a));
+    }
+    static inline auto eq(const type a, const type b) noexcept -> mask_type {
+        return _mm_cmpeq_pd(a, b);
+    }
+    static inline auto lt(const type a, const type b) noexcept -> mask_type {
+        return _mm_cmplt_pd(a, b);
+    }
+    static inline auto le(const type a, const type b) noexcept -> mask_type {
+        return _mm_cmple_pd(a, b);
+    }
+    static inline auto mask_and(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return _mm_and_pd(a, b);
+    }
+    static inline auto mask_or(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return _mm_or_pd(a, b);
+    }
+    static inline auto mask_not(const mask_type a) noexcept -> mask_type {
+        return _mm_xor_pd(a, _mm_castsi128_pd(_mm_set1_epi32(-1)));
+    }
+    static inline auto mask_bits(const mask_type a) noexcept -> uint64_t {
+        return static_cast<uint64_t>(_mm_movemask_pd(a));
+    }
+    static inline auto select(const mask_type m, const type a, const type b) noexcept -> type {
+        return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+    }
+    static inline auto reduce_add(const type a) noexcept -> double {
+        return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a)));
+    }
+    static inline auto reduce_min(const type a) noexcept -> double {
+        return _mm_cvtsd_f64(_mm_min_sd(a, _mm_unpackhi_pd(a, a)));
+    }
+    static inline auto reduce_max(const type a) noexcept -> double {
+        return _mm_cvtsd_f64(_mm_max_sd(a, _mm_unpackhi_pd(a, a)));
+    }
+};
+
+#if defined(MIA_SIMD_AVX)
+
+// :: AVX, float x 8 & double x 4; gathers need AVX2
+template <>
+struct simd_ops<float, 8> {
+    static constexpr bool native = true;
+    static constexpr bool accelerated = true;
+    static constexpr size_t width = 8;
+    using type = __m256;
+    using mask_type = __m256;
+    using half = simd_ops<float, 4>;
+
+    static inline auto load(const float *p) noexcept -> type {
+        return _mm256_load_ps(p);
+    }
+    static inline auto loadu(const float *p) noexcept -> type {
+        return _mm256_loadu_ps(p);
+    }
+    static inline void store(float *p, const type v) noexcept {
+        _mm256_store_ps(p, v);
+    }
+    static inline void storeu(float *p, const type v) noexcept {
+        _mm256_storeu_ps(p, v);
+    }
+    static inline auto set1(const float v) noexcept -> type {
+        return _mm256_set1_ps(v);
+    }
+    static inline auto gather(const float *base, const int32_t *indices) noexcept -> type {
+#if defined(MIA_SIMD_AVX2)
+        return _mm256_i32gather_ps(base, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(indices)), 4);
+#else
+        return _mm256_set_m128(half::gather(base, indices + 4), half::gather(base, indices));
+#endif
+    }
+    static inline auto add(const type a, const type b) noexcept -> type {
+        return _mm256_add_ps(a, b);
+    }
+    static inline auto sub(const type a, const type b) noexcept -> type {
+        return _mm256_sub_ps(a, b);
+    }
+    static inline auto mul(const type a, const type b) noexcept -> type {
+        return _mm256_mul_ps(a, b);
+    }
+    static inline auto div(const type a, const type b) noexcept -> type {
+        return _mm256_div_ps(a, b);
+    }
+    static inline auto neg(const type a) noexcept -> type {
+        return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f));
+    }
+    static inline auto fma(const type a, const type b, const type c) noexcept -> type {
+#if defined(MIA_SIMD_FMA)
+        return _mm256_fmadd_ps(a, b, c);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+    static inline auto min(const type a, const type b) noexcept -> type {
+        return _mm256_min_ps(b, a);
+    }
+    static inline auto max(const type a, const type b) noexcept -> type {
+        return _mm256_max_ps(b, a);
+    }
+    static inline auto abs(const type a) noexcept -> type {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+    }
+    static inline auto sqrt(const type a) noexcept -> type {
+        return _mm256_sqrt_ps(a);
+    }
+    static inline auto rsqrt(const type a) noexcept -> type {
+        const type y = _mm256_rsqrt_ps(a);
+        const type residual = _mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_mul_ps(a, y), y));
+        return _mm256_add_ps(y, _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), y), residual));
+    }
+    static inline auto eq(const type a, const type b) noexcept -> mask_type {
+        return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+    }
+    static inline auto lt(const type a, const type b) noexcept -> mask_type {
+        return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    }
+    static inline auto le(const type a, const type b) noexcept -> mask_type {
+        return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+    }
+    static inline auto mask_and(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return _mm256_and_ps(a, b);
+    }
+    static inline auto mask_or(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return _mm256_or_ps(a, b);
+    }
+    static inline auto mask_not(const mask_type a) noexcept -> mask_type {
+        return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1)));
+    }
+    static inline auto mask_bits(const mask_type a) noexcept -> uint64_t {
+        return static_cast<uint64_t>(_mm256_movemask_ps(a));
+    }
+    static inline auto select(const mask_type m, const type a, const type b) noexcept -> type {
+        return _mm256_blendv_ps(b, a, m);
+    }
+    static inline auto reduce_add(const type a) noexcept -> float {
+        return half::reduce_add(_mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1)));
+    }
+    static inline auto reduce_min(const type a) noexcept -> float {
+        return half::reduce_min(_mm_min_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1)));
+    }
+    static inline auto reduce_max(const type a) noexcept -> float {
+        return half::reduce_max(_mm_max_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1)));
+    }
+};
+
+template <>
+struct simd_ops<double, 4> {
+    static constexpr bool native = true;
+    static constexpr bool accelerated = true;
+    static constexpr size_t width = 4;
+    using type = __m256d;
+    using mask_type = __m256d;
+    using half = simd_ops<double, 2>;
+
+    static inline auto load(const double *p) noexcept -> type {
+        return _mm256_load_pd(p);
+    }
+    static inline auto loadu(const double *p) noexcept -> type {
+        return _mm256_loadu_pd(p);
+    }
+    static inline void store(double *p, const type v) noexcept {
+        _mm256_store_pd(p, v);
+    }
+    static inline void storeu(double *p, const type v) noexcept {
+        _mm256_storeu_pd(p, v);
+    }
+    static inline auto set1(const double v) noexcept -> type {
+        return _mm256_set1_pd(v);
+    }
+    static inline auto gather(const double *base, const int32_t *indices) noexcept -> type {
+#if defined(MIA_SIMD_AVX2)
+        return _mm256_i32gather_pd(base, _mm_loadu_si128(reinterpret_cast<const __m128i *>(indices)), 8);
+#else
+        return _mm256_set_m128d(half::gather(base, indices + 2), half::gather(base, indices));
+#endif
+    }
+    static inline auto add(const type a, const type b) noexcept -> type {
+        return _mm256_add_pd(a, b);
+    }
+    static inline auto sub(const type a, const type b) noexcept -> type {
+        return _mm256_sub_pd(a, b);
+    }
+    static inline auto mul(const type a, const type b) noexcept -> type {
+        return _mm256_mul_pd(a, b);
+    }
+    static inline auto div(const type a, const type b) noexcept -> type {
+        return _mm256_div_pd(a, b);
+    }
+    static inline auto neg(const type a) noexcept -> type {
+        return _mm256_xor_pd(a, _mm256_set1_pd(-0.0));
+    }
+    static inline auto fma(const type a, const type b, const type c) noexcept -> type {
+#if defined(MIA_SIMD_FMA)
+        return _mm256_fmadd_pd(a, b, c);
+#else
+        return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+    }
+    static inline auto min(const type a, const type b) noexcept -> type {
+        return _mm256_min_pd(b, a);
+    }
+    static inline auto max(const type a, const type b) noexcept -> type {
+        return _mm256_max_pd(b, a);
+    }
+    static inline auto abs(const type a) noexcept -> type {
+        return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a);
+    }
+    static inline auto sqrt(const type a) noexcept -> type {
+        return _mm256_sqrt_pd(a);
+    }
+    static inline auto rsqrt(const type a) noexcept -> type {
+        return _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(a));
+    }
+    static inline auto eq(const type a, const type b) noexcept -> mask_type {
+        return _mm256_cmp_pd(a, b, _CMP_EQ_OQ);
+    }
+    static inline auto lt(const type a, const type b) noexcept -> mask_type {
+        return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+    }
+    static inline auto le(const type a, const type b) noexcept -> mask_type {
+        return _mm256_cmp_pd(a, b, _CMP_LE_OQ);
+    }
+    static inline auto mask_and(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return _mm256_and_pd(a, b);
+    }
+    static inline auto mask_or(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return _mm256_or_pd(a, b);
+    }
+    static inline auto mask_not(const mask_type a) noexcept -> mask_type {
+        return _mm256_xor_pd(a, _mm256_castsi256_pd(_mm256_set1_epi32(-1)));
+    }
+    static inline auto mask_bits(const mask_type a) noexcept -> uint64_t {
+        return static_cast<uint64_t>(_mm256_movemask_pd(a));
+    }
+    static inline auto select(const mask_type m, const type a, const type b) noexcept -> type {
+        return _mm256_blendv_pd(b, a, m);
+    }
+    static inline auto reduce_add(const type a) noexcept -> double {
+        return half::reduce_add(_mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1)));
+    }
+    static inline auto reduce_min(const type a) noexcept -> double {
+        return half::reduce_min(_mm_min_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1)));
+    }
+    static inline auto reduce_max(const type a) noexcept -> double {
+        return half::reduce_max(_mm_max_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1)));
+    }
+};
+
+#endif // MIA_SIMD_AVX
+
+#if defined(MIA_SIMD_AVX512)
+
+// :: AVX-512F, float x 16 & double x 8; comparisons give k-masks
+template <>
+struct simd_ops<float, 16> {
+    static constexpr bool native = true;
+    static constexpr bool accelerated = true;
+    static constexpr size_t width = 16;
+    using type = __m512;
+    using mask_type = __mmask16;
+
+    static inline auto load(const float *p) noexcept -> type {
+        return _mm512_load_ps(p);
+    }
+    static inline auto loadu(const float *p) noexcept -> type {
+        return _mm512_loadu_ps(p);
+    }
+    static inline void store(float *p, const type v) noexcept {
+        _mm512_store_ps(p, v);
+    }
+    static inline void storeu(float *p, const type v) noexcept {
+        _mm512_storeu_ps(p, v);
+    }
+    static inline auto set1(const float v) noexcept -> type {
+        return _mm512_set1_ps(v);
+    }
+    static inline auto gather(const float *base, const int32_t *indices) noexcept -> type {
+#if defined(MIA_BATCH_DISPATCH)
+        return gather_avx512(base, _mm512_loadu_si512(indices));
+#else
+        return _mm512_i32gather_ps(_mm512_loadu_si512(indices), base, 4);
+#endif
+    }
+    static inline auto add(const type a, const type b) noexcept -> type {
+        return _mm512_add_ps(a, b);
+    }
+    static inline auto sub(const type a, const type b) noexcept -> type {
+        return _mm512_sub_ps(a, b);
+    }
+    static inline auto mul(const type a, const type b) noexcept -> type {
+        return _mm512_mul_ps(a, b);
+    }
+    static inline auto div(const type a, const type b) noexcept -> type {
+        return _mm512_div_ps(a, b);
+    }
+    static inline auto neg(const type a) noexcept -> type {
+        return _mm512_sub_ps(_mm512_setzero_ps(), a);
+    }
+    static inline auto fma(const type a, const type b, const type c) noexcept -> type {
+        return _mm512_fmadd_ps(a, b, c);
+    }
+    static inline auto min(const type a, const type b) noexcept -> type {
+        return _mm512_min_ps(b, a);
+    }
+    static inline auto max(const type a, const type b) noexcept -> type {
+        return _mm512_max_ps(b, a);
+    }
+    static inline auto abs(const type a) noexcept -> type {
+        return _mm512_abs_ps(a);
+    }
+    static inline auto sqrt(const type a) noexcept -> type {
+        return _mm512_sqrt_ps(a);
+    }
+    // 14 bit estimate, the Newton step brings it past float precision
+    static inline auto rsqrt(const type a) noexcept -> type {
+        const type y = _mm512_rsqrt14_ps(a);
+        const type residual = _mm512_fnmadd_ps(_mm512_mul_ps(a, y), y, _mm512_set1_ps(1.0f));
+        return _mm512_fmadd_ps(_mm512_mul_ps(_mm512_set1_ps(0.5f), y), residual, y);
+    }
+    static inline auto eq(const type a, const type b) noexcept -> mask_type {
+        return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);
+    }
+    static inline auto lt(const type a, const type b) noexcept -> mask_type {
+        return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+    }
+    static inline auto le(const type a, const type b) noexcept -> mask_type {
+        return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ);
+    }
+    static inline auto mask_and(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return static_cast<mask_type>(a & b);
+    }
+    static inline auto mask_or(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return static_cast<mask_type>(a | b);
+    }
+    static inline auto mask_not(const mask_type a) noexcept -> mask_type {
+        return static_cast<mask_type>(~a);
+    }
+    static inline auto mask_bits(const mask_type a) noexcept -> uint64_t {
+        return a;
+    }
+    static inline auto select(const mask_type m, const type a, const type b) noexcept -> type {
+        return _mm512_mask_blend_ps(m, b, a);
+    }
+    static inline auto reduce_add(const type a) noexcept -> float {
+        return _mm512_reduce_add_ps(a);
+    }
+    static inline auto reduce_min(const type a) noexcept -> float {
+        return _mm512_reduce_min_ps(a);
+    }
+    static inline auto reduce_max(const type a) noexcept -> float {
+        return _mm512_reduce_max_ps(a);
+    }
+};
+
+template <>
+struct simd_ops<double, 8> {
+    static constexpr bool native = true;
+    static constexpr bool accelerated = true;
+    static constexpr size_t width = 8;
+    using type = __m512d;
+    using mask_type = __mmask8;
+
+    static inline auto load(const double *p) noexcept -> type {
+        return _mm512_load_pd(p);
+    }
+    static inline auto loadu(const double *p) noexcept -> type {
+        return _mm512_loadu_pd(p);
+    }
+    static inline void store(double *p, const type v) noexcept {
+        _mm512_store_pd(p, v);
+    }
+    static inline void storeu(double *p, const type v) noexcept {
+        _mm512_storeu_pd(p, v);
+    }
+    static inline auto set1(const double v) noexcept -> type {
+        return _mm512_set1_pd(v);
+    }
+    static inline auto gather(const double *base, const int32_t *indices) noexcept -> type {
+#if defined(MIA_BATCH_DISPATCH)
+        return gather_avx512(base, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(indices)));
+#else
+        return _mm512_i32gather_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(indices)), base, 8);
+#endif
+    }
+    static inline auto add(const type a, const type b) noexcept -> type {
+        return _mm512_add_pd(a, b);
+    }
+    static inline auto sub(const type a, const type b) noexcept -> type {
+        return _mm512_sub_pd(a, b);
+    }
+    static inline auto mul(const type a, const type b) noexcept -> type {
+        return _mm512_mul_pd(a, b);
+    }
+    static inline auto div(const type a, const type b) noexcept -> type {
+        return _mm512_div_pd(a, b);
+    }
+    static inline auto neg(const type a) noexcept -> type {
+        return _mm512_sub_pd(_mm512_setzero_pd(), a);
+    }
+    static inline auto fma(const type a, const type b, const type c) noexcept -> type {
+        return _mm512_fmadd_pd(a, b, c);
+    }
+    static inline auto min(const type a, const type b) noexcept -> type {
+        return _mm512_min_pd(b, a);
+    }
+    static inline auto max(const type a, const type b) noexcept -> type {
+        return _mm512_max_pd(b, a);
+    }
+    static inline auto abs(const type a) noexcept -> type {
+        return _mm512_abs_pd(a);
+    }
+    static inline auto sqrt(const type a) noexcept -> type {
+        return _mm512_sqrt_pd(a);
+    }
+    static inline auto rsqrt(const type a) noexcept -> type {
+        return _mm512_div_pd(_mm512_set1_pd(1.0), _mm512_sqrt_pd(a));
+    }
+    static inline auto eq(const type a, const type b) noexcept -> mask_type {
+        return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ);
+    }
+    static inline auto lt(const type a, const type b) noexcept -> mask_type {
+        return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ);
+    }
+    static inline auto le(const type a, const type b) noexcept -> mask_type {
+        return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ);
+    }
+    static inline auto mask_and(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return static_cast<mask_type>(a & b);
+    }
+    static inline auto mask_or(const mask_type a, const mask_type b) noexcept -> mask_type {
+        return static_cast<mask_type>(a | b);
+    }
+    static inline auto mask_not(const mask_type a) noexcept -> mask_type {
+        return static_cast<mask_type>(~a);
+    }
+    static inline auto mask_bits(const mask_type a) noexcept -> uint64_t {
+        return a;
+    }
+    static inline auto select(const mask_type m, const type a, const type b) noexcept -> type {
+        return _mm512_mask_blend_pd(m, b, a);
+    }
+    static inline auto reduce_add(const type a) noexcept -> double {
+        return _mm512_reduce_add_pd(a);
+    }
+    static inline auto reduce_min(const type a) noexcept -> double {
+        return _mm512_reduce_min_pd(a);
+    }
+    static inline auto reduce_max(const type a) noexcept -> double {
+        return _mm512_reduce_max_pd(a);
+    }
+};
+
+#endif // MIA_SIMD_AVX512
+
+#endif // MIA_SIMD_SSE2
+
+// Lanes of the widest native register for T, 1 when SIMD is off or T has no backend
+template <typename T>
+constexpr size_t simd_native_width_v = 1;
+#if defined(MIA_SIMD_AVX512)
+template <>
+constexpr size_t simd_native_width_v<float> = 16;
+template <>
+constexpr size_t simd_native_width_v<double> = 8;
+#elif defined(MIA_SIMD_AVX)
+template <>
+constexpr size_t simd_native_width_v<float> = 8;
+template <>
+constexpr size_t simd_native_width_v<double> = 4;
+#elif defined(MIA_SIMD_SSE2)
+template <>
+constexpr size_t simd_native_width_v<float> = 4;
+template <>
+constexpr size_t simd_native_width_v<double> = 2;
+#endif
+
+} // namespace mia::detail
+
+namespace mia {
+
+// NOTE: SIMD PACK
+// N lanes of T in registers, the widest the target enables: simd<float, 8> is one __m256 with AVX, two __m128
+// with SSE2 only and eight floats without SIMD; write a kernel once against simd<T, N> (or native_simd<T>)
+// Lane-wise operators & functions, comparisons give a simd_mask, reductions & lane access go back to T
+
+template <typename T, size_t N>
+class simd_mask {
+  public:
+    using ops = detail::simd_ops<T, N>;
+    using register_type = typename ops::mask_type;
+
+    static constexpr size_t width = N;
+
+    register_type value;
+
+    // Bit i set for lane i
+    [[nodiscard]] auto bits() const noexcept -> uint64_t {
+        return ops::mask_bits(value);
+    }
+    [[nodiscard]] auto any() const noexcept -> bool {
+        return bits() != 0;
+    }
+    [[nodiscard]] auto all() const noexcept -> bool {
+        return bits() == (N == 64 ? ~uint64_t{0} : (uint64_t{1} << N) - 1);
+    }
+    [[nodiscard]] auto none() const noexcept -> bool {
+        return bits() == 0;
+    }
+    [[nodiscard]] auto operator[](const size_t lane) const noexcept -> bool {
+        return ((bits() >> lane) & 1) != 0;
+    }
+
+    friend auto operator&&(const simd_mask &lhs, const simd_mask &rhs) noexcept -> simd_mask {
+        return {ops::mask_and(lhs.value, rhs.value)};
+    }
+    friend auto operator||(const simd_mask &lhs, const simd_mask &rhs) noexcept -> simd_mask {
+        return {ops::mask_or(lhs.value, rhs.value)};
+    }
+    friend auto operator!(const simd_mask &m) noexcept -> simd_mask {
+        return {ops::mask_not(m.value)};
+    }
+};
+
+template <typename T, size_t N>
+    requires std::is_arithmetic_v<T>
+class simd {
+  public:
+    using ops = detail::simd_ops<T, N>;
+    using value_type = T;
+    using register_type = typename ops::type;
+    using mask_type = simd_mask<T, N>;
+
+    static constexpr size_t width = N;
+    // True when some instruction set backs this pack, false for the scalar loops
+    static constexpr bool accelerated = ops::accelerated;
+    // Bytes an aligned load or store expects
+    static constexpr size_t alignment = alignof(register_type);
+
+    register_type value;
+
+    // NOTE: CONSTRUCTOR
+
+    // Zero
+    simd() noexcept
+        : value(ops::set1(T{})) {
+    }
+    // Every lane to `scalar`, implicit so scalars mix with packs in expressions
+    simd(const T scalar) noexcept // NOLINT(google-explicit-constructor)
+        : value(ops::set1(scalar)) {
+    }
+
+    static auto from_register(const register_type v) noexcept -> simd {
+        simd result{no_init};
+        result.value = v;
+        return result;
+    }
+
+    // `p` aligned to `alignment`
+    static auto load(const T *p) noexcept -> simd {
+        return from_register(ops::load(p));
+    }
+    static auto loadu(const T *p) noexcept -> simd {
+        return from_register(ops::loadu(p));
+    }
+    // Lane i from base[indices[i]]
+    static auto gather(const T *base, const int32_t *indices) noexcept -> simd {
+        return from_register(ops::gather(base, indices));
+    }
+    // Lane i from base[i * stride]: one component across N array-of-structures elements
+    static auto gather(const T *base, const size_t stride) noexcept -> simd {
+        std::array<int32_t, N> indices;
+        for (size_t i = 0; i < N; ++i) {
+            indices[i] = static_cast<int32_t>(i * stride);
+        }
+        return gather(base, indices.data());
+    }
+
+    // NOTE: CONST FUNCTIONS
+
+    void store(T *p) const noexcept {
+        ops::store(p, value);
+    }
+    void storeu(T *p) const noexcept {
+        ops::storeu(p, value);
+    }
+    [[nodiscard]] auto operator[](const size_t lane) const noexcept -> T {
+        alignas(alignment) std::array<T, N> lanes;
+        ops::store(lanes.data(), value);
+        return lanes[lane];
+    }
+
+    // NOTE: OPERATORS
+
+    friend auto operator+(const simd &lhs, const simd &rhs) noexcept -> simd {
+        return from_register(ops::add(lhs.value, rhs.value));
+    }
+    friend auto operator-(const simd &lhs, const simd &rhs) noexcept -> simd {
+        return from_register(ops::sub(lhs.value, rhs.value));
+    }
+    friend auto operator*(const simd &lhs, const simd &rhs) noexcept -> simd {
+        return from_register(ops::mul(lhs.value, rhs.value));
+    }
+    friend auto operator/(const simd &lhs, const simd &rhs) noexcept -> simd {
+        return from_register(ops::div(lhs.value, rhs.value));
+    }
+    friend auto operator-(const simd &v) noexcept -> simd {
+        return from_register(ops::neg(v.value));
+    }
+    auto operator+=(const simd &other) noexcept -> simd & {
+        value = ops::add(value, other.value);
+        return *this;
+    }
+    auto operator-=(const simd &other) noexcept -> simd & {
+        value = ops::sub(value, other.value);
+        return *this;
+    }
+    auto operator*=(const simd &other) noexcept -> simd & {
+        value = ops::mul(value, other.value);
+        return *this;
+    }
+    auto operator/=(const simd &other) noexcept -> simd & {
+        value = ops::div(value, other.value);
+        return *this;
+    }
+
+    // :: Comparisons, ordered: false for NaN lanes except !=
+    friend auto operator==(const simd &lhs, const simd &rhs) noexcept -> mask_type {
+        return {ops::eq(lhs.value, rhs.value)};
+    }
+    friend auto operator!=(const simd &lhs, const simd &rhs) noexcept -> mask_type {
+        return {ops::mask_not(ops::eq(lhs.value, rhs.value))};
+    }
+    friend auto operator<(const simd &lhs, const simd &rhs) noexcept -> mask_type {
+        return {ops::lt(lhs.value, rhs.value)};
+    }
+    friend auto operator<=(const simd &lhs, const simd &rhs) noexcept -> mask_type {
+        return {ops::le(lhs.value, rhs.value)};
+    }
+    friend auto operator>(const simd &lhs, const simd &rhs) noexcept -> mask_type {
+        return {ops::lt(rhs.value, lhs.value)};
+    }
+    friend auto operator>=(const simd &lhs, const simd &rhs) noexcept -> mask_type {
+        return {ops::le(rhs.value, lhs.value)};
+    }
+
+    // NOTE: FUNCTIONS
+    // Found by argument-dependent lookup: min(a, b), fma(a, b, c)...
+
+    // std::min / std::max lane-wise, ties & NaN included
+    friend auto min(const simd &a, const simd &b) noexcept -> simd {
+        return from_register(ops::min(a.value, b.value));
+    }
+    friend auto max(const simd &a, const simd &b) noexcept -> simd {
+        return from_register(ops::max(a.value, b.value));
+    }
+    // a * b + c, fused when the target has FMA
+    friend auto fma(const simd &a, const simd &b, const simd &c) noexcept -> simd {
+        return from_register(ops::fma(a.value, b.value, c.value));
+    }
+    friend auto abs(const simd &a) noexcept -> simd {
+        return from_register(ops::abs(a.value));
+    }
+    friend auto sqrt(const simd &a) noexcept -> simd {
+        return from_register(ops::sqrt(a.value));
+    }
+    // float: hardware estimate and one Newton step, about 3 ULP
+    friend auto rsqrt(const simd &a) noexcept -> simd {
+        return from_register(ops::rsqrt(a.value));
+    }
+    // Lanes of `a` where `m` is set, of `b` elsewhere
+    friend auto select(const mask_type &m, const simd &a, const simd &b) noexcept -> simd {
+        return from_register(ops::select(m.value, a.value, b.value));
+    }
+
+    // :: Horizontal, the lanes in a tree: float sums may differ from a sequential loop in the last bits
+    friend auto reduce_add(const simd &a) noexcept -> T {
+        return ops::reduce_add(a.value);
+    }
+    friend auto reduce_min(const simd &a) noexcept -> T {
+        return ops::reduce_min(a.value);
+    }
+    friend auto reduce_max(const simd &a) noexcept -> T {
+        return ops::reduce_max(a.value);
+    }
+
+  private:
+    struct no_init_t {};
+    static constexpr no_init_t no_init{};
+
+    explicit simd(no_init_t) noexcept {
+    }
+};
+
+// The widest pack the target enables for T
+template <typename T>
+using native_simd = simd<T, detail::simd_native_width_v<T>>;
+
+} // namespace mia
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../arena/arena.hpp"
+#include "thread-pool.hpp"
+#include "vector.hpp"
+
+namespace mia {
+
+// How a spatial_hash sizes its table and spreads rebuilds over threads
+struct spatial_hash_options {
+    size_t table_size = 0;                // Buckets, rounded up to a power of two, 0 for twice the point count
+    size_t threads = 0;                   // Chunks of a parallel rebuild, 0 for the size of its thread pool
+    size_t parallel_threshold = 1 << 15;  // Fewer points are rebuilt on the calling thread
+};
+
+// Uniform grid of cubic cells hashed into a fixed table, for broad-phase neighbour lookups
+// rebuild() is a counting sort of the points by bucket, O(n + buckets): points of a bucket end up contiguous,
+// copied next to each other for the queries. Cells whose hashes collide share a bucket, queries filter by
+// distance so collisions only cost time. Buffers come from an arena that is only reset when the point count
+// or table outgrow them, a steady simulation stops allocating after the first steps. Parallel rebuilds run on
+// a thread_pool, its workers are reused by every phase of every step
+template <typename T = float, size_t Dims = 3>
+    requires std::is_floating_point_v<T> && (Dims == 2 || Dims == 3)
+class spatial_hash {
+  public:
+    // NOTE: MEMBER TYPES
+
+    using value_type = T;
+    using vector_type = vector<T, Dims>;
+    using cell_type = std::array<int32_t, Dims>;
+
+    // NOTE: CONSTRUCTOR
+
+    // Queries are cheapest with radius <= cell_size / 2, a sphere then overlaps at most 2 cells per axis
+    explicit spatial_hash(const T cell_size, const spatial_hash_options &options = {})
+        : cell_size_(cell_size), inverse_cell_size_(T{1} / cell_size), options_(options) {
+        assert(cell_size > 0);
+    }
+
+    // NOTE: BUILD
+
+    // From parallel_threshold points on, the rebuild is split over the threads of `pool`
+    void rebuild(thread_pool &pool, std::span<const vector_type> points) {
+        build(points, points.size() < options_.parallel_threshold ? nullptr : &pool);
+    }
+    // On default_thread_pool(), only created once a rebuild reaches parallel_threshold
+    void rebuild(std::span<const vector_type> points) {
+        build(points, points.size() < options_.parallel_threshold ? nullptr : &default_thread_pool());
+    }
+
+    // NOTE: CONST FUNCTIONS
+
+    [[nodiscard]] inline auto size() const -> size_t { return size_; }
+    [[nodiscard]] inline auto empty() const -> bool { return size_ == 0; }
+    [[nodiscard]] inline auto cell_size() const -> T { return cell_size_; }
+    [[nodiscard]] inline auto table_size() const -> size_t { return table_size_; }
+    // Bytes held by the buffer arena
+    [[nodiscard]] inline auto capacity_bytes() const -> size_t { return storage_.capacity(); }
+    // Point indices in bucket order
+    [[nodiscard]] inline auto indices() const -> std::span<const uint32_t> { return {sorted_index_, size_}; }
+
+    [[nodiscard]] auto cell(const vector_type &point) const -> cell_type {
+        cell_type c;
+        for (size_t d = 0; d < Dims; ++d) {
+            c[d] = static_cast<int32_t>(std::floor(point[d] * inverse_cell_size_));
+        }
+        return c;
+    }
+    // Bucket of a cell, the cell hash of Teschner et al. spread over the table by a Fibonacci multiply
+    [[nodiscard]] auto bucket(const cell_type &c) const -> uint32_t {
+        constexpr std::array<uint32_t, 3> primes{73856093u, 19349663u, 83492791u};
+        uint32_t h = 0;
+        for (size_t d = 0; d < Dims; ++d) {
+            h ^= static_cast<uint32_t>(c[d]) * primes[d];
+        }
+        return static_cast<uint32_t>((static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull) >> (64 - table_bits_));
+    }
+
+    // :: Neighbours
+    // Calls `visit(index, distance_squared)` for every point within `radius` of `center` (boundary included),
+    // in no particular order, returns how many
+    template <typename Visit>
+        requires std::is_invocable_v<Visit &, uint32_t, T>
+    auto query(const vector_type &center, const T radius, Visit &&visit) const -> size_t {
+        const T radius_squared = radius * radius;
+        size_t visited = 0;
+        visit_buckets(center, radius, [&](const uint32_t position) {
+            const T d = static_cast<T>(vector_type::distance_squared(center, sorted_points_[position]));
+            if (d <= radius_squared) {
+                visit(sorted_index_[position], d);
+                ++visited;
+            }
+        });
+        return visited;
+    }
+
+    // Calls `visit(i, j, distance_squared)` once per unordered pair of points within `radius` of each other,
+    // the broad phase of a particle step, returns how many pairs
+    template <typename Visit>
+        requires std::is_invocable_v<Visit &, uint32_t, uint32_t, T>
+    auto for_each_pair(const T radius, Visit &&visit) const -> size_t {
+        const T radius_squared = radius * radius;
+        size_t pairs = 0;
+        for (uint32_t a = 0; a < size_; ++a) {
+            const vector_type &p = sorted_points_[a];
+            visit_buckets(p, radius, [&](const uint32_t b) {
+                if (b <= a) {
+                    return;
+                }
+                const T d = static_cast<T>(vector_type::distance_squared(p, sorted_points_[b]));
+                if (d <= radius_squared) {
+                    visit(sorted_index_[a], sorted_index_[b], d);
+                    ++pairs;
+                }
+            });
+        }
+        return pairs;
+    }
+
+  private:
+    // Beyond this many cells a query scans every point
+    static constexpr size_t max_query_cells = 64;
+
+    // Counting sort of `points` by bucket, chunked over `pool` unless it is null
+    void build(std::span<const vector_type> points, thread_pool *pool) {
+        assert(points.size() < std::numeric_limits<uint32_t>::max());
+        const size_t count = points.size();
+        const size_t threads = pool == nullptr ? 1 : (options_.threads != 0 ? options_.threads : pool->size());
+        const size_t table = std::bit_ceil(std::max<size_t>(options_.table_size != 0 ? options_.table_size : 2 * count, 2));
+        reserve(count, table, threads);
+        table_size_ = table;
+        table_bits_ = static_cast<uint32_t>(std::countr_zero(table));
+        size_ = count;
+
+        if (threads == 1) {
+            uint32_t *counts = histograms_;
+            std::fill_n(counts, table, 0u);
+            for (size_t i = 0; i < count; ++i) {
+                hashes_[i] = bucket(cell(points[i]));
+                ++counts[hashes_[i]];
+            }
+            uint32_t running = 0;
+            for (size_t b = 0; b < table; ++b) {
+                bucket_start_[b] = running;
+                running += std::exchange(counts[b], running);
+            }
+            bucket_start_[table] = running;
+            scatter(points, counts, 0, count);
+            return;
+        }
+
+        // Chunk t of the points is counted into histogram t, which later holds its write cursors: the order
+        // inside a bucket is the input order, as in the serial path
+        const auto histogram = [&](const size_t t) { return histograms_ + t * table; };
+        run_chunks(*pool, threads, count, [&](const size_t t, const size_t begin, const size_t end) {
+            uint32_t *counts = histogram(t);
+            std::fill_n(counts, table, 0u);
+            for (size_t i = begin; i < end; ++i) {
+                hashes_[i] = bucket(cell(points[i]));
+                ++counts[hashes_[i]];
+            }
+        });
+        // Blocks of buckets: totals, then an exclusive scan over the blocks, then cursors within each block
+        uint32_t *block_totals = histograms_ + threads * table;
+        block_totals[0] = 0;
+        run_chunks(*pool, threads, table, [&](const size_t t, const size_t begin, const size_t end) {
+            uint32_t total = 0;
+            for (size_t b = begin; b < end; ++b) {
+                for (size_t h = 0; h < threads; ++h) {
+                    total += histogram(h)[b];
+                }
+            }
+            block_totals[t + 1] = total;
+        });
+        for (size_t t = 0; t < threads; ++t) {
+            block_totals[t + 1] += block_totals[t];
+        }
+        run_chunks(*pool, threads, table, [&](const size_t t, const size_t begin, const size_t end) {
+            uint32_t running = block_totals[t];
+            for (size_t b = begin; b < end; ++b) {
+                bucket_start_[b] = running;
+                for (size_t h = 0; h < threads; ++h) {
+                    running += std::exchange(histogram(h)[b], running);
+                }
+            }
+        });
+        bucket_start_[table] = static_cast<uint32_t>(count);
+        run_chunks(*pool, threads, count, [&](const size_t t, const size_t begin, const size_t end) {
+            scatter(points, histogram(t), begin, end);
+        });
+    }
+
+    // `fn(t, begin, end)` for `chunks` contiguous chunks of [0, count), one pool task each, returns once all ran
+    template <typename Fn>
+    static void run_chunks(thread_pool &pool, const size_t chunks, const size_t count, Fn &&fn) {
+        pool.parallel_for(0, chunks, [&](const size_t t) { fn(t, count * t / chunks, count * (t + 1) / chunks); });
+    }
+
+    // Grow the buffers when needed, everything is carved again from a reset arena
+    void reserve(const size_t count, const size_t table, const size_t threads) {
+        // Histograms, then the block totals of a parallel rebuild
+        const size_t histogram_size = threads * table + threads + 1;
+        if (count <= point_capacity_ && table <= table_capacity_ && histogram_size <= histogram_capacity_) {
+            return;
+        }
+        point_capacity_ = std::max(count, point_capacity_ + point_capacity_ / 2);
+        table_capacity_ = std::max(table, table_capacity_);
+        histogram_capacity_ = std::max(histogram_size, histogram_capacity_);
+        storage_.reset();
+        sorted_points_ = storage_.alloc_array_for_overwrite<vector_type>(point_capacity_);
+        sorted_index_ = storage_.alloc_array_for_overwrite<uint32_t>(point_capacity_);
+        hashes_ = storage_.alloc_array_for_overwrite<uint32_t>(point_capacity_);
+        bucket_start_ = storage_.alloc_array_for_overwrite<uint32_t>(table_capacity_ + 1);
+        histograms_ = storage_.alloc_array_for_overwrite<uint32_t>(histogram_capacity_);
+    }
+
+    void scatter(std::span<const vector_type> points, uint32_t *cursors, const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t position = cursors[hashes_[i]]++;
+            sorted_points_[position] = points[i];
+            sorted_index_[position] = static_cast<uint32_t>(i);
+        }
+    }
+
+    // `fn(position)` for every point in the buckets of the cells overlapping the box around the sphere,
+    // each bucket once even when several of those cells hash to it
+    template <typename Fn>
+    void visit_buckets(const vector_type &center, const T radius, Fn &&fn) const {
+        if (size_ == 0) {
+            return;
+        }
+        cell_type lower;
+        cell_type upper;
+        size_t cells = 1;
+        for (size_t d = 0; d < Dims; ++d) {
+            const T low = std::floor((center[d] - radius) * inverse_cell_size_);
+            const T high = std::floor((center[d] + radius) * inverse_cell_size_);
+            // Also catches spans too wide for int32_t
+            if (!(high - low < static_cast<T>(max_query_cells))) {
+                cells = max_query_cells + 1;
+                break;
+            }
+            lower[d] = static_cast<int32_t>(low);
+            upper[d] = static_cast<int32_t>(high);
+            cells *= static_cast<size_t>(upper[d] - lower[d] + 1);
+        }
+        if (cells > max_query_cells || cells > table_size_) {
+            for (uint32_t position = 0; position < size_; ++position) {
+                fn(position);
+            }
+            return;
+        }
+
+        std::array<uint32_t, max_query_cells> seen;
+        size_t seen_count = 0;
+        cell_type c = lower;
+        for (;;) {
+            const uint32_t b = bucket(c);
+            if (std::find(seen.begin(), seen.begin() + seen_count, b) == seen.begin() + seen_count) {
+                seen[seen_count++] = b;
+                for (uint32_t position = bucket_start_[b]; position < bucket_start_[b + 1]; ++position) {
+                    fn(position);
+                }
+            }
+            // Next cell, x fastest
+            size_t d = 0;
+            while (d < Dims && c[d] == upper[d]) {
+                c[d] = lower[d];
+                ++d;
+            }
+            if (d == Dims) {
+                break;
+            }
+            ++c[d];
+        }
+    }
+
+    T cell_size_;
+    T inverse_cell_size_;
+    spatial_hash_options options_;
+
+    arena storage_;
+    size_t point_capacity_ = 0;
+    size_t table_capacity_ = 0;
+    size_t histogram_capacity_ = 0;
+
+    size_t size_ = 0;
+    size_t table_size_ = 0;
+    uint32_t table_bits_ = 1;
+    vector_type *sorted_points_ = nullptr;  // Points in bucket order
+    uint32_t *sorted_index_ = nullptr;      // Their indices in the rebuilt span
+    uint32_t *hashes_ = nullptr;            // Bucket of each input point
+    uint32_t *bucket_start_ = nullptr;      // table_size + 1 offsets into the sorted arrays
+    uint32_t *histograms_ = nullptr;        // Bucket counts (then cursors) of each rebuild thread, block totals
+};
+
+} // namespace mia
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "math-utilities.hpp"
+
+namespace mia {
+
+// NOTE: THREAD POOL
+// Work stealing: every worker owns a deque, pushes & pops at the back (newest first, still in cache)
+// and, once empty, steals from the front of the others (oldest, so the largest pieces of a split range)
+// Threads that are not workers push to one shared deque. A thread waiting on a parallel_for runs tasks
+// meanwhile, so loops nest without deadlocking and the calling thread counts as a worker
+
+class thread_pool {
+  public:
+    // `threads` run tasks, the caller of parallel_for included: threads - 1 are spawned
+    // 0 for std::thread::hardware_concurrency()
+    explicit thread_pool(size_t threads = 0)
+        : queues_(std::max<size_t>(threads != 0 ? threads : std::thread::hardware_concurrency(), 1)) {
+        workers_.reserve(queues_.size() - 1);
+        for (size_t i = 0; i + 1 < queues_.size(); ++i) {
+            workers_.emplace_back([this, i](const std::stop_token stop) { work(stop, i); });
+        }
+    }
+
+    ~thread_pool() {
+        for (auto &worker : workers_) {
+            worker.request_stop();
+        }
+        {
+            const std::lock_guard lock(sleep_mutex_);
+        }
+        sleep_.notify_all();
+    }
+
+    thread_pool(const thread_pool &other) = delete;
+    auto operator=(const thread_pool &other) -> thread_pool & = delete;
+
+    // Threads running tasks during a parallel_for, the caller included
+    [[nodiscard]] auto size() const noexcept -> size_t {
+        return queues_.size();
+    }
+
+    // NOTE: LOOPS
+
+    // `body(begin, end)` over sub-ranges, or `body(i)` for each index, then returns
+    // The range is halved until chunks hold about size() * 8 of it (at least `grain` indices), so the
+    // chunk size follows the range & the pool, and stealing evens out iterations of uneven cost
+    // The first exception thrown by `body` is rethrown here, chunks not yet started are skipped
+    template <typename F>
+    void parallel_for(const size_t begin, const size_t end, F &&body, const size_t grain = 1) {
+        if (end <= begin) {
+            return;
+        }
+        const size_t count = end - begin;
+        const size_t chunk = std::max<size_t>({grain, 1, count / (size() * chunks_per_thread)});
+        loop<std::remove_reference_t<F>> context{this, &body, chunk};
+        if (count <= chunk || size() == 1) {
+            context.invoke(begin, end);
+        } else {
+            context.pending.store(1, std::memory_order_relaxed);
+            loop<std::remove_reference_t<F>>::run(&context, begin, end);
+            help_while([&] { return context.pending.load(std::memory_order_acquire) != 0; });
+        }
+        if (context.failure) {
+            std::rethrow_exception(context.failure);
+        }
+    }
+
+    // `map(begin, end) -> R` over chunks of `grain` indices, folded with `combine(R, R) -> R` in index order
+    // Chunks do not depend on the pool size or the scheduling, neither does the result
+    template <typename R, typename Map, typename Combine>
+    auto parallel_reduce(const size_t begin, const size_t end, R identity, Map &&map, Combine &&combine,
+                         const size_t grain = default_reduce_grain) -> R {
+        if (end <= begin) {
+            return identity;
+        }
+        const size_t chunk = std::max<size_t>(grain, 1);
+        const size_t chunks = (end - begin + chunk - 1) / chunk;
+        if (chunks == 1) {
+            return combine(std::move(identity), map(begin, end));
+        }
+        std::vector<std::optional<R>> partials(chunks);
+        parallel_for(0, chunks, [&](const size_t c) {
+            partials[c].emplace(map(begin + c * chunk, std::min(end, begin + (c + 1) * chunk)));
+        });
+        R result = std::move(identity);
+        for (auto &partial : partials) {
+            result = combine(std::move(result), std::move(*partial));
+        }
+        return result;
+    }
+
+    static constexpr size_t chunks_per_thread = 8;
+    static constexpr size_t default_reduce_grain = size_t{1} << 14;
+
+  private:
+    struct task {
+        void (*run)(void *context, size_t begin, size_t end);
+        void *context;
+        size_t begin;
+        size_t end;
+    };
+
+    // Padded so two workers never share a line
+    struct alignas(MIA_CACHE_LINE_ALIGNMENT) task_queue {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    // State of one parallel_for, on the caller's stack until `pending` drops to 0
+    template <typename F>
+    struct loop {
+        thread_pool *pool;
+        F *body;
+        size_t chunk;
+        std::atomic<size_t> pending{0};
+        std::atomic<bool> failed{false};
+        std::mutex failure_mutex{};
+        std::exception_ptr failure{};
+
+        void invoke(const size_t begin, const size_t end) {
+            if (failed.load(std::memory_order_relaxed)) {
+                return;
+            }
+            try {
+                if constexpr (std::is_invocable_v<F &, size_t, size_t>) {
+                    (*body)(begin, end);
+                } else {
+                    for (size_t i = begin; i < end; ++i) {
+                        (*body)(i);
+                    }
+                }
+            } catch (...) {
+                const std::lock_guard lock(failure_mutex);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        // Upper halves are pushed (stealable), the lower one is kept until it fits a chunk
+        static void run(void *context, const size_t begin, size_t end) {
+            auto &self = *static_cast<loop *>(context);
+            while (end - begin > self.chunk) {
+                const size_t middle = begin + (end - begin) / 2;
+                self.pending.fetch_add(1, std::memory_order_relaxed);
+                self.pool->push({run, context, middle, end});
+                end = middle;
+            }
+            self.invoke(begin, end);
+            self.pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    };
+
+    // Worker index of the calling thread in this pool, the shared deque otherwise
+    auto local_queue() const noexcept -> size_t {
+        return current_pool == this ? current_index : queues_.size() - 1;
+    }
+
+    void push(const task t) {
+        task_queue &queue = queues_[local_queue()];
+        {
+            // Counted first so the count never runs below the tasks a thief can see
+            const std::lock_guard lock(queue.mutex);
+            queued_.fetch_add(1, std::memory_order_seq_cst);
+            queue.tasks.push_back(t);
+        }
+        if (sleeping_.load(std::memory_order_seq_cst) != 0) {
+            // Taking the lock orders this with a worker between its check & its wait
+            {
+                const std::lock_guard lock(sleep_mutex_);
+            }
+            sleep_.notify_one();
+        }
+    }
+
+    // Own deque from the back, then the others from the front
+    auto pop(const size_t self) -> std::optional<task> {
+        if (queued_.load(std::memory_order_relaxed) == 0) {
+            return std::nullopt;
+        }
+        for (size_t k = 0; k < queues_.size(); ++k) {
+            const size_t index = (self + k) % queues_.size();
+            task_queue &queue = queues_[index];
+            const std::lock_guard lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task t;
+                if (k == 0) {
+                    t = queue.tasks.back();
+                    queue.tasks.pop_back();
+                } else {
+                    t = queue.tasks.front();
+                    queue.tasks.pop_front();
+                }
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                return t;
+            }
+        }
+        return std::nullopt;
+    }
+
+    template <typename Predicate>
+    void help_while(const Predicate &waiting) {
+        const size_t self = local_queue();
+        while (waiting()) {
+            if (const auto t = pop(self)) {
+                t->run(t->context, t->begin, t->end);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void work(const std::stop_token &stop, const size_t index) {
+        current_pool = this;
+        current_index = index;
+        while (!stop.stop_requested()) {
+            if (const auto t = pop(index)) {
+                t->run(t->context, t->begin, t->end);
+                continue;
+            }
+            std::unique_lock lock(sleep_mutex_);
+            sleeping_.fetch_add(1, std::memory_order_seq_cst);
+            sleep_.wait(lock, [&] { return stop.stop_requested() || queued_.load(std::memory_order_seq_cst) != 0; });
+            sleeping_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    static inline thread_local const thread_pool *current_pool = nullptr;
+    static inline thread_local size_t current_index = 0;
+
+    std::vector<task_queue> queues_; // One per worker, the last one shared by the other threads
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> sleeping_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_;
+    std::vector<std::jthread> workers_; // Last, joined before the queues go
+};
+
+// Shared pool of std::thread::hardware_concurrency() threads, created on first use
+inline auto default_thread_pool() -> thread_pool & {
+    static thread_pool pool;
+    return pool;
+}
+
+} // namespace mia
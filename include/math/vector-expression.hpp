@@ -0,0 +1,305 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include "fast-math.hpp"
+#include "vector-simd.hpp"
+
+// NOTE: Lazy element-wise expressions for mia::vector
+// `a + b * s - c` builds one expression object and is evaluated in a single pass (one SIMD kernel chain
+// on registers) when it is assigned to a vector. Operands are held by value: a vector is at most a couple
+// of registers, and it keeps `auto e = a + b; a += b;` meaning what it did when the operators were eager
+
+namespace mia {
+
+template <typename T, size_t Dims>
+    requires std::is_arithmetic_v<T>
+class vector;
+
+// Precision of scalars, dot products & lengths: float for double vectors (see vector::compute_type)
+// Element-wise results are computed in T, on the scalar path as in the SIMD kernels
+template <typename T>
+using vector_compute_t = std::conditional_t<std::is_floating_point_v<T> && (sizeof(T) * 8 >= 64), float, T>;
+
+namespace detail {
+
+// :: What can appear in an expression: a vector or another expression
+template <typename E>
+struct vector_operand_traits {
+    static constexpr bool value = false;
+};
+template <typename T, size_t Dims>
+struct vector_operand_traits<vector<T, Dims>> {
+    static constexpr bool value = true;
+    static constexpr bool is_expression = false;
+    using value_type = T;
+    static constexpr size_t dims = Dims;
+};
+template <typename E>
+    requires(E::is_vector_expression)
+struct vector_operand_traits<E> {
+    static constexpr bool value = true;
+    static constexpr bool is_expression = true;
+    using value_type = typename E::value_type;
+    static constexpr size_t dims = E::dims;
+};
+
+template <typename E>
+concept vector_operand = vector_operand_traits<std::remove_cvref_t<E>>::value;
+template <typename E>
+concept vector_expression_type = vector_operand<E> && vector_operand_traits<std::remove_cvref_t<E>>::is_expression;
+
+template <typename E>
+using operand_value_t = typename vector_operand_traits<std::remove_cvref_t<E>>::value_type;
+template <typename E>
+inline constexpr size_t operand_dims_v = vector_operand_traits<std::remove_cvref_t<E>>::dims;
+
+// Element `i` of any operand, converted to T
+template <typename T, typename E>
+constexpr auto operand_element(const E &e, const size_t i) -> T {
+    return static_cast<T>(e[i]);
+}
+
+// Storage (padded) of any operand for the SIMD path: a vector is used in place, an expression is
+// evaluated into `scratch`
+template <typename T, size_t Dims, typename E>
+inline auto operand_storage(const E &e, T *scratch) noexcept -> const T * {
+    if constexpr (vector_expression_type<E>) {
+        e.store(scratch);
+        return scratch;
+    } else {
+        return e.data.data();
+    }
+}
+
+// An operand can take the SIMD path when its elements already are T in the padded layout
+template <typename T, size_t Dims, typename E>
+consteval auto is_simd_operand() -> bool {
+    if constexpr (!vector_simd<T, Dims>::enabled || !std::is_same_v<operand_value_t<E>, T>) {
+        return false;
+    } else if constexpr (vector_expression_type<E>) {
+        return E::simd_enabled;
+    } else {
+        return true;
+    }
+}
+template <typename T, size_t Dims, typename E>
+inline constexpr bool simd_operand_v = is_simd_operand<T, Dims, E>();
+
+// :: Element-wise operations
+struct add_op {
+    template <typename T>
+    static constexpr auto apply(const T a, const T b) -> T {
+        return static_cast<T>(a + b);
+    }
+    template <typename T, size_t Dims>
+    static inline void simd(T *out, const T *a, const T *b) noexcept {
+        vector_simd<T, Dims>::add(out, a, b);
+    }
+};
+struct sub_op {
+    template <typename T>
+    static constexpr auto apply(const T a, const T b) -> T {
+        return static_cast<T>(a - b);
+    }
+    template <typename T, size_t Dims>
+    static inline void simd(T *out, const T *a, const T *b) noexcept {
+        vector_simd<T, Dims>::sub(out, a, b);
+    }
+};
+struct scale_op {
+    template <typename T, typename K>
+    static constexpr auto apply(const T a, const K k) -> T {
+        return static_cast<T>(a * static_cast<T>(k));
+    }
+    template <typename T, size_t Dims>
+    static inline void simd(T *out, const T *a, const T k) noexcept {
+        vector_simd<T, Dims>::scale(out, a, k);
+    }
+};
+struct divide_op {
+    template <typename T, typename K>
+    static constexpr auto apply(const T a, const K k) -> T {
+        return static_cast<T>(a / static_cast<T>(k));
+    }
+    template <typename T, size_t Dims>
+    static inline void simd(T *out, const T *a, const T k) noexcept {
+        vector_simd<T, Dims>::div(out, a, k);
+    }
+};
+
+} // namespace detail
+
+// NOTE: EXPRESSION BASE
+// Read-only view of the result, evaluated on demand. Converts to vector implicitly (vector has a
+// constructor from any expression), and forwards the const members people call on a result
+template <typename Derived, typename T, size_t Dims>
+class vector_expression {
+  public:
+    static constexpr bool is_vector_expression = true;
+    static constexpr size_t dims = Dims;
+    using value_type = T;
+    using compute_type = vector_compute_t<T>;
+    using vector_type = vector<T, Dims>;
+
+    constexpr auto operator[](const size_t i) const -> value_type {
+        return static_cast<const Derived&>(*this).element(i);
+    }
+    [[nodiscard]] constexpr auto size() const noexcept -> size_t {
+        return Dims;
+    }
+    [[nodiscard]] constexpr auto dimension() const noexcept -> size_t {
+        return Dims;
+    }
+
+    // Materialize the result
+    [[nodiscard]] constexpr auto eval() const -> vector_type {
+        return vector_type(static_cast<const Derived&>(*this));
+    }
+
+    // :: Forwarded to the result
+    constexpr auto x() const -> value_type
+        requires(Dims >= 1)
+    {
+        return (*this)[0];
+    }
+    constexpr auto y() const -> value_type
+        requires(Dims >= 2)
+    {
+        return (*this)[1];
+    }
+    constexpr auto z() const -> value_type
+        requires(Dims >= 3)
+    {
+        return (*this)[2];
+    }
+    constexpr auto w() const -> value_type
+        requires(Dims >= 4)
+    {
+        return (*this)[3];
+    }
+    [[nodiscard]] constexpr auto magnitude_squared() const -> compute_type {
+        return eval().magnitude_squared();
+    }
+    template <precision P = precision::exact>
+    [[nodiscard]] constexpr auto magnitude() const -> compute_type {
+        return eval().template magnitude<P>();
+    }
+    template <precision P = precision::exact>
+    [[nodiscard]] constexpr auto normalized() const -> vector_type {
+        return eval().template normalized<P>();
+    }
+};
+
+// :: lhs (op) rhs, element by element. The result has the element type of lhs (as the eager operators did)
+template <typename L, typename R, typename Op>
+class vector_binary_expression
+    : public vector_expression<vector_binary_expression<L, R, Op>, detail::operand_value_t<L>, detail::operand_dims_v<L>> {
+  public:
+    using value_type = detail::operand_value_t<L>;
+    static constexpr size_t dims = detail::operand_dims_v<L>;
+    using simd_traits = detail::vector_simd<value_type, dims>;
+    static constexpr bool simd_enabled = detail::simd_operand_v<value_type, dims, L> && detail::simd_operand_v<value_type, dims, R>;
+
+    constexpr vector_binary_expression(const L &lhs, const R &rhs)
+        : lhs_(lhs), rhs_(rhs) {
+    }
+
+    constexpr auto element(const size_t i) const -> value_type {
+        return Op::apply(detail::operand_element<value_type>(lhs_, i), detail::operand_element<value_type>(rhs_, i));
+    }
+
+    // Whole padded storage at once, only when simd_enabled
+    inline void store(value_type *out) const noexcept
+        requires simd_enabled
+    {
+        alignas(simd_traits::alignment) std::array<value_type, simd_traits::storage_size> l;
+        alignas(simd_traits::alignment) std::array<value_type, simd_traits::storage_size> r;
+        Op::template simd<value_type, dims>(out, detail::operand_storage<value_type, dims>(lhs_, l.data()),
+                                            detail::operand_storage<value_type, dims>(rhs_, r.data()));
+    }
+
+  private:
+    L lhs_;
+    R rhs_;
+};
+
+// :: e (op) k with a scalar k in compute_type
+template <typename E, typename Op>
+class vector_scalar_expression
+    : public vector_expression<vector_scalar_expression<E, Op>, detail::operand_value_t<E>, detail::operand_dims_v<E>> {
+  public:
+    using value_type = detail::operand_value_t<E>;
+    using compute_type = vector_compute_t<value_type>;
+    static constexpr size_t dims = detail::operand_dims_v<E>;
+    using simd_traits = detail::vector_simd<value_type, dims>;
+    static constexpr bool simd_enabled = detail::simd_operand_v<value_type, dims, E>;
+
+    constexpr vector_scalar_expression(const E &e, const compute_type k)
+        : e_(e), k_(k) {
+    }
+
+    constexpr auto element(const size_t i) const -> value_type {
+        return Op::apply(e_[i], k_);
+    }
+
+    inline void store(value_type *out) const noexcept
+        requires simd_enabled
+    {
+        alignas(simd_traits::alignment) std::array<value_type, simd_traits::storage_size> scratch;
+        Op::template simd<value_type, dims>(out, detail::operand_storage<value_type, dims>(e_, scratch.data()),
+                                            static_cast<value_type>(k_));
+    }
+
+  private:
+    E e_;
+    compute_type k_;
+};
+
+// NOTE: OPERATORS
+// vector op vector lives here too, so every combination builds an expression
+
+template <detail::vector_operand L, detail::vector_operand R>
+    requires(detail::operand_dims_v<L> == detail::operand_dims_v<R>) &&
+            std::is_convertible_v<detail::operand_value_t<R>, detail::operand_value_t<L>>
+constexpr auto operator+(const L &lhs, const R &rhs) {
+    return vector_binary_expression<L, R, detail::add_op>(lhs, rhs);
+}
+template <detail::vector_operand L, detail::vector_operand R>
+    requires(detail::operand_dims_v<L> == detail::operand_dims_v<R>) &&
+            std::is_convertible_v<detail::operand_value_t<R>, detail::operand_value_t<L>>
+constexpr auto operator-(const L &lhs, const R &rhs) {
+    return vector_binary_expression<L, R, detail::sub_op>(lhs, rhs);
+}
+
+template <detail::vector_operand E>
+constexpr auto operator*(const E &e, const vector_compute_t<detail::operand_value_t<E>> k) {
+    return vector_scalar_expression<E, detail::scale_op>(e, k);
+}
+template <detail::vector_operand E>
+constexpr auto operator*(const vector_compute_t<detail::operand_value_t<E>> k, const E &e) {
+    return vector_scalar_expression<E, detail::scale_op>(e, k);
+}
+template <detail::vector_operand E>
+constexpr auto operator/(const E &e, const vector_compute_t<detail::operand_value_t<E>> k) {
+    return vector_scalar_expression<E, detail::divide_op>(e, k);
+}
+
+// Comparing an expression evaluates it
+template <detail::vector_operand L, detail::vector_operand R>
+    requires(detail::vector_expression_type<L> || detail::vector_expression_type<R>) &&
+            (detail::operand_dims_v<L> == detail::operand_dims_v<R>)
+constexpr auto operator==(const L &lhs, const R &rhs) -> bool {
+    using T = detail::operand_value_t<L>;
+    return vector<T, detail::operand_dims_v<L>>(lhs) == vector<T, detail::operand_dims_v<L>>(rhs);
+}
+template <detail::vector_operand L, detail::vector_operand R>
+    requires(detail::vector_expression_type<L> || detail::vector_expression_type<R>) &&
+            (detail::operand_dims_v<L> == detail::operand_dims_v<R>)
+constexpr auto operator!=(const L &lhs, const R &rhs) -> bool {
+    return !(lhs == rhs);
+}
+
+} // namespace mia
@@ -0,0 +1,474 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MIA_VECTOR_IO_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "math-utilities.hpp"
+#include "vector.hpp"
+
+namespace mia {
+
+// NOTE: FILE FORMAT
+// [header, 64 bytes][zero padding up to data_offset][count vectors, `stride` bytes apart]
+// The vectors are written as they sit in memory (SIMD padding included), so a reader with the same
+// layout maps them as is; load() converts any other stride or byte order
+
+enum class scalar_type : uint8_t {
+    i8 = 1,
+    u8,
+    i16,
+    u16,
+    i32,
+    u32,
+    i64,
+    u64,
+    f32,
+    f64,
+};
+
+template <typename T>
+consteval auto scalar_type_of() -> scalar_type {
+    if constexpr (std::is_floating_point_v<T>) {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Only float and double are stored");
+        return sizeof(T) == 4 ? scalar_type::f32 : scalar_type::f64;
+    } else {
+        static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "Only arithmetic components are stored");
+        constexpr auto base = std::is_signed_v<T> ? scalar_type::i8 : scalar_type::u8;
+        return static_cast<scalar_type>(static_cast<uint8_t>(base) + 2 * std::countr_zero(sizeof(T)));
+    }
+}
+
+struct vector_file_header {
+    static constexpr std::array<char, 8> signature{'M', 'I', 'A', 'V', 'E', 'C', '\r', '\n'};
+    static constexpr uint16_t current_version = 1;
+    static constexpr uint32_t byte_order_mark = 0x0102'0304; // reads 0x04030201 on the other endianness
+
+    std::array<char, 8> magic = signature;
+    uint32_t byte_order = byte_order_mark;
+    uint16_t version = current_version;
+    scalar_type scalar{};
+    uint8_t reserved0 = 0;
+    uint32_t dims = 0;
+    uint32_t stride = 0;      // Bytes from one vector to the next
+    uint64_t alignment = 0;   // data_offset is a multiple of it
+    uint64_t count = 0;       // 0 until the writer is closed
+    uint64_t data_offset = 0; // From the start of the file
+    std::array<uint8_t, 16> reserved{};
+
+    [[nodiscard]] constexpr auto foreign() const noexcept -> bool {
+        return byte_order != byte_order_mark;
+    }
+    [[nodiscard]] constexpr auto component_size() const noexcept -> size_t {
+        switch (scalar) {
+        case scalar_type::f32:
+            return 4;
+        case scalar_type::f64:
+            return 8;
+        default:
+            return size_t{1} << ((static_cast<uint8_t>(scalar) - 1) / 2);
+        }
+    }
+};
+static_assert(sizeof(vector_file_header) == 64 && std::is_trivially_copyable_v<vector_file_header>);
+
+// Malformed file, or one that does not hold the requested vector type
+class vector_file_error : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+namespace detail {
+
+inline auto file_message(const std::filesystem::path &path, const char *what) -> std::string {
+    return path.string() + ": " + what;
+}
+
+inline auto byteswap_header(vector_file_header h) noexcept -> vector_file_header {
+    h.byte_order = std::byteswap(h.byte_order);
+    h.version = std::byteswap(h.version);
+    h.dims = std::byteswap(h.dims);
+    h.stride = std::byteswap(h.stride);
+    h.alignment = std::byteswap(h.alignment);
+    h.count = std::byteswap(h.count);
+    h.data_offset = std::byteswap(h.data_offset);
+    return h;
+}
+
+// Header in native byte order, `foreign()` still tells how the data is stored
+inline auto parse_header(const std::byte *bytes, const size_t file_size, const std::filesystem::path &path) -> vector_file_header {
+    if (file_size < sizeof(vector_file_header)) {
+        throw vector_file_error(file_message(path, "too small for a vector file header"));
+    }
+    vector_file_header header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (header.magic != vector_file_header::signature) {
+        throw vector_file_error(file_message(path, "not a vector file"));
+    }
+    if (header.foreign()) {
+        if (header.byte_order != std::byteswap(vector_file_header::byte_order_mark)) {
+            throw vector_file_error(file_message(path, "unknown byte order"));
+        }
+        header = byteswap_header(header);
+        header.byte_order = std::byteswap(vector_file_header::byte_order_mark);
+    }
+    if (header.version == 0 || header.version > vector_file_header::current_version) {
+        throw vector_file_error(file_message(path, "unsupported version"));
+    }
+    const auto scalar = static_cast<uint8_t>(header.scalar);
+    if (scalar < static_cast<uint8_t>(scalar_type::i8) || scalar > static_cast<uint8_t>(scalar_type::f64)) {
+        throw vector_file_error(file_message(path, "unknown component type"));
+    }
+    if (header.dims == 0 || header.stride < header.dims * header.component_size() || header.data_offset < sizeof(header)) {
+        throw vector_file_error(file_message(path, "inconsistent header"));
+    }
+    if (header.data_offset > file_size || header.count > (file_size - header.data_offset) / header.stride) {
+        throw vector_file_error(file_message(path, "truncated data"));
+    }
+    return header;
+}
+
+template <typename T, size_t Dims>
+void check_type(const vector_file_header &header, const std::filesystem::path &path) {
+    if (header.scalar != scalar_type_of<T>() || header.dims != Dims) {
+        throw vector_file_error(file_message(path, "holds another vector type"));
+    }
+}
+
+} // namespace detail
+
+// NOTE: READING
+// Copies into memory, whatever the stride or byte order it was written with
+
+template <typename T, size_t Dims>
+auto load(const std::filesystem::path &path) -> std::vector<vector<T, Dims>> {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::system_error(errno, std::generic_category(), path.string());
+    }
+    const auto file_size = static_cast<size_t>(file.tellg());
+    std::array<std::byte, sizeof(vector_file_header)> raw{};
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(raw.data()), static_cast<std::streamsize>(std::min(raw.size(), file_size)));
+    const vector_file_header header = detail::parse_header(raw.data(), file_size, path);
+    detail::check_type<T, Dims>(header, path);
+
+    std::vector<vector<T, Dims>> result(header.count);
+    if (header.count == 0) {
+        return result;
+    }
+    file.seekg(static_cast<std::streamoff>(header.data_offset));
+    if (header.stride == sizeof(vector<T, Dims>) && !header.foreign()) {
+        file.read(reinterpret_cast<char *>(result.data()), static_cast<std::streamsize>(header.count * header.stride));
+    } else {
+        std::vector<std::byte> element(header.stride);
+        for (auto &v : result) {
+            file.read(reinterpret_cast<char *>(element.data()), static_cast<std::streamsize>(element.size()));
+            for (size_t d = 0; d < Dims; ++d) {
+                std::array<std::byte, sizeof(T)> component;
+                std::memcpy(component.data(), element.data() + d * sizeof(T), sizeof(T));
+                if (header.foreign()) {
+                    std::reverse(component.begin(), component.end());
+                }
+                v[d] = std::bit_cast<T>(component);
+            }
+        }
+    }
+    if (!file) {
+        throw vector_file_error(detail::file_message(path, "read failed"));
+    }
+    return result;
+}
+
+// Header only, in native byte order
+inline auto read_header(const std::filesystem::path &path) -> vector_file_header {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::system_error(errno, std::generic_category(), path.string());
+    }
+    const auto file_size = static_cast<size_t>(file.tellg());
+    std::array<std::byte, sizeof(vector_file_header)> raw{};
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(raw.data()), static_cast<std::streamsize>(std::min(raw.size(), file_size)));
+    return detail::parse_header(raw.data(), file_size, path);
+}
+
+// NOTE: MAPPED ARRAY
+// Read-only view of a vector file mapped into memory: opening costs one mmap, pages are read from
+// disk (or the page cache) when first touched. The file must have been written with the in-memory
+// layout of vector<T, Dims> in this build and the native byte order, see load() otherwise
+// Without mmap the file is loaded instead
+
+enum class access_pattern : uint8_t {
+    normal,
+    sequential, // Aggressive read-ahead, pages dropped soon after use
+    random,     // No read-ahead
+    will_need,  // Start reading the whole range now
+};
+
+template <typename V>
+class mapped_array;
+
+template <typename T, size_t Dims>
+class mapped_array<vector<T, Dims>> {
+  public:
+    using value_type = vector<T, Dims>;
+    using const_iterator = const value_type *;
+
+    mapped_array() noexcept = default;
+
+    explicit mapped_array(const std::filesystem::path &path) {
+#if defined(MIA_VECTOR_IO_MMAP)
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), path.string());
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), path.string());
+        }
+        const auto file_size = static_cast<size_t>(info.st_size);
+        void *mapping = file_size == 0 ? MAP_FAILED : ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        const int error = errno;
+        ::close(fd); // The mapping keeps the file alive
+        if (file_size == 0) {
+            throw vector_file_error(detail::file_message(path, "too small for a vector file header"));
+        }
+        if (mapping == MAP_FAILED) {
+            throw std::system_error(error, std::generic_category(), path.string());
+        }
+        mapping_ = mapping;
+        mapping_size_ = file_size;
+
+        try {
+            const vector_file_header header = detail::parse_header(static_cast<const std::byte *>(mapping), file_size, path);
+            detail::check_type<T, Dims>(header, path);
+            if (header.foreign() || header.stride != sizeof(value_type) || header.data_offset % alignof(value_type) != 0) {
+                throw vector_file_error(detail::file_message(path, "layout differs from this build, use mia::load()"));
+            }
+            data_ = reinterpret_cast<const value_type *>(static_cast<const std::byte *>(mapping) + header.data_offset);
+            size_ = header.count;
+        } catch (...) {
+            unmap();
+            throw;
+        }
+#else
+        owned_ = load<T, Dims>(path);
+        data_ = owned_.data();
+        size_ = owned_.size();
+#endif
+    }
+
+    ~mapped_array() {
+        unmap();
+    }
+
+    mapped_array(const mapped_array &other) = delete;
+    auto operator=(const mapped_array &other) -> mapped_array & = delete;
+
+    mapped_array(mapped_array &&other) noexcept
+        : mapping_(std::exchange(other.mapping_, nullptr)), mapping_size_(std::exchange(other.mapping_size_, 0)),
+          owned_(std::move(other.owned_)), data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {
+    }
+    auto operator=(mapped_array &&other) noexcept -> mapped_array & {
+        if (this != &other) {
+            unmap();
+            mapping_ = std::exchange(other.mapping_, nullptr);
+            mapping_size_ = std::exchange(other.mapping_size_, 0);
+            owned_ = std::move(other.owned_);
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    // Hint for the kernel's read-ahead, over the whole array
+    void advise([[maybe_unused]] const access_pattern pattern) const noexcept {
+#if defined(MIA_VECTOR_IO_MMAP)
+        if (mapping_ == nullptr) {
+            return;
+        }
+        int advice = MADV_NORMAL;
+        switch (pattern) {
+        case access_pattern::sequential:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case access_pattern::random:
+            advice = MADV_RANDOM;
+            break;
+        case access_pattern::will_need:
+            advice = MADV_WILLNEED;
+            break;
+        default:
+            break;
+        }
+        ::madvise(mapping_, mapping_size_, advice);
+#endif
+    }
+
+    // NOTE: ACCESS
+
+    [[nodiscard]] auto span() const noexcept -> std::span<const value_type> {
+        return {data_, size_};
+    }
+    [[nodiscard]] auto data() const noexcept -> const value_type * {
+        return data_;
+    }
+    [[nodiscard]] auto size() const noexcept -> size_t {
+        return size_;
+    }
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return size_ == 0;
+    }
+    [[nodiscard]] auto operator[](const size_t i) const noexcept -> const value_type & {
+        assert(i < size_);
+        return data_[i];
+    }
+    [[nodiscard]] auto begin() const noexcept -> const_iterator {
+        return data_;
+    }
+    [[nodiscard]] auto end() const noexcept -> const_iterator {
+        return data_ + size_;
+    }
+
+  private:
+    void unmap() noexcept {
+#if defined(MIA_VECTOR_IO_MMAP)
+        if (mapping_ != nullptr) {
+            ::munmap(mapping_, mapping_size_);
+        }
+#endif
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+    }
+
+    void *mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    std::vector<value_type> owned_; // Without mmap only
+    const value_type *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// NOTE: WRITING
+// Streams vectors to a file in their in-memory layout; the count lands in the header on close(),
+// so a file cut short by a crash reads as empty rather than half written
+
+struct vector_writer_options {
+    size_t alignment = MIA_PAGE_ALIGNMENT; // Of the data offset; a page keeps mapped data aligned for any SIMD width
+};
+
+template <typename T, size_t Dims>
+class vector_writer {
+  public:
+    using value_type = vector<T, Dims>;
+
+    explicit vector_writer(const std::filesystem::path &path, const vector_writer_options options = {}) : path_(path) {
+        assert(options.alignment >= alignof(value_type) && (options.alignment & (options.alignment - 1)) == 0);
+        file_ = std::fopen(path.string().c_str(), "wb");
+        if (file_ == nullptr) {
+            throw std::system_error(errno, std::generic_category(), path.string());
+        }
+        header_.scalar = scalar_type_of<T>();
+        header_.dims = Dims;
+        header_.stride = sizeof(value_type);
+        header_.alignment = options.alignment;
+        header_.data_offset = (sizeof(vector_file_header) + options.alignment - 1) & ~(options.alignment - 1);
+
+        // Header with a zero count, then the padding
+        std::vector<std::byte> prefix(header_.data_offset);
+        std::memcpy(prefix.data(), &header_, sizeof(header_));
+        put(prefix.data(), prefix.size());
+    }
+
+    ~vector_writer() {
+        if (file_ != nullptr) {
+            try {
+                close();
+            } catch (...) {
+                // Call close() to see the error
+            }
+        }
+    }
+
+    vector_writer(const vector_writer &other) = delete;
+    auto operator=(const vector_writer &other) -> vector_writer & = delete;
+
+    vector_writer(vector_writer &&other) noexcept
+        : path_(std::move(other.path_)), file_(std::exchange(other.file_, nullptr)), header_(other.header_) {
+    }
+    auto operator=(vector_writer &&other) noexcept -> vector_writer & = delete;
+
+    void write(std::span<const value_type> vectors) {
+        assert(file_ != nullptr);
+        put(vectors.data(), vectors.size_bytes());
+        header_.count += vectors.size();
+    }
+    void write(const value_type &v) {
+        write(std::span<const value_type>{&v, 1});
+    }
+
+    // Vectors written so far
+    [[nodiscard]] auto size() const noexcept -> size_t {
+        return header_.count;
+    }
+
+    // Stores the count, flushes & closes the file
+    void close() {
+        if (file_ == nullptr) {
+            return;
+        }
+        std::FILE *file = std::exchange(file_, nullptr);
+        const bool written = std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header_, sizeof(header_), 1, file) == 1;
+        const bool closed = std::fclose(file) == 0;
+        if (!written || !closed) {
+            throw vector_file_error(detail::file_message(path_, "write failed"));
+        }
+    }
+
+  private:
+    void put(const void *bytes, const size_t size) {
+        if (size != 0 && std::fwrite(bytes, 1, size, file_) != size) {
+            std::fclose(std::exchange(file_, nullptr));
+            throw vector_file_error(detail::file_message(path_, "write failed"));
+        }
+    }
+
+    std::filesystem::path path_;
+    std::FILE *file_ = nullptr;
+    vector_file_header header_;
+};
+
+// Whole span at once
+template <typename T, size_t Dims>
+void save(const std::filesystem::path &path, std::span<const vector<T, Dims>> vectors, const vector_writer_options options = {}) {
+    vector_writer<T, Dims> writer(path, options);
+    writer.write(vectors);
+    writer.close();
+}
+
+} // namespace mia
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "simd.hpp"
+
+namespace mia::detail {
+
+// Storage layout and kernels used by mia::vector
+// The primary template is the scalar fallback: no padding, natural alignment
+template <typename T, size_t Dims>
+struct vector_simd {
+    static constexpr bool enabled = false;
+    static constexpr size_t storage_size = Dims;
+    static constexpr size_t alignment = alignof(std::array<T, Dims>);
+};
+
+// Packs over contiguous lanes (vector_soa, batch kernels): the widest native register, one element without SIMD
+template <typename T>
+using simd_pack = simd_ops<T, simd_native_width_v<T>>;
+
+#if defined(MIA_SIMD_SSE2)
+
+// :: vector<float, 3> & vector<float, 4>
+// Padded to one float x 4 register, reductions (dot, equal) ignore the padding lane
+template <size_t Dims>
+    requires(Dims == 3 || Dims == 4)
+struct vector_simd<float, Dims> {
+    using ops = simd_ops<float, 4>;
+
+    static constexpr bool enabled = true;
+    static constexpr size_t storage_size = 4;
+    static constexpr size_t alignment = 16;
+
+    static inline void add(float *res, const float *lhs, const float *rhs) noexcept {
+        ops::store(res, ops::add(ops::load(lhs), ops::load(rhs)));
+    }
+    static inline void sub(float *res, const float *lhs, const float *rhs) noexcept {
+        ops::store(res, ops::sub(ops::load(lhs), ops::load(rhs)));
+    }
+    static inline void mul(float *res, const float *lhs, const float *rhs) noexcept {
+        ops::store(res, ops::mul(ops::load(lhs), ops::load(rhs)));
+    }
+    static inline void scale(float *res, const float *lhs, const float k) noexcept {
+        ops::store(res, ops::mul(ops::load(lhs), ops::set1(k)));
+    }
+    static inline void div(float *res, const float *lhs, const float k) noexcept {
+        ops::store(res, ops::div(ops::load(lhs), ops::set1(k)));
+    }
+    static inline void max(float *res, const float *lhs, const float *rhs) noexcept {
+        ops::store(res, ops::max(ops::load(lhs), ops::load(rhs)));
+    }
+    static inline void min(float *res, const float *lhs, const float *rhs) noexcept {
+        ops::store(res, ops::min(ops::load(lhs), ops::load(rhs)));
+    }
+    static inline void lerp(float *res, const float *from, const float *to, const float alpha) noexcept {
+        const auto from_part = ops::mul(ops::load(from), ops::set1(1.0f - alpha));
+        const auto to_part = ops::mul(ops::load(to), ops::set1(alpha));
+        ops::store(res, ops::add(from_part, to_part));
+    }
+    // Sums only the first Dims lanes, in the same order as the scalar loop
+    static inline auto dot(const float *lhs, const float *rhs) noexcept -> float {
+        const __m128 prod = ops::mul(ops::load(lhs), ops::load(rhs));
+        __m128 sum = _mm_add_ss(prod, _mm_shuffle_ps(prod, prod, _MM_SHUFFLE(1, 1, 1, 1)));
+        sum = _mm_add_ss(sum, _mm_movehl_ps(prod, prod));
+        if constexpr (Dims == 4) {
+            sum = _mm_add_ss(sum, _mm_shuffle_ps(prod, prod, _MM_SHUFFLE(3, 3, 3, 3)));
+        }
+        return _mm_cvtss_f32(sum);
+    }
+    static inline auto equal(const float *lhs, const float *rhs) noexcept -> bool {
+        constexpr uint64_t lane_mask = (uint64_t{1} << Dims) - 1;
+        return (ops::mask_bits(ops::eq(ops::load(lhs), ops::load(rhs))) & lane_mask) == lane_mask;
+    }
+};
+
+// :: vector<double, 4>
+// One double x 4 register with AVX, two double x 2 with SSE2 only
+template <>
+struct vector_simd<double, 4> {
+    using ops = simd_ops<double, 4>;
+
+    static constexpr bool enabled = true;
+    static constexpr size_t storage_size = 4;
+    static constexpr size_t alignment = alignof(ops::type);
+
+    static inline void add(double *res, const double *lhs, const double *rhs) noexcept {
+        ops::store(res, ops::add(ops::load(lhs), ops::load(rhs)));
+    }
+    static inline void sub(double *res, const double *lhs, const double *rhs) noexcept {
+        ops::store(res, ops::sub(ops::load(lhs), ops::load(rhs)));
+    }
+    static inline void mul(double *res, const double *lhs, const double *rhs) noexcept {
+        ops::store(res, ops::mul(ops::load(lhs), ops::load(rhs)));
+    }
+    static inline void scale(double *res, const double *lhs, const double k) noexcept {
+        ops::store(res, ops::mul(ops::load(lhs), ops::set1(k)));
+    }
+    static inline void div(double *res, const double *lhs, const double k) noexcept {
+        ops::store(res, ops::div(ops::load(lhs), ops::set1(k)));
+    }
+    static inline void max(double *res, const double *lhs, const double *rhs) noexcept {
+        ops::store(res, ops::max(ops::load(lhs), ops::load(rhs)));
+    }
+    static inline void min(double *res, const double *lhs, const double *rhs) noexcept {
+        ops::store(res, ops::min(ops::load(lhs), ops::load(rhs)));
+    }
+    static inline void lerp(double *res, const double *from, const double *to, const double alpha) noexcept {
+        const auto from_part = ops::mul(ops::load(from), ops::set1(1.0 - alpha));
+        const auto to_part = ops::mul(ops::load(to), ops::set1(alpha));
+        ops::store(res, ops::add(from_part, to_part));
+    }
+    // In the same order as the scalar loop
+    static inline auto dot(const double *lhs, const double *rhs) noexcept -> double {
+        alignas(alignment) double prod[4];
+        ops::store(prod, ops::mul(ops::load(lhs), ops::load(rhs)));
+        return ((prod[0] + prod[1]) + prod[2]) + prod[3];
+    }
+    static inline auto equal(const double *lhs, const double *rhs) noexcept -> bool {
+        return ops::mask_bits(ops::eq(ops::load(lhs), ops::load(rhs))) == 0xF;
+    }
+};
+
+#endif // MIA_SIMD_SSE2
+
+} // namespace mia::detail
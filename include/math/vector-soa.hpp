@@ -0,0 +1,514 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "math-utilities.hpp"
+#include "matrix.hpp"
+#include "quaternion.hpp"
+#include "vector-simd.hpp"
+#include "vector.hpp"
+
+namespace mia {
+
+// Structure of arrays of mia::vector<T, Dims>
+// Each component lives in its own aligned lane, lanes are padded to a whole number of packs
+// so every batched kernel runs full SIMD packs without a scalar tail
+template <typename T, size_t Dims>
+    requires std::is_arithmetic_v<T>
+class vector_soa {
+  public:
+    // NOTE: MEMBER TYPES
+
+    using value_type = vector<T, Dims>;
+    using element_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using compute_type = typename value_type::compute_type;
+
+    using pack = detail::simd_pack<T>;
+    // Cache line aligned lanes, loads never split a line whichever ISA the kernels run on
+    static constexpr size_t lane_alignment = std::max<size_t>(MIA_CACHE_LINE_ALIGNMENT, pack::width * sizeof(T));
+    using allocator_type = simd_allocator<T, lane_alignment>;
+    using lane_type = std::vector<T, allocator_type>;
+
+    // :: Proxy to one element, reads & writes through to the lanes
+    template <bool Const>
+    class basic_reference {
+      public:
+        using owner_type = std::conditional_t<Const, const vector_soa, vector_soa>;
+        using component_reference = std::conditional_t<Const, const T &, T &>;
+
+        constexpr basic_reference(owner_type &owner, const size_t index) noexcept
+            : owner_(&owner), index_(index) {
+        }
+
+        // Load as mia::vector
+        constexpr operator value_type() const {
+            value_type result;
+            for (size_t d = 0; d < Dims; ++d) {
+                result[d] = owner_->lanes_[d][index_];
+            }
+            return result;
+        }
+        constexpr auto load() const -> value_type {
+            return *this;
+        }
+
+        // Store a mia::vector
+        constexpr auto operator=(const value_type &v) const -> const basic_reference &
+            requires(!Const)
+        {
+            for (size_t d = 0; d < Dims; ++d) {
+                owner_->lanes_[d][index_] = v[d];
+            }
+            return *this;
+        }
+        constexpr auto operator=(const basic_reference &other) const -> const basic_reference &
+            requires(!Const)
+        {
+            return *this = other.load();
+        }
+
+        constexpr auto operator[](const size_t d) const -> component_reference {
+            return owner_->lanes_[d][index_];
+        }
+
+        // :: Named accessors
+        constexpr auto x() const -> component_reference
+            requires(Dims >= 1)
+        {
+            return owner_->lanes_[0][index_];
+        }
+        constexpr auto y() const -> component_reference
+            requires(Dims >= 2)
+        {
+            return owner_->lanes_[1][index_];
+        }
+        constexpr auto z() const -> component_reference
+            requires(Dims >= 3)
+        {
+            return owner_->lanes_[2][index_];
+        }
+        constexpr auto w() const -> component_reference
+            requires(Dims >= 4)
+        {
+            return owner_->lanes_[3][index_];
+        }
+
+      private:
+        owner_type *owner_;
+        size_t index_;
+    };
+    using reference = basic_reference<false>;
+    using const_reference = basic_reference<true>;
+
+    // :: Iterator yielding proxies
+    template <bool Const>
+    class basic_iterator {
+      public:
+        using owner_type = std::conditional_t<Const, const vector_soa, vector_soa>;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = vector_soa::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = basic_reference<Const>;
+
+        constexpr basic_iterator() noexcept = default;
+        constexpr basic_iterator(owner_type &owner, const size_t index) noexcept
+            : owner_(&owner), index_(index) {
+        }
+
+        constexpr auto operator*() const -> reference {
+            return reference(*owner_, index_);
+        }
+        constexpr auto operator[](const difference_type n) const -> reference {
+            return reference(*owner_, static_cast<size_t>(static_cast<difference_type>(index_) + n));
+        }
+
+        constexpr auto operator++() -> basic_iterator & {
+            ++index_;
+            return *this;
+        }
+        constexpr auto operator++(int) -> basic_iterator {
+            basic_iterator tmp = *this;
+            ++index_;
+            return tmp;
+        }
+        constexpr auto operator--() -> basic_iterator & {
+            --index_;
+            return *this;
+        }
+        constexpr auto operator--(int) -> basic_iterator {
+            basic_iterator tmp = *this;
+            --index_;
+            return tmp;
+        }
+        constexpr auto operator+=(const difference_type n) -> basic_iterator & {
+            index_ = static_cast<size_t>(static_cast<difference_type>(index_) + n);
+            return *this;
+        }
+        constexpr auto operator-=(const difference_type n) -> basic_iterator & {
+            return *this += -n;
+        }
+        constexpr auto operator+(const difference_type n) const -> basic_iterator {
+            basic_iterator tmp = *this;
+            return tmp += n;
+        }
+        constexpr auto operator-(const difference_type n) const -> basic_iterator {
+            basic_iterator tmp = *this;
+            return tmp -= n;
+        }
+        constexpr auto operator-(const basic_iterator &other) const -> difference_type {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+
+        constexpr auto operator==(const basic_iterator &other) const -> bool {
+            return index_ == other.index_;
+        }
+        constexpr auto operator<=>(const basic_iterator &other) const {
+            return index_ <=> other.index_;
+        }
+
+      private:
+        owner_type *owner_ = nullptr;
+        size_t index_ = 0;
+    };
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // NOTE: CONSTRUCTOR
+
+    constexpr vector_soa() = default;
+
+    explicit vector_soa(const size_t count) {
+        resize(count);
+    }
+
+    // Construct from an array of structures
+    explicit vector_soa(std::span<const value_type> aos) {
+        resize(aos.size());
+        for (size_t d = 0; d < Dims; ++d) {
+            T *lane_ptr = lanes_[d].data();
+            for (size_t i = 0; i < aos.size(); ++i) {
+                lane_ptr[i] = aos[i][d];
+            }
+        }
+    }
+
+    // NOTE: ITERATION
+
+    auto begin() noexcept -> iterator {
+        return iterator(*this, 0);
+    }
+    auto begin() const noexcept -> const_iterator {
+        return const_iterator(*this, 0);
+    }
+    auto end() noexcept -> iterator {
+        return iterator(*this, count_);
+    }
+    auto end() const noexcept -> const_iterator {
+        return const_iterator(*this, count_);
+    }
+    [[nodiscard]] auto size() const noexcept -> size_type {
+        return count_;
+    }
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return count_ == 0;
+    }
+    // Lane length including padding, always a multiple of pack::width
+    [[nodiscard]] auto padded_size() const noexcept -> size_type {
+        return lanes_[0].size();
+    }
+
+    // NOTE: ELEMENT ACCESS
+
+    auto operator[](const size_t i) -> reference {
+        assert(i < count_);
+        return reference(*this, i);
+    }
+    auto operator[](const size_t i) const -> const_reference {
+        assert(i < count_);
+        return const_reference(*this, i);
+    }
+
+    // :: Lanes
+    auto lane(const size_t d) noexcept -> std::span<T> {
+        return {lanes_[d].data(), count_};
+    }
+    auto lane(const size_t d) const noexcept -> std::span<const T> {
+        return {lanes_[d].data(), count_};
+    }
+    auto x() noexcept -> std::span<T>
+        requires(Dims >= 1)
+    {
+        return lane(0);
+    }
+    auto x() const noexcept -> std::span<const T>
+        requires(Dims >= 1)
+    {
+        return lane(0);
+    }
+    auto y() noexcept -> std::span<T>
+        requires(Dims >= 2)
+    {
+        return lane(1);
+    }
+    auto y() const noexcept -> std::span<const T>
+        requires(Dims >= 2)
+    {
+        return lane(1);
+    }
+    auto z() noexcept -> std::span<T>
+        requires(Dims >= 3)
+    {
+        return lane(2);
+    }
+    auto z() const noexcept -> std::span<const T>
+        requires(Dims >= 3)
+    {
+        return lane(2);
+    }
+    auto w() noexcept -> std::span<T>
+        requires(Dims >= 4)
+    {
+        return lane(3);
+    }
+    auto w() const noexcept -> std::span<const T>
+        requires(Dims >= 4)
+    {
+        return lane(3);
+    }
+
+    // NOTE: MODIFIERS
+
+    void reserve(const size_t count) {
+        for (auto &l : lanes_) {
+            l.reserve(padded(count));
+        }
+    }
+
+    // New elements are zero, in-place kernels may have written the old padding so it is cleared too
+    void resize(const size_t count) {
+        const auto keep = static_cast<difference_type>(std::min(count, count_));
+        for (auto &l : lanes_) {
+            l.resize(padded(count));
+            std::fill(l.begin() + keep, l.end(), T{});
+        }
+        count_ = count;
+    }
+
+    void clear() noexcept {
+        for (auto &l : lanes_) {
+            l.clear();
+        }
+        count_ = 0;
+    }
+
+    void push_back(const value_type &v) {
+        if (count_ == padded_size()) {
+            for (auto &l : lanes_) {
+                l.resize(padded(count_ + 1));
+            }
+        }
+        for (size_t d = 0; d < Dims; ++d) {
+            lanes_[d][count_] = v[d];
+        }
+        ++count_;
+    }
+
+    // Copy back to an array of structures
+    void store(std::span<value_type> aos) const {
+        assert(aos.size() >= count_);
+        for (size_t d = 0; d < Dims; ++d) {
+            const T *lane_ptr = lanes_[d].data();
+            for (size_t i = 0; i < count_; ++i) {
+                aos[i][d] = lane_ptr[i];
+            }
+        }
+    }
+
+    // NOTE: BATCHED OPERATIONS
+    // `out` is resized to match, it may alias an input
+
+    // :: Element-wise
+    static void add(const vector_soa &lhs, const vector_soa &rhs, vector_soa &out) {
+        binary(lhs, rhs, out, [](auto a, auto b) { return pack::add(a, b); });
+    }
+    static void sub(const vector_soa &lhs, const vector_soa &rhs, vector_soa &out) {
+        binary(lhs, rhs, out, [](auto a, auto b) { return pack::sub(a, b); });
+    }
+    static void hadamard_product(const vector_soa &lhs, const vector_soa &rhs, vector_soa &out) {
+        binary(lhs, rhs, out, [](auto a, auto b) { return pack::mul(a, b); });
+    }
+    static void min(const vector_soa &lhs, const vector_soa &rhs, vector_soa &out) {
+        binary(lhs, rhs, out, [](auto a, auto b) { return pack::min(a, b); });
+    }
+    static void max(const vector_soa &lhs, const vector_soa &rhs, vector_soa &out) {
+        binary(lhs, rhs, out, [](auto a, auto b) { return pack::max(a, b); });
+    }
+    static void scale(const vector_soa &v, const T k, vector_soa &out) {
+        const auto k_pack = pack::set1(k);
+        unary(v, out, [k_pack](auto a) { return pack::mul(a, k_pack); });
+    }
+    static void lerp(const vector_soa &from, const vector_soa &to, const T alpha, vector_soa &out) {
+        const auto alpha_pack = pack::set1(alpha);
+        const auto one_minus_alpha_pack = pack::set1(static_cast<T>(1) - alpha);
+        binary(from, to, out, [alpha_pack, one_minus_alpha_pack](auto a, auto b) {
+            return pack::add(pack::mul(a, one_minus_alpha_pack), pack::mul(b, alpha_pack));
+        });
+    }
+
+    // :: Linear transforms, every component of a pack is loaded before the first store
+    static void transform(const matrix<T, Dims, Dims> &m, const vector_soa &v, vector_soa &out) {
+        if (&out != &v) {
+            out.resize(v.size());
+        }
+        typename pack::type m_packs[Dims * Dims];
+        for (size_t r = 0; r < Dims; ++r) {
+            for (size_t c = 0; c < Dims; ++c) {
+                m_packs[r * Dims + c] = pack::set1(m(r, c));
+            }
+        }
+        const size_t n = v.padded_size();
+        for (size_t i = 0; i < n; i += pack::width) {
+            typename pack::type in[Dims];
+            for (size_t d = 0; d < Dims; ++d) {
+                in[d] = pack::load(v.lanes_[d].data() + i);
+            }
+            for (size_t r = 0; r < Dims; ++r) {
+                auto acc = pack::mul(m_packs[r * Dims], in[0]);
+                for (size_t c = 1; c < Dims; ++c) {
+                    acc = pack::add(acc, pack::mul(m_packs[r * Dims + c], in[c]));
+                }
+                pack::store(out.lanes_[r].data() + i, acc);
+            }
+        }
+    }
+    // Rotating many vectors by one quaternion goes through its matrix: 9 multiplies per vector instead of 15
+    template <typename U = T>
+        requires std::is_floating_point_v<U> && (Dims == 3)
+    static void rotate(const quaternion<U> &q, const vector_soa &v, vector_soa &out) {
+        transform(q.to_matrix3(), v, out);
+    }
+
+    // :: Reductions per element, `out` must hold size() values
+    static void dot_product(const vector_soa &lhs, const vector_soa &rhs, std::span<compute_type> out) {
+        assert(lhs.size() == rhs.size());
+        assert(out.size() >= lhs.size());
+        const size_t count = lhs.size();
+
+        if constexpr (std::is_same_v<compute_type, T>) {
+            size_t i = 0;
+            for (; i + pack::width <= count; i += pack::width) {
+                pack::storeu(out.data() + i, dot_pack(lhs, rhs, i));
+            }
+            // Padding makes the last pack safe to compute, only the store is partial
+            if (i < count) {
+                alignas(lane_alignment) T tail[pack::width];
+                pack::store(tail, dot_pack(lhs, rhs, i));
+                std::copy(tail, tail + (count - i), out.data() + i);
+            }
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                T acc{};
+                for (size_t d = 0; d < Dims; ++d) {
+                    acc += lhs.lanes_[d][i] * rhs.lanes_[d][i];
+                }
+                out[i] = static_cast<compute_type>(acc);
+            }
+        }
+    }
+    void magnitude_squared(std::span<compute_type> out) const {
+        dot_product(*this, *this, out);
+    }
+
+    // Normalize every element in place
+    // precision::fast replaces the square root & division by the rsqrt estimate and one Newton step (float)
+    template <precision P = precision::exact>
+    void normalizing()
+        requires std::is_floating_point_v<T>
+    {
+        const size_t n = padded_size();
+        const auto one = pack::set1(static_cast<T>(1));
+        for (size_t i = 0; i < n; i += pack::width) {
+            const auto magnitude_squared = dot_pack(*this, *this, i);
+            const auto inv_magnitude = P == precision::fast ? pack::rsqrt(magnitude_squared) : pack::div(one, pack::sqrt(magnitude_squared));
+            for (size_t d = 0; d < Dims; ++d) {
+                T *p = lanes_[d].data() + i;
+                pack::store(p, pack::mul(pack::load(p), inv_magnitude));
+            }
+        }
+    }
+
+    // NOTE: OPERATORS
+
+    auto operator+=(const vector_soa &other) -> vector_soa & {
+        add(*this, other, *this);
+        return *this;
+    }
+    auto operator-=(const vector_soa &other) -> vector_soa & {
+        sub(*this, other, *this);
+        return *this;
+    }
+    auto operator*=(const T k) -> vector_soa & {
+        scale(*this, k, *this);
+        return *this;
+    }
+
+  private:
+    std::array<lane_type, Dims> lanes_;
+    size_t count_ = 0;
+
+    static constexpr auto padded(const size_t count) noexcept -> size_t {
+        return (count + pack::width - 1) / pack::width * pack::width;
+    }
+
+    static auto dot_pack(const vector_soa &lhs, const vector_soa &rhs, const size_t i) noexcept -> typename pack::type {
+        auto acc = pack::mul(pack::load(lhs.lanes_[0].data() + i), pack::load(rhs.lanes_[0].data() + i));
+        for (size_t d = 1; d < Dims; ++d) {
+            acc = pack::add(acc, pack::mul(pack::load(lhs.lanes_[d].data() + i), pack::load(rhs.lanes_[d].data() + i)));
+        }
+        return acc;
+    }
+
+    template <typename Op>
+    static void binary(const vector_soa &lhs, const vector_soa &rhs, vector_soa &out, Op op) {
+        assert(lhs.size() == rhs.size());
+        if (&out != &lhs && &out != &rhs) {
+            out.resize(lhs.size());
+        }
+        const size_t n = lhs.padded_size();
+        for (size_t d = 0; d < Dims; ++d) {
+            const T *l = lhs.lanes_[d].data();
+            const T *r = rhs.lanes_[d].data();
+            T *o = out.lanes_[d].data();
+            for (size_t i = 0; i < n; i += pack::width) {
+                pack::store(o + i, op(pack::load(l + i), pack::load(r + i)));
+            }
+        }
+    }
+
+    template <typename Op>
+    static void unary(const vector_soa &v, vector_soa &out, Op op) {
+        if (&out != &v) {
+            out.resize(v.size());
+        }
+        const size_t n = v.padded_size();
+        for (size_t d = 0; d < Dims; ++d) {
+            const T *src = v.lanes_[d].data();
+            T *o = out.lanes_[d].data();
+            for (size_t i = 0; i < n; i += pack::width) {
+                pack::store(o + i, op(pack::load(src + i)));
+            }
+        }
+    }
+};
+
+} // namespace mia
@@ -12,6 +12,11 @@
 #include <ranges>
 #include <type_traits>
 
+#include "constexpr-math.hpp"
+#include "fast-math.hpp"
+#include "vector-expression.hpp"
+#include "vector-simd.hpp"
+
 namespace mia {
 
 // FIXME: may failed on some edge case if value ~0
@@ -19,7 +24,10 @@ template <typename T, size_t Dims>
     requires std::is_arithmetic_v<T>
 class vector {
   public:
-    std::array<T, Dims> data;
+    // NOTE: padded & over-aligned when a SIMD layout exists for <T, Dims> (see vector-simd.hpp)
+    using simd_traits = detail::vector_simd<T, Dims>;
+
+    alignas(simd_traits::alignment) std::array<T, simd_traits::storage_size> data{};
 
     // NOTE: MEMBER TYPES
 
@@ -37,29 +45,27 @@ class vector {
 
     // NOTE: TYPES
 
-    using compute_type = std::conditional_t<
-        std::is_floating_point_v<T> && (sizeof(T) * 8 >= 64),
-        float, T>;
+    using compute_type = vector_compute_t<T>;
 
     // NOTE: ITERATION
 
     constexpr auto begin() noexcept -> iterator {
-        return data.begin();
+        return data.data();
     }
     constexpr auto begin() const noexcept -> const_iterator {
-        return data.begin();
+        return data.data();
     }
     constexpr auto cbegin() const noexcept -> const_iterator {
-        return data.cbegin();
+        return data.data();
     }
     constexpr auto end() noexcept -> iterator {
-        return data.end();
+        return data.data() + Dims;
     }
     constexpr auto end() const noexcept -> const_iterator {
-        return data.end();
+        return data.data() + Dims;
     }
     constexpr auto cend() const noexcept -> const_iterator {
-        return data.cend();
+        return data.data() + Dims;
     }
     [[nodiscard]] constexpr auto size() const noexcept -> size_type {
         return Dims;
@@ -112,13 +118,21 @@ class vector {
                                  | std::views::transform([](U v) { return static_cast<T>(v); });
         std::ranges::copy(transformed_range, begin());
     }
-    constexpr vector(const vector &other) {
-        std::ranges::copy(other, begin());
+    // Copying the whole storage keeps it a single (aligned) vector move when padded
+    constexpr vector(const vector &other)
+        : data(other.data) {
     }
 
     // :: Move constructor
-    constexpr vector(vector &&other) noexcept {
-        std::ranges::move(other, begin());
+    constexpr vector(vector &&other) noexcept
+        : data(other.data) {
+    }
+
+    // :: Evaluate an expression (see vector-expression.hpp)
+    template <detail::vector_expression_type E>
+        requires(detail::operand_dims_v<E> == Dims) && std::is_convertible_v<detail::operand_value_t<E>, value_type>
+    constexpr vector(const E &expression) {
+        assign_expression(expression);
     }
 
     // NOTE: ASSIGNMENT
@@ -148,13 +162,22 @@ class vector {
     constexpr auto operator=(const vector &other) -> vector & {
         if (&other == this)
             return *this;
-        std::ranges::copy(other, begin());
+        data = other.data;
         return *this;
     }
 
     // :: Move assignment
     constexpr auto operator=(vector &&other) noexcept -> vector & {
-        std::ranges::move(other, begin());
+        data = other.data;
+        return *this;
+    }
+
+    // :: Expression assignment
+    // Element i of an expression only reads element i of its operands, so `a = b + a` is safe
+    template <detail::vector_expression_type E>
+        requires(detail::operand_dims_v<E> == Dims) && std::is_convertible_v<detail::operand_value_t<E>, value_type>
+    constexpr auto operator=(const E &expression) -> vector & {
+        assign_expression(expression);
         return *this;
     }
 
@@ -227,17 +250,29 @@ class vector {
     [[nodiscard]] constexpr auto magnitude_squared() const -> compute_type {
         return dot_product(*this, *this);
     }
-    // TODO: Make constexpr after C++26
-    [[nodiscard]] /*constexpr*/ auto magnitude() const -> compute_type {
-        return static_cast<compute_type>(std::sqrt(magnitude_squared()));
+    // precision::fast uses math::fast::sqrt (3 ULP)
+    template <precision P = precision::exact>
+    [[nodiscard]] constexpr auto magnitude() const -> compute_type {
+        if constexpr (P == precision::fast) {
+            return math::fast::sqrt(static_cast<compute_type>(magnitude_squared()));
+        } else {
+            return static_cast<compute_type>(math::sqrt(magnitude_squared()));
+        }
     }
 
-    // TODO: Make constexpr after C++26
-    inline auto normalized() const -> vector {
+    // precision::fast multiplies by math::fast::rsqrt instead of dividing by the square root
+    template <precision P = precision::exact>
+    constexpr auto normalized() const -> vector {
         vector result = *this;
-        compute_type _magnitude = magnitude();
+        const auto k = static_cast<value_type>(inverse_magnitude<P>());
+        if constexpr (simd_traits::enabled) {
+            if !consteval {
+                simd_traits::scale(result.data.data(), data.data(), k);
+                return result;
+            }
+        }
         for (auto &v : result) {
-            v *= static_cast<value_type>(1 / _magnitude);
+            v *= k;
         }
         return result;
     }
@@ -246,11 +281,18 @@ class vector {
 
     // Normalize this vector
     // @return Return magnitude of the vector before normalizing
-    // TODO: Make constexpr after C++26
-    inline auto normalizing() -> value_type {
-        compute_type _magnitude = magnitude();
-        for (auto &v : data) {
-            v *= static_cast<value_type>(1 / _magnitude);
+    template <precision P = precision::exact>
+    constexpr auto normalizing() -> value_type {
+        const compute_type _magnitude = magnitude<P>();
+        const auto k = static_cast<value_type>(inverse_magnitude<P>());
+        if constexpr (simd_traits::enabled) {
+            if !consteval {
+                simd_traits::scale(data.data(), data.data(), k);
+                return _magnitude;
+            }
+        }
+        for (auto &v : *this) {
+            v *= k;
         }
         return _magnitude;
     }
@@ -328,6 +370,12 @@ class vector {
     static constexpr auto hadamard_product(const vector &lhs,
                                            const vector &rhs) -> vector {
         vector result{};
+        if constexpr (simd_traits::enabled) {
+            if !consteval {
+                simd_traits::mul(result.data.data(), lhs.data.data(), rhs.data.data());
+                return result;
+            }
+        }
         auto range = std::views::zip(result, lhs, rhs);
         for (auto [res_element, l_element, r_element] : range) {
             res_element = l_element * r_element;
@@ -338,18 +386,30 @@ class vector {
     // Dot product
     static constexpr auto dot_product(const vector &lhs,
                                       const vector &rhs) -> compute_type {
-        compute_type result{};
+        if constexpr (simd_traits::enabled) {
+            if !consteval {
+                return static_cast<compute_type>(simd_traits::dot(lhs.data.data(), rhs.data.data()));
+            }
+        }
+        // Accumulated in T like the SIMD kernels, a double vector is rounded to float once at the end
+        value_type result{};
         auto range = std::views::zip(lhs, rhs);
         for (auto [l_element, r_element] : range) {
-            result += static_cast<compute_type>(l_element * r_element);
+            result = static_cast<value_type>(result + l_element * r_element);
         }
-        return result;
+        return static_cast<compute_type>(result);
     }
 
     // Min & Max
     static constexpr auto max(const vector &lhs,
                               const vector &rhs) -> vector {
         vector result;
+        if constexpr (simd_traits::enabled) {
+            if !consteval {
+                simd_traits::max(result.data.data(), lhs.data.data(), rhs.data.data());
+                return result;
+            }
+        }
         auto range = std::views::zip(result, lhs, rhs);
         for (auto [res_element, l_element, r_element] : range) {
             res_element = std::max(l_element, r_element);
@@ -359,6 +419,12 @@ class vector {
     static constexpr auto min(const vector &lhs,
                               const vector &rhs) -> vector {
         vector result;
+        if constexpr (simd_traits::enabled) {
+            if !consteval {
+                simd_traits::min(result.data.data(), lhs.data.data(), rhs.data.data());
+                return result;
+            }
+        }
         auto range = std::views::zip(result, lhs, rhs);
         for (auto [res_element, l_element, r_element] : range) {
             res_element = std::min(l_element, r_element);
@@ -371,11 +437,18 @@ class vector {
                                const vector &to,
                                const compute_type alpha) -> vector {
         vector result;
-        const auto one_minus_alpha = static_cast<compute_type>(1.0) - alpha;
+        if constexpr (simd_traits::enabled) {
+            if !consteval {
+                simd_traits::lerp(result.data.data(), from.data.data(), to.data.data(), static_cast<value_type>(alpha));
+                return result;
+            }
+        }
+        // In T, as the SIMD kernels: a double vector is not rounded through float
+        const auto t = static_cast<value_type>(alpha);
+        const auto one_minus_t = static_cast<value_type>(1) - t;
         auto range = std::views::zip(result, from, to);
         for (auto [res_element, from_element, to_element] : range) {
-            res_element = static_cast<value_type>(one_minus_alpha * static_cast<compute_type>(from_element)
-                                                  + alpha * static_cast<compute_type>(to_element));
+            res_element = static_cast<value_type>(from_element * one_minus_t + to_element * t);
         }
         return result;
     }
@@ -386,25 +459,33 @@ class vector {
                                            const vector &rhs) -> compute_type {
         return (rhs - lhs).magnitude_squared();
     }
-    // TODO: Make constexpr after C++26
-    static inline auto distance(const vector &lhs,
-                                const vector &rhs) -> compute_type {
+    static constexpr auto distance(const vector &lhs,
+                                   const vector &rhs) -> compute_type {
         return (rhs - lhs).magnitude();
     }
 
     // Angle
+    // precision::fast: one math::fast::rsqrt for both lengths and math::fast::acos (5 ULP)
+    template <precision P = precision::exact>
     static constexpr auto angle(const vector &from,
                                 const vector &to) -> compute_type {
-        const compute_type divisor = from.magnitude() * to.magnitude();
-        if (divisor == 0)
-            return 0;
+        if constexpr (P == precision::fast) {
+            const compute_type divisor_squared = from.magnitude_squared() * to.magnitude_squared();
+            if (divisor_squared == 0)
+                return 0;
+            return math::fast::acos(dot_product(from, to) * math::fast::rsqrt(divisor_squared));
+        } else {
+            const compute_type divisor = from.magnitude() * to.magnitude();
+            if (divisor == 0)
+                return 0;
 
-        const compute_type cos_v = dot_product(from, to) / divisor;
-        if (cos_v <= 1) {
-            return std::acos(cos_v);
-        }
+            const compute_type cos_v = dot_product(from, to) / divisor;
+            if (cos_v <= 1) {
+                return static_cast<compute_type>(math::acos(cos_v));
+            }
 
-        return 0;
+            return 0;
+        }
     }
 
     // Cross product
@@ -421,6 +502,11 @@ class vector {
 
     // :: Compare operators
     constexpr auto operator==(const vector &other) const -> bool {
+        if constexpr (simd_traits::enabled) {
+            if !consteval {
+                return simd_traits::equal(data.data(), other.data.data());
+            }
+        }
         auto zip_range = std::views::zip(*this, other);
         for (auto [this_element, other_element] : zip_range) {
             if (this_element != other_element)
@@ -433,73 +519,82 @@ class vector {
     }
 
     // :: Operators
-    // +, - with vector
-    template <typename U>
-        requires std::is_convertible_v<U, value_type>
-    constexpr auto operator+(const vector<U, Dims> &other) const -> vector {
-        vector result;
-        auto zip_range = std::views::zip(result, *this, other);
-        for (auto [result_element, this_element, other_element] : zip_range) {
-            result_element = this_element + static_cast<value_type>(other_element);
-        }
-        return result;
+    // +, -, *, / build expressions (see vector-expression.hpp), the compound forms write straight into data
+    template <detail::vector_operand E>
+        requires(detail::operand_dims_v<E> == Dims) && std::is_convertible_v<detail::operand_value_t<E>, value_type>
+    constexpr auto operator+=(const E &other) -> vector & {
+        apply_in_place<detail::add_op>(other);
+        return *this;
     }
-    template <typename U>
-        requires std::is_convertible_v<U, value_type>
-    constexpr auto operator-(const vector<U, Dims> &other) const -> vector {
-        vector result;
-        auto zip_range = std::views::zip(result, *this, other);
-        for (auto [result_element, this_element, other_element] : zip_range) {
-            result_element = this_element - static_cast<value_type>(other_element);
-        }
-        return result;
+    template <detail::vector_operand E>
+        requires(detail::operand_dims_v<E> == Dims) && std::is_convertible_v<detail::operand_value_t<E>, value_type>
+    constexpr auto operator-=(const E &other) -> vector & {
+        apply_in_place<detail::sub_op>(other);
+        return *this;
     }
 
-    template <typename U>
-        requires std::is_convertible_v<U, value_type>
-    constexpr auto operator+=(const vector<U, Dims> &other) -> vector {
-        return *this = (*this + other);
+    constexpr auto operator*=(const compute_type other) -> vector & {
+        apply_in_place<detail::scale_op>(other);
+        return *this;
     }
-    template <typename U>
-        requires std::is_convertible_v<U, value_type>
-    constexpr auto operator-=(const vector<U, Dims> &other) -> vector {
-        return *this = (*this - other);
+    constexpr auto operator/=(const compute_type other) -> vector & {
+        apply_in_place<detail::divide_op>(other);
+        return *this;
     }
 
-    // *, / with number
-    constexpr auto operator*(const compute_type other) const -> vector {
-        vector result;
-        auto zip_range = std::views::zip(result, *this);
-        for (auto [result_element, this_element] : zip_range) {
-            result_element = static_cast<value_type>(static_cast<compute_type>(this_element) * other);
+  private:
+    // Single pass over the expression: one SIMD kernel chain when every operand has the padded layout,
+    // one scalar loop otherwise (and always in constant evaluation)
+    template <typename E>
+    constexpr void assign_expression(const E &expression) {
+        if constexpr (simd_traits::enabled && E::simd_enabled && std::is_same_v<typename E::value_type, T>) {
+            if !consteval {
+                expression.store(data.data());
+                return;
+            }
         }
-        return result;
-    }
-    constexpr auto operator/(const compute_type other) const -> vector {
-        vector result;
-        auto zip_range = std::views::zip(result, *this);
-        for (auto [result_element, this_element] : zip_range) {
-            result_element = static_cast<value_type>(static_cast<compute_type>(this_element) / other);
+        for (size_t i = 0; i < Dims; ++i) {
+            data[i] = static_cast<value_type>(expression[i]);
         }
-        return result;
     }
 
-    template <typename U>
-        requires std::is_convertible_v<U, value_type>
-    constexpr auto operator*=(const compute_type other) -> vector {
-        return *this = (*this * other);
+    // data = data (op) other, element by element: a vector operand is read in place, an expression is
+    // evaluated once into a register-sized scratch on the SIMD path
+    template <typename Op, typename E>
+    constexpr void apply_in_place(const E &other) {
+        if constexpr (simd_traits::enabled && detail::simd_operand_v<T, Dims, E>) {
+            if !consteval {
+                alignas(simd_traits::alignment) std::array<T, simd_traits::storage_size> scratch;
+                Op::template simd<T, Dims>(data.data(), data.data(), detail::operand_storage<T, Dims>(other, scratch.data()));
+                return;
+            }
+        }
+        for (size_t i = 0; i < Dims; ++i) {
+            data[i] = Op::apply(data[i], detail::operand_element<T>(other, i));
+        }
     }
-    template <typename U>
-        requires std::is_convertible_v<U, value_type>
-    constexpr auto operator/=(const compute_type other) -> vector {
-        return *this = (*this / other);
+    template <typename Op>
+    constexpr void apply_in_place(const compute_type k) {
+        if constexpr (simd_traits::enabled) {
+            if !consteval {
+                Op::template simd<T, Dims>(data.data(), data.data(), static_cast<T>(k));
+                return;
+            }
+        }
+        for (size_t i = 0; i < Dims; ++i) {
+            data[i] = Op::apply(data[i], k);
+        }
     }
-};
 
-// Define the rest of operator
-template <typename T, size_t Dims>
-constexpr auto operator*(const typename vector<T, Dims>::compute_type num, const vector<T, Dims> &vec) -> vector<T, Dims> {
-    return vec * num;
-}
+    // 1 / magnitude(), without the division for precision::fast
+    template <precision P>
+    constexpr auto inverse_magnitude() const -> compute_type {
+        if constexpr (P == precision::fast) {
+            return math::fast::rsqrt(static_cast<compute_type>(magnitude_squared()));
+        } else {
+            return 1 / magnitude();
+        }
+    }
+};
 
 } // namespace mia
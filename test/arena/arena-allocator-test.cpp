@@ -0,0 +1,88 @@
+#include "arena/arena-allocator.hpp"
+#include "math/vector.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+// NOTE: ARRAYS
+TEST(arena_allocator_test, alloc_array) {
+    mia::arena a;
+
+    int *zeros = a.alloc_array<int>(100);
+    for (size_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(zeros[i], 0);
+    }
+
+    int *sevens = a.alloc_array<int>(10, 7);
+    for (size_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(sevens[i], 7);
+    }
+
+    auto *vectors = a.alloc_array_for_overwrite<mia::vector<float, 3>>(16);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(vectors) % alignof(mia::vector<float, 3>), 0u);
+    for (size_t i = 0; i < 16; ++i) {
+        // Class types are still default constructed
+        EXPECT_EQ(vectors[i], (mia::vector<float, 3>{}));
+    }
+
+    double *raw = a.alloc_array_uninitialized<double>(1000);
+    raw[999] = 1.0;
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(raw) % alignof(double), 0u);
+
+    EXPECT_EQ(a.used(), 110 * sizeof(int) + 16 * sizeof(mia::vector<float, 3>) + 1000 * sizeof(double));
+}
+
+// NOTE: PMR
+TEST(arena_allocator_test, pmr_containers) {
+    mia::arena a(1 << 16);
+    mia::arena_resource resource(a);
+
+    std::pmr::vector<mia::vector<float, 3>> points(&resource);
+    points.reserve(512);
+    const size_t blocks = a.block_count();
+    const size_t used = a.used();
+    for (int i = 0; i < 512; ++i) {
+        points.push_back(mia::vector<float, 3>{static_cast<float>(i), 0.0f, 1.0f});
+    }
+    // No per-element traffic once reserved
+    EXPECT_EQ(a.used(), used);
+    EXPECT_EQ(a.block_count(), blocks);
+    EXPECT_EQ(points[511].x(), 511.0f);
+
+    std::pmr::string s("a string long enough to skip the small buffer optimization", &resource);
+    EXPECT_GT(a.used(), used);
+    EXPECT_TRUE(resource.is_equal(mia::arena_resource(a)));
+
+    mia::arena other;
+    EXPECT_FALSE(resource.is_equal(mia::arena_resource(other)));
+    EXPECT_FALSE(resource.is_equal(*std::pmr::new_delete_resource()));
+}
+
+// NOTE: STL ALLOCATOR
+TEST(arena_allocator_test, stl_allocator) {
+    mia::arena a;
+
+    std::vector<int, mia::arena_allocator<int>> v{mia::arena_allocator<int>(a)};
+    for (int i = 0; i < 1000; ++i) {
+        v.push_back(i);
+    }
+    EXPECT_EQ(v[999], 999);
+    EXPECT_GE(a.used(), 1000 * sizeof(int));
+
+    // Rebinding for node based containers
+    using map_allocator = mia::arena_allocator<std::pair<const int, double>>;
+    std::map<int, double, std::less<>, map_allocator> m{map_allocator(a)};
+    m[1] = 2.0;
+    m[3] = 4.0;
+    EXPECT_EQ(m.at(3), 4.0);
+
+    EXPECT_TRUE(mia::arena_allocator<int>(a) == mia::arena_allocator<double>(a));
+    mia::arena other;
+    EXPECT_FALSE(mia::arena_allocator<int>(a) == mia::arena_allocator<int>(other));
+}
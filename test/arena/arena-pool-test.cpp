@@ -0,0 +1,102 @@
+#include "arena/arena-pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// NOTE: THREAD-LOCAL ARENA
+TEST(arena_pool_test, thread_arena_is_per_thread) {
+    mia::arena *main_arena = &mia::thread_arena();
+    EXPECT_EQ(main_arena, &mia::thread_arena());
+
+    mia::arena *other_arena = nullptr;
+    std::thread worker([&] {
+        other_arena = &mia::thread_arena();
+        mia::arena_scope scope(*other_arena);
+        other_arena->alloc_array<int>(64);
+    });
+    worker.join();
+    EXPECT_NE(main_arena, other_arena);
+}
+
+TEST(arena_pool_test, high_water_survives_reset) {
+    mia::arena a;
+    {
+        mia::arena_scope scope(a);
+        a.alloc_array<uint64_t>(100);
+    }
+    a.alloc<uint64_t>(1);
+    EXPECT_EQ(a.used(), sizeof(uint64_t));
+    EXPECT_EQ(a.high_water(), 100 * sizeof(uint64_t));
+    a.reset();
+    EXPECT_EQ(a.high_water(), 100 * sizeof(uint64_t));
+}
+
+// NOTE: LEASING
+TEST(arena_pool_test, lease_and_return) {
+    mia::arena_pool pool(2, 1024);
+    EXPECT_EQ(pool.shard_count(), 2u);
+
+    mia::arena *first = nullptr;
+    {
+        auto lease = pool.lease();
+        ASSERT_TRUE(lease);
+        first = &lease.get_arena();
+        lease->alloc_array<char>(700);
+    }
+    EXPECT_EQ(pool.stats().created, 1u);
+    EXPECT_EQ(pool.stats().high_water, 700u);
+
+    // Returned arenas are reset and handed out again
+    auto lease = pool.lease();
+    EXPECT_EQ(lease->used(), 0u);
+    auto second = pool.lease();
+    EXPECT_NE(&*lease, &*second);
+    EXPECT_TRUE(&*lease == first || &*second == first);
+
+    second.release();
+    EXPECT_FALSE(second);
+    const auto stats = pool.stats();
+    EXPECT_EQ(stats.leases, 3u);
+    EXPECT_EQ(stats.arenas, 2u);
+    EXPECT_GE(stats.capacity, 1024u);
+
+    // Moving transfers the return
+    mia::arena_lease moved = std::move(lease);
+    EXPECT_FALSE(lease);
+    EXPECT_TRUE(moved);
+}
+
+TEST(arena_pool_test, concurrent_leases) {
+    mia::arena_pool pool(4);
+    std::atomic<size_t> failures = 0;
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < 8; ++t) {
+        workers.emplace_back([&pool, &failures, t] {
+            for (size_t i = 0; i < 200; ++i) {
+                auto lease = pool.lease();
+                auto *values = lease->alloc_array<size_t>(32, t * 1000 + i);
+                for (size_t j = 0; j < 32; ++j) {
+                    if (values[j] != t * 1000 + i) {
+                        ++failures;
+                    }
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0u);
+    const auto stats = pool.stats();
+    EXPECT_EQ(stats.leases, 8u * 200u);
+    // Arenas are recycled, at most one per concurrently running lease
+    EXPECT_LE(stats.arenas, 8u);
+    EXPECT_EQ(stats.high_water, 32 * sizeof(size_t));
+}
@@ -0,0 +1,121 @@
+#include "arena/arena.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct counted {
+    explicit counted(std::vector<int> &destroyed, int index)
+        : log(&destroyed), id(index) {
+    }
+    ~counted() { log->push_back(id); }
+
+    std::vector<int> *log;
+    int id;
+};
+
+}  // namespace
+
+// NOTE: MARKERS
+TEST(arena_scope_test, rollback_restores_position) {
+    mia::arena a(256);
+    a.alloc<int>(1);
+    const size_t used = a.used();
+    const size_t remaining = a.remaining();
+
+    const auto m = a.save();
+    for (int i = 0; i < 16; ++i) {
+        a.alloc<int>(i);
+    }
+    EXPECT_GT(a.used(), used);
+
+    a.rollback(m);
+    EXPECT_EQ(a.used(), used);
+    EXPECT_EQ(a.remaining(), remaining);
+
+    // Same memory is handed out again
+    int *first = a.alloc<int>(2);
+    a.rollback(m);
+    EXPECT_EQ(a.alloc<int>(3), first);
+}
+
+TEST(arena_scope_test, rollback_drops_blocks_and_reuses_spare) {
+    mia::arena a(64);
+    const auto m = a.save();
+    for (int i = 0; i < 1000; ++i) {
+        a.alloc<uint64_t>(i);
+    }
+    ASSERT_GT(a.block_count(), 1u);
+
+    a.rollback(m);
+    EXPECT_EQ(a.block_count(), 1u);
+    EXPECT_EQ(a.used(), 0u);
+    const size_t capacity = a.capacity();
+
+    // The largest dropped block comes back before any new malloc
+    for (int i = 0; i < 8; ++i) {
+        a.alloc<uint64_t>(i);
+    }
+    a.alloc_bytes(512, 8);
+    EXPECT_EQ(a.block_count(), 2u);
+    EXPECT_EQ(a.capacity(), capacity);
+}
+
+// NOTE: SCOPES
+TEST(arena_scope_test, nested_scopes) {
+    mia::arena a;
+    int *outer_value = a.alloc<int>(1);
+    {
+        mia::arena_scope outer(a);
+        a.alloc<int>(2);
+        const size_t used = a.used();
+        {
+            mia::arena_scope inner(outer.get_arena());
+            a.alloc_array<double>(100);
+            EXPECT_GT(a.used(), used);
+        }
+        EXPECT_EQ(a.used(), used);
+    }
+    EXPECT_EQ(a.used(), sizeof(int));
+    EXPECT_EQ(*outer_value, 1);
+}
+
+// NOTE: FINALIZERS
+TEST(arena_scope_test, tracked_destructors_run_in_reverse) {
+    std::vector<int> log;
+    mia::arena a;
+    {
+        mia::arena_scope scope(a);
+        a.alloc_tracked<counted>(log, 1);
+        a.alloc_tracked<counted>(log, 2);
+        // Trivial types register nothing
+        const size_t used = a.used();
+        a.alloc_tracked<int>(3);
+        EXPECT_EQ(a.used(), used + sizeof(int));
+        EXPECT_TRUE(log.empty());
+    }
+    EXPECT_EQ(log, (std::vector<int>{2, 1}));
+
+    log.clear();
+    auto *strings = a.alloc_array_tracked<std::string>(4);
+    strings[3] = "a string long enough to skip the small buffer optimization";
+    a.alloc_tracked<counted>(log, 4);
+    a.reset();
+    EXPECT_EQ(log, (std::vector<int>{4}));
+
+    log.clear();
+    {
+        mia::arena b;
+        b.alloc_tracked<counted>(log, 5);
+        const auto m = b.save();
+        b.alloc_tracked<counted>(log, 6);
+        b.rollback(m);
+        EXPECT_EQ(log, (std::vector<int>{6}));
+    }
+    EXPECT_EQ(log, (std::vector<int>{6, 5}));
+}
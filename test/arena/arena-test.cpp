@@ -0,0 +1,124 @@
+#include "arena/arena.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+// NOTE: ALLOCATION
+TEST(arena_test, alloc_and_add) {
+    mia::arena a;
+
+    int *i = a.alloc<int>(42);
+    EXPECT_EQ(*i, 42);
+
+    double *d = a.alloc<double>(1.5);
+    EXPECT_EQ(*d, 1.5);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(d) % alignof(double), 0u);
+
+    std::string *s = a.add(std::string("arena"));
+    EXPECT_EQ(*s, "arena");
+    std::destroy_at(s);
+
+    EXPECT_EQ(a.used(), sizeof(int) + sizeof(double) + sizeof(std::string));
+    EXPECT_EQ(a.block_count(), 1u);
+}
+
+TEST(arena_test, over_aligned) {
+    struct alignas(64) line {
+        char bytes[64];
+    };
+
+    mia::arena a(256);
+    a.alloc<char>('x');
+    line *l = a.alloc<line>();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(l) % 64, 0u);
+    EXPECT_GT(a.wasted(), 0u);
+}
+
+// NOTE: GROWTH
+TEST(arena_test, grows_without_moving) {
+    mia::arena a(64);
+    std::vector<std::pair<uint64_t *, uint64_t>> allocations;
+
+    // Far past the initial capacity
+    for (uint64_t i = 0; i < 4096; ++i) {
+        allocations.emplace_back(a.alloc<uint64_t>(i * 7), i * 7);
+    }
+
+    EXPECT_GT(a.block_count(), 1u);
+    EXPECT_GE(a.capacity(), 4096 * sizeof(uint64_t));
+    EXPECT_EQ(a.used(), 4096 * sizeof(uint64_t));
+    EXPECT_LE(a.used() + a.wasted(), a.capacity());
+
+    // Earlier allocations are untouched
+    for (auto [ptr, expected] : allocations) {
+        EXPECT_EQ(*ptr, expected);
+    }
+
+    // A single allocation larger than any block
+    char *big = static_cast<char *>(a.alloc_bytes(1 << 20, 16));
+    big[(1 << 20) - 1] = 'x';
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(big) % 16, 0u);
+}
+
+// Sizes that would wrap around throw instead of returning a short block
+TEST(arena_test, oversized_requests_throw) {
+    mia::arena a(64);
+    EXPECT_THROW(a.alloc_array_uninitialized<uint64_t>(SIZE_MAX / 4), std::bad_array_new_length);
+    EXPECT_THROW(a.alloc_array<uint32_t>(SIZE_MAX / 2), std::bad_array_new_length);
+    EXPECT_THROW(a.alloc_bytes(SIZE_MAX - 4, 16), std::bad_alloc);
+    // Growing to this wraps the capacity past SIZE_MAX / 2
+    EXPECT_THROW(a.alloc_bytes(SIZE_MAX - 8, 1), std::bad_alloc);
+
+    // The arena is unchanged and still usable
+    EXPECT_EQ(a.used(), 0u);
+    EXPECT_EQ(*a.alloc<int>(3), 3);
+}
+
+// NOTE: RESET
+TEST(arena_test, reset_keeps_largest_block) {
+    mia::arena a(128);
+    for (int i = 0; i < 1000; ++i) {
+        a.alloc<int>(i);
+    }
+    ASSERT_GT(a.block_count(), 1u);
+
+    a.reset();
+    EXPECT_EQ(a.block_count(), 1u);
+    EXPECT_EQ(a.used(), 0u);
+    EXPECT_EQ(a.wasted(), 0u);
+    const size_t kept = a.capacity();
+    EXPECT_GE(kept, 1000 * sizeof(int) / 2);
+
+    // The next frame of the same size fits without a new block
+    for (int i = 0; i < 1000 && a.remaining() >= sizeof(int); ++i) {
+        a.alloc<int>(i);
+    }
+    EXPECT_EQ(a.block_count(), 1u);
+    EXPECT_EQ(a.capacity(), kept);
+}
+
+// NOTE: MOVE
+TEST(arena_test, move) {
+    mia::arena a(128);
+    int *i = a.alloc<int>(7);
+
+    mia::arena b(std::move(a));
+    EXPECT_EQ(*i, 7);
+    EXPECT_EQ(b.used(), sizeof(int));
+    EXPECT_EQ(a.capacity(), 0u);
+
+    // A moved-from arena is still usable
+    int *j = a.alloc<int>(8);
+    EXPECT_EQ(*j, 8);
+
+    mia::arena c;
+    c = std::move(b);
+    EXPECT_EQ(*i, 7);
+    EXPECT_EQ(c.used(), sizeof(int));
+}
@@ -0,0 +1,203 @@
+#include "arena/pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// NOTE: ALLOCATION
+TEST(pool_test, create_and_destroy) {
+    mia::pool<std::string> p;
+
+    std::string *s = p.create("a string long enough to skip the small buffer optimization");
+    EXPECT_EQ(s->size(), 58u);
+    p.destroy(s);
+
+    // The freed slot is the next one handed out
+    std::string *t = p.create("again");
+    EXPECT_EQ(s, t);
+    p.destroy(t);
+    EXPECT_EQ(p.slab_count(), 1u);
+}
+
+TEST(pool_test, distinct_and_aligned) {
+    struct alignas(64) particle {
+        float position[3];
+        float velocity[3];
+    };
+
+    mia::pool<particle> p(100);
+    EXPECT_EQ(p.slot_size(), 64u);
+
+    std::set<particle *> seen;
+    std::vector<particle *> particles;
+    for (int i = 0; i < 1000; ++i) {
+        particle *q = p.create();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(q) % 64, 0u);
+        q->position[0] = static_cast<float>(i);
+        EXPECT_TRUE(seen.insert(q).second);
+        particles.push_back(q);
+    }
+    EXPECT_EQ(p.slab_count(), 10u);
+    EXPECT_EQ(p.capacity(), 1000u);
+
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(particles[static_cast<size_t>(i)]->position[0], static_cast<float>(i));
+        p.destroy(particles[static_cast<size_t>(i)]);
+    }
+
+    // Everything is recycled, no new slab
+    for (int i = 0; i < 1000; ++i) {
+        particles[static_cast<size_t>(i)] = p.create();
+    }
+    EXPECT_EQ(p.slab_count(), 10u);
+    for (particle *q : particles) {
+        p.destroy(q);
+    }
+}
+
+TEST(pool_test, throwing_constructor_returns_slot) {
+    struct throws {
+        throws() { throw 1; }
+    };
+    mia::pool<throws> p;
+    EXPECT_THROW((void)p.create(), int);
+    EXPECT_THROW((void)p.create(), int);
+    EXPECT_EQ(p.slab_count(), 1u);
+}
+
+// NOTE: THREADS
+// NOTE: THREAD CACHES
+TEST(pool_test, many_pools_keep_their_thread_caches) {
+    // More pools than the initial cache table holds, used in turn: no pool hands another's cache back
+    constexpr size_t pool_count = 4 * POOL_THREAD_CACHES + 1;
+    std::vector<std::unique_ptr<mia::pool<uint64_t>>> pools;
+    for (size_t i = 0; i < pool_count; ++i) {
+        pools.push_back(std::make_unique<mia::pool<uint64_t>>());
+    }
+    for (size_t round = 0; round < 3; ++round) {
+        for (auto &p : pools) {
+            p->destroy(p->create(round));
+        }
+    }
+
+    // Every first batch is still in this thread's cache, so another thread carves a batch of its own
+    std::thread other([&] {
+        for (auto &p : pools) {
+            p->destroy(p->create(uint64_t{0}));
+        }
+    });
+    other.join();
+    for (auto &p : pools) {
+        EXPECT_EQ(p->capacity(), 2 * POOL_CACHE_BATCH);
+    }
+
+    // Pools destroyed while the thread still has their caches, their entries make room for new ones
+    for (size_t i = 0; i < 4 * pool_count; ++i) {
+        mia::pool<uint64_t> p;
+        uint64_t *v = p.create(i);
+        EXPECT_EQ(*v, i);
+        p.destroy(v);
+    }
+    for (auto &p : pools) {
+        p->destroy(p->create(uint64_t{1}));
+        EXPECT_EQ(p->capacity(), 2 * POOL_CACHE_BATCH);
+    }
+}
+
+TEST(pool_test, cross_thread_frees) {
+    mia::pool<uint64_t> p(256);
+    constexpr size_t per_thread = 20000;
+
+    // Producers allocate, the consumer frees everything
+    std::mutex mutex;
+    std::vector<uint64_t *> handoff;
+    std::atomic<size_t> produced = 0;
+    std::atomic<size_t> corrupted = 0;
+
+    std::vector<std::thread> producers;
+    for (uint64_t t = 0; t < 4; ++t) {
+        producers.emplace_back([&, t] {
+            for (uint64_t i = 0; i < per_thread; ++i) {
+                uint64_t *v = p.create(t << 32 | i);
+                std::lock_guard lock(mutex);
+                handoff.push_back(v);
+            }
+            produced += per_thread;
+        });
+    }
+
+    std::thread consumer([&] {
+        size_t freed = 0;
+        while (freed < 4 * per_thread) {
+            std::vector<uint64_t *> batch;
+            {
+                std::lock_guard lock(mutex);
+                batch.swap(handoff);
+            }
+            for (uint64_t *v : batch) {
+                if ((*v & 0xffffffff) >= per_thread || (*v >> 32) >= 4) {
+                    ++corrupted;
+                }
+                p.destroy(v);
+            }
+            freed += batch.size();
+        }
+    });
+
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    consumer.join();
+
+    EXPECT_EQ(produced.load(), 4 * per_thread);
+    EXPECT_EQ(corrupted.load(), 0u);
+    // Freed slots flow back through the shared list: taking every one of them again carves nothing new
+    const size_t capacity = p.capacity();
+    std::vector<uint64_t *> again;
+    for (uint64_t i = 0; i < capacity; ++i) {
+        again.push_back(p.create(i));
+    }
+    EXPECT_EQ(p.capacity(), capacity);
+    for (uint64_t *v : again) {
+        p.destroy(v);
+    }
+}
+
+TEST(pool_test, concurrent_churn) {
+    mia::pool<std::pair<size_t, size_t>> p;
+    std::atomic<size_t> corrupted = 0;
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < 8; ++t) {
+        workers.emplace_back([&, t] {
+            std::vector<std::pair<size_t, size_t> *> live;
+            for (size_t i = 0; i < 5000; ++i) {
+                live.push_back(p.create(t, i));
+                if (i % 3 == 2) {
+                    for (auto *q : live) {
+                        if (q->first != t) {
+                            ++corrupted;
+                        }
+                        p.destroy(q);
+                    }
+                    live.clear();
+                }
+            }
+            for (auto *q : live) {
+                p.destroy(q);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(corrupted.load(), 0u);
+}
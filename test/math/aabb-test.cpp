@@ -0,0 +1,232 @@
+#include "math/aabb.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+// NOTE: FIXTURE AND TYPED SETUP
+template <typename T, size_t Ds>
+struct box_type {
+    using type = T;
+    static constexpr size_t dims = Ds;
+};
+using aabb_test_types = ::testing::Types<box_type<float, 2>, box_type<float, 3>, box_type<double, 3>, box_type<int, 3>>;
+
+template <typename Param>
+class typed_aabb_test : public ::testing::Test {
+  public:
+    using type = typename Param::type;
+    static constexpr size_t dims = Param::dims;
+    using box = mia::aabb<type, dims>;
+    using vector_type = mia::vector<type, dims>;
+
+  protected:
+    void SetUp() override {
+        for (size_t d = 0; d < dims; ++d) {
+            a.min[d] = 0;
+            a.max[d] = static_cast<type>(4 + d);
+            b.min[d] = 2;
+            b.max[d] = 8;
+        }
+    }
+
+    box a;
+    box b;
+};
+
+TYPED_TEST_SUITE(typed_aabb_test, aabb_test_types);
+
+// NOTE: CONSTRUCTION
+TYPED_TEST(typed_aabb_test, empty_and_from_points) {
+    using T = typename TestFixture::type;
+    using B = typename TestFixture::box;
+    using V = typename TestFixture::vector_type;
+    constexpr size_t Ds = TestFixture::dims;
+
+    EXPECT_TRUE(B{}.is_empty());
+    EXPECT_FALSE(this->a.is_empty());
+    EXPECT_EQ(B::merge(B{}, this->a), this->a);
+    EXPECT_EQ(B{}.volume(), T{0});
+    EXPECT_FALSE(B{}.contains(V{}));
+
+    std::vector<V> points(5);
+    for (size_t i = 0; i < points.size(); ++i) {
+        for (size_t d = 0; d < Ds; ++d) {
+            points[i][d] = static_cast<T>(static_cast<int>(i * (d + 2)) % 7 - 3);
+        }
+    }
+    const B bounds = B::from_points(points);
+    for (const V &p : points) {
+        EXPECT_TRUE(bounds.contains(p));
+    }
+    EXPECT_TRUE(B::from_points({}).is_empty());
+}
+
+// NOTE: SET OPERATIONS
+TYPED_TEST(typed_aabb_test, merge_expand_overlap) {
+    using T = typename TestFixture::type;
+    using B = typename TestFixture::box;
+    using V = typename TestFixture::vector_type;
+    constexpr size_t Ds = TestFixture::dims;
+
+    const B merged = B::merge(this->a, this->b);
+    EXPECT_TRUE(merged.contains(this->a));
+    EXPECT_TRUE(merged.contains(this->b));
+    EXPECT_FALSE(this->a.contains(this->b));
+    EXPECT_TRUE(this->a.overlaps(this->b));
+
+    const B common = B::intersection(this->a, this->b);
+    EXPECT_FALSE(common.is_empty());
+    EXPECT_TRUE(this->a.contains(common) && this->b.contains(common));
+
+    // Boxes sharing a face overlap, one step apart they do not
+    B touching = this->a;
+    touching.min[0] = this->a.max[0];
+    touching.max[0] = this->a.max[0] + 1;
+    EXPECT_TRUE(this->a.overlaps(touching));
+    touching.min[0] += 1;
+    EXPECT_FALSE(this->a.overlaps(touching));
+    EXPECT_TRUE(B::intersection(this->a, touching).is_empty());
+
+    B grown = this->a;
+    V outside = this->a.max;
+    outside[Ds - 1] = static_cast<T>(outside[Ds - 1] + 3);
+    grown.expand(outside);
+    EXPECT_TRUE(grown.contains(outside));
+    EXPECT_EQ(grown.max[Ds - 1], outside[Ds - 1]);
+    grown.expand(this->b);
+    EXPECT_EQ(grown, B::merge(B::merge(this->a, B::from_points({&outside, 1})), this->b));
+
+    B inflated = this->a;
+    inflated.inflate(T{1});
+    EXPECT_EQ(inflated.min[0], T{-1});
+    EXPECT_TRUE(inflated.contains(this->a));
+}
+
+// NOTE: MEASURES
+TYPED_TEST(typed_aabb_test, measures) {
+    using T = typename TestFixture::type;
+    constexpr size_t Ds = TestFixture::dims;
+
+    // a spans [0, 4 + d] on axis d
+    T volume{1};
+    for (size_t d = 0; d < Ds; ++d) {
+        volume *= static_cast<T>(4 + d);
+        EXPECT_EQ(this->a.extent()[d], static_cast<T>(4 + d));
+        EXPECT_EQ(this->a.center()[d], static_cast<T>(static_cast<T>(4 + d) / 2));
+    }
+    EXPECT_EQ(this->a.volume(), volume);
+    EXPECT_EQ(this->a.major_axis(), Ds - 1);
+    if constexpr (Ds == 2) {
+        EXPECT_EQ(this->a.surface_area(), T{2 * (4 + 5)});
+    } else {
+        EXPECT_EQ(this->a.surface_area(), T{2 * (4 * 5 + 5 * 6 + 6 * 4)});
+    }
+
+    EXPECT_EQ(this->a.distance_squared(this->a.center()), 0);
+    auto point = this->a.max;
+    point[0] = static_cast<T>(point[0] + 3);
+    EXPECT_EQ(this->a.distance_squared(point), 9);
+}
+
+// NOTE: RAY INTERSECTION
+TEST(aabb_test, ray_intersection) {
+    using B = mia::aabb3<float>;
+    using R = mia::ray<float, 3>;
+    using V = mia::vector<float, 3>;
+    const B box{V{1.0f, 1.0f, 1.0f}, V{2.0f, 3.0f, 4.0f}};
+
+    // Straight on, from inside, behind, past t_max, and grazing an edge
+    EXPECT_EQ(box.intersect(R{V{0.0f, 2.0f, 2.0f}, V{1.0f, 0.0f, 0.0f}}), 1.0f);
+    EXPECT_EQ(box.intersect(R{V{1.5f, 2.0f, 2.0f}, V{0.0f, 0.0f, -1.0f}}), 0.0f);
+    EXPECT_FALSE(box.intersect(R{V{3.0f, 2.0f, 2.0f}, V{1.0f, 0.0f, 0.0f}}).has_value());
+    EXPECT_FALSE(box.intersect(R{V{0.0f, 2.0f, 2.0f}, V{1.0f, 0.0f, 0.0f}}, 0.0f, 0.5f).has_value());
+    EXPECT_TRUE(box.intersect(R{V{0.0f, 0.0f, 2.0f}, V{1.0f, 1.0f, 0.0f}}).has_value());
+    EXPECT_FALSE(box.intersect(R{V{0.0f, 0.0f, 2.0f}, V{1.0f, 0.4f, 0.0f}}).has_value());
+
+    // Diagonal entry through the y face
+    const R diagonal{V{1.5f, 0.0f, 2.0f}, V{0.0f, 2.0f, 1.0f}};
+    ASSERT_TRUE(box.intersect(diagonal).has_value());
+    EXPECT_FLOAT_EQ(*box.intersect(diagonal), 0.5f);
+    EXPECT_TRUE(box.contains(diagonal.at(*box.intersect(diagonal))));
+
+    // Ray in the plane of a face (0 * infinity) counts as inside that slab
+    EXPECT_TRUE(box.intersect(R{V{1.0f, 0.0f, 2.0f}, V{0.0f, 1.0f, 0.0f}}).has_value());
+    EXPECT_FALSE(B{}.intersect(R{V{}, V{1.0f, 0.0f, 0.0f}}).has_value());
+}
+
+// NOTE: PACKETS
+// Random boxes & rays, every packet lane agrees with the scalar test
+template <typename T, size_t Width>
+static void expect_packet_matches_scalar() {
+    using B = mia::aabb3<T>;
+    using V = mia::vector<T, 3>;
+    using R = mia::ray<T, 3>;
+    using P = mia::aabb_packet<T, 3, Width>;
+
+    std::mt19937 random{7};
+    std::uniform_real_distribution<T> coordinate{-10, 10};
+    const auto random_vector = [&] { return V{coordinate(random), coordinate(random), coordinate(random)}; };
+
+    size_t hits = 0;
+    for (size_t round = 0; round < 200; ++round) {
+        P packet;
+        std::vector<B> boxes;
+        // Leave the last lane empty every other round
+        const size_t used = round % 2 == 0 ? Width : Width - 1;
+        for (size_t i = 0; i < used; ++i) {
+            boxes.push_back(B::from_points({}).expand(random_vector()).expand(random_vector()));
+            packet.set(i, boxes.back());
+            EXPECT_EQ(packet.get(i), boxes.back());
+        }
+
+        V direction = random_vector();
+        direction[round % 3] = round % 5 == 0 ? T{0} : direction[round % 3];
+        const R r{random_vector(), direction};
+        std::array<T, Width> t_enter{};
+        const uint32_t mask = packet.intersect(r, T{0}, T{15}, t_enter.data());
+        for (size_t i = 0; i < Width; ++i) {
+            const auto expected = i < used ? boxes[i].intersect(r, T{0}, T{15}) : std::nullopt;
+            ASSERT_EQ(((mask >> i) & 1) != 0, expected.has_value()) << round << " lane " << i;
+            if (expected) {
+                EXPECT_EQ(t_enter[i], *expected);
+                ++hits;
+            }
+        }
+        EXPECT_EQ(mask, packet.intersect(r, T{0}, T{15}));
+    }
+    // Both outcomes are covered
+    EXPECT_GT(hits, 0u);
+    EXPECT_LT(hits, 200 * Width);
+}
+
+TEST(aabb_test, packets_match_scalar) {
+    expect_packet_matches_scalar<float, 4>();
+    expect_packet_matches_scalar<float, 8>();
+    expect_packet_matches_scalar<double, 4>();
+    expect_packet_matches_scalar<float, 3>();
+    EXPECT_EQ(alignof(mia::aabb8x<float>), 32u);
+}
+
+// NOTE: CONSTANT EVALUATION
+TEST(aabb_test, constexpr_usable) {
+    using B = mia::aabb3<float>;
+    using V = mia::vector<float, 3>;
+    constexpr B box = B::merge(B{V{0.0f, 0.0f, 0.0f}, V{1.0f, 1.0f, 1.0f}}, B{V{2.0f, 2.0f, 2.0f}, V{3.0f, 3.0f, 3.0f}});
+    static_assert(box.surface_area() == 54.0f && box.contains(V{1.5f, 1.5f, 1.5f}));
+    static_assert(box.intersect(mia::ray<float, 3>{V{-1.0f, 1.0f, 1.0f}, V{1.0f, 0.0f, 0.0f}}) == 1.0f);
+
+    constexpr auto packet = [] {
+        mia::aabb4x<float> p;
+        p.set(1, B{V{0.0f, 0.0f, 0.0f}, V{1.0f, 1.0f, 1.0f}});
+        p.set(2, B{V{5.0f, 5.0f, 5.0f}, V{6.0f, 6.0f, 6.0f}});
+        return p;
+    }();
+    static_assert(packet.intersect(mia::ray<float, 3>{V{-1.0f, 0.5f, 0.5f}, V{1.0f, 0.0f, 0.0f}}) == 0b0010u);
+    EXPECT_EQ(packet.intersect(mia::ray<float, 3>{V{-1.0f, 0.5f, 0.5f}, V{1.0f, 0.0f, 0.0f}}), 0b0010u);
+}
@@ -0,0 +1,239 @@
+#include "math/batch-reduce.hpp"
+#include "math/batch-parallel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <span>
+#include <vector>
+
+// NOTE: FIXTURE AND TYPED SETUP
+template <typename T, size_t Ds>
+struct reduce_type {
+    using type = T;
+    static constexpr size_t dims = Ds;
+};
+using reduce_test_types = ::testing::Types<reduce_type<float, 3>, reduce_type<float, 4>, reduce_type<float, 2>, reduce_type<double, 3>, reduce_type<int, 3>>;
+
+template <typename Param>
+class typed_reduce_test : public ::testing::Test {
+  public:
+    using type = typename Param::type;
+    static constexpr size_t dims = Param::dims;
+    using vector_type = mia::vector<type, dims>;
+
+  protected:
+    // Small integers: every sum is exact, whatever the order
+    static auto integer_vectors(const size_t count) -> std::vector<vector_type> {
+        std::vector<vector_type> vectors(count);
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t d = 0; d < dims; ++d) {
+                vectors[i][d] = static_cast<type>(static_cast<int>((i * 7 + d * 3) % 23) - 11);
+            }
+        }
+        return vectors;
+    }
+};
+
+TYPED_TEST_SUITE(typed_reduce_test, reduce_test_types);
+
+// NOTE: REDUCTIONS MATCH LOOPS
+// Counts around the kernel blocks, so every tail path runs
+TYPED_TEST(typed_reduce_test, sum_and_bounds_match_loops) {
+    using T = typename TestFixture::type;
+    constexpr size_t Ds = TestFixture::dims;
+    using V = typename TestFixture::vector_type;
+
+    for (const size_t count : {size_t{1}, size_t{7}, size_t{31}, size_t{53}, size_t{1000}, size_t{5003}}) {
+        SCOPED_TRACE(count);
+        const auto vectors = TestFixture::integer_vectors(count);
+        V sum{};
+        mia::aabb<T, Ds> box;
+        for (const V &v : vectors) {
+            sum += v;
+            box.expand(v);
+        }
+        EXPECT_EQ((mia::batch::sum<T, Ds>(vectors)), sum);
+        EXPECT_EQ((mia::batch::bounds<T, Ds>(vectors)), box);
+        EXPECT_EQ((mia::batch::min<T, Ds>(vectors)), box.min);
+        EXPECT_EQ((mia::batch::max<T, Ds>(vectors)), box.max);
+        if constexpr (std::is_floating_point_v<T>) {
+            EXPECT_EQ((mia::batch::pairwise_sum<T, Ds>(vectors)), sum);
+            EXPECT_EQ((mia::batch::kahan_sum<T, Ds>(vectors)), sum);
+            V mean = sum;
+            for (size_t d = 0; d < Ds; ++d) {
+                mean[d] /= static_cast<T>(count);
+            }
+            EXPECT_EQ((mia::batch::mean<T, Ds>(vectors)), mean);
+        }
+    }
+    EXPECT_EQ((mia::batch::sum<T, Ds>({})), V{});
+    EXPECT_TRUE((mia::batch::bounds<T, Ds>({})).is_empty());
+}
+
+TYPED_TEST(typed_reduce_test, covariance_of_a_line) {
+    using T = typename TestFixture::type;
+    constexpr size_t Ds = TestFixture::dims;
+    using V = typename TestFixture::vector_type;
+    if constexpr (std::is_floating_point_v<T>) {
+        // x uniform over 0..9, y = 2x - 3, the other components constant
+        std::vector<V> points(2000);
+        for (size_t i = 0; i < points.size(); ++i) {
+            const T x = static_cast<T>(i % 10);
+            points[i][0] = x + T{100};
+            points[i][1] = 2 * x - 3;
+            for (size_t d = 2; d < Ds; ++d) {
+                points[i][d] = T{7};
+            }
+        }
+        const auto covariance = mia::batch::covariance<T, Ds>(points);
+        const double variance = 8.25; // (10^2 - 1) / 12
+        for (size_t r = 0; r < Ds; ++r) {
+            for (size_t c = 0; c < Ds; ++c) {
+                const double expected = r < 2 && c < 2 ? variance * (r == 0 ? 1 : 2) * (c == 0 ? 1 : 2) : 0.0;
+                EXPECT_NEAR(covariance(r, c), expected, 1e-4) << r << " " << c;
+            }
+        }
+        const V centroid = mia::batch::mean<T, Ds>(points);
+        EXPECT_NEAR(centroid[0], 104.5, 1e-4);
+        EXPECT_NEAR(centroid[1], 6.0, 1e-4);
+    }
+}
+
+// NOTE: COMPENSATED SUMS
+TEST(batch_reduce_test, compensated_sums_are_accurate) {
+    using V = mia::vector<float, 3>;
+    std::mt19937 random{7};
+    std::uniform_real_distribution<float> distribution{0.0f, 1.0f};
+    std::vector<V> values(1'000'003);
+    double exact[3] = {};
+    for (V &v : values) {
+        v = V{distribution(random), distribution(random) * 1e-3f, 0.1f};
+        for (size_t d = 0; d < 3; ++d) {
+            exact[d] += static_cast<double>(v[d]);
+        }
+    }
+    V naive{};
+    for (const V &v : values) {
+        naive += v;
+    }
+    const V kahan = mia::batch::kahan_sum<float, 3>(values);
+    const V pairwise = mia::batch::pairwise_sum<float, 3>(values);
+    for (size_t d = 0; d < 3; ++d) {
+        const double naive_error = std::abs(static_cast<double>(naive[d]) - exact[d]) / exact[d];
+        const double kahan_error = std::abs(static_cast<double>(kahan[d]) - exact[d]) / exact[d];
+        const double pairwise_error = std::abs(static_cast<double>(pairwise[d]) - exact[d]) / exact[d];
+        EXPECT_LT(kahan_error, 1e-7) << d;
+        // Inside a pairwise block the error is the kernel's own: 4 accumulators on the scalar level, 96 lanes with AVX-512
+        EXPECT_LT(pairwise_error, 1e-5) << d;
+        EXPECT_LT(kahan_error, naive_error) << d;
+    }
+
+    // Cancellation: Neumaier's variant keeps the small terms swamped by the large ones
+    std::vector<V> cancelling;
+    for (int i = 0; i < 1000; ++i) {
+        cancelling.push_back(V{1e8f, 1.0f, -1e8f});
+        cancelling.push_back(V{1.0f, 1e8f, 1.0f});
+        cancelling.push_back(V{-1e8f, -1e8f, 1e8f});
+    }
+    EXPECT_EQ((mia::batch::kahan_sum<float, 3>(cancelling)), (V{1000.0f, 1000.0f, 1000.0f}));
+}
+
+// NOTE: PARALLEL REDUCTIONS MATCH SERIAL ONES
+TEST(batch_reduce_test, parallel_matches_serial) {
+    using V = mia::vector<float, 3>;
+    std::mt19937 random{11};
+    std::normal_distribution<float> distribution{5.0f, 2.0f};
+    std::vector<V> points(200'003);
+    for (V &p : points) {
+        p = V{distribution(random), 3.0f * distribution(random), -distribution(random)};
+    }
+
+    mia::thread_pool pool{4};
+    EXPECT_EQ((mia::batch::bounds<float, 3>(pool, points)), (mia::batch::bounds<float, 3>(points)));
+    EXPECT_TRUE((mia::batch::bounds<float, 3>(pool, {})).is_empty());
+
+    const V serial_mean = mia::batch::mean<float, 3>(points);
+    const V parallel_mean = mia::batch::mean<float, 3>(pool, points);
+    const V kahan_mean = V(mia::batch::kahan_sum<float, 3>(pool, points) / static_cast<float>(points.size()));
+    for (size_t d = 0; d < 3; ++d) {
+        EXPECT_NEAR(parallel_mean[d], serial_mean[d], 1e-5f);
+        EXPECT_NEAR(kahan_mean[d], serial_mean[d], 1e-5f);
+    }
+
+    const auto serial = mia::batch::covariance<float, 3>(points);
+    const auto parallel = mia::batch::covariance<float, 3>(pool, points);
+    EXPECT_NEAR(serial(0, 0), 4.0f, 0.1f);
+    EXPECT_NEAR(serial(1, 1), 36.0f, 0.5f);
+    for (size_t r = 0; r < 3; ++r) {
+        for (size_t c = 0; c < 3; ++c) {
+            EXPECT_NEAR(parallel(r, c), serial(r, c), 1e-4f);
+            EXPECT_EQ(serial(r, c), serial(c, r));
+        }
+    }
+}
+
+// NOTE: EVERY INSTRUCTION SET THE HOST SUPPORTS
+// On raw floats, so every stride runs whatever the vector layout
+TEST(batch_reduce_test, every_supported_isa) {
+    const auto detected = mia::batch::detail::detect_isa();
+    EXPECT_EQ(mia::batch::detail::active_reduce_kernels().level, mia::batch::active_isa());
+
+    for (const size_t stride : {size_t{2}, size_t{3}, size_t{4}}) {
+        for (const size_t dims : {size_t{2}, stride}) {
+            const size_t count = 137;
+            std::vector<float> in(count * stride);
+            for (size_t j = 0; j < in.size(); ++j) {
+                // Padding lanes hold garbage the kernels must skip
+                in[j] = j % stride < dims ? static_cast<float>(static_cast<int>(j * 13 % 29) - 14) : 1e30f;
+            }
+            const float mean[4] = {0.5f, -1.0f, 2.0f, 0.0f};
+            float expected_sum[4] = {};
+            float expected_low[4] = {1e30f, 1e30f, 1e30f, 1e30f};
+            float expected_high[4] = {-1e30f, -1e30f, -1e30f, -1e30f};
+            float expected_scatter[16] = {};
+            for (size_t i = 0; i < count; ++i) {
+                for (size_t r = 0; r < dims; ++r) {
+                    const float v = in[i * stride + r];
+                    expected_sum[r] += v;
+                    expected_low[r] = std::min(expected_low[r], v);
+                    expected_high[r] = std::max(expected_high[r], v);
+                    for (size_t c = 0; c < dims; ++c) {
+                        expected_scatter[r * dims + c] += (v - mean[r]) * (in[i * stride + c] - mean[c]);
+                    }
+                }
+            }
+
+            for (auto level : {mia::batch::isa::scalar, mia::batch::isa::sse4_1, mia::batch::isa::avx2, mia::batch::isa::avx512}) {
+                if (level > detected) {
+                    continue;
+                }
+                const auto kernels = mia::batch::detail::reduce_kernels_for(level);
+                SCOPED_TRACE(testing::Message() << static_cast<int>(kernels.level) << " stride " << stride << " dims " << dims);
+
+                float sum[4];
+                float error[4];
+                float low[4];
+                float high[4];
+                float scatter[16];
+                kernels.compensated_sum(in.data(), count, stride, dims, sum, error);
+                kernels.bounds(in.data(), count, stride, dims, low, high);
+                kernels.scatter(in.data(), count, stride, dims, mean, scatter);
+                for (size_t r = 0; r < dims; ++r) {
+                    EXPECT_EQ(sum[r] + error[r], expected_sum[r]);
+                    EXPECT_EQ(low[r], expected_low[r]);
+                    EXPECT_EQ(high[r], expected_high[r]);
+                    for (size_t c = 0; c < dims; ++c) {
+                        EXPECT_NEAR(scatter[r * dims + c], expected_scatter[r * dims + c], 1e-2f);
+                    }
+                }
+                kernels.sum(in.data(), count, stride, dims, sum);
+                for (size_t r = 0; r < dims; ++r) {
+                    EXPECT_EQ(sum[r], expected_sum[r]);
+                }
+            }
+        }
+    }
+}
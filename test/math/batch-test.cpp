@@ -0,0 +1,284 @@
+#include "math/batch.hpp"
+#include "math/batch-parallel.hpp"
+#include "math/batch-reduce.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// NOTE: FIXTURE AND TYPED SETUP
+template <typename T, size_t Ds>
+struct batch_type {
+    using type = T;
+    static constexpr size_t dims = Ds;
+};
+using batch_test_types = ::testing::Types<batch_type<float, 3>, batch_type<float, 4>, batch_type<float, 2>, batch_type<double, 4>, batch_type<int, 3>>;
+
+template <typename Param>
+class typed_batch_test : public ::testing::Test {
+  public:
+    using type = typename Param::type;
+    static constexpr size_t dims = Param::dims;
+    using vector_type = mia::vector<type, dims>;
+    using compute_type = typename vector_type::compute_type;
+
+  protected:
+    void SetUp() override {
+        // Not a multiple of any kernel width, so every tail path runs
+        for (size_t i = 0; i < 53; ++i) {
+            vector_type a;
+            vector_type b;
+            for (size_t d = 0; d < dims; ++d) {
+                a[d] = static_cast<type>(static_cast<int>(i + d) % 9 + 1);
+                b[d] = static_cast<type>(static_cast<int>(i * 5 + d) % 7 - 3);
+            }
+            lhs.push_back(a);
+            rhs.push_back(b);
+        }
+    }
+
+    std::vector<vector_type> lhs;
+    std::vector<vector_type> rhs;
+};
+
+TYPED_TEST_SUITE(typed_batch_test, batch_test_types);
+
+// NOTE: BATCH OPERATIONS MATCH PER-OBJECT OPERATIONS
+TYPED_TEST(typed_batch_test, matches_vector_operations) {
+    using T = typename TestFixture::type;
+    constexpr size_t Ds = TestFixture::dims;
+    using V = typename TestFixture::vector_type;
+    using ComputeType = typename TestFixture::compute_type;
+
+    const size_t n = this->lhs.size();
+    const double tolerance = std::is_floating_point_v<T> ? 1e-4 : 0.0;
+
+    std::vector<ComputeType> out(n);
+    mia::batch::dot<T, Ds>(this->lhs, this->rhs, out);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(out[i], V::dot_product(this->lhs[i], this->rhs[i]), tolerance);
+    }
+
+    mia::batch::distance_squared<T, Ds>(this->lhs, this->rhs, out);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(out[i], V::distance_squared(this->lhs[i], this->rhs[i]), tolerance);
+    }
+
+    std::vector<V> vectors(n);
+    mia::batch::lerp<T, Ds>(this->lhs, this->rhs, static_cast<ComputeType>(0.5), vectors);
+    for (size_t i = 0; i < n; ++i) {
+        const V expected = V::lerp(this->lhs[i], this->rhs[i], static_cast<ComputeType>(0.5));
+        for (size_t d = 0; d < Ds; ++d) {
+            EXPECT_NEAR(vectors[i][d], expected[d], tolerance);
+        }
+    }
+
+    mia::batch::transform<T, Ds>(this->lhs, vectors, [](const V &v) { return v + v; });
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(vectors[i], this->lhs[i] + this->lhs[i]);
+    }
+
+    if constexpr (std::is_floating_point_v<T>) {
+        mia::batch::distance<T, Ds>(this->lhs, this->rhs, out);
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_NEAR(out[i], V::distance(this->lhs[i], this->rhs[i]), tolerance);
+        }
+
+        // In place
+        vectors = this->lhs;
+        mia::batch::normalize<T, Ds>(vectors);
+        for (size_t i = 0; i < n; ++i) {
+            const V expected = this->lhs[i].normalized();
+            for (size_t d = 0; d < Ds; ++d) {
+                EXPECT_NEAR(vectors[i][d], expected[d], 1e-6);
+            }
+        }
+    }
+}
+
+TYPED_TEST(typed_batch_test, reductions_match_loops) {
+    using T = typename TestFixture::type;
+    constexpr size_t Ds = TestFixture::dims;
+    using V = typename TestFixture::vector_type;
+
+    V sum{};
+    V low = this->lhs.front();
+    V high = this->lhs.front();
+    for (const V &v : this->lhs) {
+        sum += v;
+        low = V::min(low, v);
+        high = V::max(high, v);
+    }
+    // Small integers, the accumulation order does not matter
+    EXPECT_EQ((mia::batch::sum<T, Ds>(this->lhs)), sum);
+    EXPECT_EQ((mia::batch::min<T, Ds>(this->lhs)), low);
+    EXPECT_EQ((mia::batch::max<T, Ds>(this->lhs)), high);
+    EXPECT_EQ((mia::batch::sum<T, Ds>({})), V{});
+}
+
+// NOTE: PARALLEL OPERATIONS MATCH SERIAL ONES
+TEST(batch_test, parallel_matches_serial) {
+    using V = mia::vector<float, 3>;
+    std::vector<V> lhs(100'003);
+    std::vector<V> rhs(lhs.size());
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        lhs[i] = V{static_cast<float>(i % 17) - 8.0f, static_cast<float>(i % 5) + 1.0f, static_cast<float>(i % 31)};
+        rhs[i] = V{1.0f, static_cast<float>(i % 7), -static_cast<float>(i % 3)};
+    }
+    lhs[77'777] = V{-100.0f, 50.0f, 60.0f};
+
+    mia::thread_pool pool{4};
+    std::vector<float> serial(lhs.size());
+    std::vector<float> parallel(lhs.size());
+    mia::batch::dot<float, 3>(lhs, rhs, serial);
+    mia::batch::dot<float, 3>(pool, lhs, rhs, parallel);
+    EXPECT_EQ(serial, parallel);
+
+    std::vector<V> serial_vectors(lhs.size());
+    std::vector<V> parallel_vectors(lhs.size());
+    mia::batch::normalize<float, 3>(lhs, serial_vectors);
+    mia::batch::normalize<float, 3>(pool, lhs, parallel_vectors);
+    EXPECT_EQ(serial_vectors, parallel_vectors);
+
+    mia::batch::transform<float, 3>(pool, lhs, parallel_vectors, [](const V &v) { return v * 2.0f; });
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        ASSERT_EQ(parallel_vectors[i], lhs[i] * 2.0f);
+    }
+
+    // Exact: integer valued sums stay well under 2^24
+    EXPECT_EQ((mia::batch::sum<float, 3>(pool, lhs)), (mia::batch::sum<float, 3>(lhs)));
+    EXPECT_EQ((mia::batch::min<float, 3>(pool, lhs)), (V{-100.0f, 1.0f, 0.0f}));
+    EXPECT_EQ((mia::batch::max<float, 3>(pool, lhs)), (V{8.0f, 50.0f, 60.0f}));
+}
+
+// NOTE: EVERY INSTRUCTION SET THE HOST SUPPORTS
+TEST(batch_test, every_supported_isa) {
+    using V = mia::vector<float, 3>;
+    constexpr size_t stride = sizeof(V) / sizeof(float);
+
+    std::vector<V> lhs;
+    std::vector<V> rhs;
+    for (size_t i = 0; i < 45; ++i) {
+        lhs.push_back(V{static_cast<float>(i % 5) + 1.0f, static_cast<float>(i % 3), 2.0f});
+        rhs.push_back(V{3.0f, -static_cast<float>(i % 4), static_cast<float>(i % 7)});
+    }
+    const size_t n = lhs.size();
+
+    const auto detected = mia::batch::detail::detect_isa();
+    EXPECT_LE(mia::batch::active_isa(), detected);
+    EXPECT_EQ(mia::batch::detail::active_kernels().level, mia::batch::active_isa());
+
+    for (auto level : {mia::batch::isa::scalar, mia::batch::isa::sse4_1, mia::batch::isa::avx2, mia::batch::isa::avx512}) {
+        if (level > detected) {
+            continue;
+        }
+        const auto kernels = mia::batch::detail::kernels_for(level);
+        SCOPED_TRACE(static_cast<int>(kernels.level));
+
+        std::vector<float> out(n);
+        kernels.dot(lhs.front().data.data(), rhs.front().data.data(), out.data(), n, stride, 3);
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_NEAR(out[i], V::dot_product(lhs[i], rhs[i]), 1e-4);
+        }
+
+        kernels.distance_squared(lhs.front().data.data(), rhs.front().data.data(), out.data(), n, stride, 3);
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_NEAR(out[i], V::distance_squared(lhs[i], rhs[i]), 1e-4);
+        }
+
+        std::vector<V> normalized = lhs;
+        kernels.normalize(normalized.front().data.data(), normalized.front().data.data(), n, stride, 3);
+        for (size_t i = 0; i < n; ++i) {
+            const V expected = lhs[i].normalized();
+            EXPECT_NEAR(normalized[i].x(), expected.x(), 1e-6);
+            EXPECT_NEAR(normalized[i].y(), expected.y(), 1e-6);
+            EXPECT_NEAR(normalized[i].z(), expected.z(), 1e-6);
+        }
+    }
+}
+
+// NOTE: MATRIX TRANSFORM
+TEST(batch_test, matrix_transform) {
+    using M = mia::matrix4<float>;
+    using V3 = mia::vector<float, 3>;
+    using V4 = mia::vector<float, 4>;
+
+    M m = M::translation(V3{1.0f, -2.0f, 0.5f}) * M::rotation(V3{1.0f, 1.0f, 0.0f}, 0.7f) * M::scaling(V3{2.0f, 1.0f, 3.0f});
+    m(3, 0) = 0.25f;  // Projective row, ignored for points and directions
+
+    std::vector<V3> points;
+    std::vector<V4> vectors;
+    for (size_t i = 0; i < 53; ++i) {
+        const auto f = static_cast<float>(i);
+        points.push_back(V3{f, 1.0f - f, f * 0.5f});
+        vectors.push_back(V4{f, 2.0f, -f, 1.0f + f});
+    }
+    const size_t n = points.size();
+
+    std::vector<V3> out3(n);
+    mia::batch::transform_points<float>(m, points, out3);
+    for (size_t i = 0; i < n; ++i) {
+        const V3 expected = m.transform_point(points[i]);
+        for (size_t d = 0; d < 3; ++d) {
+            EXPECT_NEAR(out3[i][d], expected[d], 1e-4);
+        }
+        // The padding lane stays zero
+        if constexpr (sizeof(V3) == 4 * sizeof(float)) {
+            EXPECT_EQ(out3[i].data[3], 0.0f);
+        }
+    }
+
+    // In place
+    out3 = points;
+    mia::batch::transform_directions<float>(m, out3, out3);
+    for (size_t i = 0; i < n; ++i) {
+        const V3 expected = m.transform_direction(points[i]);
+        for (size_t d = 0; d < 3; ++d) {
+            EXPECT_NEAR(out3[i][d], expected[d], 1e-4);
+        }
+    }
+
+    std::vector<V4> out4(n);
+    mia::batch::transform<float>(m, vectors, out4);
+    for (size_t i = 0; i < n; ++i) {
+        const V4 expected = m * vectors[i];
+        for (size_t d = 0; d < 4; ++d) {
+            EXPECT_NEAR(out4[i][d], expected[d], 1e-4);
+        }
+    }
+
+    // Every kernel the host supports
+    const auto elements = mia::batch::detail::matrix_elements(m);
+    const auto detected = mia::batch::detail::detect_isa();
+    for (auto level : {mia::batch::isa::scalar, mia::batch::isa::sse4_1, mia::batch::isa::avx2, mia::batch::isa::avx512}) {
+        if (level > detected) {
+            continue;
+        }
+        const auto kernels = mia::batch::detail::kernels_for(level);
+        SCOPED_TRACE(static_cast<int>(kernels.level));
+
+        kernels.transform(elements.data(), points.front().data.data(), out3.front().data.data(), n, sizeof(V3) / sizeof(float), 3, 1.0f);
+        for (size_t i = 0; i < n; ++i) {
+            const V3 expected = m.transform_point(points[i]);
+            for (size_t d = 0; d < 3; ++d) {
+                EXPECT_NEAR(out3[i][d], expected[d], 1e-4);
+            }
+        }
+        kernels.transform(elements.data(), vectors.front().data.data(), out4.front().data.data(), n, 4, 4, 0.0f);
+        for (size_t i = 0; i < n; ++i) {
+            const V4 expected = m * vectors[i];
+            for (size_t d = 0; d < 4; ++d) {
+                EXPECT_NEAR(out4[i][d], expected[d], 1e-4);
+            }
+        }
+    }
+
+    // Other element types take the per-vector path
+    const mia::matrix4<double> md = mia::matrix4<double>::translation(mia::vector<double, 3>{1.0, 2.0, 3.0});
+    std::vector<mia::vector<double, 3>> pd(5, mia::vector<double, 3>{1.0, 1.0, 1.0});
+    mia::batch::transform_points<double>(md, pd, pd);
+    EXPECT_EQ(pd[4], (mia::vector<double, 3>{2.0, 3.0, 4.0}));
+}
@@ -0,0 +1,307 @@
+#include "math/bvh.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <random>
+#include <vector>
+
+// NOTE: FIXTURE
+namespace {
+
+using V3 = mia::vector<float, 3>;
+using B3 = mia::aabb3<float>;
+using R3 = mia::ray<float, 3>;
+using tree = mia::bvh<float, 3>;
+
+class bvh_test : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        std::uniform_real_distribution<float> size{0.1f, 3.0f};
+        boxes.resize(2000);
+        for (B3 &b : boxes) {
+            const V3 corner = random_vector();
+            b = B3{corner, corner + V3{size(random), size(random), size(random)}};
+        }
+    }
+
+    auto random_vector() -> V3 {
+        std::uniform_real_distribution<float> coordinate{-50.0f, 50.0f};
+        return V3{coordinate(random), coordinate(random), coordinate(random)};
+    }
+    auto random_ray() -> R3 {
+        return R3{random_vector() * 1.5f, random_vector()};
+    }
+
+    std::mt19937 random{11};
+    std::vector<B3> boxes;
+};
+
+// Closest box hit by checking every box
+auto brute_force_raycast(const std::vector<B3> &boxes, const R3 &r) -> std::optional<float> {
+    std::optional<float> closest;
+    for (const B3 &b : boxes) {
+        const auto t = b.intersect(r);
+        if (t && (!closest || *t < *closest)) {
+            closest = t;
+        }
+    }
+    return closest;
+}
+
+// Every node contains its children, leaves respect the size limit and cover each primitive once
+void expect_well_formed(const tree &t, const size_t max_leaf_size) {
+    std::vector<uint32_t> seen(t.size(), 0);
+    const auto nodes = t.nodes();
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const auto &n = nodes[i];
+        if (n.is_leaf()) {
+            EXPECT_LE(n.count, max_leaf_size);
+            for (uint32_t p = n.offset; p < n.offset + n.count; ++p) {
+                ++seen[t.indices()[p]];
+            }
+        } else {
+            EXPECT_TRUE(n.bounds.contains(nodes[i + 1].bounds));
+            EXPECT_TRUE(n.bounds.contains(nodes[n.offset].bounds));
+        }
+    }
+    EXPECT_TRUE(std::all_of(seen.begin(), seen.end(), [](const uint32_t s) { return s == 1; }));
+}
+
+} // namespace
+
+// NOTE: BUILD
+TEST_F(bvh_test, build_is_well_formed) {
+    const tree t{boxes};
+    EXPECT_EQ(t.size(), boxes.size());
+    EXPECT_EQ(t.nodes().size() % 2, 1u);
+    for (const B3 &b : boxes) {
+        EXPECT_TRUE(t.bounds().contains(b));
+    }
+    // SAH keeps the tree close to balanced on uniform boxes
+    EXPECT_LT(t.depth(), 32u);
+    expect_well_formed(t, 4);
+
+    const tree large_leaves{boxes, {.max_leaf_size = 16}};
+    expect_well_formed(large_leaves, 16);
+    EXPECT_LE(large_leaves.nodes().size(), t.nodes().size());
+}
+
+TEST_F(bvh_test, parallel_build_matches_serial) {
+    const tree serial{boxes, {.threads = 1}};
+    const tree parallel{boxes, {.threads = 4, .parallel_threshold = 64}};
+    ASSERT_EQ(serial.nodes().size(), parallel.nodes().size());
+    for (size_t i = 0; i < serial.nodes().size(); ++i) {
+        EXPECT_EQ(serial.nodes()[i].bounds, parallel.nodes()[i].bounds);
+        EXPECT_EQ(serial.nodes()[i].offset, parallel.nodes()[i].offset);
+        EXPECT_EQ(serial.nodes()[i].count, parallel.nodes()[i].count);
+    }
+    EXPECT_TRUE(std::equal(serial.indices().begin(), serial.indices().end(), parallel.indices().begin()));
+
+    // Rebuilding in place reuses the storage and gives the same tree
+    tree rebuilt{boxes, {.threads = 4, .parallel_threshold = 64}};
+    rebuilt.build(boxes, {.threads = 3, .parallel_threshold = 100});
+    EXPECT_EQ(rebuilt.nodes().size(), serial.nodes().size());
+    EXPECT_TRUE(std::equal(serial.indices().begin(), serial.indices().end(), rebuilt.indices().begin()));
+
+    // On a caller's pool, one subtree per thread or more subtrees than threads
+    mia::thread_pool pool{3};
+    for (const size_t subtrees : {size_t{0}, size_t{5}}) {
+        tree on_pool;
+        on_pool.build(pool, boxes, {.threads = subtrees, .parallel_threshold = 64});
+        on_pool.build(pool, boxes, {.threads = subtrees, .parallel_threshold = 64});
+        EXPECT_EQ(on_pool.nodes().size(), serial.nodes().size()) << subtrees;
+        EXPECT_TRUE(std::equal(serial.indices().begin(), serial.indices().end(), on_pool.indices().begin())) << subtrees;
+    }
+}
+
+TEST(bvh_edge_test, degenerate_inputs) {
+    const tree empty{std::span<const B3>{}};
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.bounds().is_empty());
+    EXPECT_FALSE(empty.raycast(R3{V3{}, V3{1.0f, 0.0f, 0.0f}}).has_value());
+    EXPECT_FALSE(empty.nearest(V3{}).has_value());
+    EXPECT_EQ(empty.query(V3{}, 1.0f, [](uint32_t) {}), 0u);
+
+    const std::vector<B3> one{B3{V3{1.0f, 1.0f, 1.0f}, V3{2.0f, 2.0f, 2.0f}}};
+    const tree single{one, {.wide = true}};
+    EXPECT_EQ(single.depth(), 1u);
+    EXPECT_EQ(single.wide_nodes().size(), 1u);
+    EXPECT_EQ(single.raycast(R3{V3{0.0f, 1.5f, 1.5f}, V3{1.0f, 0.0f, 0.0f}})->t, 1.0f);
+
+    // Coincident points cannot be separated by a plane, they are split in halves
+    const std::vector<V3> same(100, V3{3.0f, 3.0f, 3.0f});
+    const tree stacked = tree::from_points(same, {.max_leaf_size = 2});
+    expect_well_formed(stacked, 2);
+    EXPECT_LE(stacked.depth(), 8u);
+    EXPECT_EQ(stacked.query(V3{3.0f, 3.0f, 3.0f}, 0.0f, [](uint32_t) {}), 100u);
+
+    // Points on a line have no area, object medians are used
+    std::vector<V3> line(1000);
+    for (size_t i = 0; i < line.size(); ++i) {
+        line[i] = V3{static_cast<float>(i), 0.0f, 0.0f};
+    }
+    const tree flat = tree::from_points(line);
+    expect_well_formed(flat, 4);
+    EXPECT_EQ(flat.nearest(V3{500.2f, 1.0f, 0.0f})->index, 500u);
+}
+
+// NOTE: RAY CAST
+TEST_F(bvh_test, raycast_matches_brute_force) {
+    const tree binary{boxes};
+    const tree wide{boxes, {.wide = true}};
+    ASSERT_FALSE(wide.wide_nodes().empty());
+    EXPECT_LT(wide.wide_nodes().size(), wide.nodes().size() / 2);
+
+    size_t hits = 0;
+    for (int i = 0; i < 500; ++i) {
+        const R3 r = random_ray();
+        const auto expected = brute_force_raycast(boxes, r);
+        const auto from_binary = binary.raycast(r);
+        const auto from_wide = wide.raycast(r);
+        ASSERT_EQ(from_binary.has_value(), expected.has_value()) << i;
+        ASSERT_EQ(from_wide.has_value(), expected.has_value()) << i;
+        if (expected) {
+            EXPECT_EQ(from_binary->t, *expected);
+            EXPECT_EQ(from_wide->t, *expected);
+            EXPECT_EQ(boxes[from_binary->index].intersect(r), expected);
+            ++hits;
+        }
+    }
+    EXPECT_GT(hits, 50u);
+    EXPECT_LT(hits, 500u);
+}
+
+TEST_F(bvh_test, raycast_with_primitive_test) {
+    // Spheres inscribed in the boxes
+    const auto sphere = [&](const uint32_t index, const R3 &r, const float t_max) -> std::optional<float> {
+        const V3 center = boxes[index].center();
+        const V3 extent = boxes[index].extent();
+        const float radius = std::min({extent.x(), extent.y(), extent.z()}) / 2;
+        const V3 offset = r.origin - center;
+        const float a = V3::dot_product(r.direction, r.direction);
+        const float b = V3::dot_product(offset, r.direction);
+        const float c = V3::dot_product(offset, offset) - radius * radius;
+        const float discriminant = b * b - a * c;
+        if (discriminant < 0) {
+            return std::nullopt;
+        }
+        const float t = (-b - std::sqrt(discriminant)) / a;
+        return t >= 0 && t <= t_max ? std::optional<float>{t} : std::nullopt;
+    };
+
+    const tree binary{boxes};
+    const tree wide{boxes, {.wide = true}};
+    for (int i = 0; i < 300; ++i) {
+        const R3 r = random_ray();
+        std::optional<float> expected;
+        for (uint32_t p = 0; p < boxes.size(); ++p) {
+            const auto t = sphere(p, r, std::numeric_limits<float>::infinity());
+            if (t && (!expected || *t < *expected)) {
+                expected = t;
+            }
+        }
+        const auto from_binary = binary.raycast(r, sphere);
+        const auto from_wide = wide.raycast(r, sphere);
+        ASSERT_EQ(from_binary.has_value(), expected.has_value()) << i;
+        ASSERT_EQ(from_wide.has_value(), expected.has_value()) << i;
+        if (expected) {
+            EXPECT_EQ(from_binary->t, *expected);
+            EXPECT_EQ(from_wide->t, *expected);
+        }
+    }
+
+    // Hits past t_max are ignored
+    const R3 r{V3{-100.0f, 0.0f, 0.0f}, V3{1.0f, 0.0f, 0.0f}};
+    const auto first = binary.raycast(r);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_FALSE(binary.raycast(r, 0.0f, first->t * 0.5f).has_value());
+}
+
+// NOTE: NEAREST NEIGHBOUR
+TEST_F(bvh_test, nearest_matches_brute_force) {
+    std::vector<V3> points(3000);
+    for (V3 &p : points) {
+        p = random_vector();
+    }
+    const tree t = tree::from_points(points, {.threads = 2, .parallel_threshold = 256});
+    for (int i = 0; i < 300; ++i) {
+        const V3 query = random_vector() * 1.2f;
+        float expected = std::numeric_limits<float>::infinity();
+        for (const V3 &p : points) {
+            expected = std::min(expected, V3::distance_squared(query, p));
+        }
+        const auto found = t.nearest(query);
+        ASSERT_TRUE(found.has_value());
+        EXPECT_EQ(found->distance_squared, expected);
+        EXPECT_EQ(V3::distance_squared(query, points[found->index]), expected);
+        EXPECT_FALSE(t.nearest(query, expected).has_value());
+    }
+
+    // Distance to the box centers instead of the boxes
+    const tree boxed{boxes};
+    const V3 query{1.0f, 2.0f, 3.0f};
+    const auto to_center = [&](const uint32_t index, const V3 &p) { return V3::distance_squared(boxes[index].center(), p); };
+    float expected = std::numeric_limits<float>::infinity();
+    for (const B3 &b : boxes) {
+        expected = std::min(expected, V3::distance_squared(b.center(), query));
+    }
+    EXPECT_EQ(boxed.nearest(query, to_center)->distance_squared, expected);
+}
+
+// NOTE: RANGE QUERIES
+TEST_F(bvh_test, range_queries_match_brute_force) {
+    const tree t{boxes};
+    for (int i = 0; i < 100; ++i) {
+        const V3 center = random_vector();
+        const float radius = static_cast<float>(i % 10) * 2.0f;
+        const B3 region = B3{center, center}.inflate(radius);
+
+        std::vector<uint32_t> in_box;
+        std::vector<uint32_t> in_sphere;
+        const size_t box_count = t.query(region, [&](const uint32_t index) { in_box.push_back(index); });
+        const size_t sphere_count = t.query(center, radius, [&](const uint32_t index) { in_sphere.push_back(index); });
+        EXPECT_EQ(box_count, in_box.size());
+        EXPECT_EQ(sphere_count, in_sphere.size());
+        std::sort(in_box.begin(), in_box.end());
+        std::sort(in_sphere.begin(), in_sphere.end());
+
+        std::vector<uint32_t> expected_box;
+        std::vector<uint32_t> expected_sphere;
+        for (uint32_t p = 0; p < boxes.size(); ++p) {
+            if (boxes[p].overlaps(region)) {
+                expected_box.push_back(p);
+            }
+            if (boxes[p].distance_squared(center) <= radius * radius) {
+                expected_sphere.push_back(p);
+            }
+        }
+        EXPECT_EQ(in_box, expected_box);
+        EXPECT_EQ(in_sphere, expected_sphere);
+    }
+}
+
+// NOTE: OTHER INSTANTIATIONS
+TEST(bvh_edge_test, double_2d) {
+    using V2 = mia::vector<double, 2>;
+    std::vector<V2> points;
+    for (int x = 0; x < 40; ++x) {
+        for (int y = 0; y < 40; ++y) {
+            points.push_back(V2{x * 0.5, y * 0.25});
+        }
+    }
+    const auto t = mia::bvh<double, 2>::from_points(points, {.wide = true});
+    EXPECT_EQ(t.nearest(V2{3.1, 2.05})->index, 6u * 40 + 8);
+    EXPECT_EQ(t.query(V2{5.0, 5.0}, 0.3, [](uint32_t) {}), 3u);
+
+    const mia::bvh<double, 2> copy = t;
+    EXPECT_EQ(copy.nodes().size(), t.nodes().size());
+    const auto from_copy = copy.raycast(mia::ray<double, 2>{V2{-1.0, 0.25}, V2{1.0, 0.0}});
+    ASSERT_TRUE(from_copy.has_value());
+    EXPECT_EQ(from_copy->t, 1.0);
+}
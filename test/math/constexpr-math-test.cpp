@@ -0,0 +1,102 @@
+#include "math/constexpr-math.hpp"
+#include "math/quaternion.hpp"
+#include "math/vector.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <random>
+
+// NOTE: CONSTANT EVALUATION PATHS AT RUN TIME
+// detail:: holds what `if consteval` selects, called directly here to compare against libm on many inputs
+// (sqrt's final residual is one std::fma at run time, the same Newton iteration & neighbour choice otherwise)
+TEST(constexpr_math_test, sqrt_is_correctly_rounded) {
+    std::mt19937_64 random{42};
+    for (int i = 0; i < 1 << 18; ++i) {
+        // Doubles & floats over the whole exponent range, subnormal doubles included
+        const double x = std::bit_cast<double>(random() >> 1);
+        if (std::isfinite(x)) {
+            ASSERT_EQ(mia::math::detail::sqrt_constant(x), std::sqrt(x)) << x;
+        }
+        const float f = std::bit_cast<float>(static_cast<uint32_t>(random() >> 34) + 0x00800000u);
+        ASSERT_EQ(mia::math::detail::sqrt_constant(f), std::sqrt(f)) << f;
+    }
+    EXPECT_EQ(mia::math::detail::sqrt_constant(0.0), 0.0);
+    EXPECT_TRUE(std::isnan(mia::math::detail::sqrt_constant(-1.0f)));
+    EXPECT_EQ(mia::math::detail::sqrt_constant(std::numeric_limits<double>::infinity()), std::numeric_limits<double>::infinity());
+}
+
+TEST(constexpr_math_test, acos_within_one_ulp) {
+    for (int i = 0; i <= 1 << 18; ++i) {
+        const double x = -1.0 + 2.0 * i / (1 << 18);
+        const int64_t d = std::bit_cast<int64_t>(mia::math::detail::acos_constant(x)) - std::bit_cast<int64_t>(std::acos(x));
+        ASSERT_LE(d < 0 ? -d : d, 1) << x;
+        const auto f = static_cast<float>(x);
+        const int32_t df = std::bit_cast<int32_t>(mia::math::detail::acos_constant(f)) - std::bit_cast<int32_t>(std::acos(f));
+        ASSERT_LE(df < 0 ? -df : df, 1) << f;
+    }
+    EXPECT_EQ(mia::math::detail::acos_constant(1.0), 0.0);
+    EXPECT_EQ(mia::math::detail::acos_constant(-1.0f), std::numbers::pi_v<float>);
+    EXPECT_TRUE(std::isnan(mia::math::detail::acos_constant(1.5)));
+}
+
+// NOTE: BAKED TABLES
+namespace {
+
+using V3 = mia::vector<float, 3>;
+
+// Unit directions to the corners of a cube, built by the compiler
+constexpr auto corner_directions = [] {
+    std::array<V3, 8> directions;
+    for (size_t i = 0; i < directions.size(); ++i) {
+        directions[i] = V3{i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f}.normalized();
+    }
+    return directions;
+}();
+
+} // namespace
+
+TEST(constexpr_math_test, vector_operations_fold) {
+    constexpr V3 v{3.0f, 4.0f, 12.0f};
+    static_assert(v.magnitude() == 13.0f);
+    static_assert(V3::distance(v, V3{}) == 13.0f);
+    static_assert(V3::angle(V3{1.0f, 0.0f, 0.0f}, V3{0.0f, 1.0f, 0.0f}) == std::numbers::pi_v<float> / 2);
+    static_assert(V3::angle(V3{1.0f, 0.0f, 0.0f}, V3{1.0f, 0.0f, 0.0f}) == 0.0f);
+    static_assert(v.normalized().z() == 12.0f * (1.0f / 13.0f));
+    static_assert([] {
+        V3 u{0.0f, 0.0f, 2.0f};
+        return u.normalizing() == 2.0f && u == V3{0.0f, 0.0f, 1.0f};
+    }());
+
+    // Same bits as at run time
+    V3 runtime = V3{-1.0f, 1.0f, -1.0f};
+    EXPECT_EQ(corner_directions[2], runtime.normalized());
+    const V3 a{0.3f, -1.2f, 2.5f};
+    const V3 b{1.1f, 0.4f, -0.7f};
+    constexpr V3 ca{0.3f, -1.2f, 2.5f};
+    constexpr V3 cb{1.1f, 0.4f, -0.7f};
+    constexpr float folded_magnitude = ca.magnitude();
+    constexpr float folded_distance = V3::distance(ca, cb);
+    EXPECT_EQ(folded_magnitude, a.magnitude());
+    EXPECT_EQ(folded_distance, V3::distance(a, b));
+    constexpr float folded_angle = V3::angle(ca, cb);
+    EXPECT_NEAR(folded_angle, V3::angle(a, b), 1e-6f);
+
+    // double vectors compute in float
+    constexpr mia::vector<double, 4> d{1.0, 2.0, 2.0, 4.0};
+    static_assert(d.magnitude() == 5.0f);
+}
+
+TEST(constexpr_math_test, quaternion_operations_fold) {
+    using Q = mia::quaternion<double>;
+    constexpr Q q = Q{1.0, 1.0, 1.0, 1.0}.normalized();
+    static_assert(q.w() == 0.5 && q.magnitude() == 1.0);
+    constexpr Q back = Q::from_matrix(q.to_matrix3());
+    static_assert(Q::dot(back, q) > 1.0 - 1e-12);
+    static_assert(Q::nlerp(Q::identity(), q, 0.0) == Q::identity());
+    EXPECT_EQ(back, Q::from_matrix(q.to_matrix3()));
+}
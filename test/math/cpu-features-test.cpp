@@ -0,0 +1,86 @@
+#include "math/batch-reduce.hpp"
+#include "math/cpu-features.hpp"
+#include "math/packed.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+
+using mia::batch::isa;
+
+// NOTE: HOST PROBE
+TEST(cpu_features_test, probe_is_consistent) {
+    const mia::cpu_features &features = mia::host_cpu_features();
+    EXPECT_EQ(&features, &mia::host_cpu_features());
+
+    // Every level implies the one below
+    EXPECT_TRUE(!features.avx2 || features.avx);
+    EXPECT_TRUE(!features.fma || features.avx);
+    EXPECT_TRUE(!features.f16c || features.avx);
+    EXPECT_TRUE(!features.avx512bw || features.avx512f);
+    EXPECT_TRUE(!features.avx512dq || features.avx512f);
+    EXPECT_TRUE(!features.avx512vl || features.avx512f);
+
+#if defined(MIA_BATCH_DISPATCH)
+    // Same answers as the compiler's own probe, which checks the OS register state too
+    __builtin_cpu_init();
+    EXPECT_TRUE(features.sse2);
+    EXPECT_EQ(features.sse4_1, __builtin_cpu_supports("sse4.1") != 0);
+    EXPECT_EQ(features.avx, __builtin_cpu_supports("avx") != 0);
+    EXPECT_EQ(features.avx2, __builtin_cpu_supports("avx2") != 0);
+    EXPECT_EQ(features.fma, __builtin_cpu_supports("fma") != 0);
+    EXPECT_EQ(features.avx512f, __builtin_cpu_supports("avx512f") != 0);
+    EXPECT_EQ(features.avx512bw, __builtin_cpu_supports("avx512bw") != 0);
+#else
+    EXPECT_EQ(mia::batch::detail::detect_isa(), isa::scalar);
+#endif
+}
+
+TEST(cpu_features_test, supported_level) {
+    mia::cpu_features features;
+    EXPECT_EQ(mia::batch::detail::supported_isa(features), isa::scalar);
+    features.sse2 = true;
+    features.sse4_1 = true;
+    EXPECT_EQ(mia::batch::detail::supported_isa(features), isa::sse4_1);
+    features.avx = true;
+    features.avx2 = true;
+    EXPECT_EQ(mia::batch::detail::supported_isa(features), isa::sse4_1); // no FMA
+    features.fma = true;
+    EXPECT_EQ(mia::batch::detail::supported_isa(features), isa::avx2);
+    features.avx512f = true;
+    EXPECT_EQ(mia::batch::detail::supported_isa(features), isa::avx512);
+}
+
+// NOTE: OVERRIDE
+TEST(cpu_features_test, names_round_trip) {
+    for (const isa level : {isa::scalar, isa::sse4_1, isa::avx2, isa::avx512}) {
+        EXPECT_EQ(mia::batch::parse_isa(mia::batch::isa_name(level)), level);
+    }
+    EXPECT_EQ(mia::batch::parse_isa("sse4_1"), isa::sse4_1);
+    EXPECT_EQ(mia::batch::parse_isa("AVX2"), std::nullopt);
+    EXPECT_EQ(mia::batch::parse_isa(""), std::nullopt);
+}
+
+TEST(cpu_features_test, override_is_lowered_to_the_host) {
+    using mia::batch::detail::select_isa;
+    EXPECT_EQ(select_isa(nullptr, isa::avx2), isa::avx2);
+    EXPECT_EQ(select_isa("scalar", isa::avx2), isa::scalar);
+    EXPECT_EQ(select_isa("sse4.1", isa::avx2), isa::sse4_1);
+    EXPECT_EQ(select_isa("avx2", isa::avx2), isa::avx2);
+    // Never above what the host runs
+    EXPECT_EQ(select_isa("avx512", isa::avx2), isa::avx2);
+    EXPECT_EQ(select_isa("avx2", isa::scalar), isa::scalar);
+    // Unknown names are ignored
+    EXPECT_EQ(select_isa("neon", isa::sse4_1), isa::sse4_1);
+    EXPECT_EQ(select_isa("", isa::avx512), isa::avx512);
+}
+
+// NOTE: EVERY KERNEL TABLE FOLLOWS THE ONE LEVEL
+// Run the suite with MIA_ISA=scalar (or sse4.1, avx2) to check the override end to end
+TEST(cpu_features_test, tables_follow_the_active_level) {
+    const isa active = mia::batch::active_isa();
+    EXPECT_EQ(active, mia::batch::detail::select_isa(std::getenv(mia::batch::isa_environment_variable), mia::batch::detail::detect_isa()));
+    EXPECT_EQ(mia::batch::detail::active_kernels().level, active);
+    EXPECT_EQ(mia::batch::detail::active_reduce_kernels().level, active);
+    EXPECT_LE(mia::batch::detail::active_packed_kernels<mia::half_format>().level, active);
+}
@@ -0,0 +1,152 @@
+#include "math/fast-math.hpp"
+#include "math/vector.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numbers>
+
+// NOTE: ULP HARNESS
+// Distance in units in the last place between two finite floats, counting across 0
+static auto ulp_distance(const float a, const float b) -> uint32_t {
+    const auto ordered = [](const float v) {
+        const auto bits = static_cast<int64_t>(std::bit_cast<uint32_t>(v));
+        return bits & 0x80000000 ? 0x80000000 - bits : bits;
+    };
+    const int64_t d = ordered(a) - ordered(b);
+    return static_cast<uint32_t>(d < 0 ? -d : d);
+}
+
+// Worst ULP error of `fast` against `exact` (in double, rounded to float) over `samples` points of [lower, upper]
+static auto max_ulp(const std::function<float(float)> &fast, const std::function<double(double)> &exact, const float lower,
+                    const float upper, const int samples = 1 << 18) -> uint32_t {
+    uint32_t worst = 0;
+    for (int i = 0; i <= samples; ++i) {
+        const float x = lower + (upper - lower) * static_cast<float>(i) / static_cast<float>(samples);
+        worst = std::max(worst, ulp_distance(fast(x), static_cast<float>(exact(static_cast<double>(x)))));
+    }
+    return worst;
+}
+
+static auto max_absolute(const std::function<double(double)> &fast, const std::function<double(double)> &exact, const double lower,
+                         const double upper, const int samples = 1 << 16) -> double {
+    double worst = 0;
+    for (int i = 0; i <= samples; ++i) {
+        const double x = lower + (upper - lower) * static_cast<double>(i) / static_cast<double>(samples);
+        worst = std::max(worst, std::abs(fast(x) - exact(x)));
+    }
+    return worst;
+}
+
+// NOTE: DOCUMENTED BOUNDS (fast-math.hpp)
+TEST(fast_math_test, rsqrt_and_sqrt) {
+    namespace fast = mia::math::fast;
+    const auto rsqrt = [](const double x) { return 1 / std::sqrt(x); };
+    const auto exact_sqrt = [](const double x) { return std::sqrt(x); };
+    EXPECT_LE(max_ulp(fast::rsqrt<float>, rsqrt, 1e-3f, 4.0f), 3u);
+    EXPECT_LE(max_ulp(fast::rsqrt<float>, rsqrt, 1.0f, 1e6f), 3u);
+    EXPECT_LE(max_ulp(fast::sqrt<float>, exact_sqrt, 0.0f, 4.0f), 3u);
+    EXPECT_LE(max_ulp(fast::sqrt<float>, exact_sqrt, 1.0f, 1e6f), 3u);
+    EXPECT_EQ(fast::sqrt(0.0f), 0.0f);
+
+    // double: float estimate & double refinement, or the bit-level guess outside the float range
+    const auto relative = [](const double x) { return fast::rsqrt(x) * std::sqrt(x); };
+    EXPECT_LT(max_absolute(relative, [](double) { return 1.0; }, 1e-3, 4.0), 1e-15);
+    EXPECT_NEAR(fast::rsqrt(1e-300) * 1e-150, 1.0, 1e-13);
+    EXPECT_NEAR(fast::rsqrt(1e300) * 1e150, 1.0, 1e-13);
+}
+
+TEST(fast_math_test, inverse_trigonometry) {
+    namespace fast = mia::math::fast;
+    const auto exact_acos = [](const double x) { return std::acos(x); };
+    const auto exact_atan = [](const double x) { return std::atan(x); };
+    EXPECT_LE(max_ulp(fast::acos<float>, exact_acos, -1.0f, 1.0f), 5u);
+    EXPECT_EQ(fast::acos(1.0f), 0.0f);
+    EXPECT_EQ(fast::acos(1.5f), 0.0f);
+    EXPECT_LE(max_ulp(fast::atan<float>, exact_atan, -4.0f, 4.0f), 2u);
+    EXPECT_LE(max_ulp(fast::atan<float>, exact_atan, 4.0f, 1e6f), 2u);
+
+    // atan2 over the circle, both orders of magnitude of the radius
+    uint32_t worst = 0;
+    for (int i = 0; i < 1 << 16; ++i) {
+        const double theta = 2 * std::numbers::pi * i / (1 << 16);
+        for (const double radius : {1e-3, 7.0}) {
+            const auto y = static_cast<float>(radius * std::sin(theta));
+            const auto x = static_cast<float>(radius * std::cos(theta));
+            worst = std::max(worst, ulp_distance(fast::atan2(y, x), static_cast<float>(std::atan2(double{y}, double{x}))));
+        }
+    }
+    EXPECT_LE(worst, 2u);
+    EXPECT_EQ(fast::atan2(0.0f, 0.0f), 0.0f);
+    EXPECT_EQ(fast::atan2(0.0f, -1.0f), std::numbers::pi_v<float>);
+    EXPECT_EQ(fast::atan2(-1.0f, 0.0f), -std::numbers::pi_v<float> / 2);
+    // Signed zeros on the branch cut follow std::atan2
+    EXPECT_EQ(fast::atan2(-0.0f, -1.0f), -std::numbers::pi_v<float>);
+    EXPECT_EQ(fast::atan2(-0.0f, -1.0f), static_cast<float>(std::atan2(-0.0, -1.0)));
+    EXPECT_TRUE(std::signbit(fast::atan2(-0.0f, 1.0f)));
+    EXPECT_FALSE(std::signbit(fast::atan2(0.0f, 1.0f)));
+
+    EXPECT_LT(max_absolute(fast::acos<double>, exact_acos, -1.0, 1.0), 1e-7);
+    EXPECT_LT(max_absolute(fast::atan<double>, exact_atan, -10.0, 10.0), 1e-7);
+}
+
+TEST(fast_math_test, trigonometry) {
+    namespace fast = mia::math::fast;
+    const auto exact_sin = [](const double x) { return std::sin(x); };
+    const auto exact_cos = [](const double x) { return std::cos(x); };
+
+    // ULP away from the zeros (relative error is unbounded next to them), absolute everywhere
+    EXPECT_LE(max_ulp(fast::sin<float>, exact_sin, 0.1f, 3.0f), 2u);
+    EXPECT_LE(max_ulp(fast::cos<float>, exact_cos, -1.5f, 1.5f), 2u);
+    const auto sin_float = [](const double x) { return double{fast::sin(static_cast<float>(x))}; };
+    const auto cos_float = [](const double x) { return double{fast::cos(static_cast<float>(x))}; };
+    const auto sin_exact_float = [](const double x) { return std::sin(double{static_cast<float>(x)}); };
+    const auto cos_exact_float = [](const double x) { return std::cos(double{static_cast<float>(x)}); };
+    EXPECT_LT(max_absolute(sin_float, sin_exact_float, -1e4, 1e4), 1e-7);
+    EXPECT_LT(max_absolute(cos_float, cos_exact_float, -1e4, 1e4), 1e-7);
+    EXPECT_LT(max_absolute(fast::sin<double>, exact_sin, -100.0, 100.0), 1e-7);
+    EXPECT_LT(max_absolute(fast::cos<double>, exact_cos, -100.0, 100.0), 1e-7);
+}
+
+// NOTE: PRECISION POLICY
+TEST(fast_math_test, vector_precision_policy) {
+    using V = mia::vector<float, 3>;
+    using mia::precision;
+    const V a{3.0f, -4.0f, 12.0f};
+    const V b{1.0f, 2.0f, -0.5f};
+
+    EXPECT_EQ(a.magnitude(), a.magnitude<precision::exact>());
+    EXPECT_NEAR(a.magnitude<precision::fast>(), 13.0f, 13.0f * 3e-7f);
+
+    const V unit = a.normalized<precision::fast>();
+    const V expected = a.normalized();
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(unit[i], expected[i], 3e-7f);
+    }
+    V copy = a;
+    EXPECT_NEAR(copy.normalizing<precision::fast>(), 13.0f, 13.0f * 3e-7f);
+    EXPECT_EQ(copy, unit);
+
+    EXPECT_NEAR(V::angle<precision::fast>(a, b), V::angle(a, b), 1e-6f);
+    EXPECT_NEAR(V::angle<precision::fast>(a, a), 0.0f, 1e-3f);
+    EXPECT_NEAR(V::angle<precision::fast>(a, a * -1.0f), std::numbers::pi_v<float>, 1e-3f);
+    EXPECT_EQ(V::angle<precision::fast>(a, V{}), 0.0f);
+
+    // Expressions forward the policy
+    EXPECT_EQ((a + b).magnitude<precision::fast>(), (a + b).eval().magnitude<precision::fast>());
+}
+
+// NOTE: CONSTANT EVALUATION
+TEST(fast_math_test, constexpr_usable) {
+    namespace fast = mia::math::fast;
+    static_assert(fast::sqrt(16.0f) > 3.9999f && fast::sqrt(16.0f) < 4.0001f);
+    static_assert(fast::acos(1.0) == 0.0);
+    static_assert(fast::atan2(1.0f, 1.0f) > 0.7853f && fast::atan2(1.0f, 1.0f) < 0.7854f);
+    static_assert(fast::sin(0.0f) == 0.0f && fast::cos(0.0f) == 1.0f);
+    static_assert(mia::vector<float, 2>{3.0f, 4.0f}.magnitude<mia::precision::fast>() > 4.9999f);
+    EXPECT_NEAR(fast::rsqrt(4.0f), 0.5f, 1e-7f);
+}
@@ -0,0 +1,221 @@
+#include "math/kd-tree.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <random>
+#include <span>
+#include <vector>
+
+// NOTE: FIXTURE
+namespace {
+
+using V3 = mia::vector<float, 3>;
+using tree = mia::kd_tree<float, 3>;
+using neighbour = tree::neighbour;
+
+class kd_tree_test : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        points.resize(5000);
+        for (V3 &p : points) {
+            p = random_vector();
+        }
+        // A few duplicates & a dense cluster
+        for (size_t i = 0; i < 50; ++i) {
+            points[i + 100] = points[i];
+            points[i + 200] = V3{1.0f, 1.0f, 1.0f} + random_vector() * 0.001f;
+        }
+    }
+
+    auto random_vector() -> V3 {
+        std::uniform_real_distribution<float> coordinate{-10.0f, 10.0f};
+        return V3{coordinate(random), coordinate(random), coordinate(random)};
+    }
+
+    // Squared distances to every point, ascending
+    auto brute_force(const V3 &query) const -> std::vector<float> {
+        std::vector<float> distances;
+        for (const V3 &p : points) {
+            distances.push_back(V3::distance_squared(query, p));
+        }
+        std::sort(distances.begin(), distances.end());
+        return distances;
+    }
+
+    std::mt19937 random{5};
+    std::vector<V3> points;
+};
+
+} // namespace
+
+// NOTE: BUILD
+TEST_F(kd_tree_test, build_permutes_points) {
+    const tree t{points, {.threads = 4, .parallel_threshold = 256}};
+    ASSERT_EQ(t.size(), points.size());
+    std::vector<uint32_t> seen(points.size(), 0);
+    for (size_t i = 0; i < t.size(); ++i) {
+        EXPECT_EQ(t.points()[i], points[t.indices()[i]]);
+        ++seen[t.indices()[i]];
+    }
+    EXPECT_TRUE(std::all_of(seen.begin(), seen.end(), [](const uint32_t s) { return s == 1; }));
+
+    // The thread count does not change the tree
+    const tree serial{points, {.threads = 1}};
+    EXPECT_TRUE(std::equal(serial.indices().begin(), serial.indices().end(), t.indices().begin()));
+
+    // Nor does building on a caller's pool, with one subtree per thread or more subtrees than threads
+    mia::thread_pool pool{3};
+    for (const size_t threads : {size_t{0}, size_t{5}}) {
+        tree on_pool;
+        on_pool.build(pool, points, {.threads = threads, .parallel_threshold = 256});
+        EXPECT_TRUE(std::equal(serial.indices().begin(), serial.indices().end(), on_pool.indices().begin())) << threads;
+    }
+}
+
+// NOTE: NEAREST NEIGHBOURS
+TEST_F(kd_tree_test, nearest_matches_brute_force) {
+    for (const uint32_t bucket : {1u, 8u, 64u}) {
+        const tree t{points, {.bucket_size = bucket}};
+        for (int i = 0; i < 200; ++i) {
+            const V3 query = random_vector() * 1.2f;
+            const auto expected = brute_force(query);
+            const auto found = t.nearest(query);
+            ASSERT_TRUE(found.has_value());
+            EXPECT_EQ(found->distance_squared, expected.front()) << bucket;
+            EXPECT_EQ(V3::distance_squared(query, points[found->index]), expected.front());
+            EXPECT_FALSE(t.nearest(query, expected.front()).has_value());
+        }
+    }
+}
+
+TEST_F(kd_tree_test, k_nearest_matches_brute_force) {
+    const tree t{points};
+    std::vector<neighbour> out(16);
+    for (int i = 0; i < 200; ++i) {
+        const V3 query = i % 4 == 0 ? V3{1.0f, 1.0f, 1.0f} : random_vector();
+        const auto expected = brute_force(query);
+        ASSERT_EQ(t.k_nearest(query, out), out.size());
+        for (size_t j = 0; j < out.size(); ++j) {
+            EXPECT_EQ(out[j].distance_squared, expected[j]) << i << " " << j;
+            EXPECT_EQ(V3::distance_squared(query, points[out[j].index]), expected[j]);
+        }
+
+        // Bounded by a distance
+        const size_t within = t.k_nearest(query, out, expected[5]);
+        EXPECT_EQ(within, static_cast<size_t>(std::lower_bound(expected.begin(), expected.end(), expected[5]) - expected.begin()));
+    }
+}
+
+TEST(kd_tree_edge_test, small_and_empty) {
+    const tree empty{std::span<const V3>{}};
+    EXPECT_TRUE(empty.empty());
+    EXPECT_FALSE(empty.nearest(V3{}).has_value());
+    std::vector<neighbour> out(4);
+    EXPECT_EQ(empty.k_nearest(V3{}, out), 0u);
+    EXPECT_EQ(empty.query(V3{}, 1.0f, [](uint32_t, float) {}), 0u);
+
+    // Fewer points than k
+    const std::vector<V3> three{V3{0.0f, 0.0f, 0.0f}, V3{3.0f, 0.0f, 0.0f}, V3{1.0f, 0.0f, 0.0f}};
+    const tree small{three};
+    ASSERT_EQ(small.k_nearest(V3{}, out), 3u);
+    EXPECT_EQ(out[0].index, 0u);
+    EXPECT_EQ(out[1].index, 2u);
+    EXPECT_EQ(out[2].index, 1u);
+    EXPECT_EQ(out[2].distance_squared, 9.0f);
+    EXPECT_EQ(small.k_nearest(V3{}, std::span<neighbour>{}), 0u);
+}
+
+// NOTE: RADIUS SEARCH
+TEST_F(kd_tree_test, radius_matches_brute_force) {
+    const tree t{points};
+    for (int i = 0; i < 100; ++i) {
+        const V3 center = i % 5 == 0 ? V3{1.0f, 1.0f, 1.0f} : random_vector();
+        const float radius = static_cast<float>(i % 7) * 0.5f;
+        std::vector<uint32_t> found;
+        const size_t count = t.query(center, radius, [&](const uint32_t index, const float d) {
+            EXPECT_EQ(d, V3::distance_squared(center, points[index]));
+            found.push_back(index);
+        });
+        EXPECT_EQ(count, found.size());
+        std::sort(found.begin(), found.end());
+
+        std::vector<uint32_t> expected;
+        for (uint32_t p = 0; p < points.size(); ++p) {
+            if (V3::distance_squared(center, points[p]) <= radius * radius) {
+                expected.push_back(p);
+            }
+        }
+        EXPECT_EQ(found, expected);
+    }
+}
+
+// NOTE: BATCHED QUERIES
+TEST_F(kd_tree_test, batched_queries_match_single) {
+    std::vector<V3> queries(3000);
+    for (V3 &q : queries) {
+        q = random_vector();
+    }
+    constexpr size_t k = 5;
+    for (const size_t threads : {size_t{1}, size_t{4}}) {
+        const tree t{points, {.threads = threads}};
+        std::vector<std::optional<neighbour>> nearest(queries.size());
+        std::vector<neighbour> k_nearest(queries.size() * k);
+        t.nearest(queries, nearest);
+        t.k_nearest(queries, k, k_nearest);
+
+        std::array<neighbour, k> single;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            ASSERT_TRUE(nearest[i].has_value());
+            EXPECT_EQ(nearest[i]->distance_squared, t.nearest(queries[i])->distance_squared);
+            ASSERT_EQ(t.k_nearest(queries[i], single), k);
+            for (size_t j = 0; j < k; ++j) {
+                EXPECT_EQ(k_nearest[i * k + j].distance_squared, single[j].distance_squared);
+            }
+        }
+    }
+
+    // On a caller's pool, in the default chunks or one chunk per option thread
+    mia::thread_pool pool{3};
+    for (const size_t threads : {size_t{0}, size_t{7}}) {
+        const tree t{points, {.threads = threads}};
+        std::vector<std::optional<neighbour>> nearest(queries.size());
+        std::vector<neighbour> k_nearest(queries.size() * k);
+        t.nearest(pool, queries, nearest);
+        t.k_nearest(pool, queries, k, k_nearest);
+        std::array<neighbour, k> single;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            ASSERT_TRUE(nearest[i].has_value());
+            EXPECT_EQ(nearest[i]->index, t.nearest(queries[i])->index);
+            ASSERT_EQ(t.k_nearest(queries[i], single), k);
+            EXPECT_EQ(k_nearest[i * k + k - 1].distance_squared, single[k - 1].distance_squared);
+        }
+    }
+
+    // Missing neighbours are marked
+    const std::vector<V3> two{V3{}, V3{1.0f, 0.0f, 0.0f}};
+    std::vector<neighbour> out(2 * 3);
+    tree{two}.k_nearest(std::span<const V3>{two}, 3, out);
+    EXPECT_EQ(out[2].index, tree::invalid);
+    EXPECT_EQ(out[5].distance_squared, std::numeric_limits<float>::infinity());
+    EXPECT_EQ(out[3].index, 1u);
+}
+
+// NOTE: OTHER INSTANTIATIONS
+TEST(kd_tree_edge_test, double_2d) {
+    using V2 = mia::vector<double, 2>;
+    std::vector<V2> grid;
+    for (int x = 0; x < 30; ++x) {
+        for (int y = 0; y < 30; ++y) {
+            grid.push_back(V2{static_cast<double>(x), static_cast<double>(y)});
+        }
+    }
+    const mia::kd_tree<double, 2> t{grid, {.bucket_size = 2}};
+    EXPECT_EQ(t.nearest(V2{4.2, 7.9})->index, 4u * 30 + 8);
+    EXPECT_EQ(t.query(V2{10.0, 10.0}, 1.0, [](uint32_t, double) {}), 5u);
+}
@@ -0,0 +1,191 @@
+#include "math/matrix.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+
+// NOTE: FIXTURE AND TYPED SETUP
+template <typename T, size_t Ds>
+struct square_type {
+    using type = T;
+    static constexpr size_t dims = Ds;
+};
+using matrix_test_types = ::testing::Types<square_type<float, 2>, square_type<float, 3>, square_type<float, 4>,
+                                           square_type<double, 3>, square_type<double, 4>>;
+
+template <typename Param>
+class typed_matrix_test : public ::testing::Test {
+  public:
+    using type = typename Param::type;
+    static constexpr size_t dims = Param::dims;
+    using matrix_type = mia::matrix<type, dims, dims>;
+    using vector_type = mia::vector<type, dims>;
+
+  protected:
+    void SetUp() override {
+        // Diagonally dominant, so always invertible
+        for (size_t r = 0; r < dims; ++r) {
+            for (size_t c = 0; c < dims; ++c) {
+                m(r, c) = r == c ? static_cast<type>(dims + 3) : static_cast<type>(static_cast<int>(r * 2 + c) % 3 - 1);
+                n(r, c) = static_cast<type>(static_cast<int>(r + c * 3) % 5 - 2);
+            }
+            v[r] = static_cast<type>(static_cast<int>(r) - 1);
+        }
+    }
+
+    matrix_type m;
+    matrix_type n;
+    vector_type v;
+};
+
+TYPED_TEST_SUITE(typed_matrix_test, matrix_test_types);
+
+// NOTE: LAYOUT & ACCESS
+TYPED_TEST(typed_matrix_test, layout) {
+    using T = typename TestFixture::type;
+    constexpr size_t Ds = TestFixture::dims;
+    using M = typename TestFixture::matrix_type;
+
+    EXPECT_EQ(alignof(M) % alignof(typename M::column_type), 0u);
+    EXPECT_EQ(M::rows(), Ds);
+    EXPECT_EQ(M::cols(), Ds);
+
+    // Column-major: element (r, c) lives in column c
+    for (size_t r = 0; r < Ds; ++r) {
+        for (size_t c = 0; c < Ds; ++c) {
+            EXPECT_EQ(this->m(r, c), this->m.column(c)[r]);
+            EXPECT_EQ(this->m(r, c), this->m.row(r)[c]);
+            EXPECT_EQ(this->m(r, c), this->m.transposed()(c, r));
+        }
+    }
+
+    std::array<T, Ds * Ds> elements{};
+    for (size_t i = 0; i < elements.size(); ++i) {
+        elements[i] = static_cast<T>(i);
+    }
+    EXPECT_EQ(M::from_rows(elements), M::from_columns(elements).transposed());
+    EXPECT_EQ(M::from_rows(elements)(0, 1), static_cast<T>(1));
+    EXPECT_EQ(M::from_columns(elements)(1, 0), static_cast<T>(1));
+}
+
+// NOTE: PRODUCTS
+TYPED_TEST(typed_matrix_test, products) {
+    using T = typename TestFixture::type;
+    constexpr size_t Ds = TestFixture::dims;
+    using M = typename TestFixture::matrix_type;
+    using V = typename TestFixture::vector_type;
+
+    EXPECT_EQ(M::identity() * this->v, this->v);
+    EXPECT_EQ(M::identity() * this->m, this->m);
+    EXPECT_EQ(this->m * M::identity(), this->m);
+
+    const V mv = this->m * this->v;
+    const M mn = this->m * this->n;
+    for (size_t r = 0; r < Ds; ++r) {
+        T expected_v{};
+        for (size_t k = 0; k < Ds; ++k) {
+            expected_v += this->m(r, k) * this->v[k];
+        }
+        EXPECT_EQ(mv[r], expected_v);
+        for (size_t c = 0; c < Ds; ++c) {
+            T expected{};
+            for (size_t k = 0; k < Ds; ++k) {
+                expected += this->m(r, k) * this->n(k, c);
+            }
+            EXPECT_EQ(mn(r, c), expected);
+        }
+    }
+
+    // (mn)^T = n^T m^T
+    EXPECT_EQ(mn.transposed(), this->n.transposed() * this->m.transposed());
+
+    M accumulated = this->m;
+    accumulated *= this->n;
+    EXPECT_EQ(accumulated, mn);
+    EXPECT_EQ(this->m + this->m, this->m * T{2});
+    EXPECT_EQ(this->m - this->m, M{});
+    EXPECT_EQ(T{2} * this->m, this->m * T{2});
+}
+
+// NOTE: INVERSE
+TYPED_TEST(typed_matrix_test, inverse) {
+    using T = typename TestFixture::type;
+    constexpr size_t Ds = TestFixture::dims;
+    using M = typename TestFixture::matrix_type;
+
+    const auto inverse = this->m.inverse();
+    ASSERT_TRUE(inverse.has_value());
+    const M product = this->m * *inverse;
+    for (size_t r = 0; r < Ds; ++r) {
+        for (size_t c = 0; c < Ds; ++c) {
+            EXPECT_NEAR(product(r, c), r == c ? 1.0 : 0.0, 1e-5);
+        }
+    }
+    EXPECT_NEAR(this->m.determinant() * inverse->determinant(), 1.0, 1e-4);
+
+    // Two equal rows
+    M singular = this->m;
+    for (size_t c = 0; c < Ds; ++c) {
+        singular(1, c) = singular(0, c);
+    }
+    EXPECT_EQ(singular.determinant(), T{0});
+    EXPECT_FALSE(singular.inverse().has_value());
+}
+
+// NOTE: AFFINE TRANSFORMS
+TEST(matrix_test, affine_transforms) {
+    using M = mia::matrix4<float>;
+    using V3 = mia::vector<float, 3>;
+    const V3 p{1.0f, 2.0f, 3.0f};
+
+    EXPECT_EQ(M::translation(V3{1.0f, -1.0f, 2.0f}).transform_point(p), (V3{2.0f, 1.0f, 5.0f}));
+    EXPECT_EQ(M::translation(V3{1.0f, -1.0f, 2.0f}).transform_direction(p), p);
+    EXPECT_EQ(M::scaling(V3{2.0f, 3.0f, 4.0f}).transform_point(p), (V3{2.0f, 6.0f, 12.0f}));
+
+    // A quarter turn around +z takes +x to +y, the 3x3 agrees with the 4x4
+    const M rotation = M::rotation(V3{0.0f, 0.0f, 2.0f}, std::numbers::pi_v<float> / 2);
+    const V3 turned = rotation.transform_direction(V3{1.0f, 0.0f, 0.0f});
+    EXPECT_NEAR(turned.x(), 0.0f, 1e-6);
+    EXPECT_NEAR(turned.y(), 1.0f, 1e-6);
+    EXPECT_NEAR(turned.z(), 0.0f, 1e-6);
+    const V3 turned3 = mia::matrix3<float>::rotation(V3{0.0f, 0.0f, 1.0f}, std::numbers::pi_v<float> / 2) * V3{1.0f, 0.0f, 0.0f};
+    EXPECT_NEAR(turned3.y(), 1.0f, 1e-6);
+
+    // Rotations are orthonormal
+    const auto inverse = rotation.inverse();
+    ASSERT_TRUE(inverse.has_value());
+    for (size_t r = 0; r < 4; ++r) {
+        for (size_t c = 0; c < 4; ++c) {
+            EXPECT_NEAR((*inverse)(r, c), rotation(c, r), 1e-6);
+        }
+    }
+
+    // Composition applies right to left
+    const M scale_then_move = M::translation(V3{1.0f, 0.0f, 0.0f}) * M::scaling(V3{2.0f, 2.0f, 2.0f});
+    EXPECT_EQ(scale_then_move.transform_point(p), (V3{3.0f, 4.0f, 6.0f}));
+
+    // 2D homogeneous
+    using M3 = mia::matrix3<float>;
+    const mia::vector<float, 3> p2{1.0f, 2.0f, 1.0f};
+    EXPECT_EQ(M3::translation(mia::vector<float, 2>{3.0f, 4.0f}) * p2, (mia::vector<float, 3>{4.0f, 6.0f, 1.0f}));
+}
+
+// NOTE: NON-SQUARE & CONSTANT EVALUATION
+TEST(matrix_test, non_square_and_constexpr) {
+    using M23 = mia::matrix<int, 2, 3>;
+    using M32 = mia::matrix<int, 3, 2>;
+    constexpr M23 a = M23::from_rows({1, 2, 3,
+                                      4, 5, 6});
+    constexpr M32 b = a.transposed();
+    constexpr mia::matrix<int, 2, 2> ab = a * b;
+    static_assert(ab(0, 0) == 14 && ab(0, 1) == 32 && ab(1, 0) == 32 && ab(1, 1) == 77);
+    static_assert(a * mia::vector<int, 3>{1, 0, -1} == mia::vector<int, 2>{-2, -2});
+
+    using M4 = mia::matrix4<float>;
+    constexpr M4 moved = M4::translation(mia::vector<float, 3>{1.0f, 2.0f, 3.0f});
+    static_assert(moved * M4::identity() == moved);
+    static_assert(moved.inverse().value()(0, 3) == -1.0f);
+    EXPECT_EQ(ab.determinant(), 14 * 77 - 32 * 32);
+}
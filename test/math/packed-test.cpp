@@ -0,0 +1,217 @@
+#include "math/packed.hpp"
+
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace {
+
+using V3 = mia::vector<float, 3>;
+
+} // namespace
+
+// NOTE: LAYOUT
+static_assert(sizeof(mia::half3) == 6);
+static_assert(sizeof(mia::snorm16x3) == 6);
+static_assert(sizeof(mia::unorm8x4) == 4);
+static_assert(sizeof(mia::oct16) == 4);
+static_assert(sizeof(mia::oct8) == 2);
+
+// NOTE: HALF PRECISION
+static_assert(mia::float_to_half(1.0f) == 0x3C00);
+static_assert(mia::float_to_half(-2.0f) == 0xC000);
+static_assert(mia::float_to_half(65504.0f) == 0x7BFF);
+static_assert(mia::float_to_half(65520.0f) == 0x7C00); // rounds up past the largest half
+static_assert(mia::float_to_half(0x1p-24f) == 0x0001);
+static_assert(mia::float_to_half(0x1p-25f) == 0x0000); // tie to even
+static_assert(mia::half_to_float(0x3555) == 0x1.554p-2f);
+static_assert(mia::half_to_float(0x8001) == -0x1p-24f);
+static_assert(mia::half3::encode(V3{0.5f, -1.0f, 0.0f}).decode() == V3{0.5f, -1.0f, 0.0f});
+
+TEST(half_test, every_half_round_trips) {
+    for (uint32_t bits = 0; bits <= 0xFFFF; ++bits) {
+        const auto half = static_cast<uint16_t>(bits);
+        const float value = mia::half_to_float(half);
+        if (std::isnan(value)) {
+            EXPECT_TRUE(std::isnan(mia::half_to_float(mia::float_to_half(value))));
+            continue;
+        }
+        EXPECT_EQ(mia::float_to_half(value), half) << bits;
+#if defined(__FLT16_MAX__)
+        EXPECT_EQ(value, static_cast<float>(std::bit_cast<_Float16>(half))) << bits;
+#endif
+    }
+}
+
+#if defined(__FLT16_MAX__)
+TEST(half_test, encode_matches_float16) {
+    // Random bit patterns cover every exponent, rounding ties & overflow included
+    std::mt19937 random{11};
+    for (int i = 0; i < 1'000'000; ++i) {
+        const uint32_t bits = static_cast<uint32_t>(random()) & (i % 2 == 0 ? 0xFFFF'FFFFu : 0xC7FF'E000u | 0x1000u);
+        const float value = std::bit_cast<float>(bits);
+        if (std::isnan(value)) {
+            continue;
+        }
+        EXPECT_EQ(mia::float_to_half(value), std::bit_cast<uint16_t>(static_cast<_Float16>(value))) << value;
+    }
+}
+#endif
+
+// NOTE: QUANTIZED
+TEST(quantized_test, snorm_and_unorm) {
+    using snorm16 = mia::snorm_format<int16_t>;
+    using unorm8 = mia::unorm_format<uint8_t>;
+    EXPECT_EQ(snorm16::encode(1.0f), 32767);
+    EXPECT_EQ(snorm16::encode(-1.0f), -32767);
+    EXPECT_EQ(snorm16::encode(-4.0f), -32767);
+    EXPECT_EQ(snorm16::encode(0.0f), 0);
+    EXPECT_EQ(snorm16::decode(-32768), -1.0f);
+    EXPECT_EQ(snorm16::decode(32767), 1.0f);
+    EXPECT_EQ(unorm8::encode(2.0f), 255);
+    EXPECT_EQ(unorm8::encode(-1.0f), 0);
+    EXPECT_EQ(unorm8::encode(std::numeric_limits<float>::quiet_NaN()), 0);
+    EXPECT_EQ(unorm8::decode(255), 1.0f);
+
+    // Rounded to nearest: within half a step
+    for (int i = -1000; i <= 1000; ++i) {
+        const float value = static_cast<float>(i) / 1000.0f;
+        EXPECT_LE(std::abs(snorm16::decode(snorm16::encode(value)) - value), 0.5f / 32767.0f + 1e-7f) << value;
+        EXPECT_LE(std::abs(mia::snorm_format<int8_t>::decode(mia::snorm_format<int8_t>::encode(value)) - value), 0.5f / 127.0f + 1e-7f);
+        if (value >= 0.0f) {
+            EXPECT_LE(std::abs(unorm8::decode(unorm8::encode(value)) - value), 0.5f / 255.0f + 1e-7f);
+        }
+    }
+}
+
+// NOTE: OCTAHEDRAL NORMALS
+namespace {
+
+auto random_normals(const size_t count, const uint32_t seed) -> std::vector<V3> {
+    std::mt19937 random{seed};
+    std::normal_distribution<float> coordinate{0.0f, 1.0f};
+    std::vector<V3> normals(count);
+    for (auto &n : normals) {
+        n = V3{coordinate(random), coordinate(random), coordinate(random)}.normalized();
+    }
+    return normals;
+}
+
+// Chord based, acos loses everything under ~3e-4 rad in float
+auto angle(const V3 &a, const V3 &b) -> float {
+    return 2.0f * std::asin(std::min(1.0f, static_cast<float>(V3::distance(a, b)) / 2.0f));
+}
+
+} // namespace
+
+TEST(octahedral_test, angular_error) {
+    float max16 = 0.0f;
+    float max8 = 0.0f;
+    for (const auto &n : random_normals(100'000, 4)) {
+        const auto decoded = mia::oct16::encode(n).decode();
+        EXPECT_NEAR(decoded.magnitude(), 1.0f, 1e-6f);
+        max16 = std::max(max16, angle(n, decoded));
+        max8 = std::max(max8, angle(n, mia::oct8::encode(n).decode()));
+    }
+    EXPECT_LT(max16, 1e-4f);
+    EXPECT_LT(max8, 0.025f);
+
+    // Axes, both hemispheres, and the zero vector
+    for (const float s : {1.0f, -1.0f}) {
+        for (size_t axis = 0; axis < 3; ++axis) {
+            V3 n;
+            n[axis] = s;
+            EXPECT_EQ(mia::oct16::encode(n).decode(), n) << axis << " " << s;
+        }
+    }
+    EXPECT_EQ(mia::oct16::encode(V3{}).decode(), (V3{0.0f, 0.0f, 1.0f}));
+}
+
+// NOTE: BATCH
+namespace {
+
+// Not a multiple of any kernel width, specials & out of range values included
+template <size_t Dims>
+auto batch_inputs() -> std::vector<mia::vector<float, Dims>> {
+    std::mt19937 random{7};
+    std::uniform_real_distribution<float> coordinate{-1.25f, 1.25f};
+    std::vector<mia::vector<float, Dims>> inputs(1001);
+    for (auto &v : inputs) {
+        for (size_t d = 0; d < Dims; ++d) {
+            v[d] = coordinate(random);
+        }
+    }
+    inputs[3][0] = std::numeric_limits<float>::infinity();
+    inputs[4][1] = 1e-6f;
+    inputs[5][0] = -0.0f;
+    inputs[6][0] = 70000.0f;
+    return inputs;
+}
+
+template <typename Format, size_t Dims>
+void expect_kernels_match() {
+    using packed = mia::packed_vector<Format, Dims>;
+    using V = mia::vector<float, Dims>;
+    const auto inputs = batch_inputs<Dims>();
+
+    std::vector<packed> encoded(inputs.size());
+    mia::batch::encode<Format, Dims>(inputs, encoded);
+    std::vector<V> decoded(inputs.size());
+    mia::batch::decode<Format, Dims>(encoded, decoded);
+    // The SIMD rounding may take the other side of an exact tie
+    const int tolerance = std::is_same_v<Format, mia::half_format> ? 0 : 1;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const packed expected = packed::encode(inputs[i]);
+        for (size_t d = 0; d < Dims; ++d) {
+            EXPECT_LE(std::abs(static_cast<int>(encoded[i].data[d]) - static_cast<int>(expected.data[d])), tolerance) << i;
+        }
+        EXPECT_EQ(decoded[i], encoded[i].decode()) << i;
+    }
+}
+
+} // namespace
+
+TEST(packed_batch_test, matches_single_encode) {
+    expect_kernels_match<mia::half_format, 2>();
+    expect_kernels_match<mia::half_format, 3>();
+    expect_kernels_match<mia::half_format, 4>();
+    expect_kernels_match<mia::snorm_format<int16_t>, 3>();
+    expect_kernels_match<mia::snorm_format<int8_t>, 4>();
+    expect_kernels_match<mia::unorm_format<uint8_t>, 4>();
+    expect_kernels_match<mia::unorm_format<uint16_t>, 3>();
+}
+
+TEST(packed_batch_test, octahedral_matches_single_encode) {
+    auto normals = random_normals(1003, 8);
+    normals[10] = V3{};
+    normals[11] = V3{0.0f, 0.0f, -1.0f};
+
+    std::vector<mia::oct16> encoded(normals.size());
+    mia::batch::encode<int16_t>(normals, encoded);
+    std::vector<V3> decoded(normals.size());
+    mia::batch::decode<int16_t>(encoded, decoded);
+    std::vector<mia::oct8> encoded8(normals.size());
+    mia::batch::encode<int8_t>(normals, encoded8);
+    std::vector<V3> decoded8(normals.size());
+    mia::batch::decode<int8_t>(encoded8, decoded8);
+
+    for (size_t i = 0; i < normals.size(); ++i) {
+        const auto expected = mia::oct16::encode(normals[i]);
+        EXPECT_LE(std::abs(encoded[i].data[0] - expected.data[0]), 1) << i;
+        EXPECT_LE(std::abs(encoded[i].data[1] - expected.data[1]), 1) << i;
+        EXPECT_LE(V3::distance(decoded[i], encoded[i].decode()), 1e-6f) << i;
+
+        const auto expected8 = mia::oct8::encode(normals[i]);
+        EXPECT_LE(std::abs(encoded8[i].data[0] - expected8.data[0]), 1) << i;
+        EXPECT_LE(std::abs(encoded8[i].data[1] - expected8.data[1]), 1) << i;
+        EXPECT_LE(V3::distance(decoded8[i], encoded8[i].decode()), 1e-6f) << i;
+    }
+}
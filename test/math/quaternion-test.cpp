@@ -0,0 +1,192 @@
+#include "math/quaternion.hpp"
+#include "math/batch.hpp"
+#include "math/vector-soa.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <vector>
+
+// NOTE: FIXTURE AND TYPED SETUP
+template <typename T>
+class typed_quaternion_test : public ::testing::Test {
+  public:
+    using type = T;
+    using quaternion_type = mia::quaternion<T>;
+    using vector_type = mia::vector<T, 3>;
+
+  protected:
+    static auto near(const vector_type &a, const vector_type &b, const double tolerance) -> bool {
+        for (size_t d = 0; d < 3; ++d) {
+            if (std::abs(static_cast<double>(a[d] - b[d])) > tolerance) {
+                return false;
+            }
+        }
+        return true;
+    }
+    // Angle between the rotations, q and -q are the same rotation
+    // From the chord rather than acos(dot), which loses everything below ~1e-3 radians in float
+    static auto angle_between(const quaternion_type &a, const quaternion_type &b) -> double {
+        const double sign = quaternion_type::dot(a, b) < 0 ? -1.0 : 1.0;
+        double chord_squared = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            const double d = static_cast<double>(a.data[i]) - sign * static_cast<double>(b.data[i]);
+            chord_squared += d * d;
+        }
+        return 4.0 * std::asin(std::min(1.0, std::sqrt(chord_squared) / 2.0));
+    }
+
+    const T pi = std::numbers::pi_v<T>;
+};
+
+using quaternion_test_types = ::testing::Types<float, double>;
+TYPED_TEST_SUITE(typed_quaternion_test, quaternion_test_types);
+
+// NOTE: ROTATION
+TYPED_TEST(typed_quaternion_test, rotate) {
+    using T = typename TestFixture::type;
+    using Q = typename TestFixture::quaternion_type;
+    using V = typename TestFixture::vector_type;
+
+    EXPECT_EQ(Q::identity().rotate(V{1, 2, 3}), (V{1, 2, 3}));
+
+    // A quarter turn around +z takes +x to +y
+    const Q quarter = Q::from_axis_angle(V{0, 0, 5}, this->pi / 2);
+    EXPECT_TRUE(this->near(quarter.rotate(V{1, 0, 0}), V{0, 1, 0}, 1e-6));
+    EXPECT_TRUE(this->near(quarter * V{0, 1, 0}, V{-1, 0, 0}, 1e-6));
+    EXPECT_NEAR(quarter.magnitude(), T{1}, 1e-6);
+
+    // Composition applies right to left, the inverse undoes
+    const Q tilt = Q::from_axis_angle(V{1, 0, 0}, this->pi / 2);
+    const V v{1, 2, 3};
+    EXPECT_TRUE(this->near((tilt * quarter).rotate(v), tilt.rotate(quarter.rotate(v)), 1e-5));
+    EXPECT_TRUE(this->near(quarter.inverse().rotate(quarter.rotate(v)), v, 1e-5));
+    EXPECT_TRUE(this->near(quarter.conjugate().rotate(quarter.rotate(v)), v, 1e-5));
+
+    Q accumulated = tilt;
+    accumulated *= quarter;
+    EXPECT_EQ(accumulated, tilt * quarter);
+}
+
+// NOTE: MATRIX CONVERSION
+TYPED_TEST(typed_quaternion_test, matrix_conversion) {
+    using Q = typename TestFixture::quaternion_type;
+    using V = typename TestFixture::vector_type;
+    using T = typename TestFixture::type;
+
+    // Cover all four branches of from_matrix (large w, x, y & z)
+    const Q rotations[] = {Q::from_axis_angle(V{1, 2, 3}, T(0.3)), Q::from_axis_angle(V{T(1), T(0.1), T(0)}, T(3.0)),
+                           Q::from_axis_angle(V{T(0.1), T(1), T(0.2)}, T(3.0)), Q::from_axis_angle(V{T(0), T(0.2), T(1)}, T(-3.0))};
+    const V v{T(0.5), T(-2), T(1)};
+    for (const Q &q : rotations) {
+        const auto m3 = q.to_matrix3();
+        const auto m4 = q.to_matrix4();
+        EXPECT_TRUE(this->near(m3 * v, q.rotate(v), 1e-5));
+        EXPECT_TRUE(this->near(m4.transform_direction(v), q.rotate(v), 1e-5));
+        EXPECT_NEAR(m3.determinant(), T{1}, 1e-5);
+
+        EXPECT_LT(this->angle_between(Q::from_matrix(m3), q), 1e-3);
+        EXPECT_LT(this->angle_between(Q::from_matrix(m4), q), 1e-3);
+    }
+
+    // Agrees with the axis-angle matrix
+    const auto expected = mia::matrix3<T>::rotation(V{1, 2, 3}, T(0.3));
+    const auto m = rotations[0].to_matrix3();
+    for (size_t r = 0; r < 3; ++r) {
+        for (size_t c = 0; c < 3; ++c) {
+            EXPECT_NEAR(m(r, c), expected(r, c), 1e-6);
+        }
+    }
+}
+
+// NOTE: INTERPOLATION
+TYPED_TEST(typed_quaternion_test, interpolation) {
+    using T = typename TestFixture::type;
+    using Q = typename TestFixture::quaternion_type;
+    using V = typename TestFixture::vector_type;
+
+    const V axis{1, 1, 0};
+    const Q from = Q::from_axis_angle(axis, T(0.2));
+    const Q to = Q::from_axis_angle(axis, T(2.2));
+
+    for (int i = 0; i <= 10; ++i) {
+        const T alpha = static_cast<T>(i) / 10;
+        const Q expected = Q::from_axis_angle(axis, T(0.2) + alpha * 2);
+        EXPECT_LT(this->angle_between(Q::slerp(from, to, alpha), expected), 1e-5);
+        EXPECT_NEAR(Q::nlerp(from, to, alpha).magnitude(), T{1}, 1e-6);
+    }
+
+    // Ends are exact, and the short arc is taken when the signs disagree
+    EXPECT_LT(this->angle_between(Q::nlerp(from, to, 0), from), 1e-6);
+    EXPECT_LT(this->angle_between(Q::slerp(from, to, 1), to), 1e-6);
+    const Q negated{-to.x(), -to.y(), -to.z(), -to.w()};
+    EXPECT_LT(this->angle_between(Q::slerp(from, negated, T(0.5)), Q::slerp(from, to, T(0.5))), 1e-5);
+
+    // Nearly parallel falls back to nlerp
+    const Q close = Q::from_axis_angle(axis, T(0.2001));
+    EXPECT_NEAR(Q::slerp(from, close, T(0.5)).magnitude(), T{1}, 1e-6);
+}
+
+// NOTE: APPROXIMATION ERROR
+// Worst case of slerp_fast against slerp over angles up to 180 degrees, the bound is the one documented in quaternion.hpp
+TYPED_TEST(typed_quaternion_test, slerp_fast_error) {
+    using T = typename TestFixture::type;
+    using Q = typename TestFixture::quaternion_type;
+    using V = typename TestFixture::vector_type;
+
+    double worst_fast = 0;
+    double worst_nlerp = 0;
+    for (int a = 1; a <= 36; ++a) {
+        const Q from = Q::from_axis_angle(V{0, 1, 0}, T(0.1));
+        const Q to = Q::from_axis_angle(V{T(0.3), T(1), T(0.2)}, static_cast<T>(a) * this->pi / 36);
+        for (int i = 0; i <= 32; ++i) {
+            const T alpha = static_cast<T>(i) / 32;
+            const Q exact = Q::slerp(from, to, alpha);
+            worst_fast = std::max(worst_fast, this->angle_between(Q::slerp_fast(from, to, alpha), exact));
+            worst_nlerp = std::max(worst_nlerp, this->angle_between(Q::nlerp(from, to, alpha), exact));
+        }
+    }
+    EXPECT_LT(worst_fast, 1e-3);
+    EXPECT_LT(worst_fast, worst_nlerp / 10);
+}
+
+// NOTE: BATCHED ROTATION
+TYPED_TEST(typed_quaternion_test, batch_rotate) {
+    using T = typename TestFixture::type;
+    using Q = typename TestFixture::quaternion_type;
+    using V = typename TestFixture::vector_type;
+
+    const Q q = Q::from_axis_angle(V{T(1), T(-2), T(0.5)}, T(1.1));
+    std::vector<V> points;
+    for (size_t i = 0; i < 37; ++i) {
+        points.push_back(V{static_cast<T>(i), T{1} - static_cast<T>(i % 5), static_cast<T>(i) / 3});
+    }
+
+    std::vector<V> out(points.size());
+    mia::batch::rotate<T>(q, points, out);
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_TRUE(this->near(out[i], q.rotate(points[i]), 1e-4)) << i;
+    }
+
+    mia::vector_soa<T, 3> soa{std::span<const V>(points)};
+    mia::vector_soa<T, 3>::rotate(q, soa, soa);
+    ASSERT_EQ(soa.size(), points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_TRUE(this->near(soa[i].load(), q.rotate(points[i]), 1e-4)) << i;
+    }
+}
+
+// NOTE: CONSTANT EVALUATION
+TEST(quaternion_test, constexpr_usable) {
+    using Q = mia::quaternion<float>;
+    using V = mia::vector<float, 3>;
+    // Half turn around +z
+    constexpr Q half{0.0f, 0.0f, 1.0f, 0.0f};
+    static_assert(half.rotate(V{1.0f, 0.0f, 0.0f}) == V{-1.0f, 0.0f, 0.0f});
+    static_assert(half * half == Q{0.0f, 0.0f, 0.0f, -1.0f});
+    static_assert(half.to_matrix3()(0, 0) == -1.0f);
+    static_assert(half.inverse() == half.conjugate());
+    EXPECT_EQ(Q::identity(), Q{});
+}
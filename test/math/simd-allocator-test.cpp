@@ -0,0 +1,107 @@
+#include "math/math-utilities.hpp"
+#include "math/thread-pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <vector>
+
+template <typename Allocator>
+static auto is_aligned(const typename Allocator::value_type *p) -> bool {
+    return reinterpret_cast<uintptr_t>(p) % Allocator::alignment == 0;
+}
+
+// NOTE: ALIGNMENT
+TEST(simd_allocator_test, alignments) {
+    std::vector<float, mia::simd_allocator<float>> sse(3);
+    std::vector<float, mia::avx_allocator<float>> avx(5);
+    std::vector<double, mia::avx512_allocator<double>> avx512(7);
+    std::vector<char, mia::simd_allocator<char, MIA_PAGE_ALIGNMENT>> page(1);
+    std::vector<float, mia::simd_allocator<float, 256>> wide(1);
+
+    EXPECT_TRUE(is_aligned<decltype(sse)::allocator_type>(sse.data()));
+    EXPECT_TRUE(is_aligned<decltype(avx)::allocator_type>(avx.data()));
+    EXPECT_TRUE(is_aligned<decltype(avx512)::allocator_type>(avx512.data()));
+    EXPECT_TRUE(is_aligned<decltype(page)::allocator_type>(page.data()));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(wide.data()) % 256, 0u);
+
+    // Sizes that are not a multiple of the alignment
+    for (size_t n = 1; n < 40; ++n) {
+        avx512.assign(n * 3, 1.0);
+        EXPECT_TRUE(is_aligned<decltype(avx512)::allocator_type>(avx512.data()));
+        EXPECT_EQ(avx512.back(), 1.0);
+    }
+}
+
+TEST(simd_allocator_test, rebind_keeps_alignment) {
+    using allocator = mia::avx512_allocator<int>;
+    using rebound = std::allocator_traits<allocator>::rebind_alloc<double>;
+    static_assert(rebound::alignment == allocator::alignment);
+    static_assert(std::is_same_v<rebound::value_type, double>);
+
+    // Node containers allocate rebound types
+    std::list<int, allocator> l{1, 2, 3};
+    EXPECT_EQ(l.back(), 3);
+
+    EXPECT_TRUE(allocator() == rebound(allocator()));
+}
+
+// NOTE: LARGE BUFFERS
+TEST(simd_allocator_test, huge_pages) {
+    using allocator = mia::simd_allocator<float, MIA_CACHE_LINE_ALIGNMENT, mia::memory_policy::huge_pages>;
+
+    // Below the threshold this is a plain aligned allocation
+    std::vector<float, allocator> small(100, 2.0f);
+    EXPECT_TRUE(is_aligned<allocator>(small.data()));
+
+    const size_t n = 3 * MIA_HUGE_PAGE_SIZE / sizeof(float) + 17;
+    std::vector<float, allocator> large(n, 1.0f);
+    EXPECT_TRUE(is_aligned<allocator>(large.data()));
+    if (mia::detail::huge_pages_available()) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(large.data()) % MIA_HUGE_PAGE_SIZE, 0u);
+    }
+    EXPECT_EQ(large.front(), 1.0f);
+    EXPECT_EQ(large.back(), 1.0f);
+
+    // Growth goes through deallocate() with the same size rule
+    large.resize(2 * n, 3.0f);
+    EXPECT_EQ(large[n - 1], 1.0f);
+    EXPECT_EQ(large.back(), 3.0f);
+}
+
+// NOTE: FIRST TOUCH
+// Pages are split by any executor with a range parallel_for
+struct serial_executor {
+    size_t calls = 0;
+    template <typename F>
+    void parallel_for(const size_t begin, const size_t end, F &&body) {
+        ++calls;
+        body(begin, end);
+    }
+};
+
+TEST(simd_allocator_test, first_touch_writes_every_page) {
+    using allocator = mia::simd_allocator<char, MIA_PAGE_ALIGNMENT>;
+    const size_t bytes = 10 * MIA_PAGE_ALIGNMENT + 5;
+    allocator a;
+    char *p = a.allocate(bytes);
+    std::fill_n(p, bytes, 'x');
+
+    mia::thread_pool pool{4};
+    mia::first_touch(p, bytes, pool);
+    for (size_t i = 0; i < bytes; i += MIA_PAGE_ALIGNMENT) {
+        EXPECT_EQ(p[i], 0) << i;
+    }
+    EXPECT_EQ(p[1], 'x');
+    EXPECT_EQ(p[bytes - 1], 'x');
+
+    std::fill_n(p, bytes, 'x');
+    serial_executor serial;
+    mia::first_touch(p, bytes, serial);
+    EXPECT_EQ(serial.calls, 1u);
+    EXPECT_EQ(p[10 * MIA_PAGE_ALIGNMENT], 0);
+    a.deallocate(p, bytes);
+}
@@ -0,0 +1,230 @@
+#include "math/simd.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// NOTE: FIXTURE AND TYPED SETUP
+template <typename T, size_t N>
+struct simd_type {
+    using type = T;
+    static constexpr size_t width = N;
+};
+using simd_test_types = ::testing::Types<simd_type<float, 4>, simd_type<float, 8>, simd_type<float, 16>, simd_type<float, 3>, simd_type<float, 1>,
+                                         simd_type<double, 2>, simd_type<double, 4>, simd_type<double, 8>, simd_type<int32_t, 4>>;
+
+template <typename Param>
+class typed_simd_test : public ::testing::Test {
+  public:
+    using type = typename Param::type;
+    static constexpr size_t width = Param::width;
+    using simd_type = mia::simd<type, width>;
+    using lanes_type = std::array<type, width>;
+
+  protected:
+    // Small integers & halves, every lane-wise result is exact
+    void SetUp() override {
+        for (size_t i = 0; i < width; ++i) {
+            xs[i] = static_cast<type>(static_cast<int>(i * 5 % 11) - 5);
+            ys[i] = static_cast<type>(static_cast<int>(i * 3 % 7) - 3);
+            zs[i] = static_cast<type>(i + 1);
+            if constexpr (std::is_floating_point_v<type>) {
+                xs[i] += static_cast<type>(0.5);
+            }
+            if (ys[i] == type{0}) {
+                ys[i] = type{2};
+            }
+        }
+    }
+
+    static auto lanes(const simd_type &v) -> lanes_type {
+        alignas(64) lanes_type result;
+        v.store(result.data());
+        return result;
+    }
+
+    alignas(64) lanes_type xs;
+    alignas(64) lanes_type ys;
+    alignas(64) lanes_type zs;
+};
+
+TYPED_TEST_SUITE(typed_simd_test, simd_test_types);
+
+// NOTE: MEMORY
+TYPED_TEST(typed_simd_test, load_store_and_gather) {
+    using T = typename TestFixture::type;
+    constexpr size_t N = TestFixture::width;
+    using S = typename TestFixture::simd_type;
+
+    EXPECT_EQ(S::width, N);
+    EXPECT_GE(S::alignment, alignof(T));
+    EXPECT_EQ(TestFixture::lanes(S::load(this->xs.data())), this->xs);
+    EXPECT_EQ(TestFixture::lanes(S{}), typename TestFixture::lanes_type{});
+    std::array<T, N> sevens;
+    sevens.fill(T{7});
+    EXPECT_EQ(TestFixture::lanes(S{T{7}}), sevens);
+
+    // Unaligned, one element past an aligned address
+    alignas(64) std::array<T, N + 1> shifted{};
+    std::copy(this->xs.begin(), this->xs.end(), shifted.begin() + 1);
+    const S loaded = S::loadu(shifted.data() + 1);
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT_EQ(loaded[i], this->xs[i]) << i;
+    }
+    std::array<T, N + 1> out{};
+    loaded.storeu(out.data() + 1);
+    EXPECT_EQ(out, shifted);
+
+    // Gathers, by index & by stride
+    std::array<T, 3 * N> base;
+    for (size_t i = 0; i < base.size(); ++i) {
+        base[i] = static_cast<T>(i * 2);
+    }
+    std::array<int32_t, N> indices;
+    for (size_t i = 0; i < N; ++i) {
+        indices[i] = static_cast<int32_t>((N - 1 - i) * 3);
+    }
+    const S by_index = S::gather(base.data(), indices.data());
+    const S by_stride = S::gather(base.data() + 1, size_t{3});
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT_EQ(by_index[i], base[static_cast<size_t>(indices[i])]) << i;
+        EXPECT_EQ(by_stride[i], base[1 + i * 3]) << i;
+    }
+}
+
+// NOTE: LANE-WISE OPERATIONS MATCH SCALARS
+TYPED_TEST(typed_simd_test, arithmetic) {
+    using T = typename TestFixture::type;
+    constexpr size_t N = TestFixture::width;
+    using S = typename TestFixture::simd_type;
+
+    const S a = S::load(this->xs.data());
+    const S b = S::load(this->ys.data());
+    const S c = S::load(this->zs.data());
+    S compound = a;
+    compound += b;
+    compound *= c;
+    compound -= a;
+    compound /= b;
+    const auto sum = TestFixture::lanes(a + b);
+    const auto difference = TestFixture::lanes(a - b);
+    const auto product = TestFixture::lanes(a * b);
+    const auto quotient = TestFixture::lanes(a / b);
+    const auto negated = TestFixture::lanes(-a);
+    const auto fused = TestFixture::lanes(fma(a, b, c));
+    const auto mixed = TestFixture::lanes(a * T{2} + T{1});
+    const auto lowest = TestFixture::lanes(min(a, b));
+    const auto highest = TestFixture::lanes(max(a, b));
+    const auto absolute = TestFixture::lanes(abs(a));
+    const auto chained = TestFixture::lanes(compound);
+    for (size_t i = 0; i < N; ++i) {
+        const T x = this->xs[i];
+        const T y = this->ys[i];
+        const T z = this->zs[i];
+        EXPECT_EQ(sum[i], static_cast<T>(x + y)) << i;
+        EXPECT_EQ(difference[i], static_cast<T>(x - y)) << i;
+        EXPECT_EQ(product[i], static_cast<T>(x * y)) << i;
+        EXPECT_EQ(quotient[i], static_cast<T>(x / y)) << i;
+        EXPECT_EQ(negated[i], static_cast<T>(-x)) << i;
+        EXPECT_EQ(fused[i], static_cast<T>(x * y + z)) << i;
+        EXPECT_EQ(mixed[i], static_cast<T>(x * T{2} + T{1})) << i;
+        EXPECT_EQ(lowest[i], std::min(x, y)) << i;
+        EXPECT_EQ(highest[i], std::max(x, y)) << i;
+        EXPECT_EQ(absolute[i], x < T{0} ? static_cast<T>(-x) : x) << i;
+        EXPECT_EQ(chained[i], static_cast<T>(static_cast<T>(static_cast<T>((x + y) * z) - x) / y)) << i;
+    }
+
+    if constexpr (std::is_floating_point_v<T>) {
+        const S squares = c * c;
+        const auto roots = TestFixture::lanes(sqrt(squares));
+        const auto inverse_roots = TestFixture::lanes(rsqrt(squares));
+        for (size_t i = 0; i < N; ++i) {
+            EXPECT_EQ(roots[i], this->zs[i]) << i;
+            EXPECT_NEAR(inverse_roots[i], T{1} / this->zs[i], T{1} / this->zs[i] * static_cast<T>(1e-6)) << i;
+        }
+    }
+}
+
+TYPED_TEST(typed_simd_test, comparisons_and_select) {
+    constexpr size_t N = TestFixture::width;
+    using S = typename TestFixture::simd_type;
+
+    const S a = S::load(this->xs.data());
+    const S b = S::load(this->ys.data());
+    uint64_t less = 0;
+    uint64_t less_equal = 0;
+    uint64_t equal = 0;
+    for (size_t i = 0; i < N; ++i) {
+        less |= static_cast<uint64_t>(this->xs[i] < this->ys[i]) << i;
+        less_equal |= static_cast<uint64_t>(this->xs[i] <= this->ys[i]) << i;
+        equal |= static_cast<uint64_t>(this->xs[i] == this->ys[i]) << i;
+    }
+    const uint64_t all = (uint64_t{1} << N) - 1;
+    EXPECT_EQ((a < b).bits(), less);
+    EXPECT_EQ((a <= b).bits(), less_equal);
+    EXPECT_EQ((a == b).bits(), equal);
+    EXPECT_EQ((a != b).bits(), all & ~equal);
+    EXPECT_EQ((a > b).bits(), all & ~less_equal);
+    EXPECT_EQ((a >= b).bits(), all & ~less);
+    EXPECT_EQ((a < b || a == b).bits(), less_equal);
+    EXPECT_EQ((a <= b && !(a < b)).bits(), equal);
+    EXPECT_TRUE((a == a).all());
+    EXPECT_TRUE((a != a).none());
+    EXPECT_FALSE((a != a).any());
+    EXPECT_EQ((a < b)[0], this->xs[0] < this->ys[0]);
+
+    const auto selected = TestFixture::lanes(select(a < b, a, b));
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT_EQ(selected[i], this->xs[i] < this->ys[i] ? this->xs[i] : this->ys[i]) << i;
+    }
+}
+
+// NOTE: HORIZONTAL REDUCTIONS
+TYPED_TEST(typed_simd_test, reductions) {
+    using T = typename TestFixture::type;
+    using S = typename TestFixture::simd_type;
+
+    const S a = S::load(this->xs.data());
+    T sum{};
+    for (const T x : this->xs) {
+        sum = static_cast<T>(sum + x);
+    }
+    EXPECT_EQ(reduce_add(a), sum);
+    EXPECT_EQ(reduce_min(a), *std::min_element(this->xs.begin(), this->xs.end()));
+    EXPECT_EQ(reduce_max(a), *std::max_element(this->xs.begin(), this->xs.end()));
+}
+
+// NOTE: NAN FOLLOWS STD::MIN / STD::MAX
+TEST(simd_test, min_max_nan_follow_std) {
+    using S = mia::native_simd<float>;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const S value{1.0f};
+    const S not_a_number{nan};
+    // std::min(a, b) keeps a unless b < a: a NaN first operand stays, a NaN second one is ignored
+    EXPECT_TRUE(std::isnan(min(not_a_number, value)[0]));
+    EXPECT_EQ(min(value, not_a_number)[0], 1.0f);
+    EXPECT_TRUE(std::isnan(max(not_a_number, value)[0]));
+    EXPECT_EQ(max(value, not_a_number)[0], 1.0f);
+    EXPECT_TRUE((not_a_number != not_a_number).all());
+    EXPECT_TRUE((not_a_number == not_a_number).none());
+}
+
+TEST(simd_test, native_width) {
+#if defined(MIA_SIMD_AVX512)
+    EXPECT_EQ(mia::native_simd<float>::width, 16u);
+#elif defined(MIA_SIMD_AVX)
+    EXPECT_EQ(mia::native_simd<float>::width, 8u);
+#elif defined(MIA_SIMD_SSE2)
+    EXPECT_EQ(mia::native_simd<float>::width, 4u);
+#else
+    EXPECT_EQ(mia::native_simd<float>::width, 1u);
+#endif
+    EXPECT_EQ(mia::native_simd<double>::width * 2, std::max<size_t>(mia::native_simd<float>::width, 2));
+    EXPECT_EQ((mia::simd<float, 4>::accelerated), mia::native_simd<float>::accelerated);
+    EXPECT_FALSE((mia::simd<int32_t, 4>::accelerated));
+}
@@ -0,0 +1,168 @@
+#include "math/spatial-hash.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+// NOTE: FIXTURE AND TYPED SETUP
+template <typename T, size_t Ds>
+struct hash_type {
+    using type = T;
+    static constexpr size_t dims = Ds;
+};
+using spatial_hash_test_types = ::testing::Types<hash_type<float, 2>, hash_type<float, 3>, hash_type<double, 3>>;
+
+template <typename Param>
+class typed_spatial_hash_test : public ::testing::Test {
+  public:
+    using type = typename Param::type;
+    static constexpr size_t dims = Param::dims;
+    using grid_type = mia::spatial_hash<type, dims>;
+    using vector_type = mia::vector<type, dims>;
+
+  protected:
+    void SetUp() override {
+        points.resize(3000);
+        for (vector_type &p : points) {
+            p = random_vector();
+        }
+    }
+
+    // Negative coordinates included, so cells on both sides of 0 are hashed
+    auto random_vector() -> vector_type {
+        std::uniform_real_distribution<type> coordinate{-20, 20};
+        vector_type v;
+        for (size_t d = 0; d < dims; ++d) {
+            v[d] = coordinate(random);
+        }
+        return v;
+    }
+
+    std::mt19937 random{3};
+    std::vector<vector_type> points;
+};
+
+TYPED_TEST_SUITE(typed_spatial_hash_test, spatial_hash_test_types);
+
+// NOTE: NEIGHBOURS
+TYPED_TEST(typed_spatial_hash_test, query_matches_brute_force) {
+    using T = typename TestFixture::type;
+    using V = typename TestFixture::vector_type;
+    typename TestFixture::grid_type grid{T{1}};
+    grid.rebuild(this->points);
+    ASSERT_EQ(grid.size(), this->points.size());
+
+    // Radii under, at and over the cell size, the last ones scanning every point
+    for (int i = 0; i < 100; ++i) {
+        const V center = this->random_vector();
+        const T radius = static_cast<T>(i % 10) * static_cast<T>(0.4);
+        std::vector<uint32_t> found;
+        const size_t count = grid.query(center, radius, [&](const uint32_t index, const T d) {
+            EXPECT_EQ(d, static_cast<T>(V::distance_squared(center, this->points[index])));
+            found.push_back(index);
+        });
+        EXPECT_EQ(count, found.size());
+        std::sort(found.begin(), found.end());
+
+        std::vector<uint32_t> expected;
+        for (uint32_t p = 0; p < this->points.size(); ++p) {
+            if (static_cast<T>(V::distance_squared(center, this->points[p])) <= radius * radius) {
+                expected.push_back(p);
+            }
+        }
+        EXPECT_EQ(found, expected) << i;
+    }
+}
+
+TYPED_TEST(typed_spatial_hash_test, pairs_match_brute_force) {
+    using T = typename TestFixture::type;
+    using V = typename TestFixture::vector_type;
+    // A table smaller than the point count forces collisions
+    typename TestFixture::grid_type grid{static_cast<T>(1.5), {.table_size = 64}};
+    grid.rebuild(this->points);
+    EXPECT_EQ(grid.table_size(), 64u);
+
+    const auto radius = static_cast<T>(1.5);
+    std::vector<std::pair<uint32_t, uint32_t>> found;
+    const size_t count = grid.for_each_pair(radius, [&](const uint32_t i, const uint32_t j, T) {
+        found.emplace_back(std::min(i, j), std::max(i, j));
+    });
+    EXPECT_EQ(count, found.size());
+    std::sort(found.begin(), found.end());
+
+    std::vector<std::pair<uint32_t, uint32_t>> expected;
+    for (uint32_t i = 0; i < this->points.size(); ++i) {
+        for (uint32_t j = i + 1; j < this->points.size(); ++j) {
+            if (static_cast<T>(V::distance_squared(this->points[i], this->points[j])) <= radius * radius) {
+                expected.emplace_back(i, j);
+            }
+        }
+    }
+    EXPECT_EQ(found, expected);
+    EXPECT_GT(expected.size(), 0u);
+}
+
+// NOTE: REBUILD
+TYPED_TEST(typed_spatial_hash_test, parallel_rebuild_matches_serial) {
+    using T = typename TestFixture::type;
+    typename TestFixture::grid_type serial{static_cast<T>(0.5), {.threads = 1}};
+    typename TestFixture::grid_type parallel{static_cast<T>(0.5), {.threads = 4, .parallel_threshold = 100}};
+    serial.rebuild(this->points);
+    parallel.rebuild(this->points);
+    ASSERT_EQ(serial.table_size(), parallel.table_size());
+    EXPECT_TRUE(std::equal(serial.indices().begin(), serial.indices().end(), parallel.indices().begin(), parallel.indices().end()));
+
+    // On a caller's pool, one chunk per thread or more chunks than threads
+    mia::thread_pool pool{3};
+    for (const size_t chunks : {size_t{0}, size_t{7}}) {
+        typename TestFixture::grid_type on_pool{static_cast<T>(0.5), {.threads = chunks, .parallel_threshold = 100}};
+        on_pool.rebuild(pool, this->points);
+        on_pool.rebuild(pool, this->points);
+        EXPECT_TRUE(std::equal(serial.indices().begin(), serial.indices().end(), on_pool.indices().begin(), on_pool.indices().end())) << chunks;
+    }
+
+    // Points of a bucket are contiguous, in input order
+    const auto indices = serial.indices();
+    for (size_t i = 1; i < indices.size(); ++i) {
+        const uint32_t previous = serial.bucket(serial.cell(this->points[indices[i - 1]]));
+        const uint32_t current = serial.bucket(serial.cell(this->points[indices[i]]));
+        EXPECT_TRUE(previous < current || (previous == current && indices[i - 1] < indices[i]));
+    }
+}
+
+TEST(spatial_hash_test, steady_rebuilds_do_not_allocate) {
+    using V = mia::vector<float, 2>;
+    std::vector<V> points(10000);
+    std::mt19937 random{9};
+    std::uniform_real_distribution<float> coordinate{0.0f, 100.0f};
+    mia::spatial_hash<float, 2> grid{1.0f, {.threads = 2, .parallel_threshold = 1000}};
+    size_t capacity = 0;
+    for (int step = 0; step < 10; ++step) {
+        for (V &p : points) {
+            p = V{coordinate(random), coordinate(random)};
+        }
+        grid.rebuild(points);
+        if (step == 0) {
+            capacity = grid.capacity_bytes();
+        }
+        EXPECT_EQ(grid.capacity_bytes(), capacity);
+    }
+
+    // Fewer points reuse the buffers, more grow them
+    grid.rebuild(std::span<const V>{points}.first(10));
+    EXPECT_EQ(grid.capacity_bytes(), capacity);
+    EXPECT_EQ(grid.query(points[3], 0.0f, [](uint32_t, float) {}), 1u);
+    points.resize(20000, V{50.0f, 50.0f});
+    grid.rebuild(points);
+    EXPECT_GT(grid.capacity_bytes(), capacity);
+    EXPECT_EQ(grid.query(V{50.0f, 50.0f}, 0.0f, [](uint32_t, float) {}), 10000u);
+
+    grid.rebuild({});
+    EXPECT_TRUE(grid.empty());
+    EXPECT_EQ(grid.query(V{}, 1000.0f, [](uint32_t, float) {}), 0u);
+}
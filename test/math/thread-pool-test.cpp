@@ -0,0 +1,118 @@
+#include "math/thread-pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// NOTE: PARALLEL FOR
+TEST(thread_pool_test, every_index_once) {
+    for (const size_t threads : {size_t{1}, size_t{2}, size_t{5}}) {
+        mia::thread_pool pool{threads};
+        EXPECT_EQ(pool.size(), threads);
+        for (const size_t count : {size_t{0}, size_t{1}, size_t{7}, size_t{1000}, size_t{100'003}}) {
+            std::vector<std::atomic<uint32_t>> hits(count);
+            pool.parallel_for(0, count, [&](const size_t i) { hits[i].fetch_add(1, std::memory_order_relaxed); });
+
+            // Sub-ranges, offset & with a grain
+            pool.parallel_for(3, count + 3, [&](const size_t begin, const size_t end) {
+                EXPECT_LT(begin, end);
+                for (size_t i = begin; i < end; ++i) {
+                    hits[i - 3].fetch_add(1, std::memory_order_relaxed);
+                }
+            }, 64);
+            for (size_t i = 0; i < count; ++i) {
+                ASSERT_EQ(hits[i].load(), 2u) << threads << " " << count << " " << i;
+            }
+        }
+    }
+}
+
+TEST(thread_pool_test, work_is_spread_and_nested) {
+    mia::thread_pool pool{4};
+    std::mutex mutex;
+    std::set<std::thread::id> seen;
+    std::atomic<size_t> inner{0};
+    pool.parallel_for(0, 64, [&](const size_t) {
+        {
+            const std::lock_guard lock(mutex);
+            seen.insert(std::this_thread::get_id());
+        }
+        // Nested loops run on the same pool, a waiting thread keeps running tasks
+        pool.parallel_for(0, 100, [&](const size_t) { inner.fetch_add(1, std::memory_order_relaxed); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    EXPECT_EQ(inner.load(), 6400u);
+    EXPECT_GT(seen.size(), 1u);
+}
+
+TEST(thread_pool_test, concurrent_callers) {
+    mia::thread_pool pool{3};
+    std::atomic<size_t> total{0};
+    {
+        std::vector<std::jthread> callers;
+        for (int c = 0; c < 4; ++c) {
+            callers.emplace_back([&] {
+                for (int round = 0; round < 20; ++round) {
+                    pool.parallel_for(0, 5000, [&](const size_t begin, const size_t end) {
+                        total.fetch_add(end - begin, std::memory_order_relaxed);
+                    });
+                }
+            });
+        }
+    }
+    EXPECT_EQ(total.load(), 4u * 20 * 5000);
+}
+
+TEST(thread_pool_test, exceptions_reach_the_caller) {
+    mia::thread_pool pool{4};
+    std::atomic<size_t> ran{0};
+    EXPECT_THROW(pool.parallel_for(0, 100'000, [&](const size_t i) {
+        ran.fetch_add(1, std::memory_order_relaxed);
+        if (i == 500) {
+            throw std::runtime_error("failed");
+        }
+    }),
+                 std::runtime_error);
+    EXPECT_LT(ran.load(), 100'000u);
+
+    // Still usable
+    std::atomic<size_t> count{0};
+    pool.parallel_for(0, 1000, [&](const size_t) { count.fetch_add(1, std::memory_order_relaxed); });
+    EXPECT_EQ(count.load(), 1000u);
+}
+
+// NOTE: PARALLEL REDUCE
+TEST(thread_pool_test, reduce_does_not_depend_on_the_pool) {
+    std::vector<float> values(200'001);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = 1.0f / static_cast<float>(i + 1);
+    }
+    const auto sum = [&](mia::thread_pool &pool) {
+        return pool.parallel_reduce(
+            0, values.size(), 0.0f,
+            [&](const size_t begin, const size_t end) {
+                float partial = 0.0f;
+                for (size_t i = begin; i < end; ++i) {
+                    partial += values[i];
+                }
+                return partial;
+            },
+            [](const float lhs, const float rhs) { return lhs + rhs; }, 1000);
+    };
+    mia::thread_pool serial{1};
+    mia::thread_pool parallel{6};
+    const float expected = sum(serial);
+    EXPECT_NEAR(expected, 12.78f, 0.01f);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(sum(parallel), expected);
+    }
+    EXPECT_EQ(parallel.parallel_reduce(4, 4, 7, [](size_t, size_t) { return 1; }, [](int a, int b) { return a + b; }), 7);
+}
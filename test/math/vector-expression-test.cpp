@@ -0,0 +1,161 @@
+#include "math/vector.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <type_traits>
+
+// NOTE: FIXTURE AND TYPED SETUP
+template <typename T, size_t Ds>
+struct expression_type {
+    using type = T;
+    static constexpr size_t dims = Ds;
+};
+using expression_test_types = ::testing::Types<expression_type<float, 2>, expression_type<float, 3>, expression_type<float, 4>,
+                                               expression_type<double, 4>, expression_type<int, 3>>;
+
+template <typename Param>
+class vector_expression_test : public ::testing::Test {
+  public:
+    using type = typename Param::type;
+    static constexpr size_t dims = Param::dims;
+    using vector_type = mia::vector<type, dims>;
+
+  protected:
+    void SetUp() override {
+        for (size_t i = 0; i < dims; ++i) {
+            a[i] = static_cast<type>(i + 1);
+            b[i] = static_cast<type>(i * 2);
+            c[i] = static_cast<type>(3 - static_cast<int>(i));
+        }
+    }
+
+    vector_type a;
+    vector_type b;
+    vector_type c;
+};
+
+TYPED_TEST_SUITE(vector_expression_test, expression_test_types);
+
+// NOTE: LAZINESS
+TYPED_TEST(vector_expression_test, operators_build_expressions) {
+    using V = typename TestFixture::vector_type;
+
+    auto sum = this->a + this->b;
+    static_assert(!std::is_same_v<decltype(sum), V>);
+    static_assert(std::is_same_v<decltype(sum.eval()), V>);
+    static_assert(std::is_same_v<decltype(this->a * 2 - this->c / 2), decltype(this->a * 2 - this->c / 2)>);
+    EXPECT_EQ(sum.size(), TestFixture::dims);
+
+    // Operands are captured by value, later changes do not leak into an existing expression
+    const V expected = sum;
+    this->a += this->b;
+    EXPECT_EQ(sum, expected);
+    EXPECT_EQ(this->a, expected);
+
+    // A temporary operand lives on inside the expression
+    const auto from_temporary = V{this->c} + this->b;
+    const auto returned = [](const V l, const V r) { return l - r; }(this->a, this->b);
+    EXPECT_EQ(V{from_temporary}, this->c + this->b);
+    EXPECT_EQ(V{returned}, this->a - this->b);
+}
+
+// NOTE: FUSED EVALUATION
+TYPED_TEST(vector_expression_test, fused_matches_element_wise) {
+    using T = typename TestFixture::type;
+    using V = typename TestFixture::vector_type;
+    using K = typename V::compute_type;
+
+    const V result = this->a + this->b * K(3) - this->c / K(2);
+    for (size_t i = 0; i < TestFixture::dims; ++i) {
+        const T scaled = static_cast<T>(static_cast<K>(this->b[i]) * K(3));
+        const T halved = static_cast<T>(static_cast<K>(this->c[i]) / K(2));
+        EXPECT_EQ(result[i], static_cast<T>(static_cast<T>(this->a[i] + scaled) - halved));
+    }
+
+    // Element access and named accessors evaluate on demand
+    const auto expression = K(2) * (this->a - this->b);
+    for (size_t i = 0; i < TestFixture::dims; ++i) {
+        EXPECT_EQ(expression[i], static_cast<T>(K(2) * static_cast<K>(this->a[i] - this->b[i])));
+    }
+    EXPECT_EQ(expression.x(), expression.eval().x());
+    EXPECT_EQ(expression.magnitude_squared(), expression.eval().magnitude_squared());
+}
+
+TYPED_TEST(vector_expression_test, assignment_aliasing) {
+    using V = typename TestFixture::vector_type;
+
+    V expected;
+    for (size_t i = 0; i < TestFixture::dims; ++i) {
+        expected[i] = this->b[i] - this->a[i] + this->a[i];
+    }
+    this->a = this->b - this->a + this->a;
+    EXPECT_EQ(this->a, expected);
+
+    V twice = this->c;
+    twice += twice;
+    EXPECT_EQ(twice, this->c * 2);
+    twice -= this->c + this->c;
+    EXPECT_EQ(twice, V{});
+}
+
+TYPED_TEST(vector_expression_test, compound_assignment_in_place) {
+    using T = typename TestFixture::type;
+    using V = typename TestFixture::vector_type;
+    using K = typename V::compute_type;
+
+    // An expression operand is evaluated once, then added in place; aliasing the target is fine
+    V v = this->a;
+    v += v * K(2) - this->b;
+    V w = this->c;
+    w -= this->a + w;
+    for (size_t i = 0; i < TestFixture::dims; ++i) {
+        const T doubled = static_cast<T>(static_cast<K>(this->a[i]) * K(2));
+        EXPECT_EQ(v[i], static_cast<T>(this->a[i] + static_cast<T>(doubled - this->b[i]))) << i;
+        EXPECT_EQ(w[i], static_cast<T>(this->c[i] - static_cast<T>(this->a[i] + this->c[i]))) << i;
+    }
+}
+
+TYPED_TEST(vector_expression_test, compound_assignment_returns_reference) {
+    using V = typename TestFixture::vector_type;
+
+    V v = this->a;
+    V &ref = (v *= 2);
+    EXPECT_EQ(&ref, &v);
+    EXPECT_EQ(v, this->a + this->a);
+    v /= 2;
+    EXPECT_EQ(v, this->a);
+}
+
+// NOTE: MIXED TYPES
+TEST(vector_expression, mixed_element_types) {
+    const mia::vector<float, 3> f{1.5f, 2.5f, 3.5f};
+    const mia::vector<int, 3> n{1, 2, 3};
+
+    // The result takes the element type of the left operand
+    const mia::vector<float, 3> sum = f + n - f;
+    EXPECT_EQ(sum, (mia::vector<float, 3>{1.0f, 2.0f, 3.0f}));
+    const mia::vector<int, 3> truncated = n + f;
+    EXPECT_EQ(truncated, (mia::vector<int, 3>{2, 4, 6}));
+}
+
+// NOTE: CONSTANT EVALUATION
+TEST(vector_expression, constexpr_usable) {
+    using V = mia::vector<float, 3>;
+    constexpr V a{1.0f, 2.0f, 3.0f};
+    constexpr V b{4.0f, 5.0f, 6.0f};
+
+    constexpr V fused = a + b * 2.0f - a / 2.0f;
+    static_assert(fused[0] == 8.5f && fused[1] == 11.0f && fused[2] == 13.5f);
+    static_assert((a + b)[2] == 9.0f);
+    static_assert(a + b == V{5.0f, 7.0f, 9.0f});
+    static_assert(V::distance_squared(a, b) == 27.0f);
+
+    constexpr auto accumulate = [](V v) {
+        v += V{1.0f, 1.0f, 1.0f};
+        v *= 2.0f;
+        return v;
+    };
+    static_assert(accumulate(a) == V{4.0f, 6.0f, 8.0f});
+    EXPECT_EQ(accumulate(a), (V{4.0f, 6.0f, 8.0f}));
+}
@@ -0,0 +1,190 @@
+#include "math/vector-io.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+// NOTE: FIXTURE AND TYPED SETUP
+template <typename T, size_t Ds>
+struct io_type {
+    using type = T;
+    static constexpr size_t dims = Ds;
+};
+using vector_io_test_types = ::testing::Types<io_type<float, 3>, io_type<double, 2>, io_type<int32_t, 4>, io_type<uint8_t, 3>>;
+
+namespace {
+
+// One file per test, removed afterwards
+class vector_file_test : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        const auto *info = ::testing::UnitTest::GetInstance()->current_test_info();
+        std::string name = std::string("mia-") + info->test_suite_name() + "-" + info->name() + ".vec";
+        std::replace(name.begin(), name.end(), '/', '-'); // Typed suites are named suite/N
+        path = std::filesystem::temp_directory_path() / name;
+    }
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    std::filesystem::path path;
+};
+
+} // namespace
+
+template <typename Param>
+class typed_vector_file_test : public vector_file_test {
+  public:
+    using type = typename Param::type;
+    static constexpr size_t dims = Param::dims;
+    using vector_type = mia::vector<type, dims>;
+
+  protected:
+    auto random_vectors(const size_t count) -> std::vector<vector_type> {
+        std::mt19937 random{static_cast<uint32_t>(count)};
+        std::uniform_int_distribution<int> component{0, 100};
+        std::vector<vector_type> vectors(count);
+        for (vector_type &v : vectors) {
+            for (size_t d = 0; d < dims; ++d) {
+                v[d] = static_cast<type>(component(random));
+            }
+        }
+        return vectors;
+    }
+};
+
+TYPED_TEST_SUITE(typed_vector_file_test, vector_io_test_types);
+
+// NOTE: ROUND TRIPS
+TYPED_TEST(typed_vector_file_test, save_then_map_and_load) {
+    using T = typename TestFixture::type;
+    using V = typename TestFixture::vector_type;
+    const auto vectors = this->random_vectors(1000);
+    mia::save<T, TestFixture::dims>(this->path, vectors);
+
+    const mia::vector_file_header header = mia::read_header(this->path);
+    EXPECT_EQ(header.count, vectors.size());
+    EXPECT_EQ(header.dims, TestFixture::dims);
+    EXPECT_EQ(header.scalar, mia::scalar_type_of<T>());
+    EXPECT_EQ(header.stride, sizeof(V));
+    EXPECT_FALSE(header.foreign());
+
+    const mia::mapped_array<V> mapped{this->path};
+    ASSERT_EQ(mapped.size(), vectors.size());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(mapped.data()) % MIA_PAGE_ALIGNMENT, 0u);
+    EXPECT_TRUE(std::equal(mapped.begin(), mapped.end(), vectors.begin(), vectors.end()));
+    mapped.advise(mia::access_pattern::sequential);
+
+    EXPECT_EQ((mia::load<T, TestFixture::dims>(this->path)), vectors);
+}
+
+TEST_F(vector_file_test, streaming_writer) {
+    using V = mia::vector<float, 3>;
+    std::vector<V> expected;
+    {
+        mia::vector_writer<float, 3> writer{path, {.alignment = 64}};
+        for (int chunk = 0; chunk < 10; ++chunk) {
+            std::vector<V> vectors(100 + static_cast<size_t>(chunk), V{static_cast<float>(chunk), 1.0f, 2.0f});
+            writer.write(vectors);
+            expected.insert(expected.end(), vectors.begin(), vectors.end());
+            writer.write(V{-1.0f, -2.0f, static_cast<float>(chunk)});
+            expected.push_back(V{-1.0f, -2.0f, static_cast<float>(chunk)});
+        }
+        EXPECT_EQ(writer.size(), expected.size());
+        // Closed by the destructor
+    }
+    EXPECT_EQ(mia::read_header(path).data_offset, 64u);
+    mia::mapped_array<V> mapped{path};
+    EXPECT_TRUE(std::equal(mapped.begin(), mapped.end(), expected.begin(), expected.end()));
+
+    // Moves hand the mapping over
+    mia::mapped_array<V> moved{std::move(mapped)};
+    EXPECT_TRUE(mapped.empty());
+    EXPECT_EQ(moved.span().size(), expected.size());
+    EXPECT_EQ(moved[5], expected[5]);
+    mia::mapped_array<V> assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.size(), expected.size());
+}
+
+TEST_F(vector_file_test, empty_file) {
+    mia::save<float, 2>(path, {});
+    const mia::mapped_array<mia::vector<float, 2>> mapped{path};
+    EXPECT_TRUE(mapped.empty());
+    EXPECT_TRUE((mia::load<float, 2>(path)).empty());
+}
+
+// NOTE: LAYOUT CONVERSION
+// A big endian producer with unpadded vectors, written by hand
+TEST_F(vector_file_test, foreign_byte_order_and_stride) {
+    mia::vector_file_header header;
+    header.scalar = mia::scalar_type::f32;
+    header.dims = 3;
+    header.stride = 3 * sizeof(float);
+    header.alignment = 64;
+    header.count = 2;
+    header.data_offset = 64;
+    header = mia::detail::byteswap_header(header);
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (const float value : {1.0f, 2.0f, 3.0f, -4.0f, 0.5f, 1e20f}) {
+            const uint32_t swapped = std::byteswap(std::bit_cast<uint32_t>(value));
+            file.write(reinterpret_cast<const char *>(&swapped), sizeof(swapped));
+        }
+    }
+
+    EXPECT_TRUE(mia::read_header(path).foreign());
+    EXPECT_EQ(mia::read_header(path).count, 2u);
+    const auto loaded = mia::load<float, 3>(path);
+    ASSERT_EQ(loaded.size(), 2u);
+    EXPECT_EQ(loaded[0], (mia::vector<float, 3>{1.0f, 2.0f, 3.0f}));
+    EXPECT_EQ(loaded[1], (mia::vector<float, 3>{-4.0f, 0.5f, 1e20f}));
+    EXPECT_THROW((mia::mapped_array<mia::vector<float, 3>>{path}), mia::vector_file_error);
+}
+
+// NOTE: ERRORS
+TEST_F(vector_file_test, rejects_bad_files) {
+    using V = mia::vector<float, 3>;
+    EXPECT_THROW(mia::mapped_array<V>{path}, std::system_error);
+    EXPECT_THROW((mia::load<float, 3>(path)), std::system_error);
+
+    // Another vector type
+    const std::vector<V> vectors(10, V{1.0f, 2.0f, 3.0f});
+    mia::save<float, 3>(path, vectors);
+    EXPECT_THROW((mia::mapped_array<mia::vector<float, 4>>{path}), mia::vector_file_error);
+    EXPECT_THROW((mia::load<double, 3>(path)), mia::vector_file_error);
+
+    // Cut short
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_THROW(mia::mapped_array<V>{path}, mia::vector_file_error);
+    std::filesystem::resize_file(path, 10);
+    EXPECT_THROW(mia::read_header(path), mia::vector_file_error);
+
+    // Not a vector file
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << std::string(256, 'x');
+    }
+    EXPECT_THROW(mia::mapped_array<V>{path}, mia::vector_file_error);
+
+    // From a newer version
+    mia::save<float, 3>(path, vectors);
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        const uint16_t version = mia::vector_file_header::current_version + 1;
+        file.seekp(offsetof(mia::vector_file_header, version));
+        file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    }
+    EXPECT_THROW(mia::read_header(path), mia::vector_file_error);
+}
@@ -0,0 +1,147 @@
+#include "math/vector.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// NOTE: FIXTURE AND TYPED SETUP
+template <typename T, size_t Ds>
+struct simd_vector_type {
+    using type = T;
+    static constexpr size_t dims = Ds;
+};
+using simd_vector_test_types = ::testing::Types<simd_vector_type<float, 3>, simd_vector_type<float, 4>, simd_vector_type<double, 4>>;
+
+template <typename Param>
+class typed_vector_simd_test : public ::testing::Test {
+  public:
+    using type = typename Param::type;
+    static constexpr size_t dims = Param::dims;
+    using vector_type = mia::vector<type, dims>;
+
+  protected:
+    void SetUp() override {
+        for (size_t i = 0; i < dims; ++i) {
+            vec1[i] = static_cast<type>(i + 1);
+            vec2[i] = static_cast<type>(static_cast<int>(i * 3) - 4);
+        }
+    }
+
+    vector_type vec1;
+    vector_type vec2;
+};
+
+TYPED_TEST_SUITE(typed_vector_simd_test, simd_vector_test_types);
+
+// NOTE: LAYOUT
+TYPED_TEST(typed_vector_simd_test, layout) {
+    using T = typename TestFixture::type;
+    constexpr size_t Ds = TestFixture::dims;
+    using V = typename TestFixture::vector_type;
+
+    if constexpr (V::simd_traits::enabled) {
+        EXPECT_EQ(sizeof(V), sizeof(T) * 4);
+        EXPECT_GE(alignof(V), 16u);
+    } else {
+        EXPECT_EQ(sizeof(V), sizeof(T) * Ds);
+    }
+
+    // Iteration never exposes the padding lane
+    EXPECT_EQ(static_cast<size_t>(this->vec1.end() - this->vec1.begin()), Ds);
+
+    // Over-aligned elements stay aligned inside standard containers
+    std::vector<V> many(17, this->vec1);
+    for (const auto &v : many) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(&v) % alignof(V), 0u);
+    }
+}
+
+// NOTE: RUNTIME KERNELS MATCH CONSTANT EVALUATION
+TYPED_TEST(typed_vector_simd_test, runtime_matches_constexpr) {
+    using T = typename TestFixture::type;
+    using V = typename TestFixture::vector_type;
+    using ComputeType = typename V::compute_type;
+
+    static constexpr V a{1, 2, 3, 4};
+    static constexpr V b{-3, 5, 0, 2};
+
+    constexpr V sum = a + b;
+    constexpr V diff = a - b;
+    constexpr V scaled = a * static_cast<ComputeType>(3);
+    constexpr V divided = a / static_cast<ComputeType>(2);
+    constexpr V hadamard = V::hadamard_product(a, b);
+    constexpr V min_vec = V::min(a, b);
+    constexpr V max_vec = V::max(a, b);
+    constexpr V lerp_vec = V::lerp(a, b, static_cast<ComputeType>(0.25));
+    constexpr ComputeType dot = V::dot_product(a, b);
+    constexpr bool equal = (a == b);
+
+    const V ra = a;
+    const V rb = b;
+    EXPECT_EQ(ra + rb, sum);
+    EXPECT_EQ(ra - rb, diff);
+    EXPECT_EQ(ra * static_cast<ComputeType>(3), scaled);
+    EXPECT_EQ(ra / static_cast<ComputeType>(2), divided);
+    EXPECT_EQ(V::hadamard_product(ra, rb), hadamard);
+    EXPECT_EQ(V::min(ra, rb), min_vec);
+    EXPECT_EQ(V::max(ra, rb), max_vec);
+    EXPECT_EQ(V::lerp(ra, rb, static_cast<ComputeType>(0.25)), lerp_vec);
+    EXPECT_EQ(V::dot_product(ra, rb), dot);
+    EXPECT_EQ(ra == rb, equal);
+    EXPECT_TRUE(ra == a);
+
+    // Named accessors read the same lanes the kernels write
+    V added = ra + rb;
+    EXPECT_EQ(added.x(), static_cast<T>(-2));
+    EXPECT_EQ(added.y(), static_cast<T>(7));
+}
+
+// NOTE: PADDING LANE
+TYPED_TEST(typed_vector_simd_test, padding_is_ignored) {
+    using V = typename TestFixture::vector_type;
+    using ComputeType = typename V::compute_type;
+
+    // Division by zero poisons the padding lane (0 / 0), reductions must not see it
+    V inf = this->vec1 / static_cast<ComputeType>(0);
+    EXPECT_TRUE(inf == inf);
+    EXPECT_EQ(V::dot_product(inf, inf), std::numeric_limits<ComputeType>::infinity());
+
+    V zero{};
+    V sum = zero + this->vec2;
+    EXPECT_EQ(V::dot_product(sum, this->vec1), V::dot_product(this->vec2, this->vec1));
+
+    // Normalize goes through the same kernels
+    V normalized = this->vec1.normalized();
+    EXPECT_NEAR(normalized.magnitude(), static_cast<ComputeType>(1), static_cast<ComputeType>(1e-6));
+}
+
+// NOTE: DOUBLE STAYS DOUBLE ON BOTH PATHS
+// Elements a float cannot hold: rounding through compute_type on one path only would show up here
+TEST(vector_simd_test, double_runtime_matches_constexpr) {
+    using V = mia::vector<double, 4>;
+    constexpr double tiny = 0x1p-40;
+
+    static constexpr V a{1 + tiny, 2 - tiny, 3 + 3 * tiny, -4 + tiny};
+    static constexpr V b{3.0, -1 + tiny, 0.5, 2 + 5 * tiny};
+
+    constexpr V scaled = a * 0.75f;
+    constexpr V divided = a / 4.0f;
+    constexpr V lerp_vec = V::lerp(a, b, 0.25f);
+    constexpr V lerp_from = V::lerp(a, b, 0.0f);
+    constexpr float dot = V::dot_product(a, b);
+
+    const V ra = a;
+    const V rb = b;
+    EXPECT_EQ(ra * 0.75f, scaled);
+    EXPECT_EQ(ra / 4.0f, divided);
+    EXPECT_EQ(V::lerp(ra, rb, 0.25f), lerp_vec);
+    EXPECT_EQ(V::dot_product(ra, rb), dot);
+
+    // Nothing was lost to float on the way
+    EXPECT_EQ(lerp_from, a);
+    EXPECT_EQ(scaled[0], 0.75 + 0.75 * tiny);
+    EXPECT_EQ(divided[3], -1 + tiny / 4);
+}
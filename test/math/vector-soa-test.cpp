@@ -0,0 +1,180 @@
+#include "math/vector-soa.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// NOTE: FIXTURE AND TYPED SETUP
+template <typename T, size_t Ds>
+struct soa_type {
+    using type = T;
+    static constexpr size_t dims = Ds;
+};
+using vector_soa_test_types = ::testing::Types<soa_type<float, 3>, soa_type<float, 2>, soa_type<double, 4>, soa_type<int, 3>>;
+
+template <typename Param>
+class typed_vector_soa_test : public ::testing::Test {
+  public:
+    using type = typename Param::type;
+    static constexpr size_t dims = Param::dims;
+    using vector_type = mia::vector<type, dims>;
+    using soa_type = mia::vector_soa<type, dims>;
+
+  protected:
+    void SetUp() override {
+        // Odd count so the last pack is partial
+        for (size_t i = 0; i < 37; ++i) {
+            vector_type a;
+            vector_type b;
+            for (size_t d = 0; d < dims; ++d) {
+                a[d] = static_cast<type>(static_cast<int>(i + d) % 7 + 1);
+                b[d] = static_cast<type>(static_cast<int>(i * 3 + d) % 5 - 2);
+            }
+            aos1.push_back(a);
+            aos2.push_back(b);
+        }
+    }
+
+    std::vector<vector_type> aos1;
+    std::vector<vector_type> aos2;
+};
+
+TYPED_TEST_SUITE(typed_vector_soa_test, vector_soa_test_types);
+
+// NOTE: LAYOUT AND ACCESS
+TYPED_TEST(typed_vector_soa_test, layout_and_access) {
+    using T = typename TestFixture::type;
+    constexpr size_t Ds = TestFixture::dims;
+    using SoA = typename TestFixture::soa_type;
+    using V = typename TestFixture::vector_type;
+
+    SoA soa(this->aos1);
+    ASSERT_EQ(soa.size(), this->aos1.size());
+    EXPECT_EQ(soa.padded_size() % SoA::pack::width, 0u);
+
+    for (size_t d = 0; d < Ds; ++d) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(soa.lane(d).data()) % SoA::lane_alignment, 0u);
+    }
+
+    // Proxy reads
+    for (size_t i = 0; i < soa.size(); ++i) {
+        V v = soa[i];
+        EXPECT_EQ(v, this->aos1[i]);
+        EXPECT_EQ(soa[i].x(), this->aos1[i].x());
+        EXPECT_EQ(soa.x()[i], this->aos1[i].x());
+    }
+
+    // Proxy writes
+    soa[3] = this->aos2[0];
+    EXPECT_EQ(static_cast<V>(soa[3]), this->aos2[0]);
+    soa[4][0] = T{42};
+    EXPECT_EQ(soa.lane(0)[4], T{42});
+
+    // Iteration
+    size_t idx = 0;
+    for (auto ref : soa) {
+        EXPECT_EQ(ref.load(), static_cast<V>(soa[idx]));
+        ++idx;
+    }
+    EXPECT_EQ(idx, soa.size());
+
+    // Round trip
+    std::vector<V> back(soa.size());
+    soa.store(back);
+    EXPECT_EQ(back[3], this->aos2[0]);
+
+    // push_back & resize
+    SoA grown;
+    for (const auto &v : this->aos1) {
+        grown.push_back(v);
+    }
+    ASSERT_EQ(grown.size(), this->aos1.size());
+    EXPECT_EQ(static_cast<V>(grown[grown.size() - 1]), this->aos1.back());
+    grown.resize(2);
+    grown.resize(5);
+    EXPECT_EQ(static_cast<V>(grown[4]), V{});
+}
+
+// NOTE: BATCHED OPERATIONS
+TYPED_TEST(typed_vector_soa_test, batched_operations) {
+    using T = typename TestFixture::type;
+    using SoA = typename TestFixture::soa_type;
+    using V = typename TestFixture::vector_type;
+    using ComputeType = typename V::compute_type;
+
+    const SoA a(this->aos1);
+    const SoA b(this->aos2);
+    SoA out;
+
+    SoA::add(a, b, out);
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(static_cast<V>(out[i]), this->aos1[i] + this->aos2[i]);
+    }
+
+    SoA::sub(a, b, out);
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(static_cast<V>(out[i]), this->aos1[i] - this->aos2[i]);
+    }
+
+    SoA::hadamard_product(a, b, out);
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(static_cast<V>(out[i]), V::hadamard_product(this->aos1[i], this->aos2[i]));
+    }
+
+    SoA::min(a, b, out);
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(static_cast<V>(out[i]), V::min(this->aos1[i], this->aos2[i]));
+    }
+
+    SoA::max(a, b, out);
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(static_cast<V>(out[i]), V::max(this->aos1[i], this->aos2[i]));
+    }
+
+    SoA::scale(a, T{3}, out);
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(static_cast<V>(out[i]), this->aos1[i] * static_cast<ComputeType>(3));
+    }
+
+    std::vector<ComputeType> dots(a.size());
+    SoA::dot_product(a, b, dots);
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(dots[i], V::dot_product(this->aos1[i], this->aos2[i]));
+    }
+
+    // In place
+    SoA c = a;
+    c += b;
+    c -= b;
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(static_cast<V>(c[i]), this->aos1[i]);
+    }
+
+    if constexpr (std::is_floating_point_v<T>) {
+        SoA::lerp(a, b, static_cast<T>(0.25), out);
+        for (size_t i = 0; i < a.size(); ++i) {
+            V expected = V::lerp(this->aos1[i], this->aos2[i], static_cast<ComputeType>(0.25));
+            for (size_t d = 0; d < TestFixture::dims; ++d) {
+                EXPECT_NEAR(out[i][d], expected[d], 1e-6);
+            }
+        }
+
+        SoA normalized = a;
+        normalized.normalizing();
+        std::vector<ComputeType> magnitudes(a.size());
+        normalized.magnitude_squared(magnitudes);
+        for (size_t i = 0; i < a.size(); ++i) {
+            EXPECT_NEAR(magnitudes[i], static_cast<ComputeType>(1), 1e-5);
+        }
+
+        SoA fast_normalized = a;
+        fast_normalized.template normalizing<mia::precision::fast>();
+        fast_normalized.magnitude_squared(magnitudes);
+        for (size_t i = 0; i < a.size(); ++i) {
+            EXPECT_NEAR(magnitudes[i], static_cast<ComputeType>(1), 1e-5);
+        }
+    }
+}